@@ -26,6 +26,7 @@
 
 #include "base/Data.h"
 #include "base/Log.h"
+#include <cstring>
 
 namespace cc {
 
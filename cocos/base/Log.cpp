@@ -1,6 +1,8 @@
 #include "Log.h"
 #include "UTFString.h"
 #include "StringUtil.h"
+#include <cstdarg>
+#include <ctime>
 
 #if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
     #ifndef WIN32_LEAN_AND_MEAN
@@ -34,6 +34,7 @@ THE SOFTWARE.
 
 #include <cmath>
 #include <stdlib.h>
+#include <string.h>
 
 namespace cc {
 
@@ -0,0 +1,74 @@
+#include "cocos/bindings/auto/jsb_empty_auto.h"
+#include "cocos/bindings/manual/jsb_conversions.h"
+#include "cocos/bindings/manual/jsb_global.h"
+#include "renderer/gfx-empty/GFXEmpty.h"
+
+#ifndef JSB_ALLOC
+#define JSB_ALLOC(kls, ...) new (std::nothrow) kls(__VA_ARGS__)
+#endif
+
+#ifndef JSB_FREE
+#define JSB_FREE(ptr) delete ptr
+#endif
+se::Object* __jsb_cc_gfx_EmptyDevice_proto = nullptr;
+se::Class* __jsb_cc_gfx_EmptyDevice_class = nullptr;
+
+SE_DECLARE_FINALIZE_FUNC(js_cc_gfx_EmptyDevice_finalize)
+
+static bool js_empty_EmptyDevice_constructor(se::State& s) // constructor.c
+{
+    cc::gfx::EmptyDevice* cobj = JSB_ALLOC(cc::gfx::EmptyDevice);
+    s.thisObject()->setPrivateData(cobj);
+    se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+    return true;
+}
+SE_BIND_CTOR(js_empty_EmptyDevice_constructor, __jsb_cc_gfx_EmptyDevice_class, js_cc_gfx_EmptyDevice_finalize)
+
+
+
+extern se::Object* __jsb_cc_gfx_Device_proto;
+
+static bool js_cc_gfx_EmptyDevice_finalize(se::State& s)
+{
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(SE_THIS_OBJECT<cc::gfx::EmptyDevice>(s));
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end())
+    {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        cc::gfx::EmptyDevice* cobj = SE_THIS_OBJECT<cc::gfx::EmptyDevice>(s);
+        JSB_FREE(cobj);
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_cc_gfx_EmptyDevice_finalize)
+
+bool js_register_empty_EmptyDevice(se::Object* obj)
+{
+    auto cls = se::Class::create("EmptyDevice", obj, __jsb_cc_gfx_Device_proto, _SE(js_empty_EmptyDevice_constructor));
+
+    cls->defineFinalizeFunction(_SE(js_cc_gfx_EmptyDevice_finalize));
+    cls->install();
+    JSBClassType::registerClass<cc::gfx::EmptyDevice>(cls);
+
+    __jsb_cc_gfx_EmptyDevice_proto = cls->getProto();
+    __jsb_cc_gfx_EmptyDevice_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
+bool register_all_empty(se::Object* obj)
+{
+    // Get the ns
+    se::Value nsVal;
+    if (!obj->getProperty("gfx", &nsVal))
+    {
+        se::HandleObject jsobj(se::Object::createPlainObject());
+        nsVal.setObject(jsobj);
+        obj->setProperty("gfx", nsVal);
+    }
+    se::Object* ns = nsVal.toObject();
+
+    js_register_empty_EmptyDevice(ns);
+    return true;
+}
+
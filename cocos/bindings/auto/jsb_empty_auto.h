@@ -0,0 +1,16 @@
+#pragma once
+#include "base/Config.h"
+#include <type_traits>
+#include "cocos/bindings/jswrapper/SeApi.h"
+#include "cocos/bindings/manual/jsb_conversions.h"
+#include "cocos/renderer/gfx-empty/GFXEmpty.h"
+
+extern se::Object* __jsb_cc_gfx_EmptyDevice_proto;
+extern se::Class* __jsb_cc_gfx_EmptyDevice_class;
+
+bool js_register_cc_gfx_EmptyDevice(se::Object* obj);
+bool register_all_empty(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::gfx::EmptyDevice);
+SE_DECLARE_FUNC(js_empty_EmptyDevice_EmptyDevice);
+
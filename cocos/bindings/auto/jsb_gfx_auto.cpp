@@ -11589,6 +11589,25 @@ static bool js_gfx_CommandBuffer_begin(se::State& s)
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_begin)
 
+static bool js_gfx_CommandBuffer_beginProfileScope(se::State& s)
+{
+    cc::gfx::CommandBuffer* cobj = SE_THIS_OBJECT<cc::gfx::CommandBuffer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_CommandBuffer_beginProfileScope : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::string, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_CommandBuffer_beginProfileScope : Error processing arguments");
+        cobj->beginProfileScope(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_CommandBuffer_beginProfileScope)
+
 static bool js_gfx_CommandBuffer_beginRenderPass(se::State& s)
 {
     CC_UNUSED bool ok = true;
@@ -11811,6 +11830,21 @@ static bool js_gfx_CommandBuffer_end(se::State& s)
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_end)
 
+static bool js_gfx_CommandBuffer_endProfileScope(se::State& s)
+{
+    cc::gfx::CommandBuffer* cobj = SE_THIS_OBJECT<cc::gfx::CommandBuffer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_CommandBuffer_endProfileScope : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->endProfileScope();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_CommandBuffer_endProfileScope)
+
 static bool js_gfx_CommandBuffer_endRenderPass(se::State& s)
 {
     cc::gfx::CommandBuffer* cobj = SE_THIS_OBJECT<cc::gfx::CommandBuffer>(s);
@@ -11883,6 +11917,25 @@ static bool js_gfx_CommandBuffer_getNumTris(se::State& s)
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_getNumTris)
 
+static bool js_gfx_CommandBuffer_getNumUploadBytes(se::State& s)
+{
+    cc::gfx::CommandBuffer* cobj = SE_THIS_OBJECT<cc::gfx::CommandBuffer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_CommandBuffer_getNumUploadBytes : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getNumUploadBytes();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_CommandBuffer_getNumUploadBytes : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_CommandBuffer_getNumUploadBytes)
+
 static bool js_gfx_CommandBuffer_getQueue(se::State& s)
 {
     cc::gfx::CommandBuffer* cobj = SE_THIS_OBJECT<cc::gfx::CommandBuffer>(s);
@@ -12139,6 +12192,7 @@ bool js_register_gfx_CommandBuffer(se::Object* obj)
     auto cls = se::Class::create("CommandBuffer", obj, __jsb_cc_gfx_GFXObject_proto, _SE(js_gfx_CommandBuffer_constructor));
 
     cls->defineFunction("begin", _SE(js_gfx_CommandBuffer_begin));
+    cls->defineFunction("beginProfileScope", _SE(js_gfx_CommandBuffer_beginProfileScope));
     cls->defineFunction("beginRenderPass", _SE(js_gfx_CommandBuffer_beginRenderPass));
     cls->defineFunction("bindDescriptorSet", _SE(js_gfx_CommandBuffer_bindDescriptorSetForJS));
     cls->defineFunction("bindInputAssembler", _SE(js_gfx_CommandBuffer_bindInputAssembler));
@@ -12146,10 +12200,12 @@ bool js_register_gfx_CommandBuffer(se::Object* obj)
     cls->defineFunction("destroy", _SE(js_gfx_CommandBuffer_destroy));
     cls->defineFunction("draw", _SE(js_gfx_CommandBuffer_draw));
     cls->defineFunction("end", _SE(js_gfx_CommandBuffer_end));
+    cls->defineFunction("endProfileScope", _SE(js_gfx_CommandBuffer_endProfileScope));
     cls->defineFunction("endRenderPass", _SE(js_gfx_CommandBuffer_endRenderPass));
     cls->defineFunction("getNumDrawCalls", _SE(js_gfx_CommandBuffer_getNumDrawCalls));
     cls->defineFunction("getNumInstances", _SE(js_gfx_CommandBuffer_getNumInstances));
     cls->defineFunction("getNumTris", _SE(js_gfx_CommandBuffer_getNumTris));
+    cls->defineFunction("getNumUploadBytes", _SE(js_gfx_CommandBuffer_getNumUploadBytes));
     cls->defineFunction("getQueue", _SE(js_gfx_CommandBuffer_getQueue));
     cls->defineFunction("getType", _SE(js_gfx_CommandBuffer_getType));
     cls->defineFunction("initialize", _SE(js_gfx_CommandBuffer_initialize));
@@ -15219,6 +15275,381 @@ bool js_register_gfx_Shader(se::Object* obj)
     return true;
 }
 
+se::Object* __jsb_cc_gfx_Profiler_proto = nullptr;
+se::Class* __jsb_cc_gfx_Profiler_class = nullptr;
+
+static bool js_gfx_Profiler_exportChromeTrace(se::State& s)
+{
+    cc::gfx::Profiler* cobj = SE_THIS_OBJECT<cc::gfx::Profiler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Profiler_exportChromeTrace : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::string, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_exportChromeTrace : Error processing arguments");
+        bool result = cobj->exportChromeTrace(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_exportChromeTrace : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Profiler_exportChromeTrace)
+
+static bool js_gfx_Profiler_getCPUTime(se::State& s)
+{
+    cc::gfx::Profiler* cobj = SE_THIS_OBJECT<cc::gfx::Profiler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Profiler_getCPUTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::string, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_getCPUTime : Error processing arguments");
+        float result = cobj->getCPUTime(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_getCPUTime : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Profiler_getCPUTime)
+
+static bool js_gfx_Profiler_getGPUTime(se::State& s)
+{
+    cc::gfx::Profiler* cobj = SE_THIS_OBJECT<cc::gfx::Profiler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Profiler_getGPUTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::string, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_getGPUTime : Error processing arguments");
+        float result = cobj->getGPUTime(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_getGPUTime : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Profiler_getGPUTime)
+
+static bool js_gfx_Profiler_getScopeNames(se::State& s)
+{
+    cc::gfx::Profiler* cobj = SE_THIS_OBJECT<cc::gfx::Profiler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Profiler_getScopeNames : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        std::vector<std::string> result = cobj->getScopeNames();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_getScopeNames : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Profiler_getScopeNames)
+
+static bool js_gfx_Profiler_isEnabled(se::State& s)
+{
+    cc::gfx::Profiler* cobj = SE_THIS_OBJECT<cc::gfx::Profiler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Profiler_isEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_isEnabled : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Profiler_isEnabled)
+
+static bool js_gfx_Profiler_setEnabled(se::State& s)
+{
+    cc::gfx::Profiler* cobj = SE_THIS_OBJECT<cc::gfx::Profiler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Profiler_setEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Profiler_setEnabled : Error processing arguments");
+        cobj->setEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_PROP_SET(js_gfx_Profiler_setEnabled)
+
+bool js_register_gfx_Profiler(se::Object* obj)
+{
+    auto cls = se::Class::create("Profiler", obj, nullptr, nullptr);
+
+    cls->defineProperty("enabled", _SE(js_gfx_Profiler_isEnabled), _SE(js_gfx_Profiler_setEnabled));
+    cls->defineFunction("exportChromeTrace", _SE(js_gfx_Profiler_exportChromeTrace));
+    cls->defineFunction("getCPUTime", _SE(js_gfx_Profiler_getCPUTime));
+    cls->defineFunction("getGPUTime", _SE(js_gfx_Profiler_getGPUTime));
+    cls->defineFunction("getScopeNames", _SE(js_gfx_Profiler_getScopeNames));
+    cls->install();
+    JSBClassType::registerClass<cc::gfx::Profiler>(cls);
+
+    __jsb_cc_gfx_Profiler_proto = cls->getProto();
+    __jsb_cc_gfx_Profiler_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+se::Object* __jsb_cc_gfx_TextureStreamer_proto = nullptr;
+se::Class* __jsb_cc_gfx_TextureStreamer_class = nullptr;
+
+static bool js_gfx_TextureStreamer_getMemoryBudget(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_getMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getMemoryBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_getMemoryBudget : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_TextureStreamer_getMemoryBudget)
+
+static bool js_gfx_TextureStreamer_getPendingCount(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_getPendingCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getPendingCount();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_getPendingCount : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_TextureStreamer_getPendingCount)
+
+static bool js_gfx_TextureStreamer_getResidentBytes(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_getResidentBytes : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getResidentBytes();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_getResidentBytes : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_TextureStreamer_getResidentBytes)
+
+static bool js_gfx_TextureStreamer_getUploadBudget(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_getUploadBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getUploadBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_getUploadBudget : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_TextureStreamer_getUploadBudget)
+
+static bool js_gfx_TextureStreamer_load(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_load : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::string, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_load : Error processing arguments");
+        cc::gfx::Texture* result = cobj->load(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_load : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    if (argc == 2) {
+        HolderType<std::string, true> arg0 = {};
+        HolderType<int, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_load : Error processing arguments");
+        cc::gfx::Texture* result = cobj->load(arg0.value(), arg1.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_load : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_TextureStreamer_load)
+
+static bool js_gfx_TextureStreamer_setMemoryBudget(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_setMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_setMemoryBudget : Error processing arguments");
+        cobj->setMemoryBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_PROP_SET(js_gfx_TextureStreamer_setMemoryBudget)
+
+static bool js_gfx_TextureStreamer_setPriority(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_setPriority : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<cc::gfx::Texture*, false> arg0 = {};
+        HolderType<int, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_setPriority : Error processing arguments");
+        cobj->setPriority(arg0.value(), arg1.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_TextureStreamer_setPriority)
+
+static bool js_gfx_TextureStreamer_setUploadBudget(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_setUploadBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_setUploadBudget : Error processing arguments");
+        cobj->setUploadBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_PROP_SET(js_gfx_TextureStreamer_setUploadBudget)
+
+static bool js_gfx_TextureStreamer_touch(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_touch : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<cc::gfx::Texture*, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_touch : Error processing arguments");
+        cobj->touch(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_TextureStreamer_touch)
+
+static bool js_gfx_TextureStreamer_unload(se::State& s)
+{
+    cc::gfx::TextureStreamer* cobj = SE_THIS_OBJECT<cc::gfx::TextureStreamer>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_TextureStreamer_unload : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<cc::gfx::Texture*, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_TextureStreamer_unload : Error processing arguments");
+        cobj->unload(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_TextureStreamer_unload)
+
+bool js_register_gfx_TextureStreamer(se::Object* obj)
+{
+    auto cls = se::Class::create("TextureStreamer", obj, nullptr, nullptr);
+
+    cls->defineProperty("uploadBudget", _SE(js_gfx_TextureStreamer_getUploadBudget), _SE(js_gfx_TextureStreamer_setUploadBudget));
+    cls->defineProperty("memoryBudget", _SE(js_gfx_TextureStreamer_getMemoryBudget), _SE(js_gfx_TextureStreamer_setMemoryBudget));
+    cls->defineProperty("residentBytes", _SE(js_gfx_TextureStreamer_getResidentBytes), nullptr);
+    cls->defineProperty("pendingCount", _SE(js_gfx_TextureStreamer_getPendingCount), nullptr);
+    cls->defineFunction("load", _SE(js_gfx_TextureStreamer_load));
+    cls->defineFunction("setPriority", _SE(js_gfx_TextureStreamer_setPriority));
+    cls->defineFunction("touch", _SE(js_gfx_TextureStreamer_touch));
+    cls->defineFunction("unload", _SE(js_gfx_TextureStreamer_unload));
+    cls->install();
+    JSBClassType::registerClass<cc::gfx::TextureStreamer>(cls);
+
+    __jsb_cc_gfx_TextureStreamer_proto = cls->getProto();
+    __jsb_cc_gfx_TextureStreamer_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
 se::Object* __jsb_cc_gfx_Device_proto = nullptr;
 se::Class* __jsb_cc_gfx_Device_class = nullptr;
 
@@ -16022,6 +16453,196 @@ static bool js_gfx_Device_getNumTris(se::State& s)
 }
 SE_BIND_PROP_GET(js_gfx_Device_getNumTris)
 
+static bool js_gfx_Device_getNumUploadBytes(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getNumUploadBytes : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getNumUploadBytes();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumUploadBytes : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getNumUploadBytes)
+
+static bool js_gfx_Device_getNumDescriptorWrites(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getNumDescriptorWrites : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getNumDescriptorWrites();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumDescriptorWrites : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getNumDescriptorWrites)
+
+static bool js_gfx_Device_getNumCoalescedCommands(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getNumCoalescedCommands : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getNumCoalescedCommands();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumCoalescedCommands : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getNumCoalescedCommands)
+
+static bool js_gfx_Device_getFrameLatency(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getFrameLatency : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getFrameLatency();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getFrameLatency : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getFrameLatency)
+
+static bool js_gfx_Device_getRenderThreadTime(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getRenderThreadTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getRenderThreadTime();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getRenderThreadTime : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getRenderThreadTime)
+
+static bool js_gfx_Device_getRenderThreadStallTime(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getRenderThreadStallTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getRenderThreadStallTime();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getRenderThreadStallTime : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getRenderThreadStallTime)
+
+static bool js_gfx_Device_getNumRenderThreadCommands(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getNumRenderThreadCommands : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getNumRenderThreadCommands();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumRenderThreadCommands : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getNumRenderThreadCommands)
+
+static bool js_gfx_Device_getNumRenderThreadBytes(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getNumRenderThreadBytes : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getNumRenderThreadBytes();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumRenderThreadBytes : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getNumRenderThreadBytes)
+
+static bool js_gfx_Device_getProfiler(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getProfiler : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        cc::gfx::Profiler* result = cobj->getProfiler();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getProfiler : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getProfiler)
+
+static bool js_gfx_Device_getTextureStreamer(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getTextureStreamer : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        cc::gfx::TextureStreamer* result = cobj->getTextureStreamer();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getTextureStreamer : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_PROP_GET(js_gfx_Device_getTextureStreamer)
+
 static bool js_gfx_Device_getQueue(se::State& s)
 {
     cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
@@ -16136,6 +16757,28 @@ static bool js_gfx_Device_getUVSpaceSignY(se::State& s)
 }
 SE_BIND_PROP_GET(js_gfx_Device_getUVSpaceSignY)
 
+static bool js_gfx_Device_getNumLODTris(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getNumLODTris : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumLODTris : Error processing arguments");
+        unsigned int result = cobj->getNumLODTris(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getNumLODTris : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Device_getNumLODTris)
+
 static bool js_gfx_Device_getUboOffsetAlignment(se::State& s)
 {
     cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
@@ -16237,6 +16880,25 @@ static bool js_gfx_Device_initialize(se::State& s)
 }
 SE_BIND_FUNC(js_gfx_Device_initialize)
 
+static bool js_gfx_Device_isMultithreaded(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_isMultithreaded : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isMultithreaded();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_isMultithreaded : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Device_isMultithreaded)
+
 static bool js_gfx_Device_present(se::State& s)
 {
     cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
@@ -16326,6 +16988,16 @@ bool js_register_gfx_Device(se::Object* obj)
     cls->defineProperty("nativeHeight", _SE(js_gfx_Device_getNativeHeight), nullptr);
     cls->defineProperty("depthStencilFormat", _SE(js_gfx_Device_getDepthStencilFormat), nullptr);
     cls->defineProperty("numTris", _SE(js_gfx_Device_getNumTris), nullptr);
+    cls->defineProperty("numUploadBytes", _SE(js_gfx_Device_getNumUploadBytes), nullptr);
+    cls->defineProperty("numDescriptorWrites", _SE(js_gfx_Device_getNumDescriptorWrites), nullptr);
+    cls->defineProperty("numCoalescedCommands", _SE(js_gfx_Device_getNumCoalescedCommands), nullptr);
+    cls->defineProperty("frameLatency", _SE(js_gfx_Device_getFrameLatency), nullptr);
+    cls->defineProperty("renderThreadTime", _SE(js_gfx_Device_getRenderThreadTime), nullptr);
+    cls->defineProperty("renderThreadStallTime", _SE(js_gfx_Device_getRenderThreadStallTime), nullptr);
+    cls->defineProperty("numRenderThreadCommands", _SE(js_gfx_Device_getNumRenderThreadCommands), nullptr);
+    cls->defineProperty("numRenderThreadBytes", _SE(js_gfx_Device_getNumRenderThreadBytes), nullptr);
+    cls->defineProperty("profiler", _SE(js_gfx_Device_getProfiler), nullptr);
+    cls->defineProperty("textureStreamer", _SE(js_gfx_Device_getTextureStreamer), nullptr);
     cls->defineProperty("screenSpaceSignY", _SE(js_gfx_Device_getScreenSpaceSignY), nullptr);
     cls->defineProperty("stencilBits", _SE(js_gfx_Device_getStencilBits), nullptr);
     cls->defineProperty("queue", _SE(js_gfx_Device_getQueue), nullptr);
@@ -16347,9 +17019,11 @@ bool js_register_gfx_Device(se::Object* obj)
     cls->defineFunction("createShader", _SE(js_gfx_Device_createShader));
     cls->defineFunction("destroy", _SE(js_gfx_Device_destroy));
     cls->defineFunction("genShaderId", _SE(js_gfx_Device_genShaderId));
+    cls->defineFunction("getNumLODTris", _SE(js_gfx_Device_getNumLODTris));
     cls->defineFunction("getUboOffsetAlignment", _SE(js_gfx_Device_getUboOffsetAlignment));
     cls->defineFunction("hasFeature", _SE(js_gfx_Device_hasFeature));
     cls->defineFunction("initialize", _SE(js_gfx_Device_initialize));
+    cls->defineFunction("isMultithreaded", _SE(js_gfx_Device_isMultithreaded));
     cls->defineFunction("present", _SE(js_gfx_Device_present));
     cls->defineFunction("resize", _SE(js_gfx_Device_resize));
     cls->defineFunction("setMultithreaded", _SE(js_gfx_Device_setMultithreaded));
@@ -16412,6 +17086,8 @@ bool register_all_gfx(se::Object* obj)
     js_register_gfx_PipelineStateInfo(ns);
     js_register_gfx_Shader(ns);
     js_register_gfx_BlendState(ns);
+    js_register_gfx_Profiler(ns);
+    js_register_gfx_TextureStreamer(ns);
     js_register_gfx_Device(ns);
     js_register_gfx_DescriptorSetInfo(ns);
     js_register_gfx_DescriptorSetLayoutInfo(ns);
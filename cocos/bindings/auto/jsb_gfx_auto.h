@@ -423,6 +423,7 @@ bool register_all_gfx(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(cc::gfx::CommandBuffer);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_begin);
+SE_DECLARE_FUNC(js_gfx_CommandBuffer_beginProfileScope);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_beginRenderPass);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_bindDescriptorSetForJS);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_bindInputAssembler);
@@ -430,10 +431,12 @@ SE_DECLARE_FUNC(js_gfx_CommandBuffer_bindPipelineState);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_destroy);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_draw);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_end);
+SE_DECLARE_FUNC(js_gfx_CommandBuffer_endProfileScope);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_endRenderPass);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_getNumDrawCalls);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_getNumInstances);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_getNumTris);
+SE_DECLARE_FUNC(js_gfx_CommandBuffer_getNumUploadBytes);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_getQueue);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_getType);
 SE_DECLARE_FUNC(js_gfx_CommandBuffer_initialize);
@@ -614,6 +617,30 @@ SE_DECLARE_FUNC(js_gfx_Shader_destroy);
 SE_DECLARE_FUNC(js_gfx_Shader_initialize);
 SE_DECLARE_FUNC(js_gfx_Shader_Shader);
 
+extern se::Object* __jsb_cc_gfx_Profiler_proto;
+extern se::Class* __jsb_cc_gfx_Profiler_class;
+
+bool js_register_cc_gfx_Profiler(se::Object* obj);
+bool register_all_gfx(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::gfx::Profiler);
+SE_DECLARE_FUNC(js_gfx_Profiler_exportChromeTrace);
+SE_DECLARE_FUNC(js_gfx_Profiler_getCPUTime);
+SE_DECLARE_FUNC(js_gfx_Profiler_getGPUTime);
+SE_DECLARE_FUNC(js_gfx_Profiler_getScopeNames);
+
+extern se::Object* __jsb_cc_gfx_TextureStreamer_proto;
+extern se::Class* __jsb_cc_gfx_TextureStreamer_class;
+
+bool js_register_cc_gfx_TextureStreamer(se::Object* obj);
+bool register_all_gfx(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::gfx::TextureStreamer);
+SE_DECLARE_FUNC(js_gfx_TextureStreamer_load);
+SE_DECLARE_FUNC(js_gfx_TextureStreamer_setPriority);
+SE_DECLARE_FUNC(js_gfx_TextureStreamer_touch);
+SE_DECLARE_FUNC(js_gfx_TextureStreamer_unload);
+
 extern se::Object* __jsb_cc_gfx_Device_proto;
 extern se::Class* __jsb_cc_gfx_Device_class;
 
@@ -637,9 +664,11 @@ SE_DECLARE_FUNC(js_gfx_Device_createSampler);
 SE_DECLARE_FUNC(js_gfx_Device_createShader);
 SE_DECLARE_FUNC(js_gfx_Device_destroy);
 SE_DECLARE_FUNC(js_gfx_Device_genShaderId);
+SE_DECLARE_FUNC(js_gfx_Device_getNumLODTris);
 SE_DECLARE_FUNC(js_gfx_Device_getUboOffsetAlignment);
 SE_DECLARE_FUNC(js_gfx_Device_hasFeature);
 SE_DECLARE_FUNC(js_gfx_Device_initialize);
+SE_DECLARE_FUNC(js_gfx_Device_isMultithreaded);
 SE_DECLARE_FUNC(js_gfx_Device_present);
 SE_DECLARE_FUNC(js_gfx_Device_resize);
 SE_DECLARE_FUNC(js_gfx_Device_setMultithreaded);
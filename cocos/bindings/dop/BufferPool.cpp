@@ -29,6 +29,7 @@ THE SOFTWARE.
 using namespace se;
 
 cc::map<PoolType, BufferPool *> BufferPool::_poolMap;
+BufferPool::Slot BufferPool::_slots[BufferPool::SLOT_COUNT];
 
 BufferPool::BufferPool(PoolType type, uint entryBits, uint bytesPerEntry)
 : _allocator(type),
@@ -44,10 +45,30 @@ BufferPool::BufferPool(PoolType type, uint entryBits, uint bytesPerEntry)
     _bytesPerChunk = _bytesPerEntry * _entriesPerChunk;
 
     BufferPool::_poolMap[type] = this;
+    updateSlot();
 }
 
 BufferPool::~BufferPool() {
     BufferPool::_poolMap.erase(_type);
+
+    const uint slotIndex = static_cast<uint>(_type) - SLOT_BASE;
+    if (slotIndex < SLOT_COUNT) {
+        _slots[slotIndex] = Slot();
+    }
+}
+
+void BufferPool::updateSlot() {
+    const uint slotIndex = static_cast<uint>(_type) - SLOT_BASE;
+    CCASSERT(slotIndex < SLOT_COUNT, "BufferPool: Invalid buffer pool type");
+    if (slotIndex >= SLOT_COUNT) return;
+
+    Slot &slot = _slots[slotIndex];
+    slot.chunks = _chunks.data();
+    slot.chunkCount = (uint)_chunks.size();
+    slot.chunkMask = _chunkMask;
+    slot.entryMask = _entryMask;
+    slot.entryBits = _entryBits;
+    slot.bytesPerEntry = _bytesPerEntry;
 }
 
 Object *BufferPool::allocateNewChunk() {
@@ -57,6 +78,7 @@ Object *BufferPool::allocateNewChunk() {
     size_t len = 0;
     jsObj->getArrayBufferData(&realPtr, &len);
     _chunks.push_back(realPtr);
+    updateSlot();
 
     return jsObj;
 }
@@ -41,6 +41,19 @@ public:
     CC_INLINE static const cc::map<PoolType, BufferPool *> &getPoolMap() { return BufferPool::_poolMap; }
     CC_INLINE static const uint getPoolFlag() { return _poolFlag; }
 
+    // Resolves a handle without going through the pool map, returns nullptr if the pool or chunk does not exist.
+    template <class T>
+    CC_INLINE static T *getTypedObject(PoolType type, uint id) {
+        const uint slotIndex = static_cast<uint>(type) - SLOT_BASE;
+        if (slotIndex >= SLOT_COUNT) return nullptr;
+
+        const Slot &slot = _slots[slotIndex];
+        uint chunk = (slot.chunkMask & id) >> slot.entryBits;
+        if (chunk >= slot.chunkCount) return nullptr;
+        uint entry = slot.entryMask & id;
+        return reinterpret_cast<T *>(slot.chunks[chunk] + (entry * slot.bytesPerEntry));
+    }
+
     BufferPool(PoolType type, uint entryBits, uint bytesPerEntry);
     ~BufferPool();
 
@@ -55,7 +68,24 @@ public:
     Object *allocateNewChunk();
 
 private:
+    // Buffer pool types live in [PoolType::PASS, PoolType::LOD_GROUP], extend the range along with PoolType.
+    static constexpr uint SLOT_BASE = static_cast<uint>(PoolType::PASS);
+    static constexpr uint SLOT_COUNT = static_cast<uint>(PoolType::LOD_GROUP) + 1 - SLOT_BASE;
+
+    // Everything needed to resolve a handle of one pool type, one cache line per type.
+    struct CC_CACHE_ALIGN Slot {
+        const Chunk *chunks = nullptr;
+        uint chunkCount = 0;
+        uint chunkMask = 0;
+        uint entryMask = 0;
+        uint entryBits = 0;
+        uint bytesPerEntry = 0;
+    };
+
+    void updateSlot();
+
     static cc::map<PoolType, BufferPool *> _poolMap;
+    static Slot _slots[SLOT_COUNT];
     static constexpr uint _poolFlag = 1 << 30;
 
     BufferAllocator _allocator;
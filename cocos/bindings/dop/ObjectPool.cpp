@@ -27,6 +27,7 @@ THE SOFTWARE.
 using namespace se;
 
 cc::map<PoolType, ObjectPool *> ObjectPool::_poolMap;
+ObjectPool *ObjectPool::_pools[ObjectPool::SLOT_COUNT] = {nullptr};
 
 ObjectPool::ObjectPool(PoolType type, Object *jsArr)
 : _type(type),
@@ -37,9 +38,44 @@ ObjectPool::ObjectPool(PoolType type, Object *jsArr)
     _jsArr->incRef();
     _indexMask = 0xffffffff & ~_poolFlag;
     ObjectPool::_poolMap.emplace(type, this);
+
+    CCASSERT(static_cast<uint>(type) < SLOT_COUNT, "ObjectPool: Invalid object pool type");
+    if (static_cast<uint>(type) < SLOT_COUNT) {
+        ObjectPool::_pools[static_cast<uint>(type)] = this;
+    }
+
+    uint len = 0;
+    if (_jsArr->getArrayLength(&len)) {
+        _mirror.resize(len, nullptr);
+        se::Value jsEntry;
+        for (uint i = 0; i < len; ++i) {
+            if (_jsArr->getArrayElement(i, &jsEntry) && jsEntry.isObject()) {
+                _mirror[i] = jsEntry.toObject()->getPrivateData();
+            }
+        }
+    }
 }
 
 ObjectPool::~ObjectPool() {
     _jsArr->decRef();
     ObjectPool::_poolMap.erase(_type);
+
+    if (static_cast<uint>(_type) < SLOT_COUNT) {
+        ObjectPool::_pools[static_cast<uint>(_type)] = nullptr;
+    }
+}
+
+void ObjectPool::bind(uint id, Object *object) {
+    id = _indexMask & id;
+    if (id >= _mirror.size()) {
+        _mirror.resize(id + 1, nullptr);
+    }
+
+    if (object) {
+        _jsArr->setArrayElement(id, se::Value(object));
+        _mirror[id] = object->getPrivateData();
+    } else {
+        _jsArr->setArrayElement(id, se::Value::Null);
+        _mirror[id] = nullptr;
+    }
 }
@@ -37,30 +37,36 @@ class CC_DLL ObjectPool final : public cc::Object {
 public:
     CC_INLINE static const cc::map<PoolType, ObjectPool *> &getPoolMap() { return ObjectPool::_poolMap; }
 
+    // Resolves a handle without going through the pool map, returns nullptr if the pool does not exist.
+    template <class Type>
+    CC_INLINE static Type *getTypedObject(PoolType type, uint id) {
+        const uint slotIndex = static_cast<uint>(type);
+        if (slotIndex >= SLOT_COUNT || !_pools[slotIndex]) return nullptr;
+        return _pools[slotIndex]->getTypedObject<Type>(id);
+    }
+
     ObjectPool(PoolType type, Object *jsArr);
     ~ObjectPool();
 
+    // Handles resolve through a native mirror of the JS array, which is authoritative: script assigns and
+    // releases entries with bind(), which writes the JS array and the mirror together. Entries already in
+    // the array are mirrored when the pool is created. A null object releases the entry.
+    void bind(uint id, Object *object);
+
     template <class Type>
-    Type *getTypedObject(uint id) const {
+    CC_INLINE Type *getTypedObject(uint id) const {
         id = _indexMask & id;
-        bool ok = true;
-#ifdef CC_DEBUG
-        uint len = 0;
-        ok = _jsArr->getArrayLength(&len);
-        CCASSERT(ok && id < len, "ObjectPool: Invalid buffer pool entry id");
-#endif
-
-        se::Value jsEntry;
-        ok = _jsArr->getArrayElement(id, &jsEntry);
-        if (!ok || !jsEntry.isObject()) {
-            return nullptr;
-        }
-        Type *entry = (Type *)jsEntry.toObject()->getPrivateData();
-        return entry;
+        return id < _mirror.size() ? static_cast<Type *>(_mirror[id]) : nullptr;
     }
 
 private:
+    // Object pool types live in [PoolType::ATTRIBUTE, PoolType::FRAMEBUFFER].
+    static constexpr uint SLOT_COUNT = static_cast<uint>(PoolType::FRAMEBUFFER) + 1;
+
     static cc::map<PoolType, ObjectPool *> _poolMap;
+    static ObjectPool *_pools[SLOT_COUNT];
+
+    cc::vector<void *> _mirror;
 
     PoolType _type = PoolType::SHADER;
     Object *_jsArr = nullptr;
@@ -35,6 +35,7 @@ enum class PoolType {
     BLEND_TARGET,
     BLEND_STATE,
     UI_BATCH,
+    LOD_GROUP,
 
     // array
     SUB_MODEL_ARRAY = 200,
@@ -141,8 +141,48 @@ static bool jsb_ObjectPool_finalize(se::State &s) {
 }
 SE_BIND_FINALIZE_FUNC(jsb_ObjectPool_finalize)
 
+static bool jsb_ObjectPool_bind(se::State &s) {
+    se::ObjectPool *pool = (se::ObjectPool *)s.nativeThisObject();
+    SE_PRECONDITION2(pool, false, "jsb_ObjectPool_bind : Invalid Native Object");
+
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        uint id = 0;
+        bool ok = seval_to_uint(args[0], &id);
+        SE_PRECONDITION2(ok, false, "jsb_ObjectPool_bind : Error processing arguments");
+        pool->bind(id, args[1].isObject() ? args[1].toObject() : nullptr);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d", (int)argc);
+    return false;
+}
+SE_BIND_FUNC(jsb_ObjectPool_bind);
+
+static bool jsb_ObjectPool_unbind(se::State &s) {
+    se::ObjectPool *pool = (se::ObjectPool *)s.nativeThisObject();
+    SE_PRECONDITION2(pool, false, "jsb_ObjectPool_unbind : Invalid Native Object");
+
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint id = 0;
+        bool ok = seval_to_uint(args[0], &id);
+        SE_PRECONDITION2(ok, false, "jsb_ObjectPool_unbind : Error processing arguments");
+        pool->bind(id, nullptr);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d", (int)argc);
+    return false;
+}
+SE_BIND_FUNC(jsb_ObjectPool_unbind);
+
 static bool js_register_se_ObjectPool(se::Object *obj) {
     se::Class *cls = se::Class::create("NativeObjectPool", obj, nullptr, _SE(jsb_ObjectPool_constructor));
+    cls->defineFunction("bind", _SE(jsb_ObjectPool_bind));
+    cls->defineFunction("unbind", _SE(jsb_ObjectPool_unbind));
     cls->install();
     JSBClassType::registerClass<se::ObjectPool>(cls);
 
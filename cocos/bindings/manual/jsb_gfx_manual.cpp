@@ -4,7 +4,7 @@
 #include "bindings/manual/jsb_conversions.h"
 #include "bindings/manual/jsb_global.h"
 
-#if !(defined(CC_USE_GLES2) || defined(CC_USE_GLES3) || defined(CC_USE_VULKAN) || defined(CC_USE_METAL))
+#if !(defined(CC_USE_GLES2) || defined(CC_USE_GLES3) || defined(CC_USE_VULKAN) || defined(CC_USE_METAL) || defined(CC_USE_EMPTY))
     #error "gfx backend is not defined!"
 #endif
 
@@ -28,6 +28,11 @@
     #include "renderer/gfx-gles2/GFXGLES2.h"
 #endif
 
+#ifdef CC_USE_EMPTY
+    #include "bindings/auto/jsb_empty_auto.h"
+    #include "renderer/gfx-empty/GFXEmpty.h"
+#endif
+
 #include <fstream>
 #include <sstream>
 
@@ -505,6 +510,9 @@ bool register_all_gfx_manual(se::Object *obj) {
 #ifdef CC_USE_METAL
     register_all_mtl(obj);
 #endif
+#ifdef CC_USE_EMPTY
+    register_all_empty(obj);
+#endif
 
     return true;
 }
@@ -4,9 +4,11 @@
 #include "cocos/bindings/manual/jsb_conversions.h"
 #include "cocos/bindings/manual/jsb_global.h"
 #include "renderer/core/gfx/GFXPipelineState.h"
+#include "renderer/pipeline/BatchedBuffer.h"
 #include "renderer/pipeline/Define.h"
 #include "renderer/pipeline/PipelineStateManager.h"
 #include "renderer/pipeline/RenderPipeline.h"
+#include "renderer/pipeline/helper/SharedMemory.h"
 
 static bool js_pipeline_RenderPipeline_getMacros(se::State &s) {
     cc::pipeline::RenderPipeline *cobj = (cc::pipeline::RenderPipeline *)s.nativeThisObject();
@@ -24,6 +26,151 @@ static bool js_pipeline_RenderPipeline_getMacros(se::State &s) {
 }
 SE_BIND_PROP_GET(js_pipeline_RenderPipeline_getMacros)
 
+static bool js_pipeline_ForwardPipeline_getRebuiltEntryCount(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getRebuiltEntryCount : Invalid Native Object.");
+    s.rval().setUint32(cobj->getRebuiltEntryCount());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getRebuiltEntryCount)
+
+static bool js_pipeline_ForwardPipeline_getBatchedCopiedBytes(se::State &s) {
+    s.rval().setUint32(cc::pipeline::BatchedBuffer::getCopiedBytes());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getBatchedCopiedBytes)
+
+static bool js_pipeline_ForwardPipeline_getBatchedUploadedBytes(se::State &s) {
+    s.rval().setUint32(cc::pipeline::BatchedBuffer::getUploadedBytes());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getBatchedUploadedBytes)
+
+static bool js_pipeline_ForwardPipeline_getMultithreadedRecording(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getMultithreadedRecording : Invalid Native Object.");
+    s.rval().setBoolean(cobj->isMultithreadedRecording());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getMultithreadedRecording)
+
+static bool js_pipeline_ForwardPipeline_setMultithreadedRecording(se::State &s) {
+    const auto &args = s.args();
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setMultithreadedRecording : Invalid Native Object.");
+    cobj->setMultithreadedRecording(args[0].toBoolean());
+    return true;
+}
+SE_BIND_PROP_SET(js_pipeline_ForwardPipeline_setMultithreadedRecording)
+
+static bool js_pipeline_ForwardPipeline_getRenderedShadowMapCount(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getRenderedShadowMapCount : Invalid Native Object.");
+    s.rval().setUint32(cobj->getRenderedShadowMapCount());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getRenderedShadowMapCount)
+
+static bool js_pipeline_ForwardPipeline_getShadowMapCaching(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getShadowMapCaching : Invalid Native Object.");
+    s.rval().setBoolean(cobj->isShadowMapCaching());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getShadowMapCaching)
+
+static bool js_pipeline_ForwardPipeline_setShadowMapCaching(se::State &s) {
+    const auto &args = s.args();
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setShadowMapCaching : Invalid Native Object.");
+    cobj->setShadowMapCaching(args[0].toBoolean());
+    return true;
+}
+SE_BIND_PROP_SET(js_pipeline_ForwardPipeline_setShadowMapCaching)
+
+static bool js_pipeline_ForwardPipeline_getOcclusionCulling(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getOcclusionCulling : Invalid Native Object.");
+    s.rval().setBoolean(cobj->isOcclusionCulling());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getOcclusionCulling)
+
+static bool js_pipeline_ForwardPipeline_setOcclusionCulling(se::State &s) {
+    const auto &args = s.args();
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOcclusionCulling : Invalid Native Object.");
+    cobj->setOcclusionCulling(args[0].toBoolean());
+    return true;
+}
+SE_BIND_PROP_SET(js_pipeline_ForwardPipeline_setOcclusionCulling)
+
+static bool js_pipeline_ForwardPipeline_getOccludedObjectCount(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getOccludedObjectCount : Invalid Native Object.");
+    s.rval().setUint32(cobj->getOccludedObjectCount());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getOccludedObjectCount)
+
+static bool js_pipeline_ForwardPipeline_getOcclusionCullingTime(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getOcclusionCullingTime : Invalid Native Object.");
+    s.rval().setFloat(cobj->getOcclusionCullingTime());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getOcclusionCullingTime)
+
+static bool js_pipeline_ForwardPipeline_getClusteredLighting(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getClusteredLighting : Invalid Native Object.");
+    s.rval().setBoolean(cobj->isClusteredLighting());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getClusteredLighting)
+
+static bool js_pipeline_ForwardPipeline_setClusteredLighting(se::State &s) {
+    const auto &args = s.args();
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setClusteredLighting : Invalid Native Object.");
+    cobj->setClusteredLighting(args[0].toBoolean());
+    return true;
+}
+SE_BIND_PROP_SET(js_pipeline_ForwardPipeline_setClusteredLighting)
+
+static bool js_pipeline_ForwardPipeline_getClusteredLightCount(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getClusteredLightCount : Invalid Native Object.");
+    s.rval().setUint32(cobj->getClusteredLightCount());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getClusteredLightCount)
+
+static bool js_pipeline_ForwardPipeline_getLightBinningTime(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getLightBinningTime : Invalid Native Object.");
+    s.rval().setFloat(cobj->getLightBinningTime());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getLightBinningTime)
+
+static bool js_pipeline_ForwardPipeline_getLODBias(se::State &s) {
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getLODBias : Invalid Native Object.");
+    s.rval().setFloat(cobj->getLODBias());
+    return true;
+}
+SE_BIND_PROP_GET(js_pipeline_ForwardPipeline_getLODBias)
+
+static bool js_pipeline_ForwardPipeline_setLODBias(se::State &s) {
+    const auto &args = s.args();
+    cc::pipeline::ForwardPipeline *cobj = (cc::pipeline::ForwardPipeline *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setLODBias : Invalid Native Object.");
+    cobj->setLODBias(args[0].toFloat());
+    return true;
+}
+SE_BIND_PROP_SET(js_pipeline_ForwardPipeline_setLODBias)
+
 static bool JSB_getOrCreatePipelineState(se::State &s) {
     const auto &args = s.args();
     size_t argc = args.size();
@@ -44,6 +191,57 @@ static bool JSB_getOrCreatePipelineState(se::State &s) {
 }
 SE_BIND_FUNC(JSB_getOrCreatePipelineState);
 
+static bool JSB_setModelLODGroup(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        bool ok = true;
+        uint32_t modelHandle = 0;
+        uint32_t lodGroupHandle = 0;
+        ok &= seval_to_uint32(args[0], &modelHandle);
+        ok &= seval_to_uint32(args[1], &lodGroupHandle);
+        SE_PRECONDITION2(ok, false, "JSB_setModelLODGroup : Error getting model or LOD group handle.");
+        cc::pipeline::LODGroupTable::setModelLODGroup(modelHandle, lodGroupHandle);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(JSB_setModelLODGroup);
+
+static bool JSB_notifyModelChanged(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t modelHandle = 0;
+        bool ok = seval_to_uint32(args[0], &modelHandle);
+        SE_PRECONDITION2(ok, false, "JSB_notifyModelChanged : Error getting model handle.");
+        cc::pipeline::ModelChangeTable::notifyChanged(modelHandle);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_notifyModelChanged);
+
+static bool JSB_setModelAnimatedBounds(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        bool ok = true;
+        uint32_t modelHandle = 0;
+        bool animated = false;
+        ok &= seval_to_uint32(args[0], &modelHandle);
+        ok &= seval_to_boolean(args[1], &animated);
+        SE_PRECONDITION2(ok, false, "JSB_setModelAnimatedBounds : Error getting model handle or flag.");
+        cc::pipeline::ModelChangeTable::setAnimatedBounds(modelHandle, animated);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(JSB_setModelAnimatedBounds);
+
 bool register_all_pipeline_manual(se::Object *obj) {
     // Get the ns
     se::Value nrVal;
@@ -60,6 +258,32 @@ bool register_all_pipeline_manual(se::Object *obj) {
     nr->setProperty("PipelineStateManager", psmVal);
     psmVal.toObject()->defineFunction("getOrCreatePipelineState", _SE(JSB_getOrCreatePipelineState));
 
+    se::Value lodVal;
+    se::HandleObject lodObj(se::Object::createPlainObject());
+    lodVal.setObject(lodObj);
+    nr->setProperty("LODGroupTable", lodVal);
+    lodVal.toObject()->defineFunction("setModelLODGroup", _SE(JSB_setModelLODGroup));
+
+    se::Value changeVal;
+    se::HandleObject changeObj(se::Object::createPlainObject());
+    changeVal.setObject(changeObj);
+    nr->setProperty("ModelChangeTable", changeVal);
+    changeVal.toObject()->defineFunction("notifyChanged", _SE(JSB_notifyModelChanged));
+    changeVal.toObject()->defineFunction("setAnimatedBounds", _SE(JSB_setModelAnimatedBounds));
+
     __jsb_cc_pipeline_RenderPipeline_proto->defineProperty("macros", _SE(js_pipeline_RenderPipeline_getMacros), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("rebuiltEntryCount", _SE(js_pipeline_ForwardPipeline_getRebuiltEntryCount), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("batchedCopiedBytes", _SE(js_pipeline_ForwardPipeline_getBatchedCopiedBytes), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("batchedUploadedBytes", _SE(js_pipeline_ForwardPipeline_getBatchedUploadedBytes), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("multithreadedRecording", _SE(js_pipeline_ForwardPipeline_getMultithreadedRecording), _SE(js_pipeline_ForwardPipeline_setMultithreadedRecording));
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("renderedShadowMapCount", _SE(js_pipeline_ForwardPipeline_getRenderedShadowMapCount), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("shadowMapCaching", _SE(js_pipeline_ForwardPipeline_getShadowMapCaching), _SE(js_pipeline_ForwardPipeline_setShadowMapCaching));
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("occlusionCulling", _SE(js_pipeline_ForwardPipeline_getOcclusionCulling), _SE(js_pipeline_ForwardPipeline_setOcclusionCulling));
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("occludedObjectCount", _SE(js_pipeline_ForwardPipeline_getOccludedObjectCount), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("occlusionCullingTime", _SE(js_pipeline_ForwardPipeline_getOcclusionCullingTime), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("clusteredLighting", _SE(js_pipeline_ForwardPipeline_getClusteredLighting), _SE(js_pipeline_ForwardPipeline_setClusteredLighting));
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("clusteredLightCount", _SE(js_pipeline_ForwardPipeline_getClusteredLightCount), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("lightBinningTime", _SE(js_pipeline_ForwardPipeline_getLightBinningTime), nullptr);
+    __jsb_cc_pipeline_ForwardPipeline_proto->defineProperty("lodBias", _SE(js_pipeline_ForwardPipeline_getLODBias), _SE(js_pipeline_ForwardPipeline_setLODBias));
     return true;
 }
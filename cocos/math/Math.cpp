@@ -3,6 +3,7 @@
 #include <cmath>
 #include <cstring>
 #include <cctype>
+#include <limits>
 
 namespace cc {
 namespace math {
@@ -22,6 +22,7 @@ This file was modified to fit the cocos2d-x project
 
 #include "math/MathUtil.h"
 #include "base/Macros.h"
+#include <cmath>
 
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
     #include <cpu-features.h>
@@ -283,4 +284,109 @@ void MathUtil::combineHash(size_t &seed, const size_t &v) {
     seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+void MathUtil::cullAABBs(const float *planes, int planeCount, const float *boxes, int blockCount, uint8_t *visible) {
+    GP_ASSERT(planeCount <= MAX_CULLING_PLANES);
+#ifdef USE_NEON32
+    MathUtilNeon::cullAABBs(planes, planeCount, boxes, blockCount, visible);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::cullAABBs(planes, planeCount, boxes, blockCount, visible);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled())
+        MathUtilNeon::cullAABBs(planes, planeCount, boxes, blockCount, visible);
+    else
+        MathUtilC::cullAABBs(planes, planeCount, boxes, blockCount, visible);
+#elif defined(USE_SSE)
+    __m128 splatted[MAX_CULLING_PLANES * 7];
+    for (int i = 0; i < planeCount; ++i) {
+        const float *p = planes + i * 4;
+        __m128 *dst = splatted + i * 7;
+        dst[0] = _mm_set1_ps(p[0]);
+        dst[1] = _mm_set1_ps(p[1]);
+        dst[2] = _mm_set1_ps(p[2]);
+        dst[3] = _mm_set1_ps(fabsf(p[0]));
+        dst[4] = _mm_set1_ps(fabsf(p[1]));
+        dst[5] = _mm_set1_ps(fabsf(p[2]));
+        dst[6] = _mm_set1_ps(p[3]);
+    }
+    MathUtil::cullAABBs(splatted, planeCount, boxes, blockCount, visible);
+#else
+    MathUtilC::cullAABBs(planes, planeCount, boxes, blockCount, visible);
+#endif
+}
+
+void MathUtil::intersectSphereAABBs(const float *sphere, const float *boxes, int blockCount, uint8_t *hits) {
+#ifdef USE_NEON32
+    MathUtilNeon::intersectSphereAABBs(sphere, boxes, blockCount, hits);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::intersectSphereAABBs(sphere, boxes, blockCount, hits);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled())
+        MathUtilNeon::intersectSphereAABBs(sphere, boxes, blockCount, hits);
+    else
+        MathUtilC::intersectSphereAABBs(sphere, boxes, blockCount, hits);
+#elif defined(USE_SSE)
+    const __m128 splatted[4] = {
+        _mm_set1_ps(sphere[0]),
+        _mm_set1_ps(sphere[1]),
+        _mm_set1_ps(sphere[2]),
+        _mm_set1_ps(sphere[3] * sphere[3]),
+    };
+    MathUtil::intersectSphereAABBs(splatted, boxes, blockCount, hits);
+#else
+    MathUtilC::intersectSphereAABBs(sphere, boxes, blockCount, hits);
+#endif
+}
+
+void MathUtil::writeDepthSpan(float *depths, int count, float depth) {
+#ifdef USE_NEON32
+    MathUtilNeon::writeDepthSpan(depths, count, depth);
+#elif defined(USE_NEON64)
+    MathUtilNeon64::writeDepthSpan(depths, count, depth);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled())
+        MathUtilNeon::writeDepthSpan(depths, count, depth);
+    else
+        MathUtilC::writeDepthSpan(depths, count, depth);
+#elif defined(USE_SSE)
+    MathUtil::writeDepthSpan(_mm_set1_ps(depth), depths, count);
+#else
+    MathUtilC::writeDepthSpan(depths, count, depth);
+#endif
+}
+
+float MathUtil::getMaxDepth(const float *depths, int count) {
+    GP_ASSERT(count > 0);
+#ifdef USE_NEON32
+    return MathUtilNeon::getMaxDepth(depths, count);
+#elif defined(USE_NEON64)
+    return MathUtilNeon64::getMaxDepth(depths, count);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled())
+        return MathUtilNeon::getMaxDepth(depths, count);
+    else
+        return MathUtilC::getMaxDepth(depths, count);
+#elif defined(USE_SSE)
+    return MathUtil::getMaxDepth(_mm_set1_ps(depths[0]), depths, count);
+#else
+    return MathUtilC::getMaxDepth(depths, count);
+#endif
+}
+
+bool MathUtil::testDepthSpan(const float *depths, int count, float depth) {
+#ifdef USE_NEON32
+    return MathUtilNeon::testDepthSpan(depths, count, depth);
+#elif defined(USE_NEON64)
+    return MathUtilNeon64::testDepthSpan(depths, count, depth);
+#elif defined(INCLUDE_NEON32)
+    if (isNeon32Enabled())
+        return MathUtilNeon::testDepthSpan(depths, count, depth);
+    else
+        return MathUtilC::testDepthSpan(depths, count, depth);
+#elif defined(USE_SSE)
+    return MathUtil::testDepthSpan(_mm_set1_ps(depth), depths, count);
+#else
+    return MathUtilC::testDepthSpan(depths, count, depth);
+#endif
+}
+
 NS_CC_MATH_END
@@ -27,6 +27,8 @@
     #include <xmmintrin.h>
 #endif
 
+#include <cstdint>
+
 #include "math/MathBase.h"
 
 /**
@@ -95,6 +97,60 @@ public:
      */
     static void combineHash(size_t &seed, const size_t &v);
 
+    /**
+     * Tests axis-aligned boxes against a set of planes, four boxes at a time.
+     * Boxes are packed in blocks of four as {cx[4], cy[4], cz[4], ex[4], ey[4], ez[4]},
+     * planes as {nx, ny, nz, d} with the normals facing inwards.
+     * A box is rejected when it lies completely on the negative side of any plane.
+     *
+     * @param planes The planes to test against, at most MAX_CULLING_PLANES.
+     * @param planeCount The number of planes.
+     * @param boxes The packed box blocks.
+     * @param blockCount The number of four-box blocks.
+     * @param visible Receives 1 for every box that is not rejected and 0 otherwise, blockCount * 4 entries.
+     */
+    static void cullAABBs(const float *planes, int planeCount, const float *boxes, int blockCount, uint8_t *visible);
+
+    static const int MAX_CULLING_PLANES = 8;
+
+    /**
+     * Tests axis-aligned boxes against a sphere, four boxes at a time.
+     * Boxes are packed in blocks of four like in cullAABBs.
+     *
+     * @param sphere The sphere as {x, y, z, radius}.
+     * @param boxes The packed box blocks.
+     * @param blockCount The number of four-box blocks.
+     * @param hits Receives 1 for every box touching the sphere and 0 otherwise, blockCount * 4 entries.
+     */
+    static void intersectSphereAABBs(const float *sphere, const float *boxes, int blockCount, uint8_t *hits);
+
+    /**
+     * Keeps the nearer of each stored depth and the given depth, used to fill flat spans of a software depth buffer.
+     *
+     * @param depths The span to update, smaller values are nearer.
+     * @param count The number of entries in the span.
+     * @param depth The depth written into the span.
+     */
+    static void writeDepthSpan(float *depths, int count, float depth);
+
+    /**
+     * Returns the farthest of the stored depths.
+     *
+     * @param depths The span to read, smaller values are nearer.
+     * @param count The number of entries in the span, at least one.
+     */
+    static float getMaxDepth(const float *depths, int count);
+
+    /**
+     * Tests whether a surface at the given depth shows through any entry of the span.
+     *
+     * @param depths The span to read, smaller values are nearer.
+     * @param count The number of entries in the span.
+     * @param depth The depth to test.
+     * @return true if any stored depth is at or behind the given depth.
+     */
+    static bool testDepthSpan(const float *depths, int count, float depth);
+
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -117,6 +173,16 @@ private:
     static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
 
     static void transformVec4(const __m128 m[4], const __m128 &v, __m128 &dst);
+
+    static void cullAABBs(const __m128 *planes, int planeCount, const float *boxes, int blockCount, uint8_t *visible);
+
+    static void intersectSphereAABBs(const __m128 *sphere, const float *boxes, int blockCount, uint8_t *hits);
+
+    static void writeDepthSpan(const __m128 &depth, float *depths, int count);
+
+    static float getMaxDepth(const __m128 &first, const float *depths, int count);
+
+    static bool testDepthSpan(const __m128 &depth, const float *depths, int count);
 #endif
     static void addMatrix(const float *m, float scalar, float *dst);
 
@@ -42,6 +42,16 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void cullAABBs(const float* planes, int planeCount, const float* boxes, int blockCount, uint8_t* visible);
+
+    inline static void intersectSphereAABBs(const float* sphere, const float* boxes, int blockCount, uint8_t* hits);
+
+    inline static void writeDepthSpan(float* depths, int count, float depth);
+
+    inline static float getMaxDepth(const float* depths, int count);
+
+    inline static bool testDepthSpan(const float* depths, int count, float depth);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +225,74 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::cullAABBs(const float* planes, int planeCount, const float* boxes, int blockCount, uint8_t* visible)
+{
+    for (int i = 0; i < blockCount; ++i, boxes += 24, visible += 4)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            const float* box = boxes + j;
+            uint8_t result = 1;
+            for (int k = 0; k < planeCount; ++k)
+            {
+                const float* p = planes + k * 4;
+                float dot = p[0] * box[0] + p[1] * box[4] + p[2] * box[8];
+                float radius = fabsf(p[0]) * box[12] + fabsf(p[1]) * box[16] + fabsf(p[2]) * box[20];
+                if (dot + radius < p[3])
+                {
+                    result = 0;
+                    break;
+                }
+            }
+            visible[j] = result;
+        }
+    }
+}
+
+inline void MathUtilC::intersectSphereAABBs(const float* sphere, const float* boxes, int blockCount, uint8_t* hits)
+{
+    const float radiusSq = sphere[3] * sphere[3];
+    for (int i = 0; i < blockCount; ++i, boxes += 24, hits += 4)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            const float* box = boxes + j;
+            float distanceSq = 0.0f;
+            for (int k = 0; k < 3; ++k)
+            {
+                float d = fabsf(sphere[k] - box[k * 4]) - box[12 + k * 4];
+                if (d > 0.0f) distanceSq += d * d;
+            }
+            hits[j] = distanceSq <= radiusSq ? 1 : 0;
+        }
+    }
+}
+
+inline void MathUtilC::writeDepthSpan(float* depths, int count, float depth)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (depth < depths[i]) depths[i] = depth;
+    }
+}
+
+inline float MathUtilC::getMaxDepth(const float* depths, int count)
+{
+    float result = depths[0];
+    for (int i = 1; i < count; ++i)
+    {
+        if (depths[i] > result) result = depths[i];
+    }
+    return result;
+}
+
+inline bool MathUtilC::testDepthSpan(const float* depths, int count, float depth)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (depths[i] >= depth) return true;
+    }
+    return false;
+}
+
 NS_CC_MATH_END
@@ -17,6 +17,8 @@
 
  This file was modified to fit the cocos2d-x project
  */
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -41,6 +43,16 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void cullAABBs(const float* planes, int planeCount, const float* boxes, int blockCount, uint8_t* visible);
+
+    inline static void intersectSphereAABBs(const float* sphere, const float* boxes, int blockCount, uint8_t* hits);
+
+    inline static void writeDepthSpan(float* depths, int count, float depth);
+
+    inline static float getMaxDepth(const float* depths, int count);
+
+    inline static bool testDepthSpan(const float* depths, int count, float depth);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -268,4 +280,112 @@ inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst
                  );
 }
 
+inline void MathUtilNeon::cullAABBs(const float* planes, int planeCount, const float* boxes, int blockCount, uint8_t* visible)
+{
+    uint32_t lanes[4];
+    for (int i = 0; i < blockCount; ++i, boxes += 24, visible += 4)
+    {
+        float32x4_t cx = vld1q_f32(boxes);
+        float32x4_t cy = vld1q_f32(boxes + 4);
+        float32x4_t cz = vld1q_f32(boxes + 8);
+        float32x4_t ex = vld1q_f32(boxes + 12);
+        float32x4_t ey = vld1q_f32(boxes + 16);
+        float32x4_t ez = vld1q_f32(boxes + 20);
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (int k = 0; k < planeCount; ++k)
+        {
+            const float* p = planes + k * 4;
+            float32x4_t dot = vmulq_n_f32(cx, p[0]);
+            dot = vmlaq_n_f32(dot, cy, p[1]);
+            dot = vmlaq_n_f32(dot, cz, p[2]);
+            dot = vmlaq_n_f32(dot, ex, fabsf(p[0]));
+            dot = vmlaq_n_f32(dot, ey, fabsf(p[1]));
+            dot = vmlaq_n_f32(dot, ez, fabsf(p[2]));
+            outside = vorrq_u32(outside, vcltq_f32(dot, vdupq_n_f32(p[3])));
+        }
+        vst1q_u32(lanes, outside);
+        visible[0] = lanes[0] ? 0 : 1;
+        visible[1] = lanes[1] ? 0 : 1;
+        visible[2] = lanes[2] ? 0 : 1;
+        visible[3] = lanes[3] ? 0 : 1;
+    }
+}
+
+inline void MathUtilNeon::intersectSphereAABBs(const float* sphere, const float* boxes, int blockCount, uint8_t* hits)
+{
+    uint32_t lanes[4];
+    float32x4_t sx = vdupq_n_f32(sphere[0]);
+    float32x4_t sy = vdupq_n_f32(sphere[1]);
+    float32x4_t sz = vdupq_n_f32(sphere[2]);
+    float32x4_t radiusSq = vdupq_n_f32(sphere[3] * sphere[3]);
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    for (int i = 0; i < blockCount; ++i, boxes += 24, hits += 4)
+    {
+        // distance from the sphere center to the box, per axis
+        float32x4_t dx = vmaxq_f32(vsubq_f32(vabdq_f32(sx, vld1q_f32(boxes)), vld1q_f32(boxes + 12)), zero);
+        float32x4_t dy = vmaxq_f32(vsubq_f32(vabdq_f32(sy, vld1q_f32(boxes + 4)), vld1q_f32(boxes + 16)), zero);
+        float32x4_t dz = vmaxq_f32(vsubq_f32(vabdq_f32(sz, vld1q_f32(boxes + 8)), vld1q_f32(boxes + 20)), zero);
+        float32x4_t distanceSq = vmulq_f32(dx, dx);
+        distanceSq = vmlaq_f32(distanceSq, dy, dy);
+        distanceSq = vmlaq_f32(distanceSq, dz, dz);
+        vst1q_u32(lanes, vcleq_f32(distanceSq, radiusSq));
+        hits[0] = lanes[0] ? 1 : 0;
+        hits[1] = lanes[1] ? 1 : 0;
+        hits[2] = lanes[2] ? 1 : 0;
+        hits[3] = lanes[3] ? 1 : 0;
+    }
+}
+
+inline void MathUtilNeon::writeDepthSpan(float* depths, int count, float depth)
+{
+    float32x4_t d = vdupq_n_f32(depth);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(depths + i, vminq_f32(vld1q_f32(depths + i), d));
+    }
+    for (; i < count; ++i)
+    {
+        if (depth < depths[i]) depths[i] = depth;
+    }
+}
+
+inline float MathUtilNeon::getMaxDepth(const float* depths, int count)
+{
+    float result = depths[0];
+    int i = 0;
+    if (count >= 4)
+    {
+        float32x4_t m = vld1q_f32(depths);
+        for (i = 4; i + 4 <= count; i += 4)
+        {
+            m = vmaxq_f32(m, vld1q_f32(depths + i));
+        }
+        float32x2_t h = vpmax_f32(vget_low_f32(m), vget_high_f32(m));
+        result = vget_lane_f32(vpmax_f32(h, h), 0);
+    }
+    for (; i < count; ++i)
+    {
+        if (depths[i] > result) result = depths[i];
+    }
+    return result;
+}
+
+inline bool MathUtilNeon::testDepthSpan(const float* depths, int count, float depth)
+{
+    float32x4_t d = vdupq_n_f32(depth);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t behind = vcgeq_f32(vld1q_f32(depths + i), d);
+        uint32x2_t h = vorr_u32(vget_low_u32(behind), vget_high_u32(behind));
+        if (vget_lane_u32(vpmax_u32(h, h), 0)) return true;
+    }
+    for (; i < count; ++i)
+    {
+        if (depths[i] >= depth) return true;
+    }
+    return false;
+}
+
 NS_CC_MATH_END
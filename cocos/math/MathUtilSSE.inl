@@ -151,6 +151,106 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::cullAABBs(const __m128* planes, int planeCount, const float* boxes, int blockCount, uint8_t* visible)
+{
+    for (int i = 0; i < blockCount; ++i, boxes += 24, visible += 4)
+    {
+        __m128 cx = _mm_loadu_ps(boxes);
+        __m128 cy = _mm_loadu_ps(boxes + 4);
+        __m128 cz = _mm_loadu_ps(boxes + 8);
+        __m128 ex = _mm_loadu_ps(boxes + 12);
+        __m128 ey = _mm_loadu_ps(boxes + 16);
+        __m128 ez = _mm_loadu_ps(boxes + 20);
+        __m128 outside = _mm_setzero_ps();
+        for (int k = 0; k < planeCount; ++k)
+        {
+            // planes are splatted as {nx, ny, nz, |nx|, |ny|, |nz|, d}
+            const __m128* p = planes + k * 7;
+            __m128 dot = _mm_add_ps(
+                                    _mm_add_ps(_mm_mul_ps(p[0], cx), _mm_mul_ps(p[1], cy)),
+                                    _mm_add_ps(_mm_mul_ps(p[2], cz), _mm_mul_ps(p[3], ex))
+                                    );
+            dot = _mm_add_ps(dot, _mm_add_ps(_mm_mul_ps(p[4], ey), _mm_mul_ps(p[5], ez)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dot, p[6]));
+            // all four boxes rejected, skip the remaining planes
+            if (_mm_movemask_ps(outside) == 0xF) break;
+        }
+        int mask = _mm_movemask_ps(outside);
+        visible[0] = (mask & 1) ? 0 : 1;
+        visible[1] = (mask & 2) ? 0 : 1;
+        visible[2] = (mask & 4) ? 0 : 1;
+        visible[3] = (mask & 8) ? 0 : 1;
+    }
+}
+
+void MathUtil::intersectSphereAABBs(const __m128* sphere, const float* boxes, int blockCount, uint8_t* hits)
+{
+    // sphere is splatted as {x, y, z, radius * radius}
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (int i = 0; i < blockCount; ++i, boxes += 24, hits += 4)
+    {
+        __m128 dx = _mm_andnot_ps(signMask, _mm_sub_ps(sphere[0], _mm_loadu_ps(boxes)));
+        __m128 dy = _mm_andnot_ps(signMask, _mm_sub_ps(sphere[1], _mm_loadu_ps(boxes + 4)));
+        __m128 dz = _mm_andnot_ps(signMask, _mm_sub_ps(sphere[2], _mm_loadu_ps(boxes + 8)));
+        dx = _mm_max_ps(_mm_sub_ps(dx, _mm_loadu_ps(boxes + 12)), zero);
+        dy = _mm_max_ps(_mm_sub_ps(dy, _mm_loadu_ps(boxes + 16)), zero);
+        dz = _mm_max_ps(_mm_sub_ps(dz, _mm_loadu_ps(boxes + 20)), zero);
+        __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSq, sphere[3]));
+        hits[0] = (mask & 1) ? 1 : 0;
+        hits[1] = (mask & 2) ? 1 : 0;
+        hits[2] = (mask & 4) ? 1 : 0;
+        hits[3] = (mask & 8) ? 1 : 0;
+    }
+}
+
+void MathUtil::writeDepthSpan(const __m128& depth, float* depths, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(depths + i, _mm_min_ps(_mm_loadu_ps(depths + i), depth));
+    }
+    float d = _mm_cvtss_f32(depth);
+    for (; i < count; ++i)
+    {
+        if (d < depths[i]) depths[i] = d;
+    }
+}
+
+float MathUtil::getMaxDepth(const __m128& first, const float* depths, int count)
+{
+    __m128 m = first;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        m = _mm_max_ps(m, _mm_loadu_ps(depths + i));
+    }
+    for (; i < count; ++i)
+    {
+        m = _mm_max_ss(m, _mm_load_ss(depths + i));
+    }
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(m);
+}
+
+bool MathUtil::testDepthSpan(const __m128& depth, const float* depths, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depths + i), depth))) return true;
+    }
+    float d = _mm_cvtss_f32(depth);
+    for (; i < count; ++i)
+    {
+        if (depths[i] >= d) return true;
+    }
+    return false;
+}
+
 #endif
 
 
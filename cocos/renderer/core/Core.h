@@ -41,8 +41,10 @@ THE SOFTWARE.
 #include "gfx/GFXInputAssembler.h"
 #include "gfx/GFXPipelineLayout.h"
 #include "gfx/GFXPipelineState.h"
+#include "gfx/GFXProfiler.h"
 #include "gfx/GFXQueue.h"
 #include "gfx/GFXRenderPass.h"
 #include "gfx/GFXSampler.h"
 #include "gfx/GFXShader.h"
 #include "gfx/GFXTexture.h"
+#include "gfx/GFXTextureStreamer.h"
@@ -29,6 +29,9 @@ THE SOFTWARE.
 // STD including
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
 #include <wchar.h>
 #include <math.h>
 #include <float.h>
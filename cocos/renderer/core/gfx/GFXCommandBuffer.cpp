@@ -1,6 +1,7 @@
 #include "CoreStd.h"
 
 #include "GFXCommandBuffer.h"
+#include "GFXDevice.h"
 
 namespace cc {
 namespace gfx {
@@ -12,5 +13,25 @@ CommandBuffer::CommandBuffer(Device *device)
 CommandBuffer::~CommandBuffer() {
 }
 
+void CommandBuffer::beginProfileScope(const String &name) {
+    if (_type != CommandBufferType::PRIMARY) return;
+
+    Profiler *profiler = _device->getProfiler();
+    const uint scope = profiler->beginScope(name);
+    if (scope != Profiler::INVALID_SCOPE) {
+        writeTimestamp(profiler->getFrameSlot(), scope * 2);
+    }
+}
+
+void CommandBuffer::endProfileScope() {
+    if (_type != CommandBufferType::PRIMARY) return;
+
+    Profiler *profiler = _device->getProfiler();
+    const uint scope = profiler->endScope();
+    if (scope != Profiler::INVALID_SCOPE) {
+        writeTimestamp(profiler->getFrameSlot(), scope * 2 + 1);
+    }
+}
+
 } // namespace gfx
 } // namespace cc
@@ -35,6 +35,10 @@ public:
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) = 0;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) = 0;
 
+    // named timing scopes reported through Device::getProfiler(), only primary buffers recorded on the main thread take part
+    void beginProfileScope(const String &name);
+    void endProfileScope();
+
     CC_INLINE void bindDescriptorSetForJS(uint set, DescriptorSet *descriptorSet) {
         bindDescriptorSet(set, descriptorSet, 0, nullptr);
     }
@@ -72,8 +76,12 @@ public:
     virtual uint getNumDrawCalls() const { return _numDrawCalls; }
     virtual uint getNumInstances() const { return _numInstances; }
     virtual uint getNumTris() const { return _numTriangles; }
+    virtual uint getNumUploadBytes() const { return _numUploadBytes; }
 
 protected:
+    // writes a GPU timestamp into the given query of a profiler frame slot, backends without timer queries leave it empty
+    virtual void writeTimestamp(uint slot, uint query) {}
+
     Device *_device = nullptr;
     Queue *_queue = nullptr;
     CommandBufferType _type = CommandBufferType::PRIMARY;
@@ -81,6 +89,7 @@ protected:
     uint32_t _numDrawCalls = 0;
     uint32_t _numInstances = 0;
     uint32_t _numTriangles = 0;
+    uint32_t _numUploadBytes = 0;
 };
 
 } // namespace gfx
@@ -289,5 +289,13 @@ uint FormatSurfaceSize(Format format, uint width, uint height, uint depth, uint
     return size;
 }
 
+uint MipLevelCount(uint width, uint height) {
+    uint levels = 1u;
+    for (uint extent = std::max(width, height); extent > 1u; extent >>= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
 } // namespace gfx
 } // namespace cc
@@ -1074,6 +1074,9 @@ extern CC_DLL uint FormatSize(Format format, uint width, uint height, uint depth
 
 extern CC_DLL uint FormatSurfaceSize(Format format, uint width, uint height, uint depth, uint mips);
 
+// length of the full mip chain down to 1x1
+extern CC_DLL uint MipLevelCount(uint width, uint height);
+
 } // namespace gfx
 } // namespace cc
 
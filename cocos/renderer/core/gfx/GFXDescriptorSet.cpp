@@ -2,6 +2,7 @@
 
 #include "GFXDescriptorSet.h"
 #include "GFXDescriptorSetLayout.h"
+#include "GFXDevice.h"
 
 namespace cc {
 namespace gfx {
@@ -13,6 +14,17 @@ DescriptorSet::DescriptorSet(Device *device)
 DescriptorSet::~DescriptorSet() {
 }
 
+void DescriptorSet::markDirty(uint descriptorIndex) {
+    const uint word = descriptorIndex >> 5;
+    if (word >= _dirtyMasks.size()) _dirtyMasks.resize(word + 1, 0u);
+    _dirtyMasks[word] |= 1u << (descriptorIndex & 31u);
+    _isDirty = true;
+}
+
+void DescriptorSet::recordDescriptorWrites(uint count) {
+    _device->_descriptorWriteCount += count;
+}
+
 void DescriptorSet::bindBuffer(uint binding, Buffer *buffer, uint index) {
     const vector<uint> &bindingIndices = _layout->getBindingIndices();
     const DescriptorSetLayoutBindingList &bindings = _layout->getBindings();
@@ -23,7 +35,7 @@ void DescriptorSet::bindBuffer(uint binding, Buffer *buffer, uint index) {
         const uint descriptorIndex = _layout->getDescriptorIndices()[binding];
         if (_buffers[descriptorIndex + index] != buffer) {
             _buffers[descriptorIndex + index] = buffer;
-            _isDirty = true;
+            markDirty(descriptorIndex + index);
         }
     } else {
         CCASSERT(false, "Setting binding is not DESCRIPTOR_BUFFER_TYPE.");
@@ -40,7 +52,7 @@ void DescriptorSet::bindTexture(uint binding, Texture *texture, uint index) {
         const uint descriptorIndex = _layout->getDescriptorIndices()[binding];
         if (_textures[descriptorIndex + index] != texture) {
             _textures[descriptorIndex + index] = texture;
-            _isDirty = true;
+            markDirty(descriptorIndex + index);
         }
     } else {
         CCASSERT(false, "Setting binding is not DESCRIPTOR_SAMPLER_TYPE.");
@@ -57,7 +69,7 @@ void DescriptorSet::bindSampler(uint binding, Sampler *sampler, uint index) {
         const uint descriptorIndex = _layout->getDescriptorIndices()[binding];
         if (_samplers[descriptorIndex + index] != sampler) {
             _samplers[descriptorIndex + index] = sampler;
-            _isDirty = true;
+            markDirty(descriptorIndex + index);
         }
     } else {
         CCASSERT(false, "Setting binding is not DESCRIPTOR_SAMPLER_TYPE.");
@@ -38,6 +38,28 @@ public:
     CC_INLINE Sampler *getSampler(uint binding) const { return getSampler(binding, 0u); }
 
 protected:
+    void markDirty(uint descriptorIndex);
+    void recordDescriptorWrites(uint count);
+
+    // visits every descriptor bound since the last update, then clears the dirty state
+    template <typename Fn>
+    void consumeDirtyDescriptors(Fn &&fn) {
+        uint count = 0u;
+        for (uint word = 0u; word < _dirtyMasks.size(); ++word) {
+            uint mask = _dirtyMasks[word];
+            if (!mask) continue;
+            _dirtyMasks[word] = 0u;
+            for (uint i = word << 5; mask; ++i, mask >>= 1) {
+                if (mask & 1u) {
+                    fn(i);
+                    ++count;
+                }
+            }
+        }
+        recordDescriptorWrites(count);
+        _isDirty = false;
+    }
+
     Device *_device = nullptr;
 
     DescriptorSetLayout *_layout;
@@ -45,6 +67,7 @@ protected:
     TextureList _textures;
     SamplerList _samplers;
 
+    vector<uint> _dirtyMasks; // one bit per descriptor
     bool _isDirty = false;
 };
 
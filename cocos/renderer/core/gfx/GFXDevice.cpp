@@ -17,6 +17,8 @@ Device *Device::getInstance() {
 Device::Device() {
     Device::_instance = this;
     memset(_features, 0, sizeof(_features));
+    _profiler = CC_NEW(Profiler);
+    _textureStreamer = CC_NEW(TextureStreamer(this));
     EventDispatcher::addCustomEventListener(EVENT_RESTART_VM, [=](const CustomEvent&) -> void {
         // FIXME: wait & flush all pending gfx commands
         Device::_instance->destroy();
@@ -34,6 +36,8 @@ Device::~Device() {
     if (this == Device::_instance) {
         Device::_instance = nullptr;
     }
+    CC_SAFE_DELETE(_textureStreamer);
+    CC_SAFE_DELETE(_profiler);
 }
 
 Format Device::getColorFormat() const {
@@ -16,12 +16,17 @@
 #include "GFXBuffer.h"
 #include "GFXTexture.h"
 #include "GFXShader.h"
+#include "GFXProfiler.h"
+#include "GFXRenderThread.h"
+#include "GFXTextureStreamer.h"
 
 namespace cc {
 namespace gfx {
 
 class CC_DLL Device : public Object {
 public:
+    static constexpr uint MAX_LOD_LEVELS = 4u;
+
     static Device *getInstance();
 
     Device();
@@ -53,7 +58,9 @@ public:
         copyBuffersToTexture(buffers.data(), dst, regions.data(), static_cast<uint>(regions.size()) );
     }
 
+    // replays the device work on a render thread so submission overlaps the next frame, backends without support ignore it
     virtual void setMultithreaded(bool multithreaded) {}
+    CC_INLINE bool isMultithreaded() const { return _renderThread != nullptr; }
     virtual SurfaceTransform getSurfaceTransform() const { return _transform; }
     virtual uint getWidth() const { return _width; }
     virtual uint getHeight() const { return _height; }
@@ -63,6 +70,35 @@ public:
     virtual uint getNumDrawCalls() const { return _numDrawCalls; }
     virtual uint getNumInstances() const { return _numInstances; }
     virtual uint getNumTris() const { return _numTriangles; }
+    virtual uint getNumUploadBytes() const { return _numUploadBytes; }
+    virtual uint getNumDescriptorWrites() const { return _numDescriptorWrites; }
+    virtual uint getNumCoalescedCommands() const { return _numCoalescedCommands; }
+    virtual uint getNumLODTris(uint level) const { return level < MAX_LOD_LEVELS ? _numLODTriangles[level] : 0u; }
+    // render thread figures of the latest finished frame, all zero while single threaded
+    virtual float getFrameLatency() const { return _renderThread ? _renderThread->getFrameLatency() : 0.0f; }
+    virtual float getRenderThreadTime() const { return _renderThread ? _renderThread->getBusyTime() : 0.0f; }
+    virtual float getRenderThreadStallTime() const { return _renderThread ? _renderThread->getStallTime() : 0.0f; }
+    virtual uint getNumRenderThreadCommands() const { return _renderThread ? _renderThread->getCommandCount() : 0u; }
+    virtual uint getNumRenderThreadBytes() const { return _renderThread ? _renderThread->getByteCount() : 0u; }
+
+    // triangles of the visible models by level of detail, reported by the render pipeline during the frame
+    CC_INLINE void addLODTris(uint level, uint count) { _lodTriangleCount[level < MAX_LOD_LEVELS ? level : MAX_LOD_LEVELS - 1] += count; }
+
+    // runs fn right away, or after everything enqueued before it on the render thread while multithreaded
+    template <typename Fn>
+    CC_INLINE void enqueue(Fn &&fn) {
+        if (_renderThread) {
+            _renderThread->enqueue(std::forward<Fn>(fn));
+        } else {
+            fn();
+        }
+    }
+    // data the next enqueued command may read, copied only while multithreaded
+    CC_INLINE const void *stage(const void *data, uint size) { return _renderThread ? _renderThread->stage(data, size) : data; }
+    // blocks until the render thread has executed everything enqueued so far
+    CC_INLINE void flushRenderThread() {
+        if (_renderThread) _renderThread->flush();
+    }
 
     Format getColorFormat() const;
     Format getDepthStencilFormat() const;
@@ -71,6 +107,9 @@ public:
     CC_INLINE Context *getContext() const { return _context; }
     CC_INLINE Queue *getQueue() const { return _queue; }
     CC_INLINE CommandBuffer *getCommandBuffer() const { return _cmdBuff; }
+    CC_INLINE Profiler *getProfiler() const { return _profiler; }
+    CC_INLINE TextureStreamer *getTextureStreamer() const { return _textureStreamer; }
+    CC_INLINE RenderThread *getRenderThread() const { return _renderThread; }
     CC_INLINE const String &getRenderer() const { return _renderer; }
     CC_INLINE const String &getVendor() const { return _vendor; }
     CC_INLINE int getMaxVertexAttributes() const { return _maxVertexAttributes; }
@@ -94,6 +133,7 @@ public:
 
 protected:
     friend class DeviceAgent;
+    friend class DescriptorSet;
 
     virtual CommandBuffer *doCreateCommandBuffer(const CommandBufferInfo &info, bool hasAgent) = 0;
     virtual Fence *createFence() = 0;
@@ -130,9 +170,18 @@ protected:
     Context *_context = nullptr;
     Queue *_queue = nullptr;
     CommandBuffer *_cmdBuff = nullptr;
+    Profiler *_profiler = nullptr;
+    TextureStreamer *_textureStreamer = nullptr;
+    RenderThread *_renderThread = nullptr; // only while multithreaded
     uint _numDrawCalls = 0u;
     uint _numInstances = 0u;
     uint _numTriangles = 0u;
+    uint _numUploadBytes = 0u;
+    uint _numDescriptorWrites = 0u;
+    uint _descriptorWriteCount = 0u; // accumulated by descriptor set updates during the current frame
+    uint _numCoalescedCommands = 0u;
+    uint _numLODTriangles[MAX_LOD_LEVELS] = {};
+    uint _lodTriangleCount[MAX_LOD_LEVELS] = {}; // accumulated by addLODTris during the current frame
     uint _maxVertexAttributes = 0u;
     uint _maxVertexUniformVectors = 0u;
     uint _maxFragmentUniformVectors = 0u;
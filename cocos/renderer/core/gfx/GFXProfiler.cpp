@@ -0,0 +1,195 @@
+#include "CoreStd.h"
+
+#include "GFXProfiler.h"
+#include "platform/FileUtils.h"
+#include <chrono>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr float AVERAGE_WEIGHT = 0.1f; // exponential moving average, roughly the last 10 frames
+
+void writeEscaped(FILE *fp, const String &str) {
+    for (char c : str) {
+        if (c == '"' || c == '\\') fputc('\\', fp);
+        if (static_cast<unsigned char>(c) >= 0x20) fputc(c, fp);
+    }
+}
+
+void writeEvent(FILE *fp, const String &name, uint tid, double ts, double dur) {
+    fprintf(fp, ",\n{\"name\":\"");
+    writeEscaped(fp, name);
+    fprintf(fp, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", tid, ts, dur);
+}
+} // namespace
+
+constexpr uint Profiler::FRAME_LATENCY;
+constexpr uint Profiler::MAX_SCOPES;
+constexpr uint Profiler::HISTORY_FRAMES;
+constexpr uint Profiler::INVALID_SCOPE;
+
+Profiler::Profiler() {
+    _epoch = now();
+    _history.resize(HISTORY_FRAMES);
+    for (uint i = 0u; i < FRAME_LATENCY; ++i) {
+        _frames[i].scopes.reserve(MAX_SCOPES);
+    }
+}
+
+Profiler::~Profiler() {
+}
+
+double Profiler::now() const {
+    const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double, std::micro>(elapsed).count() - _epoch;
+}
+
+void Profiler::beginFrame() {
+    ++_frameIndex;
+
+    FrameRecord &frame = _frames[getFrameSlot()];
+    if (!frame.scopes.empty()) {
+        commit(frame);
+        frame.scopes.clear();
+    }
+    frame.index = _frameIndex;
+
+    _scopeStack.clear();
+    _recording = _enabled;
+}
+
+void Profiler::endFrame() {
+    // close whatever a stage forgot to
+    while (!_scopeStack.empty()) endScope();
+    _recording = false;
+}
+
+uint Profiler::beginScope(const String &name) {
+    if (!_recording) return INVALID_SCOPE;
+
+    FrameRecord &frame = _frames[getFrameSlot()];
+    if (frame.scopes.size() >= MAX_SCOPES) {
+        _scopeStack.push_back(INVALID_SCOPE);
+        return INVALID_SCOPE;
+    }
+
+    const uint scope = static_cast<uint>(frame.scopes.size());
+    frame.scopes.emplace_back();
+    ScopeRecord &record = frame.scopes.back();
+    record.name = name;
+    record.cpuBegin = now();
+    _scopeStack.push_back(scope);
+    return scope;
+}
+
+uint Profiler::endScope() {
+    if (!_recording || _scopeStack.empty()) return INVALID_SCOPE;
+
+    const uint scope = _scopeStack.back();
+    _scopeStack.pop_back();
+    if (scope != INVALID_SCOPE) {
+        _frames[getFrameSlot()].scopes[scope].cpuEnd = now();
+    }
+    return scope;
+}
+
+void Profiler::resolveGPUScope(uint slot, uint scope, uint64_t beginNs, uint64_t endNs) {
+    vector<ScopeRecord> &scopes = _frames[slot].scopes;
+    if (scope >= scopes.size() || endNs < beginNs) return;
+
+    scopes[scope].gpuBegin = beginNs;
+    scopes[scope].gpuEnd = endNs;
+    scopes[scope].gpuValid = true;
+}
+
+void Profiler::commit(FrameRecord &frame) {
+    _frameSums.clear();
+    for (const ScopeRecord &record : frame.scopes) {
+        ScopeAverage &sum = _frameSums[record.name];
+        sum.cpu += static_cast<float>((record.cpuEnd - record.cpuBegin) * 1e-3);
+        sum.hasCPU = true;
+        if (record.gpuValid) {
+            sum.gpu += static_cast<float>((record.gpuEnd - record.gpuBegin) * 1e-6);
+            sum.hasGPU = true;
+        }
+    }
+    for (const auto &it : _frameSums) {
+        ScopeAverage &average = _averages[it.first];
+        const ScopeAverage &sum = it.second;
+        average.cpu = average.hasCPU ? average.cpu + (sum.cpu - average.cpu) * AVERAGE_WEIGHT : sum.cpu;
+        average.hasCPU = true;
+        if (sum.hasGPU) {
+            average.gpu = average.hasGPU ? average.gpu + (sum.gpu - average.gpu) * AVERAGE_WEIGHT : sum.gpu;
+            average.hasGPU = true;
+        }
+    }
+
+    FrameRecord &entry = _history[_historyHead];
+    entry.index = frame.index;
+    entry.scopes.swap(frame.scopes); // the caller clears the swapped-in vector
+    _historyHead = (_historyHead + 1) % HISTORY_FRAMES;
+    _historyCount = std::min(_historyCount + 1, HISTORY_FRAMES);
+}
+
+float Profiler::getCPUTime(const String &name) const {
+    auto it = _averages.find(name);
+    return it != _averages.end() ? it->second.cpu : 0.0f;
+}
+
+float Profiler::getGPUTime(const String &name) const {
+    auto it = _averages.find(name);
+    return it != _averages.end() ? it->second.gpu : 0.0f;
+}
+
+StringArray Profiler::getScopeNames() const {
+    StringArray names;
+    names.reserve(_averages.size());
+    for (const auto &it : _averages) {
+        names.push_back(it.first);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool Profiler::exportChromeTrace(const String &path) const {
+    FileUtils *fileUtils = FileUtils::getInstance();
+    const String fullPath = fileUtils->isAbsolutePath(path) ? path : fileUtils->getWritablePath() + path;
+
+    FILE *fp = fopen(fullPath.c_str(), "wb");
+    if (!fp) {
+        CC_LOG_ERROR("Failed to open %s for the profiler trace.", fullPath.c_str());
+        return false;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    fprintf(fp, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"CPU\"}}");
+    fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+
+    const uint start = (_historyHead + HISTORY_FRAMES - _historyCount) % HISTORY_FRAMES;
+    for (uint i = 0u; i < _historyCount; ++i) {
+        const FrameRecord &frame = _history[(start + i) % HISTORY_FRAMES];
+
+        // GPU timestamps live in their own clock domain, anchor them to the CPU begin of the first timed scope
+        const ScopeRecord *anchor = nullptr;
+        for (const ScopeRecord &record : frame.scopes) {
+            writeEvent(fp, record.name, 1u, record.cpuBegin, record.cpuEnd - record.cpuBegin);
+            if (record.gpuValid && !anchor) anchor = &record;
+        }
+        if (!anchor) continue;
+
+        for (const ScopeRecord &record : frame.scopes) {
+            if (!record.gpuValid) continue;
+            const double offset = (static_cast<double>(record.gpuBegin) - static_cast<double>(anchor->gpuBegin)) * 1e-3;
+            writeEvent(fp, record.name, 2u, anchor->cpuBegin + offset, (record.gpuEnd - record.gpuBegin) * 1e-3);
+        }
+    }
+
+    fprintf(fp, "\n]}\n");
+    const bool succeeded = !ferror(fp);
+    fclose(fp);
+    return succeeded;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,95 @@
+#ifndef CC_CORE_GFX_PROFILER_H_
+#define CC_CORE_GFX_PROFILER_H_
+
+#include "GFXDef.h"
+
+namespace cc {
+namespace gfx {
+
+/**
+ * Named timing scopes opened through CommandBuffer::beginProfileScope.
+ * CPU time is always recorded, GPU time only where the backend supports timestamp queries.
+ * GPU results are read back FRAME_LATENCY frames after recording so they never stall the pipeline.
+ */
+class CC_DLL Profiler final : public Object {
+public:
+    static constexpr uint FRAME_LATENCY = 3u;
+    static constexpr uint MAX_SCOPES = 128u;     // per frame, extra scopes are dropped
+    static constexpr uint HISTORY_FRAMES = 300u; // frames kept for trace export
+    static constexpr uint INVALID_SCOPE = ~0u;
+
+    Profiler();
+    ~Profiler();
+
+    // takes effect from the next frame on
+    CC_INLINE void setEnabled(bool enabled) { _enabled = enabled; }
+    CC_INLINE bool isEnabled() const { return _enabled; }
+
+    // frame boundaries, driven by the device
+    void beginFrame();
+    void endFrame();
+
+    CC_INLINE bool isRecording() const { return _recording; }
+    CC_INLINE uint getFrameSlot() const { return _frameIndex % FRAME_LATENCY; }
+    // the slot the next beginFrame() will recycle, backends resolve their GPU timestamps for it beforehand
+    CC_INLINE uint getResolveSlot() const { return (_frameIndex + 1) % FRAME_LATENCY; }
+    CC_INLINE uint getScopeCount(uint slot) const { return static_cast<uint>(_frames[slot].scopes.size()); }
+    void resolveGPUScope(uint slot, uint scope, uint64_t beginNs, uint64_t endNs);
+
+    // returns the index of the scope inside the current frame, or INVALID_SCOPE if not recording
+    uint beginScope(const String &name);
+    uint endScope();
+
+    // rolling averages in milliseconds, summed over all scopes of the same name in a frame
+    float getCPUTime(const String &name) const;
+    float getGPUTime(const String &name) const;
+    StringArray getScopeNames() const;
+
+    // writes the recorded history in the Chrome trace event format, relative paths go to the writable path
+    bool exportChromeTrace(const String &path) const;
+
+private:
+    struct ScopeRecord {
+        String name;
+        double cpuBegin = 0.0; // microseconds
+        double cpuEnd = 0.0;
+        uint64_t gpuBegin = 0u; // nanoseconds, in the GPU clock domain
+        uint64_t gpuEnd = 0u;
+        bool gpuValid = false;
+    };
+
+    struct FrameRecord {
+        uint64_t index = 0u;
+        vector<ScopeRecord> scopes;
+    };
+
+    struct ScopeAverage {
+        float cpu = 0.0f;
+        float gpu = 0.0f;
+        bool hasCPU = false;
+        bool hasGPU = false;
+    };
+
+    double now() const;
+    void commit(FrameRecord &frame);
+
+    bool _enabled = false;
+    bool _recording = false;
+    uint64_t _frameIndex = 0u;
+    double _epoch = 0.0;
+
+    FrameRecord _frames[FRAME_LATENCY];
+    vector<uint> _scopeStack;
+
+    vector<FrameRecord> _history;
+    uint _historyHead = 0u;
+    uint _historyCount = 0u;
+
+    unordered_map<String, ScopeAverage> _averages;
+    unordered_map<String, ScopeAverage> _frameSums;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_PROFILER_H_
@@ -0,0 +1,240 @@
+#include "CoreStd.h"
+
+#include "GFXRenderThread.h"
+#include <chrono>
+#include <cstring>
+
+namespace cc {
+namespace gfx {
+
+RenderThread::RenderThread(uint ringSize)
+: _ringSize(ringSize), _ringMask(ringSize - 1u) {
+    CCASSERT(ringSize && !(ringSize & (ringSize - 1u)), "render thread ring size must be a power of two");
+    _ring = (uint8_t *)CC_MALLOC(_ringSize);
+}
+
+RenderThread::~RenderThread() {
+    stop();
+    CC_FREE(_ring);
+}
+
+double RenderThread::now() {
+    const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+void RenderThread::start(const std::function<void()> &onStart, const std::function<void()> &onStop) {
+    if (isRunning()) return;
+
+    _quit.store(false);
+    _thread = std::thread(&RenderThread::run, this, onStart, onStop);
+}
+
+void RenderThread::stop() {
+    if (!isRunning()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit.store(true);
+    }
+    _consumerCond.notify_one();
+    _thread.join();
+
+    // everything has executed, nothing is left to wait for
+    runRetired(~0ull);
+    for (auto &callback : _retiring) callback();
+    _retiring.clear();
+}
+
+void RenderThread::run(const std::function<void()> &onStart, const std::function<void()> &onStop) {
+    if (onStart) onStart();
+
+    uint64_t readPos = _readPos.load(std::memory_order_relaxed);
+    vector<void *> heapPayloads;
+    _busySince = now();
+
+    while (true) {
+        const uint64_t writePos = _writePos.load(std::memory_order_acquire);
+        if (readPos == writePos) {
+            // the last commands are published before the quit flag, look again once it is seen
+            if (_quit.load() && _writePos.load() == readPos) break;
+
+            const double idleBegin = now();
+            _busyAccum += idleBegin - _busySince;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _consumerWaiting.store(true);
+                _consumerCond.wait(lock, [&]() { return _writePos.load() != readPos || _quit.load(); });
+                _consumerWaiting.store(false);
+            }
+            _busySince = now();
+            continue;
+        }
+
+        while (readPos != writePos) {
+            Entry *entry = reinterpret_cast<Entry *>(_ring + (readPos & _ringMask));
+            readPos += entry->size;
+
+            switch (entry->kind) {
+                case Entry::COMMAND: {
+                    entry->invoke(entry);
+                    // the payloads staged for this command go together with it
+                    for (void *payload : heapPayloads) CC_FREE(payload);
+                    heapPayloads.clear();
+                    _readPos.store(readPos);
+                    if (_producerWaiting.load()) {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _producerCond.notify_one();
+                    }
+                    break;
+                }
+                case Entry::HEAP_DATA:
+                    heapPayloads.push_back(*reinterpret_cast<void **>(entry + 1));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    for (void *payload : heapPayloads) CC_FREE(payload);
+
+    if (onStop) onStop();
+}
+
+RenderThread::Entry *RenderThread::reserve(uint size, Entry::Kind kind) {
+    CCASSERT(size <= _ringSize / 4u, "render thread command too large");
+
+    uint offset = static_cast<uint>(_reservedPos & _ringMask);
+    uint padding = offset + size > _ringSize ? _ringSize - offset : 0u;
+    if (_reservedPos + padding + size - _readPos.load(std::memory_order_acquire) > _ringSize) {
+        wait([&]() { return _reservedPos + padding + size - _readPos.load() <= _ringSize; });
+    }
+
+    if (padding) {
+        Entry *fill = new (_ring + offset) Entry;
+        fill->size = padding;
+        fill->kind = Entry::PADDING;
+        _reservedPos += padding;
+        offset = 0u;
+    }
+
+    Entry *entry = new (_ring + offset) Entry;
+    entry->size = size;
+    entry->kind = kind;
+    _reservedPos += size;
+    _frameBytes += size;
+    return entry;
+}
+
+void RenderThread::commit() {
+    _writePos.store(_reservedPos);
+    _pendingBytes = 0u;
+    ++_frameCommands;
+
+    if (_consumerWaiting.load()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _consumerCond.notify_one();
+    }
+}
+
+void *RenderThread::allocate(uint size) {
+    const uint entrySize = align(sizeof(Entry) + size);
+    // the payloads of one command have to fit next to it, larger ones go to the heap
+    if (_pendingBytes + entrySize > _ringSize / 4u) {
+        void *payload = CC_MALLOC(size);
+        Entry *entry = reserve(align(sizeof(Entry) + sizeof(void *)), Entry::HEAP_DATA);
+        *reinterpret_cast<void **>(entry + 1) = payload;
+        _pendingBytes += entry->size;
+        _frameBytes += size;
+        return payload;
+    }
+
+    Entry *entry = reserve(entrySize, Entry::DATA);
+    _pendingBytes += entrySize;
+    return entry + 1;
+}
+
+const void *RenderThread::stage(const void *data, uint size) {
+    void *copy = allocate(size);
+    memcpy(copy, data, size);
+    return copy;
+}
+
+void RenderThread::retire(std::function<void()> &&fn) {
+    _retiring.push_back(std::move(fn));
+}
+
+void RenderThread::wait(const std::function<bool()> &ready) {
+    const double begin = now();
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _producerWaiting.store(true);
+        _producerCond.wait(lock, ready);
+        _producerWaiting.store(false);
+    }
+    _frameStall += now() - begin;
+}
+
+void RenderThread::flush() {
+    if (!isRunning()) return;
+
+    enqueue([]() {});
+    wait([this]() { return _readPos.load() == _reservedPos; });
+
+    runRetired(~0ull);
+    for (auto &callback : _retiring) callback();
+    _retiring.clear();
+}
+
+void RenderThread::runRetired(uint64_t completedFrame) {
+    while (!_retired.empty() && _retired.front().frame <= completedFrame) {
+        for (auto &callback : _retired.front().callbacks) callback();
+        _retired.pop_front();
+    }
+}
+
+void RenderThread::beginFrame() {
+    _frameBegin = now();
+}
+
+void RenderThread::endFrame() {
+    const uint64_t frame = ++_submittedFrames;
+    const double frameBegin = _frameBegin;
+    enqueue([this, frame, frameBegin]() {
+        const double frameEnd = now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _completedLatency = frameEnd - frameBegin;
+        _completedBusy = _busyAccum + (frameEnd - _busySince);
+        _busyAccum = 0.0;
+        _busySince = frameEnd;
+        _completedFrames.store(frame);
+        _producerCond.notify_one();
+    });
+
+    _commandCount = _frameCommands;
+    _byteCount = _frameBytes;
+    _frameCommands = 0u;
+    _frameBytes = 0u;
+
+    if (!_retiring.empty()) {
+        _retired.push_back({frame, std::move(_retiring)});
+        _retiring.clear();
+    }
+
+    if (frame > MAX_FRAMES_AHEAD && _completedFrames.load() < frame - MAX_FRAMES_AHEAD) {
+        wait([&]() { return _completedFrames.load() >= frame - MAX_FRAMES_AHEAD; });
+    }
+    runRetired(_completedFrames.load());
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _frameLatency = static_cast<float>(_completedLatency);
+        _busyTime = static_cast<float>(_completedBusy);
+    }
+    _stallTime = static_cast<float>(_frameStall);
+    _frameStall = 0.0;
+}
+
+} // namespace gfx
+} // namespace cc
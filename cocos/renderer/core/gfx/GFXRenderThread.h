@@ -0,0 +1,145 @@
+#ifndef CC_CORE_GFX_RENDER_THREAD_H_
+#define CC_CORE_GFX_RENDER_THREAD_H_
+
+#include "GFXDef.h"
+#include <condition_variable>
+
+namespace cc {
+namespace gfx {
+
+/**
+ * Replays device work on a dedicated thread so the submission of one frame overlaps
+ * the script and culling of the next. Commands are functors written into a lock-free
+ * single producer, single consumer ring: only the thread owning the device may enqueue,
+ * and commands run in submission order. The producer runs at most MAX_FRAMES_AHEAD
+ * frames ahead of the consumer, so anything a command references only has to survive
+ * until the frame after the one it was enqueued in has ended.
+ */
+class CC_DLL RenderThread final : public Object {
+public:
+    static constexpr uint DEFAULT_RING_SIZE = 4u * 1024u * 1024u; // power of two
+    static constexpr uint MAX_FRAMES_AHEAD = 1u;
+
+    RenderThread(uint ringSize = DEFAULT_RING_SIZE);
+    ~RenderThread();
+
+    // onStart runs first on the new thread, e.g. to make a context current there, onStop runs last
+    void start(const std::function<void()> &onStart, const std::function<void()> &onStop);
+    // executes everything still queued, retires all frames and joins the thread
+    void stop();
+    CC_INLINE bool isRunning() const { return _thread.joinable(); }
+
+    template <typename Fn>
+    void enqueue(Fn &&fn);
+    // copies data next to the commands, the copy stays valid until the next command enqueued has executed
+    const void *stage(const void *data, uint size);
+    // returns uninitialized storage with the lifetime of stage()
+    void *allocate(uint size);
+    // runs fn on the producer thread once the render thread has finished the current frame
+    void retire(std::function<void()> &&fn);
+    // blocks until everything enqueued so far has executed
+    void flush();
+
+    // frame boundaries, driven by the device on the producer thread
+    void beginFrame();
+    // blocks while more than MAX_FRAMES_AHEAD frames are in flight
+    void endFrame();
+
+    // per frame figures, in milliseconds where timed, of the latest frame the render thread finished
+    CC_INLINE float getFrameLatency() const { return _frameLatency; }
+    CC_INLINE float getBusyTime() const { return _busyTime; }
+    CC_INLINE float getStallTime() const { return _stallTime; }
+    CC_INLINE uint getCommandCount() const { return _commandCount; }
+    CC_INLINE uint getByteCount() const { return _byteCount; }
+
+private:
+    struct alignas(16) Entry {
+        enum Kind : uint32_t {
+            COMMAND,
+            DATA,
+            HEAP_DATA, // a pointer to a payload too large for the ring
+            PADDING,   // fills the tail of the ring when the next entry does not fit
+        };
+        uint32_t size = 0u; // bytes up to the next entry, header included
+        Kind kind = COMMAND;
+        void (*invoke)(Entry *entry) = nullptr;
+    };
+    static constexpr uint ENTRY_ALIGNMENT = alignof(Entry);
+
+    struct RetiredFrame {
+        uint64_t frame = 0u;
+        vector<std::function<void()>> callbacks;
+    };
+
+    static double now();
+    static CC_INLINE uint align(uint size) { return (size + ENTRY_ALIGNMENT - 1u) & ~(ENTRY_ALIGNMENT - 1u); }
+
+    Entry *reserve(uint size, Entry::Kind kind);
+    // publishes the entries reserved so far, called once per command
+    void commit();
+    // blocks the producer until ready() holds, the time spent counts as stall time
+    void wait(const std::function<bool()> &ready);
+    void runRetired(uint64_t completedFrame);
+    void run(const std::function<void()> &onStart, const std::function<void()> &onStop);
+
+    uint8_t *_ring = nullptr;
+    uint _ringSize = 0u;
+    uint _ringMask = 0u;
+
+    std::thread _thread;
+    std::atomic<uint64_t> _writePos{0u}; // published by the producer after each command
+    std::atomic<uint64_t> _readPos{0u};  // published by the consumer after each command
+    uint64_t _reservedPos = 0u;          // producer side, ahead of _writePos while an entry is being written
+    uint _pendingBytes = 0u;             // staged since the last command, released together with it
+    std::atomic<bool> _quit{false};
+
+    std::mutex _mutex;
+    std::condition_variable _consumerCond;
+    std::condition_variable _producerCond;
+    std::atomic<bool> _consumerWaiting{false};
+    std::atomic<bool> _producerWaiting{false};
+
+    // producer side
+    uint64_t _submittedFrames = 0u;
+    double _frameBegin = 0.0;
+    double _frameStall = 0.0;
+    uint _frameCommands = 0u;
+    uint _frameBytes = 0u;
+    vector<std::function<void()>> _retiring;
+    std::deque<RetiredFrame> _retired;
+
+    // written by the consumer at the end of each frame under _mutex
+    std::atomic<uint64_t> _completedFrames{0u};
+    double _completedLatency = 0.0;
+    double _completedBusy = 0.0;
+
+    // consumer side
+    double _busySince = 0.0;
+    double _busyAccum = 0.0;
+
+    float _frameLatency = 0.0f;
+    float _busyTime = 0.0f;
+    float _stallTime = 0.0f;
+    uint _commandCount = 0u;
+    uint _byteCount = 0u;
+};
+
+template <typename Fn>
+void RenderThread::enqueue(Fn &&fn) {
+    using Command = typename std::decay<Fn>::type;
+    static_assert(alignof(Command) <= ENTRY_ALIGNMENT, "over-aligned render thread command");
+
+    Entry *entry = reserve(align(sizeof(Entry) + sizeof(Command)), Entry::COMMAND);
+    new (entry + 1) Command(std::forward<Fn>(fn));
+    entry->invoke = [](Entry *self) {
+        Command *command = reinterpret_cast<Command *>(self + 1);
+        (*command)();
+        command->~Command();
+    };
+    commit();
+}
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_RENDER_THREAD_H_
@@ -0,0 +1,330 @@
+#include "CoreStd.h"
+
+#include "GFXDevice.h"
+#include "GFXTexture.h"
+#include "GFXTextureStreamer.h"
+#include "base/ThreadPool.h"
+#include "platform/FileUtils.h"
+#include "platform/Image.h"
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr int DECODE_THREAD_COUNT = 2;
+
+// the streamer only deals in RGBA8, narrower uncompressed formats are widened on the worker
+bool expandToRGBA8(const Image *image, vector<uint8_t> &out) {
+    const uint pixelCount = static_cast<uint>(image->getWidth() * image->getHeight());
+    const uint8_t *src = image->getData();
+    out.resize(pixelCount * 4u);
+    uint8_t *dst = out.data();
+
+    switch (image->getRenderFormat()) {
+        case Format::RGBA8:
+            memcpy(dst, src, out.size());
+            return true;
+        case Format::RGB8:
+            for (uint i = 0u; i < pixelCount; ++i, src += 3, dst += 4) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = 255u;
+            }
+            return true;
+        case Format::L8:
+            for (uint i = 0u; i < pixelCount; ++i, ++src, dst += 4) {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = 255u;
+            }
+            return true;
+        case Format::LA8:
+            for (uint i = 0u; i < pixelCount; ++i, src += 2, dst += 4) {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = src[1];
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 2x2 box filter, odd edges reuse their last texel
+void downsample(const uint8_t *src, uint srcWidth, uint srcHeight, uint8_t *dst, uint dstWidth, uint dstHeight) {
+    for (uint y = 0u; y < dstHeight; ++y) {
+        const uint y0 = std::min(y * 2u, srcHeight - 1u);
+        const uint y1 = std::min(y * 2u + 1u, srcHeight - 1u);
+        for (uint x = 0u; x < dstWidth; ++x) {
+            const uint x0 = std::min(x * 2u, srcWidth - 1u);
+            const uint x1 = std::min(x * 2u + 1u, srcWidth - 1u);
+            const uint8_t *p00 = src + (y0 * srcWidth + x0) * 4u;
+            const uint8_t *p01 = src + (y0 * srcWidth + x1) * 4u;
+            const uint8_t *p10 = src + (y1 * srcWidth + x0) * 4u;
+            const uint8_t *p11 = src + (y1 * srcWidth + x1) * 4u;
+            uint8_t *out = dst + (y * dstWidth + x) * 4u;
+            for (uint c = 0u; c < 4u; ++c) {
+                out[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2u) >> 2);
+            }
+        }
+    }
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(Device *device)
+: _device(device) {
+}
+
+TextureStreamer::~TextureStreamer() {
+    destroy();
+}
+
+void TextureStreamer::destroy() {
+    // joins the workers, so nothing writes to _decoded afterwards
+    CC_SAFE_DELETE(_threadPool);
+    _decoded.clear();
+
+    for (auto &it : _entries) {
+        it.first->destroy();
+        CC_DELETE(it.first);
+    }
+    _entries.clear();
+    _residentBytes = 0u;
+    _pendingCount = 0u;
+}
+
+Texture *TextureStreamer::load(const String &path, int priority) {
+    // fullPathForFilename isn't thread safe, resolve it before going to the worker
+    const String fullPath = FileUtils::getInstance()->fullPathForFilename(path);
+    if (fullPath.empty()) {
+        CC_LOG_ERROR("TextureStreamer: %s not found.", path.c_str());
+        return nullptr;
+    }
+
+    TextureInfo info;
+    info.usage = TextureUsageBit::SAMPLED | TextureUsageBit::TRANSFER_DST;
+    info.format = Format::RGBA8;
+    info.width = 1u;
+    info.height = 1u;
+    info.levelCount = MAX_LEVEL_COUNT;
+    Texture *texture = _device->createTexture(info);
+
+    static const uint8_t PLACEHOLDER[] = {127u, 127u, 127u, 255u};
+    BufferTextureCopy region;
+    region.texExtent = {1u, 1u, 1u};
+    _device->copyBuffersToTexture({PLACEHOLDER}, texture, {region});
+
+    Entry &entry = _entries[texture];
+    entry.id = ++_nextID;
+    entry.priority = priority;
+    entry.lastUsedFrame = _frame;
+    entry.decoding = true;
+
+    if (!_threadPool) {
+        _threadPool = ThreadPool::newFixedThreadPool(DECODE_THREAD_COUNT);
+    }
+    const uint id = entry.id;
+    _threadPool->pushTask([this, texture, id, fullPath](int /*threadId*/) {
+        DecodeResult result;
+        result.texture = texture;
+        result.id = id;
+        if (!decode(fullPath, result.levels)) {
+            result.levels.clear();
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _decoded.push_back(std::move(result));
+    });
+
+    return texture;
+}
+
+void TextureStreamer::unload(Texture *texture) {
+    auto it = _entries.find(texture);
+    if (it == _entries.end()) return;
+
+    _residentBytes -= residentSize(it->second, it->second.residentLevel);
+    _entries.erase(it);
+    texture->destroy();
+    CC_DELETE(texture);
+}
+
+void TextureStreamer::touch(Texture *texture) {
+    auto it = _entries.find(texture);
+    if (it == _entries.end()) return;
+
+    it->second.lastUsedFrame = _frame;
+    it->second.capLevel = 0u;
+}
+
+void TextureStreamer::setPriority(Texture *texture, int priority) {
+    auto it = _entries.find(texture);
+    if (it != _entries.end()) it->second.priority = priority;
+}
+
+bool TextureStreamer::decode(const String &path, vector<Level> &levels) {
+    Image *image = new (std::nothrow) Image();
+    if (!image) return false;
+
+    bool succeeded = false;
+    if (!image->initWithImageFile(path)) {
+        CC_LOG_ERROR("TextureStreamer: failed to decode %s.", path.c_str());
+    } else if (image->isCompressed()) {
+        // there is no CPU decoder for block compressed formats to build the chain from
+        CC_LOG_ERROR("TextureStreamer: %s is compressed and can't be streamed.", path.c_str());
+    } else {
+        uint width = static_cast<uint>(image->getWidth());
+        uint height = static_cast<uint>(image->getHeight());
+        levels.resize(MipLevelCount(width, height));
+        levels[0].width = width;
+        levels[0].height = height;
+        succeeded = expandToRGBA8(image, levels[0].data);
+        if (!succeeded) {
+            CC_LOG_ERROR("TextureStreamer: unsupported format in %s.", path.c_str());
+        }
+        for (size_t i = 1u; succeeded && i < levels.size(); ++i) {
+            const Level &src = levels[i - 1];
+            Level &dst = levels[i];
+            dst.width = std::max(src.width >> 1, 1u);
+            dst.height = std::max(src.height >> 1, 1u);
+            dst.data.resize(dst.width * dst.height * 4u);
+            downsample(src.data.data(), src.width, src.height, dst.data.data(), dst.width, dst.height);
+        }
+        if (succeeded && levels.size() > MAX_LEVEL_COUNT) {
+            levels.erase(levels.begin(), levels.begin() + (levels.size() - MAX_LEVEL_COUNT));
+        }
+    }
+
+    image->release();
+    return succeeded;
+}
+
+uint TextureStreamer::residentSize(const Entry &entry, uint level) {
+    uint size = 0u;
+    for (size_t i = level; i < entry.levels.size(); ++i) {
+        size += static_cast<uint>(entry.levels[i].data.size());
+    }
+    return size;
+}
+
+uint TextureStreamer::applyLevel(Texture *texture, Entry &entry, uint level) {
+    const uint levelCount = static_cast<uint>(entry.levels.size()) - level;
+    _buffers.resize(levelCount);
+    _regions.resize(levelCount);
+    for (uint i = 0u; i < levelCount; ++i) {
+        const Level &src = entry.levels[level + i];
+        _buffers[i] = src.data.data();
+        _regions[i].texExtent = {src.width, src.height, 1u};
+        _regions[i].texSubres.mipLevel = i;
+    }
+
+    // resizing reallocates the storage, so every level below has to go up again as well
+    texture->resize(entry.levels[level].width, entry.levels[level].height);
+    _device->copyBuffersToTexture(_buffers, texture, _regions);
+
+    const uint size = residentSize(entry, level);
+    _residentBytes = _residentBytes - residentSize(entry, entry.residentLevel) + size;
+    entry.residentLevel = level;
+    _uploadedBytes += size;
+    return size;
+}
+
+bool TextureStreamer::evict(Texture *requester, uint bytes) {
+    const Entry &target = _entries[requester];
+
+    // only textures that matter less than the one asking for room give up levels
+    vector<std::pair<Texture *, Entry *>> victims;
+    uint evictable = 0u;
+    for (auto &it : _entries) {
+        Entry &entry = it.second;
+        if (it.first == requester || entry.residentLevel >= entry.baseLevel) continue;
+        if (entry.priority > target.priority) continue;
+        if (entry.priority == target.priority && entry.lastUsedFrame >= target.lastUsedFrame) continue;
+        victims.emplace_back(it.first, &entry);
+        evictable += residentSize(entry, entry.residentLevel) - residentSize(entry, entry.baseLevel);
+    }
+    if (evictable < bytes) return false;
+
+    std::sort(victims.begin(), victims.end(), [](const std::pair<Texture *, Entry *> &lhs, const std::pair<Texture *, Entry *> &rhs) {
+        if (lhs.second->priority != rhs.second->priority) return lhs.second->priority < rhs.second->priority;
+        return lhs.second->lastUsedFrame < rhs.second->lastUsedFrame;
+    });
+
+    uint freed = 0u;
+    for (auto &victim : victims) {
+        Entry &entry = *victim.second;
+        const uint before = residentSize(entry, entry.residentLevel);
+        uint level = entry.residentLevel;
+        while (level < entry.baseLevel && freed + before - residentSize(entry, level) < bytes) {
+            ++level;
+        }
+        freed += before - residentSize(entry, level);
+        entry.capLevel = level;
+        applyLevel(victim.first, entry, level);
+        if (freed >= bytes) break;
+    }
+    return true;
+}
+
+void TextureStreamer::update() {
+    ++_frame;
+    _uploadedBytes = 0u;
+
+    vector<DecodeResult> decoded;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        decoded.swap(_decoded);
+    }
+
+    for (DecodeResult &result : decoded) {
+        auto it = _entries.find(result.texture);
+        if (it == _entries.end() || it->second.id != result.id) continue; // unloaded in the meantime
+
+        Entry &entry = it->second;
+        entry.decoding = false;
+        if (result.levels.empty()) continue; // keeps the placeholder
+
+        entry.levels = std::move(result.levels);
+        entry.residentLevel = static_cast<uint>(entry.levels.size());
+        entry.baseLevel = entry.residentLevel - 1u;
+        while (entry.baseLevel > 0u && std::max(entry.levels[entry.baseLevel - 1].width, entry.levels[entry.baseLevel - 1].height) <= BASE_EXTENT) {
+            --entry.baseLevel;
+        }
+        // the first step is small and always goes through, so something sensible is on screen right away
+        applyLevel(result.texture, entry, entry.baseLevel);
+    }
+
+    vector<std::pair<Texture *, Entry *>> candidates;
+    uint pendingCount = 0u;
+    for (auto &it : _entries) {
+        Entry &entry = it.second;
+        if (entry.decoding) {
+            ++pendingCount;
+        } else if (!entry.levels.empty() && entry.residentLevel > entry.capLevel) {
+            candidates.emplace_back(it.first, &entry);
+        }
+    }
+    _pendingCount = pendingCount + static_cast<uint>(candidates.size());
+
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<Texture *, Entry *> &lhs, const std::pair<Texture *, Entry *> &rhs) {
+        if (lhs.second->priority != rhs.second->priority) return lhs.second->priority > rhs.second->priority;
+        if (lhs.second->lastUsedFrame != rhs.second->lastUsedFrame) return lhs.second->lastUsedFrame > rhs.second->lastUsedFrame;
+        return lhs.second->residentLevel > rhs.second->residentLevel;
+    });
+
+    for (auto &candidate : candidates) {
+        Entry &entry = *candidate.second;
+        if (entry.residentLevel <= entry.capLevel) continue; // lost levels to an earlier candidate this frame
+
+        const uint level = entry.residentLevel - 1u;
+        const uint size = residentSize(entry, level);
+        // a single step larger than the whole budget still goes through on an otherwise idle frame
+        if (_uploadedBytes && _uploadedBytes + size > _uploadBudget) continue;
+
+        const uint growth = size - residentSize(entry, entry.residentLevel);
+        if (_residentBytes + growth > _memoryBudget && !evict(candidate.first, _residentBytes + growth - _memoryBudget)) continue;
+
+        applyLevel(candidate.first, entry, level);
+    }
+}
+
+} // namespace gfx
+} // namespace cc
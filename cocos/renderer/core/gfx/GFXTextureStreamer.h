@@ -0,0 +1,108 @@
+#ifndef CC_CORE_GFX_TEXTURE_STREAMER_H_
+#define CC_CORE_GFX_TEXTURE_STREAMER_H_
+
+#include "GFXDef.h"
+#include <mutex>
+
+namespace cc {
+
+class ThreadPool;
+
+namespace gfx {
+
+class Device;
+class Texture;
+
+/**
+ * Streams 2D textures from disk without stalling the frame.
+ * Files are decoded on a worker thread and expanded to RGBA8 with a full mip chain.
+ * The texture then grows in place one level per step, smallest levels first, so a
+ * low resolution version shows up almost immediately. Uploads are capped per frame,
+ * and once the resident levels exceed the memory budget the least recently touched
+ * textures give up their largest levels.
+ */
+class CC_DLL TextureStreamer final : public Object {
+public:
+    static constexpr uint MAX_LEVEL_COUNT = 14u; // up to 8192 x 8192, larger images drop their top levels
+    static constexpr uint BASE_EXTENT = 64u;     // levels up to this size go up in the first step and are never evicted
+    static constexpr uint DEFAULT_UPLOAD_BUDGET = 4u * 1024u * 1024u;
+    static constexpr uint DEFAULT_MEMORY_BUDGET = 256u * 1024u * 1024u;
+
+    TextureStreamer(Device *device);
+    ~TextureStreamer();
+
+    // releases every streamed texture, backends call this before tearing down
+    void destroy();
+
+    // returns a 1x1 placeholder right away, higher priorities stream first
+    Texture *load(const String &path, int priority = 0);
+    // stops streaming and destroys the texture
+    void unload(Texture *texture);
+    // marks the texture as used this frame, eviction starts with the ones touched least recently
+    void touch(Texture *texture);
+    void setPriority(Texture *texture, int priority);
+
+    // applies finished decodes and spends the upload budget, driven by the device once per frame
+    void update();
+
+    CC_INLINE void setUploadBudget(uint bytes) { _uploadBudget = bytes; }
+    CC_INLINE uint getUploadBudget() const { return _uploadBudget; }
+    CC_INLINE void setMemoryBudget(uint bytes) { _memoryBudget = bytes; }
+    CC_INLINE uint getMemoryBudget() const { return _memoryBudget; }
+    CC_INLINE uint getResidentBytes() const { return _residentBytes; }
+    // textures still decoding or waiting for levels
+    CC_INLINE uint getPendingCount() const { return _pendingCount; }
+
+private:
+    struct Level {
+        uint width = 0u;
+        uint height = 0u;
+        vector<uint8_t> data;
+    };
+
+    struct Entry {
+        uint id = 0u;
+        int priority = 0;
+        uint64_t lastUsedFrame = 0u;
+        vector<Level> levels;    // level 0 is the largest, kept so evicted levels can come back without decoding again
+        uint baseLevel = 0u;     // largest level that goes up in the first step
+        uint residentLevel = 0u; // largest level on the GPU, levels.size() while only the placeholder is
+        uint capLevel = 0u;      // largest level streaming may grow to, raised by eviction until touched again
+        bool decoding = false;
+    };
+
+    struct DecodeResult {
+        Texture *texture = nullptr;
+        uint id = 0u;
+        vector<Level> levels;
+    };
+
+    static bool decode(const String &path, vector<Level> &levels);
+    static uint residentSize(const Entry &entry, uint level);
+    // resizes the texture to the given level and uploads the chain below it, returns the bytes uploaded
+    uint applyLevel(Texture *texture, Entry &entry, uint level);
+    bool evict(Texture *requester, uint bytes);
+
+    Device *_device = nullptr;
+    ThreadPool *_threadPool = nullptr;
+
+    unordered_map<Texture *, Entry> _entries;
+    std::mutex _mutex;
+    vector<DecodeResult> _decoded;
+
+    BufferDataList _buffers;
+    BufferTextureCopyList _regions;
+
+    uint64_t _frame = 0u;
+    uint _nextID = 0u;
+    uint _uploadBudget = DEFAULT_UPLOAD_BUDGET;
+    uint _memoryBudget = DEFAULT_MEMORY_BUDGET;
+    uint _uploadedBytes = 0u;
+    uint _residentBytes = 0u;
+    uint _pendingCount = 0u;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_TEXTURE_STREAMER_H_
@@ -0,0 +1,125 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "EmptyStd.h"
+
+#include "EmptyBuffer.h"
+
+namespace cc {
+namespace gfx {
+
+EmptyBuffer::EmptyBuffer(Device *device)
+: Buffer(device) {
+}
+
+EmptyBuffer::~EmptyBuffer() {
+}
+
+bool EmptyBuffer::initialize(const BufferInfo &info) {
+    _usage = info.usage;
+    _memUsage = info.memUsage;
+    _size = info.size;
+    _stride = std::max(info.stride, 1U);
+    _count = _size / _stride;
+    _flags = info.flags;
+
+    if ((_flags & BufferFlagBit::BAKUP_BUFFER) && _size > 0) {
+        _buffer = (uint8_t *)CC_MALLOC(_size);
+        if (!_buffer) {
+            CC_LOG_ERROR("EmptyBuffer: CC_MALLOC backup buffer failed.");
+            return false;
+        }
+        _device->getMemoryStatus().bufferSize += _size;
+    }
+
+    // accounts for the storage a real backend would allocate on the GPU
+    _device->getMemoryStatus().bufferSize += _size;
+
+    return true;
+}
+
+bool EmptyBuffer::initialize(const BufferViewInfo &info) {
+    _isBufferView = true;
+
+    const auto *buffer = static_cast<EmptyBuffer *>(info.buffer);
+    _usage = buffer->_usage;
+    _memUsage = buffer->_memUsage;
+    _size = _stride = info.range;
+    _count = 1u;
+    _offset = info.offset;
+    _flags = buffer->_flags;
+
+    return true;
+}
+
+void EmptyBuffer::destroy() {
+    if (!_isBufferView) {
+        _device->getMemoryStatus().bufferSize -= _size;
+    }
+
+    if (_buffer) {
+        CC_FREE(_buffer);
+        _device->getMemoryStatus().bufferSize -= _size;
+        _buffer = nullptr;
+    }
+    _size = 0u;
+}
+
+void EmptyBuffer::resize(uint size) {
+    CCASSERT(!_isBufferView, "Cannot resize buffer views");
+
+    if (_size != size) {
+        const uint oldSize = _size;
+        _size = size;
+        _count = _size / _stride;
+
+        MemoryStatus &status = _device->getMemoryStatus();
+        status.bufferSize -= oldSize;
+        status.bufferSize += _size;
+
+        if (_buffer) {
+            const uint8_t *oldBuffer = _buffer;
+            uint8_t *buffer = (uint8_t *)CC_MALLOC(_size);
+            if (!buffer) {
+                CC_LOG_ERROR("EmptyBuffer: CC_MALLOC resize backup buffer failed.");
+                return;
+            }
+            memcpy(buffer, oldBuffer, std::min(oldSize, size));
+            _buffer = buffer;
+            CC_FREE(oldBuffer);
+            status.bufferSize -= oldSize;
+            status.bufferSize += _size;
+        }
+    }
+}
+
+void EmptyBuffer::update(void *buffer, uint size) {
+    CCASSERT(!_isBufferView, "Cannot update through buffer views");
+
+    if (_buffer) {
+        memcpy(_buffer, buffer, std::min(size, _size));
+    }
+}
+
+} // namespace gfx
+} // namespace cc
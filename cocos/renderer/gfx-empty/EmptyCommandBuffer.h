@@ -0,0 +1,72 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+namespace cc {
+namespace gfx {
+
+// Records nothing, only keeps the statistics a real backend would report for the same calls.
+class EmptyCommandBuffer final : public CommandBuffer {
+public:
+    EmptyCommandBuffer(Device *device);
+    ~EmptyCommandBuffer();
+
+    friend class EmptyQueue;
+
+public:
+    virtual bool initialize(const CommandBufferInfo &info) override;
+    virtual void destroy() override;
+    virtual void begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer, int submitIndex) override;
+    virtual void end() override;
+    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, bool fromSecondaryCB) override;
+    virtual void endRenderPass() override;
+    virtual void bindPipelineState(PipelineState *pso) override;
+    virtual void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) override;
+    virtual void bindInputAssembler(InputAssembler *ia) override;
+    virtual void setViewport(const Viewport &vp) override;
+    virtual void setScissor(const Rect &rect) override;
+    virtual void setLineWidth(float width) override;
+    virtual void setDepthBias(float constant, float clamp, float slope) override;
+    virtual void setBlendConstants(const Color &constants) override;
+    virtual void setDepthBound(float minBounds, float maxBounds) override;
+    virtual void setStencilWriteMask(StencilFace face, uint mask) override;
+    virtual void setStencilCompareMask(StencilFace face, int ref, uint mask) override;
+    virtual void draw(InputAssembler *ia) override;
+    virtual void updateBuffer(Buffer *buff, const void *data, uint size) override;
+    virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) override;
+    virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) override;
+
+    // Pipeline state, input assembler and descriptor set binds that differ from the current ones.
+    CC_INLINE uint getNumStateChanges() const { return _numStateChanges; }
+
+private:
+    PipelineState *_curPipelineState = nullptr;
+    InputAssembler *_curInputAssembler = nullptr;
+    vector<DescriptorSet *> _curDescriptorSets;
+    bool _isInRenderPass = false;
+    uint _numStateChanges = 0;
+};
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,59 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "EmptyStd.h"
+
+#include "EmptyDescriptorSet.h"
+
+namespace cc {
+namespace gfx {
+
+EmptyDescriptorSet::EmptyDescriptorSet(Device *device)
+: DescriptorSet(device) {
+}
+
+EmptyDescriptorSet::~EmptyDescriptorSet() {
+}
+
+bool EmptyDescriptorSet::initialize(const DescriptorSetInfo &info) {
+    _layout = info.layout;
+
+    const uint descriptorCount = _layout->getDescriptorCount();
+    _buffers.resize(descriptorCount);
+    _textures.resize(descriptorCount);
+    _samplers.resize(descriptorCount);
+
+    return true;
+}
+
+void EmptyDescriptorSet::destroy() {
+}
+
+void EmptyDescriptorSet::update() {
+    if (_isDirty) {
+        consumeDirtyDescriptors([](uint /*descriptorIndex*/) {});
+    }
+}
+
+} // namespace gfx
+} // namespace cc
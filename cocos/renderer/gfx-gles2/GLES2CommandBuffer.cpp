@@ -88,6 +88,7 @@ void GLES2CommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer
     _numDrawCalls = 0;
     _numInstances = 0;
     _numTriangles = 0;
+    _numUploadBytes = 0;
 }
 
 void GLES2CommandBuffer::end() {
@@ -284,6 +285,7 @@ void GLES2CommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size)
             cmd->gpuBuffer = gpuBuffer;
             cmd->size = size;
             cmd->buffer = (uint8_t *)data;
+            _numUploadBytes += size;
 
             _curCmdPackage->updateBufferCmds.push(cmd);
             _curCmdPackage->cmds.push(GFXCmdType::UPDATE_BUFFER);
@@ -347,6 +349,7 @@ void GLES2CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t
         _numDrawCalls += cmdBuff->_numDrawCalls;
         _numInstances += cmdBuff->_numInstances;
         _numTriangles += cmdBuff->_numTriangles;
+        _numUploadBytes += cmdBuff->_numUploadBytes;
 
         cmdBuff->_pendingPackages.pop();
         cmdBuff->_freePackages.push(cmdPackage);
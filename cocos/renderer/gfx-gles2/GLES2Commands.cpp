@@ -26,6 +26,9 @@ THE SOFTWARE.
 #include "GLES2Commands.h"
 #include "GLES2Context.h"
 #include "GLES2Device.h"
+#include "GLES2ProgramCache.h"
+
+#include <chrono>
 
 #define BUFFER_OFFSET(idx) (static_cast<char *>(0) + (idx))
 
@@ -894,7 +897,8 @@ void GLES2CmdFuncCreateSampler(GLES2Device *device, GLES2GPUSampler *gpuSampler)
 void GLES2CmdFuncDestroySampler(GLES2Device *device, GLES2GPUSampler *gpuSampler) {
 }
 
-void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader) {
+namespace {
+bool compileProgram(GLES2GPUShader *gpuShader) {
     GLenum glShaderType = 0;
     String shaderTypeStr;
     GLint status;
@@ -915,7 +919,7 @@ void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader) {
             }
             default: {
                 CCASSERT(false, "Unsupported ShaderStageFlagBit");
-                return;
+                return false;
             }
         }
 
@@ -939,7 +943,7 @@ void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader) {
             CC_FREE(logs);
             GL_CHECK(glDeleteShader(gpuStage.glShader));
             gpuStage.glShader = 0;
-            return;
+            return false;
         }
     }
 
@@ -976,7 +980,24 @@ void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader) {
             CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
             CC_LOG_ERROR(logs);
             CC_FREE(logs);
-            return;
+        }
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader) {
+    GLES2ProgramCache *programCache = device->programCache();
+    const uint64_t programKey = programCache ? programCache->computeKey(gpuShader) : 0u;
+
+    if (!programCache || !programCache->loadProgram(programKey, gpuShader)) {
+        const auto begin = std::chrono::steady_clock::now();
+        if (!compileProgram(gpuShader)) return;
+        if (programCache) {
+            const auto compileTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+            programCache->storeProgram(programKey, gpuShader, static_cast<uint>(compileTime.count()));
         }
     }
 
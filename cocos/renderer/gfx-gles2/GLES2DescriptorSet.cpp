@@ -75,31 +75,31 @@ void GLES2DescriptorSet::destroy() {
     _buffers.clear();
     _textures.clear();
     _samplers.clear();
+    _dirtyMasks.clear();
 }
 
 void GLES2DescriptorSet::update() {
     if (_isDirty && _gpuDescriptorSet) {
-        const GLES2GPUDescriptorList &descriptors = _gpuDescriptorSet->gpuDescriptors;
-        for (size_t i = 0; i < descriptors.size(); i++) {
+        GLES2GPUDescriptorList &descriptors = _gpuDescriptorSet->gpuDescriptors;
+        consumeDirtyDescriptors([&](uint i) {
             if ((uint)descriptors[i].type & DESCRIPTOR_BUFFER_TYPE) {
                 GLES2Buffer *buffer = (GLES2Buffer *)_buffers[i];
                 if (buffer) {
                     if (buffer->gpuBuffer()) {
-                        _gpuDescriptorSet->gpuDescriptors[i].gpuBuffer = buffer->gpuBuffer();
+                        descriptors[i].gpuBuffer = buffer->gpuBuffer();
                     } else if (buffer->gpuBufferView()) {
-                        _gpuDescriptorSet->gpuDescriptors[i].gpuBufferView = buffer->gpuBufferView();
+                        descriptors[i].gpuBufferView = buffer->gpuBufferView();
                     }
                 }
             } else if ((uint)descriptors[i].type & DESCRIPTOR_SAMPLER_TYPE) {
                 if (_textures[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuTexture = ((GLES2Texture *)_textures[i])->gpuTexture();
+                    descriptors[i].gpuTexture = ((GLES2Texture *)_textures[i])->gpuTexture();
                 }
                 if (_samplers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuSampler = ((GLES2Sampler *)_samplers[i])->gpuSampler();
+                    descriptors[i].gpuSampler = ((GLES2Sampler *)_samplers[i])->gpuSampler();
                 }
             }
-        }
-        _isDirty = false;
+        });
     }
 }
 
@@ -35,11 +35,13 @@ THE SOFTWARE.
 #include "GLES2InputAssembler.h"
 #include "GLES2PipelineLayout.h"
 #include "GLES2PipelineState.h"
+#include "GLES2ProgramCache.h"
 #include "GLES2Queue.h"
 #include "GLES2RenderPass.h"
 #include "GLES2Sampler.h"
 #include "GLES2Shader.h"
 #include "GLES2Texture.h"
+#include "platform/FileUtils.h"
 
 namespace cc {
 namespace gfx {
@@ -187,12 +189,21 @@ bool GLES2Device::initialize(const DeviceInfo &info) {
 
     _gpuStateCache->initialize(_maxTextureUnits, _maxVertexAttributes);
 
+    if (checkExtension("get_program_binary")) {
+        _programCache = CC_NEW(GLES2ProgramCache);
+        if (!_programCache->initialize(FileUtils::getInstance()->getWritablePath() + "gles2-program-cache.bin", _renderer + "|" + _version)) {
+            CC_SAFE_DESTROY(_programCache);
+        }
+    }
+
     return true;
 }
 
 void GLES2Device::destroy() {
+    _textureStreamer->destroy();
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
+    CC_SAFE_DESTROY(_programCache);
     CC_SAFE_DELETE(_gpuStagingBufferPool);
     CC_SAFE_DELETE(_gpuStateCache);
     CC_SAFE_DESTROY(_deviceContext);
@@ -206,20 +217,33 @@ void GLES2Device::resize(uint width, uint height) {
 
 void GLES2Device::acquire() {
     _gpuStagingBufferPool->reset();
+    _profiler->beginFrame();
+
+    _textureStreamer->update();
 }
 
 void GLES2Device::present() {
+    _profiler->endFrame();
+
     GLES2Queue *queue = (GLES2Queue *)_queue;
     _numDrawCalls = queue->_numDrawCalls;
     _numInstances = queue->_numInstances;
     _numTriangles = queue->_numTriangles;
+    _numUploadBytes = queue->_numUploadBytes;
+    _numDescriptorWrites = _descriptorWriteCount;
+    _descriptorWriteCount = 0u;
+    memcpy(_numLODTriangles, _lodTriangleCount, sizeof(_numLODTriangles));
+    memset(_lodTriangleCount, 0, sizeof(_lodTriangleCount));
 
     _context->present();
 
+    if (_programCache) _programCache->tick();
+
     // Clear queue stats
     queue->_numDrawCalls = 0;
     queue->_numInstances = 0;
     queue->_numTriangles = 0;
+    queue->_numUploadBytes = 0;
 }
 
 void GLES2Device::bindRenderContext(bool bound) {
@@ -38,6 +38,7 @@ namespace gfx {
 class GLES2Context;
 class GLES2GPUStateCache;
 class GLES2GPUStagingBufferPool;
+class GLES2ProgramCache;
 
 class CC_GLES2_API GLES2Device final : public Device {
 public:
@@ -73,6 +74,7 @@ public:
 
     CC_INLINE GLES2GPUStateCache *stateCache() const { return _gpuStateCache; }
     CC_INLINE GLES2GPUStagingBufferPool *stagingBufferPool() const { return _gpuStagingBufferPool; }
+    CC_INLINE GLES2ProgramCache *programCache() const { return _programCache; }
 
     CC_INLINE bool checkExtension(const String &extension) const {
         for (size_t i = 0; i < _extensions.size(); ++i) {
@@ -113,6 +115,7 @@ private:
     GLES2Context *_deviceContext = nullptr;
     GLES2GPUStateCache *_gpuStateCache = nullptr;
     GLES2GPUStagingBufferPool *_gpuStagingBufferPool = nullptr;
+    GLES2ProgramCache *_programCache = nullptr;
 
     StringArray _extensions;
 
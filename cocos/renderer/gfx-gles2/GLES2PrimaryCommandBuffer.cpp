@@ -109,6 +109,7 @@ void GLES2PrimaryCommandBuffer::updateBuffer(Buffer *buff, const void *data, uin
         GLES2GPUBuffer *gpuBuffer = ((GLES2Buffer *)buff)->gpuBuffer();
         if (gpuBuffer) {
             GLES2CmdFuncUpdateBuffer((GLES2Device *)_device, gpuBuffer, data, 0u, size);
+            _numUploadBytes += size;
         }
     } else {
         CC_LOG_ERROR("Command 'updateBuffer' must be recorded outside a render pass.");
@@ -138,6 +139,7 @@ void GLES2PrimaryCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, ui
         _numDrawCalls += cmdBuff->_numDrawCalls;
         _numInstances += cmdBuff->_numInstances;
         _numTriangles += cmdBuff->_numTriangles;
+        _numUploadBytes += cmdBuff->_numUploadBytes;
 
         cmdBuff->_pendingPackages.pop();
         cmdBuff->_freePackages.push(cmdPackage);
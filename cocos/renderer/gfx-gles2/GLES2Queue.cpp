@@ -56,6 +56,7 @@ void GLES2Queue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence
             _numDrawCalls += cmdBuff->_numDrawCalls;
             _numInstances += cmdBuff->_numInstances;
             _numTriangles += cmdBuff->_numTriangles;
+            _numUploadBytes += cmdBuff->_numUploadBytes;
 
             cmdBuff->_pendingPackages.pop();
             cmdBuff->_freePackages.push(cmdPackage);
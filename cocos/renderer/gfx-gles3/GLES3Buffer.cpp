@@ -64,13 +64,17 @@ bool GLES3Buffer::initialize(const BufferInfo &info) {
     _gpuBuffer->stride = _stride;
     _gpuBuffer->count = _count;
 
+    // host storage of the GPU object is allocated and freed with it wherever the GL work runs,
+    // it never aliases the backup buffer, which the main thread keeps writing and frees on destroy
     if (_usage & BufferUsageBit::INDIRECT) {
         _gpuBuffer->indirects.resize(_count);
-    } else {
-        _gpuBuffer->buffer = _buffer;
     }
 
-    GLES3CmdFuncCreateBuffer((GLES3Device *)_device, _gpuBuffer);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+    _device->enqueue([device, gpuBuffer]() {
+        GLES3CmdFuncCreateBuffer(device, gpuBuffer);
+    });
     _device->getMemoryStatus().bufferSize += _size;
     
     return true;
@@ -94,11 +98,17 @@ bool GLES3Buffer::initialize(const BufferViewInfo &info) {
     _gpuBuffer->size = _size;
     _gpuBuffer->stride = _stride;
     _gpuBuffer->count = _count;
-    _gpuBuffer->glTarget = buffer->_gpuBuffer->glTarget;
-    _gpuBuffer->glBuffer = buffer->_gpuBuffer->glBuffer;
     _gpuBuffer->glOffset = info.offset;
-    _gpuBuffer->buffer = buffer->_gpuBuffer->buffer;
-    _gpuBuffer->indirects = buffer->_gpuBuffer->indirects;
+
+    // the GL name and host storage of the source are assigned wherever the GL work runs, so read them there too
+    GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+    GLES3GPUBuffer *sourceBuffer = buffer->_gpuBuffer;
+    _device->enqueue([gpuBuffer, sourceBuffer]() {
+        gpuBuffer->glTarget = sourceBuffer->glTarget;
+        gpuBuffer->glBuffer = sourceBuffer->glBuffer;
+        gpuBuffer->buffer = sourceBuffer->buffer;
+        gpuBuffer->indirects = sourceBuffer->indirects;
+    });
 
     return true;
 }
@@ -106,10 +116,16 @@ bool GLES3Buffer::initialize(const BufferViewInfo &info) {
 void GLES3Buffer::destroy() {
     if (_gpuBuffer) {
         if (!_isBufferView) {
-            GLES3CmdFuncDestroyBuffer((GLES3Device *)_device, _gpuBuffer);
             _device->getMemoryStatus().bufferSize -= _size;
         }
-        CC_DELETE(_gpuBuffer);
+        // commands enqueued earlier may still use the buffer
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+        const bool isBufferView = _isBufferView;
+        _device->enqueue([device, gpuBuffer, isBufferView]() {
+            if (!isBufferView) GLES3CmdFuncDestroyBuffer(device, gpuBuffer);
+            CC_DELETE(gpuBuffer);
+        });
         _gpuBuffer = nullptr;
     }
 
@@ -129,9 +145,14 @@ void GLES3Buffer::resize(uint size) {
         _count = _size / _stride;
 
         MemoryStatus &status = _device->getMemoryStatus();
-        _gpuBuffer->size = _size;
-        _gpuBuffer->count = _count;
-        GLES3CmdFuncResizeBuffer((GLES3Device *)_device, _gpuBuffer);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+        const uint count = _count;
+        _device->enqueue([device, gpuBuffer, size, count]() {
+            gpuBuffer->size = size;
+            gpuBuffer->count = count;
+            GLES3CmdFuncResizeBuffer(device, gpuBuffer);
+        });
         status.bufferSize -= oldSize;
         status.bufferSize += _size;
 
@@ -157,7 +178,12 @@ void GLES3Buffer::update(void *buffer, uint size) {
     if (_buffer) {
         memcpy(_buffer, buffer, size);
     }
-    GLES3CmdFuncUpdateBuffer((GLES3Device *)_device, _gpuBuffer, buffer, 0u, size);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+    const void *data = _device->stage(buffer, size);
+    _device->enqueue([device, gpuBuffer, data, size]() {
+        GLES3CmdFuncUpdateBuffer(device, gpuBuffer, data, 0u, size);
+    });
 }
 
 } // namespace gfx
@@ -58,6 +58,9 @@ bool GLES3CommandBuffer::initialize(const CommandBufferInfo &info) {
 }
 
 void GLES3CommandBuffer::destroy() {
+    // packages still executing on the render thread come back to the free list first
+    _device->flushRenderThread();
+
     _cmdAllocator->clearCmds(_curCmdPackage);
     CC_SAFE_DELETE(_curCmdPackage);
 
@@ -88,6 +91,7 @@ void GLES3CommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer
     _numDrawCalls = 0;
     _numInstances = 0;
     _numTriangles = 0;
+    _numUploadBytes = 0;
 }
 
 void GLES3CommandBuffer::end() {
@@ -96,6 +100,7 @@ void GLES3CommandBuffer::end() {
     }
     _isInRenderPass = false;
 
+    GLES3CmdFuncOptimizeCmds(_cmdAllocator, _curCmdPackage);
     _pendingPackages.push(_curCmdPackage);
     if (!_freePackages.empty()) {
         _curCmdPackage = _freePackages.front();
@@ -107,6 +112,7 @@ void GLES3CommandBuffer::end() {
 
 void GLES3CommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, bool fromSecondaryCB) {
     _isInRenderPass = true;
+    _isStateInvalid = true; // render pass setup may have overridden the dynamic states
 
     GLES3CmdBeginRenderPass *cmd = _cmdAllocator->beginRenderPassCmdPool.alloc();
     cmd->gpuRenderPass = ((GLES3RenderPass *)renderPass)->gpuRenderPass();
@@ -150,8 +156,11 @@ void GLES3CommandBuffer::bindDescriptorSet(uint set, DescriptorSet *descriptorSe
 }
 
 void GLES3CommandBuffer::bindInputAssembler(InputAssembler *ia) {
-    _curGPUInputAssember = ((GLES3InputAssembler *)ia)->gpuInputAssembler();
-    _isStateInvalid = true;
+    GLES3GPUInputAssembler *gpuInputAssembler = ((GLES3InputAssembler *)ia)->gpuInputAssembler();
+    if (_curGPUInputAssember != gpuInputAssembler) {
+        _curGPUInputAssember = gpuInputAssembler;
+        _isStateInvalid = true;
+    }
 }
 
 void GLES3CommandBuffer::setViewport(const Viewport &vp) {
@@ -288,7 +297,14 @@ void GLES3CommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size)
             GLES3CmdUpdateBuffer *cmd = _cmdAllocator->updateBufferCmdPool.alloc();
             cmd->gpuBuffer = gpuBuffer;
             cmd->size = size;
-            cmd->buffer = (uint8_t *)data;
+            if (_device->isMultithreaded()) {
+                // the package runs on the render thread after the caller has moved on
+                cmd->data.assign((const uint8_t *)data, (const uint8_t *)data + size);
+                cmd->buffer = cmd->data.data();
+            } else {
+                cmd->buffer = (uint8_t *)data;
+            }
+            _numUploadBytes += size;
 
             _curCmdPackage->updateBufferCmds.push(cmd);
             _curCmdPackage->cmds.push(GFXCmdType::UPDATE_BUFFER);
@@ -306,10 +322,26 @@ void GLES3CommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Tex
         if (gpuTexture) {
             GLES3CmdCopyBufferToTexture *cmd = _cmdAllocator->copyBufferToTextureCmdPool.alloc();
             cmd->gpuTexture = gpuTexture;
-            cmd->gpuTexture = gpuTexture;
-            cmd->regions = regions;
             cmd->count = count;
-            cmd->buffers = buffers;
+            if (_device->isMultithreaded()) {
+                // the package runs on the render thread after the caller has moved on
+                vector<uint> sizes;
+                GLES3CmdFuncGetCopyBufferSizes(gpuTexture, regions, count, sizes);
+                uint totalSize = 0u;
+                for (uint size : sizes) totalSize += size;
+                cmd->data.resize(totalSize);
+                cmd->dataBuffers.resize(sizes.size());
+                for (uint i = 0u, offset = 0u; i < sizes.size(); offset += sizes[i++]) {
+                    memcpy(cmd->data.data() + offset, buffers[i], sizes[i]);
+                    cmd->dataBuffers[i] = cmd->data.data() + offset;
+                }
+                cmd->dataRegions.assign(regions, regions + count);
+                cmd->regions = cmd->dataRegions.data();
+                cmd->buffers = cmd->dataBuffers.data();
+            } else {
+                cmd->regions = regions;
+                cmd->buffers = buffers;
+            }
 
             _curCmdPackage->copyBufferToTextureCmds.push(cmd);
             _curCmdPackage->cmds.push(GFXCmdType::COPY_BUFFER_TO_TEXTURE);
@@ -350,16 +382,27 @@ void GLES3CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t
             _curCmdPackage->copyBufferToTextureCmds.push(cmd);
         }
         _curCmdPackage->cmds.concat(cmdPackage->cmds);
+        _curCmdPackage->numCoalescedCmds += cmdPackage->numCoalescedCmds;
 
         _numDrawCalls += cmdBuff->_numDrawCalls;
         _numInstances += cmdBuff->_numInstances;
         _numTriangles += cmdBuff->_numTriangles;
+        _numUploadBytes += cmdBuff->_numUploadBytes;
 
         cmdBuff->_pendingPackages.pop();
         cmdBuff->_freePackages.push(cmdPackage);
     }
 }
 
+void GLES3CommandBuffer::recyclePackage(GLES3CmdPackage *cmdPackage) {
+    RenderThread *renderThread = _device->getRenderThread();
+    if (renderThread) {
+        renderThread->retire([this, cmdPackage]() { _freePackages.push(cmdPackage); });
+    } else {
+        _freePackages.push(cmdPackage);
+    }
+}
+
 void GLES3CommandBuffer::BindStates() {
     GLES3CmdBindStates *cmd = _cmdAllocator->bindStatesCmdPool.alloc();
 
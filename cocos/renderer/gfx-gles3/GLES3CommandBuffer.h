@@ -63,6 +63,8 @@ public:
 
 protected:
     virtual void BindStates();
+    // returns a package for reuse once it has been executed, which may happen on the render thread
+    void recyclePackage(GLES3CmdPackage *cmdPackage);
 
     GLES3GPUCommandAllocator *_cmdAllocator = nullptr;
     GLES3CmdPackage *_curCmdPackage = nullptr;
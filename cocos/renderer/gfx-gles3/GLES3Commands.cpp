@@ -26,6 +26,10 @@ THE SOFTWARE.
 #include "GLES3Commands.h"
 #include "GLES3Context.h"
 #include "GLES3Device.h"
+#include "GLES3ProgramCache.h"
+#include "GLES3UploadRing.h"
+
+#include <chrono>
 
 #define BUFFER_OFFSET(idx) (static_cast<char *>(0) + (idx))
 
@@ -1000,7 +1004,8 @@ void GLES3CmdFuncDestroySampler(GLES3Device *device, GLES3GPUSampler *gpuSampler
     }
 }
 
-void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
+namespace {
+bool compileProgram(GLES3GPUShader *gpuShader, bool retrievable) {
     GLenum glShaderStage = 0;
     String shaderStageStr;
     GLint status;
@@ -1021,7 +1026,7 @@ void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
             }
             default: {
                 CCASSERT(false, "Unsupported ShaderStageFlagBit");
-                return;
+                return false;
             }
         }
 
@@ -1046,11 +1051,14 @@ void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
             CC_FREE(logs);
             GL_CHECK(glDeleteShader(gpuStage.glShader));
             gpuStage.glShader = 0;
-            return;
+            return false;
         }
     }
 
     GL_CHECK(gpuShader->glProgram = glCreateProgram());
+    if (retrievable) {
+        GL_CHECK(glProgramParameteri(gpuShader->glProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
 
     // link program
     for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
@@ -1083,7 +1091,24 @@ void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
             CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
             CC_LOG_ERROR(logs);
             CC_FREE(logs);
-            return;
+        }
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
+    GLES3ProgramCache *programCache = device->programCache();
+    const uint64_t programKey = programCache ? programCache->computeKey(gpuShader) : 0u;
+
+    if (!programCache || !programCache->loadProgram(programKey, gpuShader)) {
+        const auto begin = std::chrono::steady_clock::now();
+        if (!compileProgram(gpuShader, programCache != nullptr)) return;
+        if (programCache) {
+            const auto compileTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+            programCache->storeProgram(programKey, gpuShader, static_cast<uint>(compileTime.count()));
         }
     }
 
@@ -1667,7 +1692,8 @@ void GLES3CmdFuncEndRenderPass(GLES3Device *device) {
 void GLES3CmdFuncBindState(GLES3Device *device, GLES3GPUPipelineState *gpuPipelineState, GLES3GPUInputAssembler *gpuInputAssembler,
                            vector<GLES3GPUDescriptorSet *> &gpuDescriptorSets, vector<uint> &dynamicOffsets, Viewport &viewport, Rect &scissor,
                            float lineWidth, bool depthBiasEnabled, GLES3DepthBias &depthBias, Color &blendConstants, GLES3DepthBounds &depthBounds,
-                           GLES3StencilWriteMask &stencilWriteMask, GLES3StencilCompareMask &stencilCompareMask) {
+                           GLES3StencilWriteMask &stencilWriteMask, GLES3StencilCompareMask &stencilCompareMask,
+                           GLES3BindGroup dirtyGroups) {
     GLES3ObjectCache &gfxStateCache = device->stateCache()->gfxStateCache;
 
     GLES3GPUStateCache *cache = device->stateCache();
@@ -1873,8 +1899,9 @@ void GLES3CmdFuncBindState(GLES3Device *device, GLES3GPUPipelineState *gpuPipeli
         }
     } // if
 
-    // bind descriptor sets
-    if (gpuPipelineState && gpuPipelineState->gpuShader && gpuPipelineState->gpuPipelineLayout) {
+    // bind descriptor sets, nothing but draws ran since the previous bind if neither the pipeline nor the sets changed
+    if (gpuPipelineState && gpuPipelineState->gpuShader && gpuPipelineState->gpuPipelineLayout &&
+        (dirtyGroups & (GLES3BindGroup::PIPELINE_STATE | GLES3BindGroup::DESCRIPTOR_SETS))) {
 
         size_t blockLen = gpuPipelineState->gpuShader->glBlocks.size();
         const vector<vector<int>> &dynamicOffsetIndices = gpuPipelineState->gpuPipelineLayout->dynamicOffsetIndices;
@@ -2046,7 +2073,8 @@ void GLES3CmdFuncBindState(GLES3Device *device, GLES3GPUPipelineState *gpuPipeli
         }
     } // if
 
-    if (gpuPipelineState && !gpuPipelineState->dynamicStates.empty()) {
+    if (gpuPipelineState && !gpuPipelineState->dynamicStates.empty() &&
+        (dirtyGroups & (GLES3BindGroup::PIPELINE_STATE | GLES3BindGroup::DYNAMIC_STATES))) {
         for (DynamicStateFlagBit dynamicState : gpuPipelineState->dynamicStates) {
             switch (dynamicState) {
                 case DynamicStateFlagBit::VIEWPORT:
@@ -2223,51 +2251,20 @@ void GLES3CmdFuncDraw(GLES3Device *device, DrawInfo &drawInfo) {
 }
 
 void GLES3CmdFuncUpdateBuffer(GLES3Device *device, GLES3GPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size) {
-    GLES3ObjectCache &gfxStateCache = device->stateCache()->gfxStateCache;
     if (gpuBuffer->usage & BufferUsageBit::INDIRECT) {
         memcpy((uint8_t *)gpuBuffer->indirects.data() + offset, buffer, size);
-    } else if (gpuBuffer->usage & BufferUsageBit::TRANSFER_SRC) {
+    } else if ((gpuBuffer->usage & BufferUsageBit::TRANSFER_SRC) && gpuBuffer->buffer) {
         memcpy((uint8_t *)gpuBuffer->buffer + offset, buffer, size);
-    } else {
-        switch (gpuBuffer->glTarget) {
-            case GL_ARRAY_BUFFER: {
-                if (device->stateCache()->glVAO) {
-                    GL_CHECK(glBindVertexArray(0));
-                    device->stateCache()->glVAO = 0;
-                    gfxStateCache.gpuInputAssembler = nullptr;
-                }
-                if (device->stateCache()->glArrayBuffer != gpuBuffer->glBuffer) {
-                    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, gpuBuffer->glBuffer));
-                    device->stateCache()->glArrayBuffer = gpuBuffer->glBuffer;
-                }
-                GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER, offset, size, buffer));
-                break;
-            }
-            case GL_ELEMENT_ARRAY_BUFFER: {
-                if (device->stateCache()->glVAO) {
-                    GL_CHECK(glBindVertexArray(0));
-                    device->stateCache()->glVAO = 0;
-                    gfxStateCache.gpuInputAssembler = nullptr;
-                }
-                if (device->stateCache()->glElementArrayBuffer != gpuBuffer->glBuffer) {
-                    GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpuBuffer->glBuffer));
-                    device->stateCache()->glElementArrayBuffer = gpuBuffer->glBuffer;
-                }
-                GL_CHECK(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, buffer));
-                break;
-            }
-            case GL_UNIFORM_BUFFER: {
-                if (device->stateCache()->glUniformBuffer != gpuBuffer->glBuffer) {
-                    GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, gpuBuffer->glBuffer));
-                    device->stateCache()->glUniformBuffer = gpuBuffer->glBuffer;
-                }
-                GL_CHECK(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, buffer));
-                break;
-            }
-            default:
-                CCASSERT(false, "Unsupported BufferType, update buffer failed.");
-                break;
+    } else if (gpuBuffer->glTarget != GL_NONE) {
+        // go through the copy targets, which are not part of the VAO state,
+        // so the currently bound VAO and buffer bindings stay untouched
+        GLES3UploadRing *uploadRing = device->uploadRing();
+        if (!uploadRing || !uploadRing->upload(gpuBuffer->glBuffer, offset, buffer, size)) {
+            GL_CHECK(glBindBuffer(GL_COPY_WRITE_BUFFER, gpuBuffer->glBuffer));
+            GL_CHECK(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, buffer));
         }
+    } else {
+        CCASSERT(false, "Unsupported BufferType, update buffer failed.");
     }
 }
 
@@ -2283,6 +2280,10 @@ void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const
 
     switch (gpuTexture->glTarget) {
         case GL_TEXTURE_2D: {
+            // stage through the upload ring so the driver can source the copy from a
+            // pixel unpack buffer instead of blocking on client memory
+            GLES3UploadRing *uploadRing = device->uploadRing();
+            bool unpackBound = false;
             uint w;
             uint h;
             for (size_t i = 0; i < count; ++i) {
@@ -2290,8 +2291,19 @@ void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const
                 w = region.texExtent.width;
                 h = region.texExtent.height;
                 const uint8_t *buff = buffers[n++];
+                GLsizei memSize = (GLsizei)FormatSize(gpuTexture->format, w, h, 1);
+                const uint offset = uploadRing ? uploadRing->stage(buff, memSize) : GLES3UploadRing::INVALID_OFFSET;
+                if (offset != GLES3UploadRing::INVALID_OFFSET) {
+                    if (!unpackBound) {
+                        GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadRing->getBuffer()));
+                        unpackBound = true;
+                    }
+                    buff = reinterpret_cast<const uint8_t *>(static_cast<uintptr_t>(offset));
+                } else if (unpackBound) {
+                    GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+                    unpackBound = false;
+                }
                 if (isCompressed) {
-                    GLsizei memSize = (GLsizei)FormatSize(gpuTexture->format, w, h, 1);
                     GL_CHECK(glCompressedTexSubImage2D(GL_TEXTURE_2D,
                                                        region.texSubres.mipLevel,
                                                        region.texOffset.x,
@@ -2311,6 +2323,9 @@ void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const
                                              (GLvoid *)buff));
                 }
             }
+            if (unpackBound) {
+                GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+            }
             break;
         }
         case GL_TEXTURE_2D_ARRAY: {
@@ -2433,6 +2448,127 @@ void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const
     }
 }
 
+void GLES3CmdFuncGetCopyBufferSizes(const GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count, vector<uint> &sizes) {
+    // the texture type is known up front, unlike the GL target assigned on creation
+    const bool isLayered = gpuTexture->type == TextureType::TEX2D_ARRAY || gpuTexture->type == TextureType::CUBE;
+    const bool isCompressed = GFX_FORMAT_INFOS[(int)gpuTexture->format].isCompressed;
+
+    sizes.clear();
+    for (uint i = 0u; i < count; ++i) {
+        const BufferTextureCopy &region = regions[i];
+        uint depth = 1u;
+        if (!isCompressed) {
+            if (gpuTexture->type == TextureType::TEX2D_ARRAY) depth = region.texSubres.layerCount;
+            if (gpuTexture->type == TextureType::TEX3D) depth = region.texExtent.depth;
+        }
+        const uint size = FormatSize(gpuTexture->format, region.texExtent.width, region.texExtent.height, depth);
+        sizes.insert(sizes.end(), isLayered ? region.texSubres.layerCount : 1u, size);
+    }
+}
+
+namespace {
+GLES3BindGroup diffBindStates(GLES3CmdBindStates *prev, GLES3CmdBindStates *cmd) {
+    GLES3BindGroup groups = GLES3BindGroup::NONE;
+    if (prev->gpuPipelineState != cmd->gpuPipelineState) {
+        groups |= GLES3BindGroup::PIPELINE_STATE;
+    }
+    if (prev->gpuDescriptorSets != cmd->gpuDescriptorSets ||
+        prev->dynamicOffsets != cmd->dynamicOffsets) {
+        groups |= GLES3BindGroup::DESCRIPTOR_SETS;
+    }
+    if (prev->gpuInputAssembler != cmd->gpuInputAssembler) {
+        groups |= GLES3BindGroup::INPUT_ASSEMBLER;
+    }
+    if (prev->viewport != cmd->viewport ||
+        prev->scissor != cmd->scissor ||
+        prev->lineWidth != cmd->lineWidth ||
+        prev->depthBiasEnabled != cmd->depthBiasEnabled ||
+        memcmp(&prev->depthBias, &cmd->depthBias, sizeof(GLES3DepthBias)) ||
+        memcmp(&prev->blendConstants, &cmd->blendConstants, sizeof(Color)) ||
+        memcmp(&prev->depthBounds, &cmd->depthBounds, sizeof(GLES3DepthBounds)) ||
+        prev->stencilWriteMask.face != cmd->stencilWriteMask.face ||
+        prev->stencilWriteMask.writeMask != cmd->stencilWriteMask.writeMask ||
+        prev->stencilCompareMask.face != cmd->stencilCompareMask.face ||
+        prev->stencilCompareMask.refrence != cmd->stencilCompareMask.refrence ||
+        prev->stencilCompareMask.compareMask != cmd->stencilCompareMask.compareMask) {
+        groups |= GLES3BindGroup::DYNAMIC_STATES;
+    }
+    return groups;
+}
+
+bool canMergeDraws(const GLES3CmdBindStates *bindStates, const DrawInfo &prev, const DrawInfo &draw) {
+    const GLES3GPUInputAssembler *gpuInputAssembler = bindStates->gpuInputAssembler;
+    if (!gpuInputAssembler || !gpuInputAssembler->gpuIndexBuffer || gpuInputAssembler->gpuIndirectBuffer) return false;
+
+    // only list primitives can be concatenated
+    const GLenum glPrimitive = bindStates->gpuPipelineState ? bindStates->gpuPipelineState->glPrimitive : GL_NONE;
+    if (glPrimitive != GL_TRIANGLES && glPrimitive != GL_LINES && glPrimitive != GL_POINTS) return false;
+
+    return prev.indexCount > 0 && draw.indexCount > 0 &&
+           prev.firstIndex + prev.indexCount == draw.firstIndex &&
+           prev.vertexOffset == draw.vertexOffset &&
+           prev.instanceCount == draw.instanceCount &&
+           prev.firstInstance == draw.firstInstance;
+}
+} // namespace
+
+// Drops bind-state commands identical to the bind before them, tags the survivors with the state groups
+// that actually changed and merges draws of the same input assembler over contiguous index ranges.
+// Only runs of binds and draws are considered, any other command may touch the GL state behind our back.
+void GLES3CmdFuncOptimizeCmds(GLES3GPUCommandAllocator *cmdAllocator, GLES3CmdPackage *cmdPackage) {
+    CachedArray<GFXCmdType> &cmds = cmdPackage->cmds;
+    CachedArray<GLES3CmdBindStates *> &bindStatesCmds = cmdPackage->bindStatesCmds;
+    CachedArray<GLES3CmdDraw *> &drawCmds = cmdPackage->drawCmds;
+
+    GLES3CmdBindStates *lastBindStates = nullptr;
+    GLES3CmdDraw *lastDraw = nullptr;
+    uint cmdCount = 0u, bindStatesCount = 0u, drawCount = 0u, removed = 0u;
+    uint bindStatesIdx = 0u, drawIdx = 0u;
+
+    for (uint i = 0u; i < cmds.size(); ++i) {
+        const GFXCmdType cmdType = cmds[i];
+        switch (cmdType) {
+            case GFXCmdType::BIND_STATES: {
+                GLES3CmdBindStates *cmd = bindStatesCmds[bindStatesIdx++];
+                cmd->dirtyGroups = lastBindStates ? diffBindStates(lastBindStates, cmd) : GLES3BindGroup::ALL;
+                if (cmd->dirtyGroups == GLES3BindGroup::NONE) {
+                    cmdAllocator->bindStatesCmdPool.free(cmd);
+                    ++removed;
+                    continue;
+                }
+                lastBindStates = cmd;
+                lastDraw = nullptr;
+                bindStatesCmds[bindStatesCount++] = cmd;
+                break;
+            }
+            case GFXCmdType::DRAW: {
+                GLES3CmdDraw *cmd = drawCmds[drawIdx++];
+                if (lastDraw && canMergeDraws(lastBindStates, lastDraw->drawInfo, cmd->drawInfo)) {
+                    lastDraw->drawInfo.indexCount += cmd->drawInfo.indexCount;
+                    cmdAllocator->drawCmdPool.free(cmd);
+                    ++removed;
+                    continue;
+                }
+                // the first draw of a run has to be kept as is, later ones may be merged into it
+                lastDraw = lastBindStates ? cmd : nullptr;
+                drawCmds[drawCount++] = cmd;
+                break;
+            }
+            default:
+                lastBindStates = nullptr;
+                lastDraw = nullptr;
+                break;
+        }
+        cmds[cmdCount++] = cmdType;
+    }
+
+    // every removed command lowered one of the counts below, so the arrays can be truncated in place
+    while (cmds.size() > cmdCount) cmds.pop();
+    while (bindStatesCmds.size() > bindStatesCount) bindStatesCmds.pop();
+    while (drawCmds.size() > drawCount) drawCmds.pop();
+    cmdPackage->numCoalescedCmds += removed;
+}
+
 void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
     if (!cmdPackage->cmds.size()) return;
 
@@ -2455,7 +2591,7 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
             }
             case GFXCmdType::BIND_STATES: {
                 GLES3CmdBindStates *cmd = cmdPackage->bindStatesCmds[cmdIdx];
-                GLES3CmdFuncBindState(device, cmd->gpuPipelineState, cmd->gpuInputAssembler, cmd->gpuDescriptorSets, cmd->dynamicOffsets, cmd->viewport, cmd->scissor, cmd->lineWidth, cmd->depthBiasEnabled, cmd->depthBias, cmd->blendConstants, cmd->depthBounds, cmd->stencilWriteMask, cmd->stencilCompareMask);
+                GLES3CmdFuncBindState(device, cmd->gpuPipelineState, cmd->gpuInputAssembler, cmd->gpuDescriptorSets, cmd->dynamicOffsets, cmd->viewport, cmd->scissor, cmd->lineWidth, cmd->depthBiasEnabled, cmd->depthBias, cmd->blendConstants, cmd->depthBounds, cmd->stencilWriteMask, cmd->stencilCompareMask, cmd->dirtyGroups);
                 break;
             } // case BIND_STATES
             case GFXCmdType::DRAW: {
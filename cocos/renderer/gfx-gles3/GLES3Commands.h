@@ -99,6 +99,17 @@ enum class GLES3State {
     COUNT,
 };
 
+// state groups of a GLES3CmdBindStates that differ from the bind before it in the same command run
+enum class GLES3BindGroup : uint {
+    NONE = 0x0,
+    PIPELINE_STATE = 0x1,
+    DESCRIPTOR_SETS = 0x2,
+    INPUT_ASSEMBLER = 0x4,
+    DYNAMIC_STATES = 0x8,
+    ALL = 0xf,
+};
+CC_ENUM_OPERATORS(GLES3BindGroup);
+
 class GLES3CmdBindStates final : public GFXCmd {
 public:
     GLES3GPUPipelineState *gpuPipelineState = nullptr;
@@ -114,6 +125,7 @@ public:
     GLES3DepthBounds depthBounds;
     GLES3StencilWriteMask stencilWriteMask;
     GLES3StencilCompareMask stencilCompareMask;
+    GLES3BindGroup dirtyGroups = GLES3BindGroup::ALL;
 
     GLES3CmdBindStates() : GFXCmd(GFXCmdType::BIND_STATES) {}
 
@@ -122,6 +134,7 @@ public:
         gpuInputAssembler = nullptr;
         gpuDescriptorSets.clear();
         dynamicOffsets.clear();
+        dirtyGroups = GLES3BindGroup::ALL;
     }
 };
 
@@ -139,6 +152,7 @@ public:
     uint8_t *buffer = nullptr;
     uint size = 0;
     uint offset = 0;
+    vector<uint8_t> data; // owned copy of the source while the device runs a render thread
 
     GLES3CmdUpdateBuffer() : GFXCmd(GFXCmdType::UPDATE_BUFFER) {}
 
@@ -154,6 +168,10 @@ public:
     const BufferTextureCopy *regions = nullptr;
     uint count = 0u;
     const uint8_t *const *buffers;
+    // owned copies of the sources while the device runs a render thread
+    vector<uint8_t> data;
+    BufferDataList dataBuffers;
+    BufferTextureCopyList dataRegions;
 
     GLES3CmdCopyBufferToTexture() : GFXCmd(GFXCmdType::COPY_BUFFER_TO_TEXTURE) {}
 
@@ -173,6 +191,7 @@ public:
     CachedArray<GLES3CmdDraw *> drawCmds;
     CachedArray<GLES3CmdUpdateBuffer *> updateBufferCmds;
     CachedArray<GLES3CmdCopyBufferToTexture *> copyBufferToTextureCmds;
+    uint numCoalescedCmds = 0u; // bind and draw commands removed by GLES3CmdFuncOptimizeCmds
 };
 
 class GLES3GPUCommandAllocator final : public Object {
@@ -201,6 +220,7 @@ public:
         }
 
         cmd_package->cmds.clear();
+        cmd_package->numCoalescedCmds = 0u;
     }
 
     CC_INLINE void reset() {
@@ -233,11 +253,15 @@ CC_GLES3_API void GLES3CmdFuncEndRenderPass(GLES3Device *device);
 CC_GLES3_API void GLES3CmdFuncBindState(GLES3Device *device, GLES3GPUPipelineState *gpuPipelineState, GLES3GPUInputAssembler *gpuInputAssembler,
                                         vector<GLES3GPUDescriptorSet *> &gpuDescriptorSets, vector<uint> &dynamicOffsets,
                                         Viewport &viewport, Rect &scissor, float lineWidth, bool depthBiasEnabled, GLES3DepthBias &depthBias, Color &blendConstants,
-                                        GLES3DepthBounds &depthBounds, GLES3StencilWriteMask &stencilWriteMask, GLES3StencilCompareMask &stencilCompareMask);
+                                        GLES3DepthBounds &depthBounds, GLES3StencilWriteMask &stencilWriteMask, GLES3StencilCompareMask &stencilCompareMask,
+                                        GLES3BindGroup dirtyGroups = GLES3BindGroup::ALL);
 CC_GLES3_API void GLES3CmdFuncDraw(GLES3Device *device, DrawInfo &drawInfo);
 CC_GLES3_API void GLES3CmdFuncUpdateBuffer(GLES3Device *device, GLES3GPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size);
 CC_GLES3_API void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const *buffers,
                                                    GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count);
+// bytes GLES3CmdFuncCopyBuffersToTexture reads from each source buffer, in the order it reads them
+CC_GLES3_API void GLES3CmdFuncGetCopyBufferSizes(const GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count, vector<uint> &sizes);
+CC_GLES3_API void GLES3CmdFuncOptimizeCmds(GLES3GPUCommandAllocator *cmdAllocator, GLES3CmdPackage *cmdPackage);
 CC_GLES3_API void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage);
 
 } // namespace gfx
@@ -259,32 +259,40 @@ bool GLES3Context::initialize(const ContextInfo &info) {
         _eglSharedContext = _eglContext;
 
     #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
+        // the surface belongs to the thread the GL work runs on, the render thread while multithreaded
         EventDispatcher::addCustomEventListener(EVENT_DESTROY_WINDOW, [=](const CustomEvent &) -> void {
-            if (_eglSurface != EGL_NO_SURFACE) {
-                eglDestroySurface(_eglDisplay, _eglSurface);
-                _eglSurface = EGL_NO_SURFACE;
-            }
+            _device->enqueue([=]() {
+                if (_eglSurface != EGL_NO_SURFACE) {
+                    eglDestroySurface(_eglDisplay, _eglSurface);
+                    _eglSurface = EGL_NO_SURFACE;
+                }
+            });
+            // the window goes away once the event returns
+            _device->flushRenderThread();
         });
 
         EventDispatcher::addCustomEventListener(EVENT_RECREATE_WINDOW, [=](const CustomEvent &event) -> void {
-            _windowHandle = (uintptr_t)event.args->ptrVal;
-
-            EGLint nFmt;
-            if (eglGetConfigAttrib(_eglDisplay, _eglConfig, EGL_NATIVE_VISUAL_ID, &nFmt) == EGL_FALSE) {
-                CC_LOG_ERROR("Getting configuration attributes failed.");
-                return;
-            }
-            uint width = _device->getWidth();
-            uint height = _device->getHeight();
-            ANativeWindow_setBuffersGeometry((ANativeWindow *)_windowHandle, width, height, nFmt);
-
-            EGL_CHECK(_eglSurface = eglCreateWindowSurface(_eglDisplay, _eglConfig, (EGLNativeWindowType)_windowHandle, NULL));
-            if (_eglSurface == EGL_NO_SURFACE) {
-                CC_LOG_ERROR("Recreate window surface failed.");
-                return;
-            }
+            const uintptr_t windowHandle = (uintptr_t)event.args->ptrVal;
+            _device->enqueue([=]() {
+                _windowHandle = windowHandle;
+
+                EGLint nFmt;
+                if (eglGetConfigAttrib(_eglDisplay, _eglConfig, EGL_NATIVE_VISUAL_ID, &nFmt) == EGL_FALSE) {
+                    CC_LOG_ERROR("Getting configuration attributes failed.");
+                    return;
+                }
+                uint width = _device->getWidth();
+                uint height = _device->getHeight();
+                ANativeWindow_setBuffersGeometry((ANativeWindow *)_windowHandle, width, height, nFmt);
+
+                EGL_CHECK(_eglSurface = eglCreateWindowSurface(_eglDisplay, _eglConfig, (EGLNativeWindowType)_windowHandle, NULL));
+                if (_eglSurface == EGL_NO_SURFACE) {
+                    CC_LOG_ERROR("Recreate window surface failed.");
+                    return;
+                }
 
-            ((GLES3Context *)_device->getContext())->MakeCurrent();
+                ((GLES3Context *)_device->getContext())->MakeCurrent();
+            });
         });
     #endif
 
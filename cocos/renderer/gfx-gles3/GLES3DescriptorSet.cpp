@@ -68,33 +68,49 @@ bool GLES3DescriptorSet::initialize(const DescriptorSetInfo &info) {
 
 void GLES3DescriptorSet::destroy() {
     if (_gpuDescriptorSet) {
-        CC_DELETE(_gpuDescriptorSet);
+        // commands enqueued earlier may still read it
+        GLES3GPUDescriptorSet *gpuDescriptorSet = _gpuDescriptorSet;
+        _device->enqueue([gpuDescriptorSet]() { CC_DELETE(gpuDescriptorSet); });
         _gpuDescriptorSet = nullptr;
     }
     // do remember to clear these or else it might not be properly updated when reused
     _buffers.clear();
     _textures.clear();
     _samplers.clear();
+    _dirtyMasks.clear();
 }
 
 void GLES3DescriptorSet::update() {
     if (_isDirty && _gpuDescriptorSet) {
-        const GLES3GPUDescriptorList &descriptors = _gpuDescriptorSet->gpuDescriptors;
-        for (size_t i = 0; i < descriptors.size(); i++) {
+        // the descriptors are read wherever the GL work runs, so they are written there as well,
+        // null entries of a write leave the descriptor as it is
+        GLES3GPUDescriptorSet *gpuDescriptorSet = _gpuDescriptorSet;
+        const GLES3GPUDescriptorList &descriptors = gpuDescriptorSet->gpuDescriptors;
+        vector<std::pair<uint, GLES3GPUDescriptor>> writes;
+        consumeDirtyDescriptors([&](uint i) {
+            GLES3GPUDescriptor write;
             if ((uint)descriptors[i].type & DESCRIPTOR_BUFFER_TYPE) {
                 if (_buffers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuBuffer = ((GLES3Buffer *)_buffers[i])->gpuBuffer();
+                    write.gpuBuffer = ((GLES3Buffer *)_buffers[i])->gpuBuffer();
                 }
             } else if ((uint)descriptors[i].type & DESCRIPTOR_SAMPLER_TYPE) {
                 if (_textures[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuTexture = ((GLES3Texture *)_textures[i])->gpuTexture();
+                    write.gpuTexture = ((GLES3Texture *)_textures[i])->gpuTexture();
                 }
                 if (_samplers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuSampler = ((GLES3Sampler *)_samplers[i])->gpuSampler();
+                    write.gpuSampler = ((GLES3Sampler *)_samplers[i])->gpuSampler();
                 }
             }
-        }
-        _isDirty = false;
+            writes.emplace_back(i, write);
+        });
+        _device->enqueue([gpuDescriptorSet, writes = std::move(writes)]() {
+            for (const auto &write : writes) {
+                GLES3GPUDescriptor &descriptor = gpuDescriptorSet->gpuDescriptors[write.first];
+                if (write.second.gpuBuffer) descriptor.gpuBuffer = write.second.gpuBuffer;
+                if (write.second.gpuTexture) descriptor.gpuTexture = write.second.gpuTexture;
+                if (write.second.gpuSampler) descriptor.gpuSampler = write.second.gpuSampler;
+            }
+        });
     }
 }
 
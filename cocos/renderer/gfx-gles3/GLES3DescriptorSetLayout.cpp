@@ -80,7 +80,9 @@ bool GLES3DescriptorSetLayout::initialize(const DescriptorSetLayoutInfo &info) {
 
 void GLES3DescriptorSetLayout::destroy() {
     if (_gpuDescriptorSetLayout) {
-        CC_DELETE(_gpuDescriptorSetLayout);
+        // commands enqueued earlier may still read it
+        GLES3GPUDescriptorSetLayout *gpuDescriptorSetLayout = _gpuDescriptorSetLayout;
+        _device->enqueue([gpuDescriptorSetLayout]() { CC_DELETE(gpuDescriptorSetLayout); });
         _gpuDescriptorSetLayout = nullptr;
     }
 }
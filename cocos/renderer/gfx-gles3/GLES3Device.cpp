@@ -35,11 +35,15 @@ THE SOFTWARE.
 #include "GLES3PipelineLayout.h"
 #include "GLES3PipelineState.h"
 #include "GLES3PrimaryCommandBuffer.h"
+#include "GLES3ProgramCache.h"
 #include "GLES3Queue.h"
 #include "GLES3RenderPass.h"
 #include "GLES3Sampler.h"
 #include "GLES3Shader.h"
 #include "GLES3Texture.h"
+#include "GLES3TimestampPool.h"
+#include "GLES3UploadRing.h"
+#include "platform/FileUtils.h"
 
 namespace cc {
 namespace gfx {
@@ -171,12 +175,30 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
 
     _gpuStateCache->initialize(_maxTextureUnits, _maxUniformBufferBindings, _maxVertexAttributes);
 
+    _uploadRing = CC_NEW(GLES3UploadRing);
+    _uploadRing->initialize();
+
+    _programCache = CC_NEW(GLES3ProgramCache);
+    if (!_programCache->initialize(FileUtils::getInstance()->getWritablePath() + "gles3-program-cache.bin", _renderer + "|" + _version)) {
+        CC_SAFE_DESTROY(_programCache);
+    }
+
+    if (checkExtension("disjoint_timer_query")) {
+        _timestampPool = CC_NEW(GLES3TimestampPool);
+        _timestampPool->initialize();
+    }
+
     return true;
 }
 
 void GLES3Device::destroy() {
+    setMultithreaded(false);
+    _textureStreamer->destroy();
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
+    CC_SAFE_DESTROY(_programCache);
+    CC_SAFE_DESTROY(_uploadRing);
+    CC_SAFE_DESTROY(_timestampPool);
     CC_SAFE_DELETE(_gpuStagingBufferPool);
     CC_SAFE_DELETE(_gpuStateCache);
     CC_SAFE_DESTROY(_deviceContext);
@@ -189,21 +211,64 @@ void GLES3Device::resize(uint width, uint height) {
 }
 
 void GLES3Device::acquire() {
-    _gpuStagingBufferPool->reset();
+    if (_renderThread) _renderThread->beginFrame();
+
+    enqueue([this]() {
+        _gpuStagingBufferPool->reset();
+        _uploadRing->beginFrame();
+    });
+
+    // timestamps are read back here on the main thread, so GPU timings pause while multithreaded
+    if (_timestampPool && !_renderThread) _timestampPool->resolve(_profiler);
+    _profiler->beginFrame();
+
+    _textureStreamer->update();
 }
 
 void GLES3Device::present() {
+    _profiler->endFrame();
+
     GLES3Queue *queue = (GLES3Queue *)_queue;
     _numDrawCalls = queue->_numDrawCalls;
     _numInstances = queue->_numInstances;
     _numTriangles = queue->_numTriangles;
-
-    _context->present();
+    _numUploadBytes = queue->_numUploadBytes;
+    _numDescriptorWrites = _descriptorWriteCount;
+    _descriptorWriteCount = 0u;
+    memcpy(_numLODTriangles, _lodTriangleCount, sizeof(_numLODTriangles));
+    memset(_lodTriangleCount, 0, sizeof(_lodTriangleCount));
+    _numCoalescedCommands = _coalescedCommandCount;
+    _coalescedCommandCount = 0u;
+
+    enqueue([this]() {
+        _uploadRing->endFrame();
+        _context->present();
+
+        if (_programCache) _programCache->tick();
+    });
+    if (_renderThread) _renderThread->endFrame();
 
     // Clear queue stats
     queue->_numDrawCalls = 0;
     queue->_numInstances = 0;
     queue->_numTriangles = 0;
+    queue->_numUploadBytes = 0;
+}
+
+void GLES3Device::setMultithreaded(bool multithreaded) {
+    if (multithreaded == isMultithreaded()) return;
+
+    if (multithreaded) {
+        // the render context moves over to the render thread, the main thread keeps no GL access
+        _renderContext->MakeCurrent(false);
+        _renderThread = CC_NEW(RenderThread);
+        _renderThread->start([this]() { _renderContext->MakeCurrent(true); },
+                             [this]() { _renderContext->MakeCurrent(false); });
+    } else {
+        _renderThread->stop();
+        CC_SAFE_DELETE(_renderThread);
+        _renderContext->MakeCurrent(true);
+    }
 }
 
 void GLES3Device::bindRenderContext(bool bound) {
@@ -290,7 +355,24 @@ PipelineState *GLES3Device::createPipelineState() {
 }
 
 void GLES3Device::copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) {
-    GLES3CmdFuncCopyBuffersToTexture(this, buffers, ((GLES3Texture *)dst)->gpuTexture(), regions, count);
+    GLES3GPUTexture *gpuTexture = ((GLES3Texture *)dst)->gpuTexture();
+    const uint8_t *const *stagedBuffers = stageBuffersToTexture(buffers, gpuTexture, regions, count);
+    const BufferTextureCopy *stagedRegions = (const BufferTextureCopy *)stage(regions, count * sizeof(BufferTextureCopy));
+    enqueue([=]() {
+        GLES3CmdFuncCopyBuffersToTexture(this, stagedBuffers, gpuTexture, stagedRegions, count);
+    });
+}
+
+const uint8_t *const *GLES3Device::stageBuffersToTexture(const uint8_t *const *buffers, const GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count) {
+    if (!_renderThread) return buffers;
+
+    GLES3CmdFuncGetCopyBufferSizes(gpuTexture, regions, count, _copyBufferSizes);
+    const uint bufferCount = static_cast<uint>(_copyBufferSizes.size());
+    const uint8_t **stagedBuffers = (const uint8_t **)_renderThread->allocate(bufferCount * sizeof(const uint8_t *));
+    for (uint i = 0u; i < bufferCount; ++i) {
+        stagedBuffers[i] = (const uint8_t *)_renderThread->stage(buffers[i], _copyBufferSizes[i]);
+    }
+    return stagedBuffers;
 }
 
 } // namespace gfx
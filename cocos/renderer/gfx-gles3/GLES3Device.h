@@ -28,8 +28,12 @@ namespace cc {
 namespace gfx {
 
 class GLES3Context;
+class GLES3GPUTexture;
 class GLES3GPUStateCache;
 class GLES3GPUStagingBufferPool;
+class GLES3ProgramCache;
+class GLES3UploadRing;
+class GLES3TimestampPool;
 
 class CC_GLES3_API GLES3Device final : public Device {
 public:
@@ -57,9 +61,13 @@ public:
     virtual void resize(uint width, uint height) override;
     virtual void acquire() override;
     virtual void present() override;
+    virtual void setMultithreaded(bool multithreaded) override;
 
     CC_INLINE GLES3GPUStateCache *stateCache() const { return _gpuStateCache; }
     CC_INLINE GLES3GPUStagingBufferPool *stagingBufferPool() const { return _gpuStagingBufferPool; }
+    CC_INLINE GLES3ProgramCache *programCache() const { return _programCache; }
+    CC_INLINE GLES3UploadRing *uploadRing() const { return _uploadRing; }
+    CC_INLINE GLES3TimestampPool *timestampPool() const { return _timestampPool; }
 
     CC_INLINE bool checkExtension(const String &extension) const {
         for (size_t i = 0; i < _extensions.size(); ++i) {
@@ -72,6 +80,12 @@ public:
 
     CC_INLINE uint getThreadID() const { return _threadID; }
 
+    // bind and draw commands dropped from command packages before they were replayed
+    CC_INLINE void recordCoalescedCommands(uint count) { _coalescedCommandCount += count; }
+
+    // copies the source buffers of a texture upload for the render thread, returns buffers as is while single threaded
+    const uint8_t *const *stageBuffersToTexture(const uint8_t *const *buffers, const GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count);
+
 protected:
     virtual CommandBuffer *doCreateCommandBuffer(const CommandBufferInfo &info, bool hasAgent) override;
     virtual Fence *createFence() override;
@@ -97,10 +111,15 @@ private:
     GLES3Context *_deviceContext = nullptr;
     GLES3GPUStateCache *_gpuStateCache = nullptr;
     GLES3GPUStagingBufferPool *_gpuStagingBufferPool = nullptr;
+    GLES3ProgramCache *_programCache = nullptr;
+    GLES3UploadRing *_uploadRing = nullptr;
+    GLES3TimestampPool *_timestampPool = nullptr;
 
     StringArray _extensions;
 
     uint _threadID = 0u;
+    uint _coalescedCommandCount = 0u;
+    vector<uint> _copyBufferSizes;
 };
 
 } // namespace gfx
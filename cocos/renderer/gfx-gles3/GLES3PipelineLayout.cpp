@@ -71,7 +71,9 @@ bool GLES3PipelineLayout::initialize(const PipelineLayoutInfo &info) {
 void GLES3PipelineLayout::destroy() {
 
     if (_gpuPipelineLayout) {
-        CC_DELETE(_gpuPipelineLayout);
+        // commands enqueued earlier may still read it
+        GLES3GPUPipelineLayout *gpuPipelineLayout = _gpuPipelineLayout;
+        _device->enqueue([gpuPipelineLayout]() { CC_DELETE(gpuPipelineLayout); });
         _gpuPipelineLayout = nullptr;
     }
 }
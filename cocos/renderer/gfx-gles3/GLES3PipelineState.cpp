@@ -88,7 +88,9 @@ bool GLES3PipelineState::initialize(const PipelineStateInfo &info) {
 
 void GLES3PipelineState::destroy() {
     if (_gpuPipelineState) {
-        CC_DELETE(_gpuPipelineState);
+        // commands enqueued earlier may still read it
+        GLES3GPUPipelineState *gpuPipelineState = _gpuPipelineState;
+        _device->enqueue([gpuPipelineState]() { CC_DELETE(gpuPipelineState); });
         _gpuPipelineState = nullptr;
     }
 }
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "GLES3PrimaryCommandBuffer.h"
 #include "GLES3RenderPass.h"
 #include "GLES3Texture.h"
+#include "GLES3TimestampPool.h"
 
 namespace cc {
 namespace gfx {
@@ -45,15 +46,27 @@ GLES3PrimaryCommandBuffer::~GLES3PrimaryCommandBuffer() {
 
 void GLES3PrimaryCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, bool fromSecondaryCB) {
     _isInRenderPass = true;
+    _isStateInvalid = true; // render pass setup may have overridden the dynamic states
+    GLES3Device *device = (GLES3Device *)_device;
     GLES3GPURenderPass *gpuRenderPass = ((GLES3RenderPass *)renderPass)->gpuRenderPass();
     GLES3GPUFramebuffer *gpuFramebuffer = ((GLES3Framebuffer *)fbo)->gpuFBO();
+    const size_t numClearColors = gpuRenderPass->colorAttachments.size();
+    std::array<Color, GFX_MAX_ATTACHMENTS> clearColors;
+    for (size_t i = 0; i < numClearColors; ++i) {
+        clearColors[i] = colors[i];
+    }
 
-    GLES3CmdFuncBeginRenderPass((GLES3Device *)_device, gpuRenderPass, gpuFramebuffer,
-                                renderArea, gpuRenderPass->colorAttachments.size(), colors, depth, stencil);
+    _device->enqueue([=]() {
+        GLES3CmdFuncBeginRenderPass(device, gpuRenderPass, gpuFramebuffer,
+                                    renderArea, numClearColors, clearColors.data(), depth, stencil);
+    });
 }
 
 void GLES3PrimaryCommandBuffer::endRenderPass() {
-    GLES3CmdFuncEndRenderPass((GLES3Device *)_device);
+    GLES3Device *device = (GLES3Device *)_device;
+    _device->enqueue([device]() {
+        GLES3CmdFuncEndRenderPass(device);
+    });
     _isInRenderPass = false;
 }
 
@@ -61,6 +74,7 @@ void GLES3PrimaryCommandBuffer::draw(InputAssembler *ia) {
     if ((_type == CommandBufferType::PRIMARY && _isInRenderPass) ||
         (_type == CommandBufferType::SECONDARY)) {
 
+        GLES3Device *device = (GLES3Device *)_device;
         if (_isStateInvalid) {
             vector<uint> &dynamicOffsetOffsets = _curGPUPipelineState->gpuPipelineLayout->dynamicOffsetOffsets;
             vector<uint> &dynamicOffsets = _curGPUPipelineState->gpuPipelineLayout->dynamicOffsets;
@@ -70,15 +84,23 @@ void GLES3PrimaryCommandBuffer::draw(InputAssembler *ia) {
                 count = std::min(count, _curDynamicOffsets[i].size());
                 if (count) memcpy(&dynamicOffsets[dynamicOffsetOffsets[i]], _curDynamicOffsets[i].data(), count * sizeof(uint));
             }
-            GLES3CmdFuncBindState((GLES3Device *)_device, _curGPUPipelineState, _curGPUInputAssember, _curGPUDescriptorSets, dynamicOffsets,
-                                  _curViewport, _curScissor, _curLineWidth, false, _curDepthBias, _curBlendConstants, _curDepthBounds, _curStencilWriteMask, _curStencilCompareMask);
+            // the bind captures copies of the current states, they keep changing while it waits for the render thread
+            _device->enqueue([device, gpuPipelineState = _curGPUPipelineState, gpuInputAssembler = _curGPUInputAssember,
+                              gpuDescriptorSets = _curGPUDescriptorSets, dynamicOffsets, viewport = _curViewport, scissor = _curScissor,
+                              lineWidth = _curLineWidth, depthBias = _curDepthBias, blendConstants = _curBlendConstants, depthBounds = _curDepthBounds,
+                              stencilWriteMask = _curStencilWriteMask, stencilCompareMask = _curStencilCompareMask]() mutable {
+                GLES3CmdFuncBindState(device, gpuPipelineState, gpuInputAssembler, gpuDescriptorSets, dynamicOffsets,
+                                      viewport, scissor, lineWidth, false, depthBias, blendConstants, depthBounds, stencilWriteMask, stencilCompareMask);
+            });
 
             _isStateInvalid = false;
         }
 
         DrawInfo drawInfo;
         ia->extractDrawInfo(drawInfo);
-        GLES3CmdFuncDraw((GLES3Device *)_device, drawInfo);
+        _device->enqueue([device, drawInfo]() mutable {
+            GLES3CmdFuncDraw(device, drawInfo);
+        });
 
         ++_numDrawCalls;
         _numInstances += ia->getInstanceCount();
@@ -108,7 +130,12 @@ void GLES3PrimaryCommandBuffer::updateBuffer(Buffer *buff, const void *data, uin
 
         GLES3GPUBuffer *gpuBuffer = ((GLES3Buffer *)buff)->gpuBuffer();
         if (gpuBuffer) {
-            GLES3CmdFuncUpdateBuffer((GLES3Device *)_device, gpuBuffer, data, 0u, size);
+            GLES3Device *device = (GLES3Device *)_device;
+            const void *stagedData = _device->stage(data, size);
+            _device->enqueue([device, gpuBuffer, stagedData, size]() {
+                GLES3CmdFuncUpdateBuffer(device, gpuBuffer, stagedData, 0u, size);
+            });
+            _numUploadBytes += size;
         }
     } else {
         CC_LOG_ERROR("Command 'updateBuffer' must be recorded outside a render pass.");
@@ -121,7 +148,12 @@ void GLES3PrimaryCommandBuffer::copyBuffersToTexture(const uint8_t *const *buffe
 
         GLES3GPUTexture *gpuTexture = ((GLES3Texture *)texture)->gpuTexture();
         if (gpuTexture) {
-            GLES3CmdFuncCopyBuffersToTexture((GLES3Device *)_device, buffers, gpuTexture, regions, count);
+            GLES3Device *device = (GLES3Device *)_device;
+            const uint8_t *const *stagedBuffers = device->stageBuffersToTexture(buffers, gpuTexture, regions, count);
+            const BufferTextureCopy *stagedRegions = (const BufferTextureCopy *)_device->stage(regions, count * sizeof(BufferTextureCopy));
+            _device->enqueue([device, stagedBuffers, gpuTexture, stagedRegions, count]() {
+                GLES3CmdFuncCopyBuffersToTexture(device, stagedBuffers, gpuTexture, stagedRegions, count);
+            });
         }
     } else {
         CC_LOG_ERROR("Command 'copyBuffersToTexture' must be recorded outside a render pass.");
@@ -132,17 +164,28 @@ void GLES3PrimaryCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, ui
     for (uint i = 0; i < count; ++i) {
         GLES3PrimaryCommandBuffer *cmdBuff = (GLES3PrimaryCommandBuffer *)cmdBuffs[i];
         GLES3CmdPackage *cmdPackage = cmdBuff->_pendingPackages.front();
+        GLES3Device *device = (GLES3Device *)_device;
 
-        GLES3CmdFuncExecuteCmds((GLES3Device *)_device, cmdPackage);
+        device->recordCoalescedCommands(cmdPackage->numCoalescedCmds);
+        _device->enqueue([device, cmdPackage]() {
+            GLES3CmdFuncExecuteCmds(device, cmdPackage);
+        });
 
         _numDrawCalls += cmdBuff->_numDrawCalls;
         _numInstances += cmdBuff->_numInstances;
         _numTriangles += cmdBuff->_numTriangles;
+        _numUploadBytes += cmdBuff->_numUploadBytes;
 
         cmdBuff->_pendingPackages.pop();
-        cmdBuff->_freePackages.push(cmdPackage);
+        cmdBuff->recyclePackage(cmdPackage);
     }
 }
 
+void GLES3PrimaryCommandBuffer::writeTimestamp(uint slot, uint query) {
+    // results are resolved on the main thread, which has no GL access while multithreaded
+    GLES3TimestampPool *timestampPool = ((GLES3Device *)_device)->timestampPool();
+    if (timestampPool && !_device->isMultithreaded()) timestampPool->write(slot, query);
+}
+
 } // namespace gfx
 } // namespace cc
@@ -42,6 +42,9 @@ public:
     virtual void updateBuffer(Buffer *buff, const void *data, uint size) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) override;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) override;
+
+protected:
+    virtual void writeTimestamp(uint slot, uint query) override;
 };
 
 } // namespace gfx
@@ -0,0 +1,260 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "GLES3Std.h"
+
+#include "GLES3GPUObjects.h"
+#include "GLES3ProgramCache.h"
+#include "base/ThreadPool.h"
+
+#include <cstdio>
+#include <memory>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr uint PROGRAM_CACHE_MAGIC = 0x43425047u; // 'GPBC'
+constexpr uint PROGRAM_CACHE_VERSION = 1u;
+
+uint64_t hashBytes(const void *data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0u; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint computeChecksum(const vector<uint8_t> &data) {
+    return static_cast<uint>(hashBytes(data.data(), data.size()));
+}
+
+template <typename T>
+void writeValue(vector<uint8_t> &data, const T &value) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readValue(const vector<uint8_t> &data, size_t &offset, T &value) {
+    if (offset + sizeof(T) > data.size()) return false;
+    memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+bool readBytes(const vector<uint8_t> &data, size_t &offset, size_t size, vector<uint8_t> &out) {
+    if (offset + size > data.size()) return false;
+    out.assign(data.begin() + offset, data.begin() + offset + size);
+    offset += size;
+    return true;
+}
+
+void writeFile(const String &path, const vector<uint8_t> &data) {
+    // write to a temporary file first so an interrupted save never leaves a torn cache behind
+    const String tempPath = path + ".tmp";
+    FILE *file = fopen(tempPath.c_str(), "wb");
+    bool succeeded = file != nullptr;
+    if (file) {
+        succeeded = fwrite(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+    }
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    remove(path.c_str()); // rename doesn't replace existing files here
+#endif
+    if (!succeeded || rename(tempPath.c_str(), path.c_str())) {
+        remove(tempPath.c_str());
+        CC_LOG_WARNING("Failed to save program cache: %s", path.c_str());
+    }
+}
+} // namespace
+
+GLES3ProgramCache::GLES3ProgramCache()
+: Object() {
+}
+
+GLES3ProgramCache::~GLES3ProgramCache() {
+}
+
+bool GLES3ProgramCache::initialize(const String &path, const String &driverKey) {
+    _path = path;
+    _driverKey = driverKey;
+
+    GLint formatCount = 0;
+    GL_CHECK(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+    if (formatCount <= 0) {
+        CC_LOG_INFO("Program binaries are not supported by this driver.");
+        return false;
+    }
+
+    _threadPool = ThreadPool::newSingleThreadPool();
+
+    vector<uint8_t> data;
+    if (FILE *file = fopen(_path.c_str(), "rb")) {
+        fseek(file, 0, SEEK_END);
+        const long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (size > 0) {
+            data.resize(static_cast<size_t>(size));
+            if (fread(data.data(), 1, data.size(), file) != data.size()) {
+                data.clear();
+            }
+        }
+        fclose(file);
+    }
+    if (data.empty()) return true;
+
+    size_t offset = 0u;
+    uint magic = 0u, version = 0u, keySize = 0u, count = 0u;
+    vector<uint8_t> fileDriverKey;
+    if (!readValue(data, offset, magic) || magic != PROGRAM_CACHE_MAGIC ||
+        !readValue(data, offset, version) || version != PROGRAM_CACHE_VERSION ||
+        !readValue(data, offset, keySize) || !readBytes(data, offset, keySize, fileDriverKey) ||
+        String(fileDriverKey.begin(), fileDriverKey.end()) != _driverKey ||
+        !readValue(data, offset, count)) {
+        CC_LOG_INFO("Discarding stale program cache: %s", _path.c_str());
+        _dirty = true;
+        return true;
+    }
+
+    for (uint i = 0u; i < count; ++i) {
+        uint64_t key = 0u;
+        uint size = 0u, checksum = 0u;
+        Entry entry;
+        if (!readValue(data, offset, key) || !readValue(data, offset, entry.format) ||
+            !readValue(data, offset, size) || !readValue(data, offset, checksum) ||
+            !readBytes(data, offset, size, entry.binary)) {
+            CC_LOG_WARNING("Truncated program cache: %s", _path.c_str());
+            _dirty = true;
+            break;
+        }
+        if (computeChecksum(entry.binary) != checksum) {
+            _dirty = true;
+            continue;
+        }
+        _entries[key] = std::move(entry);
+    }
+
+    return true;
+}
+
+void GLES3ProgramCache::destroy() {
+    CC_SAFE_DELETE(_threadPool);
+    if (_dirty) save(false);
+    _entries.clear();
+}
+
+uint64_t GLES3ProgramCache::computeKey(const GLES3GPUShader *gpuShader) const {
+    uint64_t hash = hashBytes(&PROGRAM_CACHE_VERSION, sizeof(PROGRAM_CACHE_VERSION));
+    for (const GLES3GPUShaderStage &gpuStage : gpuShader->gpuStages) {
+        hash = hashBytes(&gpuStage.type, sizeof(gpuStage.type), hash);
+        const uint size = static_cast<uint>(gpuStage.source.size());
+        hash = hashBytes(&size, sizeof(size), hash);
+        hash = hashBytes(gpuStage.source.data(), gpuStage.source.size(), hash);
+    }
+    return hash;
+}
+
+bool GLES3ProgramCache::loadProgram(uint64_t key, GLES3GPUShader *gpuShader) {
+    auto iter = _entries.find(key);
+    if (iter == _entries.end()) {
+        ++_missCount;
+        return false;
+    }
+
+    const Entry &entry = iter->second;
+    GLint status = GL_FALSE;
+    GL_CHECK(gpuShader->glProgram = glCreateProgram());
+    // a driver update may invalidate binaries without changing the version string,
+    // so errors here are expected and shouldn't trip GL_CHECK
+    glProgramBinary(gpuShader->glProgram, entry.format, entry.binary.data(), static_cast<GLsizei>(entry.binary.size()));
+    glGetError();
+    GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status));
+
+    if (status != GL_TRUE) {
+        GL_CHECK(glDeleteProgram(gpuShader->glProgram));
+        gpuShader->glProgram = 0;
+        _entries.erase(iter);
+        _dirty = true;
+        ++_rejectCount;
+        ++_missCount;
+        return false;
+    }
+
+    ++_hitCount;
+    return true;
+}
+
+void GLES3ProgramCache::storeProgram(uint64_t key, const GLES3GPUShader *gpuShader, uint compileTime) {
+    _compileTime += compileTime;
+
+    GLint length = 0;
+    GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) return;
+
+    Entry entry;
+    entry.binary.resize(static_cast<size_t>(length));
+    GL_CHECK(glGetProgramBinary(gpuShader->glProgram, length, &length, &entry.format, entry.binary.data()));
+    entry.binary.resize(static_cast<size_t>(length));
+
+    _entries[key] = std::move(entry);
+    _dirty = true;
+}
+
+void GLES3ProgramCache::tick() {
+    if (++_frameCount < SAVE_INTERVAL) return;
+    _frameCount = 0u;
+
+    if (_dirty && !_saving) save(true);
+}
+
+void GLES3ProgramCache::save(bool async) {
+    auto data = std::make_shared<vector<uint8_t>>();
+    writeValue(*data, PROGRAM_CACHE_MAGIC);
+    writeValue(*data, PROGRAM_CACHE_VERSION);
+    writeValue(*data, static_cast<uint>(_driverKey.size()));
+    data->insert(data->end(), _driverKey.begin(), _driverKey.end());
+    writeValue(*data, static_cast<uint>(_entries.size()));
+    for (const auto &iter : _entries) {
+        writeValue(*data, iter.first);
+        writeValue(*data, iter.second.format);
+        writeValue(*data, static_cast<uint>(iter.second.binary.size()));
+        writeValue(*data, computeChecksum(iter.second.binary));
+        data->insert(data->end(), iter.second.binary.begin(), iter.second.binary.end());
+    }
+    _dirty = false;
+
+    if (async && _threadPool) {
+        _saving = true;
+        _threadPool->pushTask([this, data](int /*threadId*/) {
+            writeFile(_path, *data);
+            _saving = false;
+        });
+    } else {
+        writeFile(_path, *data);
+    }
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,90 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_GFXGLES3_PROGRAM_CACHE_H_
+#define CC_GFXGLES3_PROGRAM_CACHE_H_
+
+#include <atomic>
+
+namespace cc {
+class ThreadPool;
+
+namespace gfx {
+
+class GLES3GPUShader;
+
+// Persists linked program binaries across launches so shaders don't need to be
+// compiled from source again. Entries are keyed by the hash of the shader sources,
+// and the whole cache is discarded whenever the driver renderer/version changes.
+class CC_GLES3_API GLES3ProgramCache final : public Object {
+public:
+    static constexpr uint SAVE_INTERVAL = 1800u; // in frames
+
+    GLES3ProgramCache();
+    ~GLES3ProgramCache();
+
+    bool initialize(const String &path, const String &driverKey);
+    void destroy();
+
+    uint64_t computeKey(const GLES3GPUShader *gpuShader) const;
+
+    // Creates gpuShader->glProgram from a cached binary, returns false if the binary is missing or rejected.
+    bool loadProgram(uint64_t key, GLES3GPUShader *gpuShader);
+    // Retrieves the binary of a program that was just linked from source.
+    void storeProgram(uint64_t key, const GLES3GPUShader *gpuShader, uint compileTime);
+
+    // Called once per frame; writes newly stored binaries to disk every SAVE_INTERVAL frames.
+    void tick();
+    void save(bool async);
+
+    CC_INLINE uint getHitCount() const { return _hitCount; }
+    CC_INLINE uint getMissCount() const { return _missCount; }
+    CC_INLINE uint getRejectCount() const { return _rejectCount; }
+    // accumulated time spent compiling programs from source, in microseconds
+    CC_INLINE uint64_t getCompileTime() const { return _compileTime; }
+
+private:
+    struct Entry {
+        GLenum format = 0;
+        vector<uint8_t> binary;
+    };
+
+    String _path;
+    String _driverKey;
+    unordered_map<uint64_t, Entry> _entries;
+    bool _dirty = false;
+    uint _frameCount = 0u;
+
+    uint _hitCount = 0u;
+    uint _missCount = 0u;
+    uint _rejectCount = 0u;
+    uint64_t _compileTime = 0u;
+
+    std::atomic<bool> _saving{false};
+    ThreadPool *_threadPool = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_GFXGLES3_PROGRAM_CACHE_H_
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "GLES3Queue.h"
 #include "GLES3Commands.h"
 #include "GLES3CommandBuffer.h"
+#include "GLES3Device.h"
 
 namespace cc {
 namespace gfx {
@@ -50,15 +51,20 @@ void GLES3Queue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence
         for (uint i = 0; i < count; ++i) {
             GLES3CommandBuffer *cmdBuff = (GLES3CommandBuffer *)cmdBuffs[i];
             GLES3CmdPackage *cmdPackage = cmdBuff->_pendingPackages.front();
+            GLES3Device *device = (GLES3Device *)_device;
 
-            GLES3CmdFuncExecuteCmds((GLES3Device *)_device, cmdPackage);
+            device->recordCoalescedCommands(cmdPackage->numCoalescedCmds);
+            _device->enqueue([device, cmdPackage]() {
+                GLES3CmdFuncExecuteCmds(device, cmdPackage);
+            });
 
             _numDrawCalls += cmdBuff->_numDrawCalls;
             _numInstances += cmdBuff->_numInstances;
             _numTriangles += cmdBuff->_numTriangles;
+            _numUploadBytes += cmdBuff->_numUploadBytes;
 
             cmdBuff->_pendingPackages.pop();
-            cmdBuff->_freePackages.push(cmdPackage);
+            cmdBuff->recyclePackage(cmdPackage);
         }
     }
 }
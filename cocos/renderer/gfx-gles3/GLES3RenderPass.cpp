@@ -51,7 +51,9 @@ bool GLES3RenderPass::initialize(const RenderPassInfo &info) {
 
 void GLES3RenderPass::destroy() {
     if (_gpuRenderPass) {
-        CC_DELETE(_gpuRenderPass);
+        // commands enqueued earlier may still read it
+        GLES3GPURenderPass *gpuRenderPass = _gpuRenderPass;
+        _device->enqueue([gpuRenderPass]() { CC_DELETE(gpuRenderPass); });
         _gpuRenderPass = nullptr;
     }
 }
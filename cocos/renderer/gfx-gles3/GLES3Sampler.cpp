@@ -59,15 +59,23 @@ bool GLES3Sampler::initialize(const SamplerInfo &info) {
     _gpuSampler->minLOD = _minLOD;
     _gpuSampler->maxLOD = _maxLOD;
 
-    GLES3CmdFuncCreateSampler((GLES3Device *)_device, _gpuSampler);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUSampler *gpuSampler = _gpuSampler;
+    _device->enqueue([device, gpuSampler]() {
+        GLES3CmdFuncCreateSampler(device, gpuSampler);
+    });
 
     return true;
 }
 
 void GLES3Sampler::destroy() {
     if (_gpuSampler) {
-        GLES3CmdFuncDestroySampler((GLES3Device *)_device, _gpuSampler);
-        CC_DELETE(_gpuSampler);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUSampler *gpuSampler = _gpuSampler;
+        _device->enqueue([device, gpuSampler]() {
+            GLES3CmdFuncDestroySampler(device, gpuSampler);
+            CC_DELETE(gpuSampler);
+        });
         _gpuSampler = nullptr;
     }
 }
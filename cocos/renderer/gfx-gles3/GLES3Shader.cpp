@@ -51,15 +51,23 @@ bool GLES3Shader::initialize(const ShaderInfo &info) {
         _gpuShader->gpuStages.emplace_back(std::move(gpuShaderStage));
     }
 
-    GLES3CmdFuncCreateShader((GLES3Device *)_device, _gpuShader);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUShader *gpuShader = _gpuShader;
+    _device->enqueue([device, gpuShader]() {
+        GLES3CmdFuncCreateShader(device, gpuShader);
+    });
 
     return true;
 }
 
 void GLES3Shader::destroy() {
     if (_gpuShader) {
-        GLES3CmdFuncDestroyShader((GLES3Device *)_device, _gpuShader);
-        CC_DELETE(_gpuShader);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUShader *gpuShader = _gpuShader;
+        _device->enqueue([device, gpuShader]() {
+            GLES3CmdFuncDestroyShader(device, gpuShader);
+            CC_DELETE(gpuShader);
+        });
         _gpuShader = nullptr;
     }
 }
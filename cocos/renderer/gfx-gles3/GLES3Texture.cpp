@@ -112,7 +112,11 @@ bool GLES3Texture::initialize(const TextureInfo &info) {
     _gpuTexture->flags = _flags;
     _gpuTexture->isPowerOf2 = math::IsPowerOfTwo(_width) && math::IsPowerOfTwo(_height);
 
-    GLES3CmdFuncCreateTexture((GLES3Device *)_device, _gpuTexture);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUTexture *gpuTexture = _gpuTexture;
+    _device->enqueue([device, gpuTexture]() {
+        GLES3CmdFuncCreateTexture(device, gpuTexture);
+    });
     _device->getMemoryStatus().textureSize += _size;
 
     return true;
@@ -127,9 +131,14 @@ bool GLES3Texture::initialize(const TextureViewInfo &info) {
 
 void GLES3Texture::destroy() {
     if (_gpuTexture) {
-        GLES3CmdFuncDestroyTexture((GLES3Device *)_device, _gpuTexture);
+        // commands enqueued earlier may still use the texture
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUTexture *gpuTexture = _gpuTexture;
+        _device->enqueue([device, gpuTexture]() {
+            GLES3CmdFuncDestroyTexture(device, gpuTexture);
+            CC_DELETE(gpuTexture);
+        });
         _device->getMemoryStatus().textureSize -= _size;
-        CC_DELETE(_gpuTexture);
         _gpuTexture = nullptr;
     }
 
@@ -149,10 +158,14 @@ void GLES3Texture::resize(uint width, uint height) {
         _size = size;
 
         MemoryStatus &status = _device->getMemoryStatus();
-        _gpuTexture->width = _width;
-        _gpuTexture->height = _height;
-        _gpuTexture->size = _size;
-        GLES3CmdFuncResizeTexture((GLES3Device *)_device, _gpuTexture);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUTexture *gpuTexture = _gpuTexture;
+        _device->enqueue([device, gpuTexture, width, height, size]() {
+            gpuTexture->width = width;
+            gpuTexture->height = height;
+            gpuTexture->size = size;
+            GLES3CmdFuncResizeTexture(device, gpuTexture);
+        });
         status.bufferSize -= oldSize;
         status.bufferSize += _size;
 
@@ -0,0 +1,103 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "GLES3Std.h"
+
+#include "GLES3GPUObjects.h"
+#include "GLES3TimestampPool.h"
+
+namespace cc {
+namespace gfx {
+
+GLES3TimestampPool::GLES3TimestampPool()
+: Object() {
+}
+
+GLES3TimestampPool::~GLES3TimestampPool() {
+}
+
+void GLES3TimestampPool::initialize() {
+    for (Slot &slot : _slots) {
+        slot.glQueries.resize(Profiler::MAX_SCOPES * 2, 0);
+        slot.written.resize(Profiler::MAX_SCOPES * 2, false);
+        GL_CHECK(glGenQueries(Profiler::MAX_SCOPES * 2, slot.glQueries.data()));
+    }
+    _results.resize(Profiler::MAX_SCOPES * 2);
+
+    // clear any disjoint event that happened before the first frame
+    GLint disjoint = 0;
+    GL_CHECK(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+}
+
+void GLES3TimestampPool::destroy() {
+    for (Slot &slot : _slots) {
+        if (!slot.glQueries.empty()) {
+            GL_CHECK(glDeleteQueries(static_cast<GLsizei>(slot.glQueries.size()), slot.glQueries.data()));
+        }
+        slot.glQueries.clear();
+        slot.written.clear();
+    }
+}
+
+void GLES3TimestampPool::write(uint slot, uint query) {
+    Slot &target = _slots[slot];
+    if (query >= target.glQueries.size()) return;
+
+    GL_CHECK(glQueryCounterEXT(target.glQueries[query], GL_TIMESTAMP_EXT));
+    target.written[query] = true;
+}
+
+void GLES3TimestampPool::resolve(Profiler *profiler) {
+    const uint slotIndex = profiler->getResolveSlot();
+    Slot &slot = _slots[slotIndex];
+    const uint scopeCount = std::min(profiler->getScopeCount(slotIndex), Profiler::MAX_SCOPES);
+    if (!scopeCount) return;
+
+    // any disjoint event since the last check invalidates every timestamp in flight
+    GLint disjoint = 0;
+    GL_CHECK(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+
+    bool available = !disjoint;
+    for (uint i = 0u; available && i < scopeCount * 2; ++i) {
+        if (!slot.written[i]) continue;
+        GLuint ready = GL_FALSE;
+        GL_CHECK(glGetQueryObjectuiv(slot.glQueries[i], GL_QUERY_RESULT_AVAILABLE, &ready));
+        if (ready) {
+            GL_CHECK(glGetQueryObjectui64vEXT(slot.glQueries[i], GL_QUERY_RESULT, &_results[i]));
+        } else {
+            available = false; // still in flight, drop the frame rather than stall
+        }
+    }
+
+    for (uint i = 0u; i < scopeCount; ++i) {
+        const uint begin = i * 2;
+        const uint end = begin + 1;
+        if (available && slot.written[begin] && slot.written[end]) {
+            profiler->resolveGPUScope(slotIndex, i, _results[begin], _results[end]);
+        }
+    }
+    std::fill(slot.written.begin(), slot.written.end(), false);
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,60 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_GFXGLES3_TIMESTAMP_POOL_H_
+#define CC_GFXGLES3_TIMESTAMP_POOL_H_
+
+namespace cc {
+namespace gfx {
+
+class Profiler;
+
+// GPU timestamps for the profiler through GL_EXT_disjoint_timer_query.
+// Queries are kept per profiler frame slot and only read back once the
+// slot comes around again, so results are polled rather than waited on.
+class CC_GLES3_API GLES3TimestampPool final : public Object {
+public:
+    GLES3TimestampPool();
+    ~GLES3TimestampPool();
+
+    void initialize();
+    void destroy();
+
+    void write(uint slot, uint query);
+    // hands the finished timestamps of the profiler's resolve slot over to it
+    void resolve(Profiler *profiler);
+
+private:
+    struct Slot {
+        vector<GLuint> glQueries;
+        vector<bool> written;
+    };
+
+    Slot _slots[Profiler::FRAME_LATENCY];
+    vector<GLuint64> _results;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_GFXGLES3_TIMESTAMP_POOL_H_
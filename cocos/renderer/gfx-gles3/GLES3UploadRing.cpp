@@ -0,0 +1,140 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "GLES3Std.h"
+
+#include "GLES3GPUObjects.h"
+#include "GLES3UploadRing.h"
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr uint UPLOAD_ALIGNMENT = 16u;
+constexpr GLuint64 FENCE_TIMEOUT = 1000000000u; // 1 second
+} // namespace
+
+GLES3UploadRing::GLES3UploadRing()
+: Object() {
+}
+
+GLES3UploadRing::~GLES3UploadRing() {
+}
+
+void GLES3UploadRing::initialize(uint segmentSize) {
+    _segmentSize = segmentSize;
+    _segmentIndex = 0u;
+    _offset = 0u;
+
+    GL_CHECK(glGenBuffers(1, &_glBuffer));
+    GL_CHECK(glBindBuffer(GL_COPY_READ_BUFFER, _glBuffer));
+    GL_CHECK(glBufferData(GL_COPY_READ_BUFFER, _segmentSize * FRAME_COUNT, nullptr, GL_STREAM_DRAW));
+}
+
+void GLES3UploadRing::destroy() {
+    for (GLsync &fence : _fences) {
+        if (fence) {
+            GL_CHECK(glDeleteSync(fence));
+            fence = nullptr;
+        }
+    }
+    if (_glBuffer) {
+        GL_CHECK(glDeleteBuffers(1, &_glBuffer));
+        _glBuffer = 0;
+    }
+}
+
+void GLES3UploadRing::beginFrame() {
+    _segmentIndex = (_segmentIndex + 1) % FRAME_COUNT;
+    _offset = 0u;
+
+    if (_overflowed) {
+        // grow once every segment is retired, so the reallocation never races the GPU
+        for (uint i = 0u; i < FRAME_COUNT; ++i) {
+            waitForSegment(i);
+        }
+        _overflowed = false;
+        _segmentSize *= 2u;
+        GL_CHECK(glBindBuffer(GL_COPY_READ_BUFFER, _glBuffer));
+        GL_CHECK(glBufferData(GL_COPY_READ_BUFFER, _segmentSize * FRAME_COUNT, nullptr, GL_STREAM_DRAW));
+        return;
+    }
+
+    waitForSegment(_segmentIndex);
+}
+
+void GLES3UploadRing::endFrame() {
+    GLsync &fence = _fences[_segmentIndex];
+    if (fence) {
+        GL_CHECK(glDeleteSync(fence));
+    }
+    GL_CHECK(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+bool GLES3UploadRing::upload(GLuint glBuffer, uint offset, const void *data, uint size) {
+    const uint srcOffset = stage(data, size);
+    if (srcOffset == INVALID_OFFSET) return false;
+
+    GL_CHECK(glBindBuffer(GL_COPY_WRITE_BUFFER, glBuffer));
+    GL_CHECK(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, offset, size));
+
+    return true;
+}
+
+uint GLES3UploadRing::stage(const void *data, uint size) {
+    if (_offset + size > _segmentSize) {
+        ++_overflowCount;
+        // a single copy larger than a whole segment isn't worth growing for
+        if (size <= _segmentSize) _overflowed = true;
+        return INVALID_OFFSET;
+    }
+
+    const uint srcOffset = _segmentIndex * _segmentSize + _offset;
+    _offset += (size + UPLOAD_ALIGNMENT - 1) & ~(UPLOAD_ALIGNMENT - 1);
+
+    GL_CHECK(glBindBuffer(GL_COPY_READ_BUFFER, _glBuffer));
+    void *dst = nullptr;
+    GL_CHECK(dst = glMapBufferRange(GL_COPY_READ_BUFFER, srcOffset, size,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    if (!dst) return INVALID_OFFSET;
+    memcpy(dst, data, size);
+    GL_CHECK(glUnmapBuffer(GL_COPY_READ_BUFFER));
+
+    return srcOffset;
+}
+
+void GLES3UploadRing::waitForSegment(uint index) {
+    GLsync &fence = _fences[index];
+    if (!fence) return;
+
+    GLenum result = GL_TIMEOUT_EXPIRED;
+    GL_CHECK(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT));
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+        CC_LOG_WARNING("GLES3UploadRing: timed out waiting for segment %u.", index);
+    }
+    GL_CHECK(glDeleteSync(fence));
+    fence = nullptr;
+}
+
+} // namespace gfx
+} // namespace cc
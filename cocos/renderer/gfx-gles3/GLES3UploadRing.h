@@ -0,0 +1,77 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_GFXGLES3_UPLOAD_RING_H_
+#define CC_GFXGLES3_UPLOAD_RING_H_
+
+namespace cc {
+namespace gfx {
+
+// Frame-ringed staging buffer for dynamic buffer updates.
+// Data is written into the current frame's segment through an unsynchronized
+// mapping and copied into the destination on the GPU, so updates neither stall
+// on buffers still in use nor touch the VAO-tracked array/element bindings.
+// Each segment is guarded by a fence and only reused once the GPU is done with it.
+// Texture uploads stage their pixels the same way and read them back as a pixel unpack buffer.
+class CC_GLES3_API GLES3UploadRing final : public Object {
+public:
+    static constexpr uint FRAME_COUNT = 3u;
+    static constexpr uint DEFAULT_SEGMENT_SIZE = 1024u * 1024u;
+    static constexpr uint INVALID_OFFSET = ~0u;
+
+    GLES3UploadRing();
+    ~GLES3UploadRing();
+
+    void initialize(uint segmentSize = DEFAULT_SEGMENT_SIZE);
+    void destroy();
+
+    void beginFrame();
+    void endFrame();
+
+    // Returns false if the current segment is exhausted; the caller should fall back to glBufferSubData.
+    bool upload(GLuint glBuffer, uint offset, const void *data, uint size);
+
+    // Copies data into the current segment and returns its offset inside getBuffer(),
+    // or INVALID_OFFSET if the segment is exhausted.
+    uint stage(const void *data, uint size);
+
+    CC_INLINE GLuint getBuffer() const { return _glBuffer; }
+    CC_INLINE uint getSegmentSize() const { return _segmentSize; }
+    CC_INLINE uint getOverflowCount() const { return _overflowCount; }
+
+private:
+    void waitForSegment(uint index);
+
+    GLuint _glBuffer = 0;
+    uint _segmentSize = 0u;
+    uint _segmentIndex = 0u;
+    uint _offset = 0u;
+    uint _overflowCount = 0u;
+    bool _overflowed = false;
+    GLsync _fences[FRAME_COUNT] = {};
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_GFXGLES3_UPLOAD_RING_H_
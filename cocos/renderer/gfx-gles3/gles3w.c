@@ -497,6 +497,8 @@ PFNGLDEBUGMESSAGECONTROLKHRPROC gles3wDebugMessageControlKHR;
 PFNGLDEBUGMESSAGECALLBACKKHRPROC gles3wDebugMessageCallbackKHR;
 PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC gles3wFramebufferTexture2DMultisampleEXT;
 PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC gles3wFramebufferTexture2DMultisampleIMG;
+PFNGLQUERYCOUNTEREXTPROC gles3wQueryCounterEXT;
+PFNGLGETQUERYOBJECTUI64VEXTPROC gles3wGetQueryObjectui64vEXT;
 
 static void load_procs(void)
 {
@@ -792,4 +794,6 @@ static void load_procs(void)
 	gles3wDebugMessageCallbackKHR = (PFNGLDEBUGMESSAGECALLBACKKHRPROC)get_proc("glDebugMessageCallbackKHR");
 	gles3wFramebufferTexture2DMultisampleEXT = (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC)get_proc("glFramebufferTexture2DMultisampleEXT");
 	gles3wFramebufferTexture2DMultisampleIMG = (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC)get_proc("glFramebufferTexture2DMultisampleIMG");
+	gles3wQueryCounterEXT = (PFNGLQUERYCOUNTEREXTPROC)get_proc("glQueryCounterEXT");
+	gles3wGetQueryObjectui64vEXT = (PFNGLGETQUERYOBJECTUI64VEXTPROC)get_proc("glGetQueryObjectui64vEXT");
 }
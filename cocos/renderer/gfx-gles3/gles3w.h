@@ -367,6 +367,13 @@ typedef void(GL_APIENTRY *PFNGLGETPROGRAMPIPELINEINFOLOGEXTPROC)(GLuint pipeline
 
 typedef void(GL_APIENTRY *PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC)(GLenum, GLenum, GLenum, GLuint, GLint, GLsizei);
 
+#ifndef GL_EXT_disjoint_timer_query
+    #define GL_TIMESTAMP_EXT    0x8E28
+    #define GL_GPU_DISJOINT_EXT 0x8FBB
+typedef void(GL_APIENTRY *PFNGLQUERYCOUNTEREXTPROC)(GLuint id, GLenum target);
+typedef void(GL_APIENTRY *PFNGLGETQUERYOBJECTUI64VEXTPROC)(GLuint id, GLenum pname, GLuint64 *params);
+#endif
+
 extern PFNGLACTIVETEXTUREPROC gles3wActiveTexture;
 extern PFNGLATTACHSHADERPROC gles3wAttachShader;
 extern PFNGLBINDATTRIBLOCATIONPROC gles3wBindAttribLocation;
@@ -659,6 +666,8 @@ extern PFNGLDEBUGMESSAGECONTROLKHRPROC gles3wDebugMessageControlKHR;
 extern PFNGLDEBUGMESSAGECALLBACKKHRPROC gles3wDebugMessageCallbackKHR;
 extern PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC gles3wFramebufferTexture2DMultisampleEXT;
 extern PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC gles3wFramebufferTexture2DMultisampleIMG;
+extern PFNGLQUERYCOUNTEREXTPROC gles3wQueryCounterEXT;
+extern PFNGLGETQUERYOBJECTUI64VEXTPROC gles3wGetQueryObjectui64vEXT;
 
 #define glActiveTexture                       gles3wActiveTexture
 #define glAttachShader                        gles3wAttachShader
@@ -952,6 +961,8 @@ extern PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC gles3wFramebufferTexture2DMul
 #define glDebugMessageCallbackKHR            gles3wDebugMessageCallbackKHR
 #define glFramebufferTexture2DMultisampleEXT gles3wFramebufferTexture2DMultisampleEXT
 #define glFramebufferTexture2DMultisampleIMG gles3wFramebufferTexture2DMultisampleIMG
+#define glQueryCounterEXT                    gles3wQueryCounterEXT
+#define glGetQueryObjectui64vEXT             gles3wGetQueryObjectui64vEXT
 
 #ifdef __cplusplus
 }
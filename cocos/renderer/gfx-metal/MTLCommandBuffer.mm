@@ -66,6 +66,7 @@ void CCMTLCommandBuffer::begin(RenderPass * /*renderPass*/, uint /*subPass*/, Fr
     [_mtlCommandBuffer retain];
     [_mtlCommandBuffer enqueue];
     _numTriangles = 0;
+    _numUploadBytes = 0;
     _numDrawCalls = 0;
     _numInstances = 0;
 
@@ -330,6 +331,7 @@ void CCMTLCommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size)
     stagingBuffer.size = size;
     _mtlDevice->gpuStagingBufferPool()->alloc(&stagingBuffer);
     memcpy(stagingBuffer.mappedData, data, size);
+    _numUploadBytes += size;
     id<MTLBlitCommandEncoder> encoder = [_mtlCommandBuffer blitCommandEncoder];
     [encoder copyFromBuffer:stagingBuffer.mtlBuffer
                sourceOffset:stagingBuffer.startOffset
@@ -404,6 +406,7 @@ void CCMTLCommandBuffer::execute(const CommandBuffer *const *commandBuffs, uint3
         _numDrawCalls += commandBuffer->_numDrawCalls;
         _numInstances += commandBuffer->_numInstances;
         _numTriangles += commandBuffer->_numTriangles;
+        _numUploadBytes += commandBuffer->_numUploadBytes;
     }
 }
 
@@ -65,26 +65,26 @@ void CCMTLDescriptorSet::destroy() {
     _buffers.clear();
     _textures.clear();
     _samplers.clear();
+    _dirtyMasks.clear();
 }
 
 void CCMTLDescriptorSet::update() {
     if (_isDirty && _gpuDescriptorSet) {
-        const auto &descriptors = _gpuDescriptorSet->gpuDescriptors;
-        for (size_t i = 0; i < descriptors.size(); i++) {
+        auto &descriptors = _gpuDescriptorSet->gpuDescriptors;
+        consumeDirtyDescriptors([&](uint i) {
             if (static_cast<uint>(descriptors[i].type) & DESCRIPTOR_BUFFER_TYPE) {
                 if (_buffers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].buffer = static_cast<CCMTLBuffer *>(_buffers[i]);
+                    descriptors[i].buffer = static_cast<CCMTLBuffer *>(_buffers[i]);
                 }
             } else if (static_cast<uint>(descriptors[i].type) & DESCRIPTOR_SAMPLER_TYPE) {
                 if (_textures[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].texture = static_cast<CCMTLTexture *>(_textures[i]);
+                    descriptors[i].texture = static_cast<CCMTLTexture *>(_textures[i]);
                 }
                 if (_samplers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].sampler = static_cast<CCMTLSampler *>(_samplers[i]);
+                    descriptors[i].sampler = static_cast<CCMTLSampler *>(_samplers[i]);
                 }
             }
-        }
-        _isDirty = false;
+        });
     }
 }
 }
@@ -175,6 +175,7 @@ void CCMTLDevice::destroy() {
         _memoryAlarmListenerId = 0;
     }
 
+    _textureStreamer->destroy();
     CCMTLGPUGarbageCollectionPool::getInstance()->flush();
 
     if (_inFlightSemaphore) {
@@ -201,19 +202,30 @@ void CCMTLDevice::resize(uint /*width*/, uint /*height*/) {}
 
 void CCMTLDevice::acquire() {
     _inFlightSemaphore->wait();
+    _profiler->beginFrame();
 
     // Clear queue stats
     CCMTLQueue *queue = static_cast<CCMTLQueue *>(_queue);
     queue->_numDrawCalls = 0;
     queue->_numInstances = 0;
     queue->_numTriangles = 0;
+    queue->_numUploadBytes = 0;
+
+    _textureStreamer->update();
 }
 
 void CCMTLDevice::present() {
+    _profiler->endFrame();
+
     CCMTLQueue *queue = (CCMTLQueue *)_queue;
     _numDrawCalls = queue->_numDrawCalls;
     _numInstances = queue->_numInstances;
     _numTriangles = queue->_numTriangles;
+    _numUploadBytes = queue->_numUploadBytes;
+    _numDescriptorWrites = _descriptorWriteCount;
+    _descriptorWriteCount = 0u;
+    memcpy(_numLODTriangles, _lodTriangleCount, sizeof(_numLODTriangles));
+    memset(_lodTriangleCount, 0, sizeof(_lodTriangleCount));
 
     //hold this pointer before update _currentFrameIndex
     CCMTLGPUStagingBufferPool *bufferPool = _gpuStagingBufferPools[_currentFrameIndex];
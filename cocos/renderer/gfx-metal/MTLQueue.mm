@@ -47,6 +47,7 @@ void CCMTLQueue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence
         _numDrawCalls += cmdBuffer->getNumDrawCalls();
         _numInstances += cmdBuffer->getNumInstances();
         _numTriangles += cmdBuffer->getNumTris();
+        _numUploadBytes += cmdBuffer->getNumUploadBytes();
     }
 }
 
@@ -185,7 +185,8 @@ bool CCMTLTexture::createMTLTexture() {
     descriptor.usage = mu::toMTLTextureUsage(_usage);
     descriptor.textureType = mu::toMTLTextureType(_type);
     descriptor.sampleCount = mu::toMTLSampleCount(_samples);
-    descriptor.mipmapLevelCount = _levelCount;
+    // textures that grow in place may ask for more levels than their current extent allows
+    descriptor.mipmapLevelCount = std::min(_levelCount, MipLevelCount(_width, _height));
     descriptor.arrayLength = _flags & TextureFlagBit::CUBEMAP ? 1 : _layerCount;
     if (_usage & TextureUsage::COLOR_ATTACHMENT ||
         _usage & TextureUsage::DEPTH_STENCIL_ATTACHMENT ||
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "VKQueue.h"
 #include "VKRenderPass.h"
 #include "VKTexture.h"
+#include "VKTimestampPool.h"
 
 namespace cc {
 namespace gfx {
@@ -85,6 +86,7 @@ void CCVKCommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer
     _numDrawCalls = 0;
     _numInstances = 0;
     _numTriangles = 0;
+    _numUploadBytes = 0;
 
     VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
@@ -110,6 +112,11 @@ void CCVKCommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer
 
     VK_CHECK(vkBeginCommandBuffer(_gpuCommandBuffer->vkCommandBuffer, &beginInfo));
 
+    CCVKTimestampPool *timestampPool = ((CCVKDevice *)_device)->timestampPool();
+    if (timestampPool && _type == CommandBufferType::PRIMARY && _device->getProfiler()->isRecording()) {
+        timestampPool->reset(_gpuCommandBuffer->vkCommandBuffer, _device->getProfiler()->getFrameSlot());
+    }
+
     _gpuCommandBuffer->began = true;
     _gpuCommandBuffer->recordedBuffers.clear();
 }
@@ -128,6 +135,10 @@ void CCVKCommandBuffer::end() {
 }
 
 void CCVKCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, bool fromSecondaryCB) {
+    // write out every descriptor set updated since the last pass in one batch, on the thread owning
+    // the primary command buffer, before any draw of the pass is recorded inline or into secondary buffers
+    ((CCVKDevice *)_device)->gpuDescriptorSetHub()->flush();
+
     // guard against RAW hazards
     VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -409,6 +420,7 @@ void CCVKCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint count
             _numDrawCalls += cmdBuff->_numDrawCalls;
             _numInstances += cmdBuff->_numInstances;
             _numTriangles += cmdBuff->_numTriangles;
+            _numUploadBytes += cmdBuff->_numUploadBytes;
         }
     }
     if (validCount) {
@@ -419,6 +431,7 @@ void CCVKCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint count
 
 void CCVKCommandBuffer::updateBuffer(Buffer *buffer, const void *data, uint size) {
     CCVKCmdFuncUpdateBuffer((CCVKDevice *)_device, ((CCVKBuffer *)buffer)->gpuBuffer(), data, size, _gpuCommandBuffer);
+    _numUploadBytes += size;
 }
 
 void CCVKCommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) {
@@ -458,5 +471,12 @@ void CCVKCommandBuffer::bindDescriptorSets() {
     _firstDirtyDescriptorSet = UINT_MAX;
 }
 
+void CCVKCommandBuffer::writeTimestamp(uint slot, uint query) {
+    CCVKTimestampPool *timestampPool = ((CCVKDevice *)_device)->timestampPool();
+    if (timestampPool) {
+        timestampPool->write(_gpuCommandBuffer->vkCommandBuffer, slot, query);
+    }
+}
+
 } // namespace gfx
 } // namespace cc
@@ -62,6 +62,9 @@ public:
 
     CCVKGPUCommandBuffer *gpuCommandBuffer() const { return _gpuCommandBuffer; }
 
+protected:
+    virtual void writeTimestamp(uint slot, uint query) override;
+
 private:
     void bindDescriptorSets();
 
@@ -27,8 +27,9 @@ THE SOFTWARE.
 #include "VKCommands.h"
 #include "VKContext.h"
 #include "VKDevice.h"
+#include "VKPipelineCache.h"
 #include "VKQueue.h"
-#include "VKSPIRV.h"
+#include "VKSPIRVCache.h"
 
 #include <algorithm>
 
@@ -38,11 +39,13 @@ namespace cc {
 namespace gfx {
 
 CCVKGPUCommandBufferPool *CCVKGPUDevice::getCommandBufferPool(std::thread::id threadID) {
-    if (!commandBufferPools.count(threadID)) {
-        //std::scoped_lock<std::mutex> guard(mutex);
-        commandBufferPools[threadID] = CC_NEW(CCVKGPUCommandBufferPool(this));
+    // secondary command buffers may be recorded from pipeline worker threads
+    std::lock_guard<std::mutex> guard(mutex);
+    auto &pool = commandBufferPools[threadID];
+    if (!pool) {
+        pool = CC_NEW(CCVKGPUCommandBufferPool(this));
     }
-    return commandBufferPools[threadID];
+    return pool;
 }
 
 void insertVkDynamicStates(vector<VkDynamicState> &out, const vector<DynamicStateFlagBit> &dynamicStates) {
@@ -116,6 +119,8 @@ void CCVKCmdFuncCreateTexture(CCVKDevice *device, CCVKGPUTexture *gpuTexture) {
     createInfo.imageType = MapVkImageType(gpuTexture->type);
     createInfo.format = format;
     createInfo.extent = {gpuTexture->width, gpuTexture->height, gpuTexture->depth};
+    // textures that grow in place may ask for more levels than their current extent allows
+    gpuTexture->mipLevels = std::min(gpuTexture->mipLevels, MipLevelCount(gpuTexture->width, gpuTexture->height));
     createInfo.mipLevels = gpuTexture->mipLevels;
     createInfo.arrayLayers = gpuTexture->arrayLayers;
     createInfo.samples = MapVkSampleCount(gpuTexture->samples);
@@ -145,7 +150,7 @@ void CCVKCmdFuncCreateTextureView(CCVKDevice *device, CCVKGPUTextureView *gpuTex
     createInfo.format = MapVkFormat(gpuTextureView->format);
     createInfo.subresourceRange.aspectMask = GFX_FORMAT_INFOS[(uint)gpuTextureView->format].hasDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
     createInfo.subresourceRange.baseMipLevel = gpuTextureView->baseLevel;
-    createInfo.subresourceRange.levelCount = gpuTextureView->levelCount;
+    createInfo.subresourceRange.levelCount = std::min(gpuTextureView->levelCount, gpuTextureView->gpuTexture->mipLevels - gpuTextureView->baseLevel);
     createInfo.subresourceRange.baseArrayLayer = gpuTextureView->baseLayer;
     createInfo.subresourceRange.layerCount = gpuTextureView->layerCount;
 
@@ -400,7 +405,8 @@ void CCVKCmdFuncCreateFramebuffer(CCVKDevice *device, CCVKGPUFramebuffer *gpuFra
 
 void CCVKCmdFuncCreateShader(CCVKDevice *device, CCVKGPUShader *gpuShader) {
     for (CCVKGPUShaderStage &stage : gpuShader->gpuStages) {
-        vector<unsigned int> spirv = GLSL2SPIRV(stage.type, "#version 450\n" + stage.source, ((CCVKContext *)device->getContext())->minorVersion());
+        vector<unsigned int> spirv;
+        device->spirvCache()->compile(stage.type, stage.source, spirv);
         VkShaderModuleCreateInfo createInfo{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
         createInfo.codeSize = spirv.size() * sizeof(unsigned int);
         createInfo.pCode = spirv.data();
@@ -664,8 +670,20 @@ void CCVKCmdFuncCreatePipelineState(CCVKDevice *device, CCVKGPUPipelineState *gp
 
     ///////////////////// Creation /////////////////////
 
+    VkPipelineCreationFeedbackEXT creationFeedback{};
+    VkPipelineCreationFeedbackCreateInfoEXT creationFeedbackInfo{VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT};
+    if (device->gpuDevice()->usePipelineCreationFeedback) {
+        creationFeedbackInfo.pPipelineCreationFeedback = &creationFeedback;
+        createInfo.pNext = &creationFeedbackInfo;
+    }
+
     VK_CHECK(vkCreateGraphicsPipelines(device->gpuDevice()->vkDevice, device->gpuDevice()->vkPipelineCache,
                                        1, &createInfo, nullptr, &gpuPipelineState->vkPipeline));
+
+    // without the feedback extension every pipeline is counted as a miss
+    const bool cacheHit = (creationFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) &&
+                          (creationFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT);
+    device->pipelineCache()->recordPipeline(cacheHit);
 }
 
 void CCVKCmdFuncCreateFence(CCVKDevice *device, CCVKGPUFence *gpuFence) {
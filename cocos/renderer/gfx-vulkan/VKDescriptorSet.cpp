@@ -169,14 +169,15 @@ void CCVKDescriptorSet::destroy() {
     _buffers.clear();
     _textures.clear();
     _samplers.clear();
+    _dirtyMasks.clear();
 }
 
 void CCVKDescriptorSet::update() {
     if (_isDirty && _gpuDescriptorSet) {
         CCVKGPUDescriptorHub *descriptorHub = ((CCVKDevice *)_device)->gpuDescriptorHub();
-        uint descriptorCount = _gpuDescriptorSet->gpuDescriptors.size();
+        bool changed = false;
 
-        for (size_t i = 0u; i < descriptorCount; i++) {
+        consumeDirtyDescriptors([&](uint i) {
             CCVKGPUDescriptor &binding = _gpuDescriptorSet->gpuDescriptors[i];
 
             if ((uint)binding.type & DESCRIPTOR_BUFFER_TYPE) {
@@ -195,6 +196,7 @@ void CCVKDescriptorSet::update() {
                             }
                         }
                         binding.gpuBufferView = bufferView;
+                        changed = true;
                     }
                 }
             } else if ((uint)binding.type & DESCRIPTOR_SAMPLER_TYPE) {
@@ -212,6 +214,7 @@ void CCVKDescriptorSet::update() {
                             }
                         }
                         binding.gpuTextureView = textureView;
+                        changed = true;
                     }
                 }
                 if (_samplers[i]) {
@@ -228,12 +231,16 @@ void CCVKDescriptorSet::update() {
                             }
                         }
                         binding.gpuSampler = sampler;
+                        changed = true;
                     }
                 }
             }
+        });
+
+        // the actual descriptor writes are deferred and batched by the descriptor set hub
+        if (changed) {
+            ((CCVKDevice *)_device)->gpuDescriptorSetHub()->record(_gpuDescriptorSet);
         }
-        ((CCVKDevice *)_device)->gpuDescriptorSetHub()->record(_gpuDescriptorSet);
-        _isDirty = false;
     }
 }
 
@@ -9,14 +9,18 @@
 #include "VKFence.h"
 #include "VKFramebuffer.h"
 #include "VKInputAssembler.h"
+#include "VKPipelineCache.h"
 #include "VKPipelineLayout.h"
 #include "VKPipelineState.h"
 #include "VKQueue.h"
 #include "VKRenderPass.h"
+#include "VKSPIRVCache.h"
 #include "VKSampler.h"
 #include "VKShader.h"
 #include "VKTexture.h"
+#include "VKTimestampPool.h"
 #include "VKUtils.h"
+#include "platform/FileUtils.h"
 
 CC_DISABLE_WARNINGS()
 #define VMA_IMPLEMENTATION
@@ -86,6 +90,7 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
         VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME,
         VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
         VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
+        VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME,
     };
     VkPhysicalDeviceFeatures2 requestedFeatures2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
     VkPhysicalDeviceVulkan11Features requestedVulkan11Features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
@@ -192,6 +197,7 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
 
     _gpuDevice->useMultiDrawIndirect = deviceFeatures.multiDrawIndirect;
     _gpuDevice->useDescriptorUpdateTemplate = checkExtension(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+    _gpuDevice->usePipelineCreationFeedback = checkExtension(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
 
     VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
     VkFormatProperties formatProperties;
@@ -304,6 +310,9 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
 
     _gpuDescriptorHub->link(_gpuDescriptorSetHub);
 
+    _spirvCache = CC_NEW(CCVKSPIRVCache);
+    _spirvCache->initialize(FileUtils::getInstance()->getWritablePath() + "spirv-cache/", context->minorVersion());
+
     CommandBufferInfo cmdBuffInfo;
     cmdBuffInfo.type = CommandBufferType::PRIMARY;
     cmdBuffInfo.queue = _queue;
@@ -327,8 +336,16 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     _gpuDevice->defaultBuffer.count = 1u;
     CCVKCmdFuncCreateBuffer(this, &_gpuDevice->defaultBuffer);
 
-    VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
-    VK_CHECK(vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache));
+    _pipelineCache = CC_NEW(CCVKPipelineCache);
+    _pipelineCache->initialize(_gpuDevice, gpuContext->physicalDeviceProperties, FileUtils::getInstance()->getWritablePath() + "vulkan-pipeline-cache.bin");
+    _gpuDevice->vkPipelineCache = _pipelineCache->getVkPipelineCache();
+
+    const uint queueFamilyIndex = ((CCVKQueue *)_queue)->gpuQueue()->queueFamilyIndex;
+    _timestampPool = CC_NEW(CCVKTimestampPool);
+    if (!_timestampPool->initialize(_gpuDevice, gpuContext->queueFamilyProperties[queueFamilyIndex].timestampValidBits,
+                                    gpuContext->physicalDeviceProperties.limits.timestampPeriod)) {
+        CC_SAFE_DESTROY(_timestampPool);
+    }
 
     for (uint i = 0u; i < gpuContext->swapchainCreateInfo.minImageCount; i++) {
         TextureInfo depthStencilTexInfo;
@@ -387,6 +404,8 @@ void CCVKDevice::destroy() {
         VK_CHECK(vkDeviceWaitIdle(_gpuDevice->vkDevice));
     }
 
+    _textureStreamer->destroy();
+
     for (CCVKTexture *texture : _depthStencilTextures) {
         CC_SAFE_DESTROY(texture);
     }
@@ -400,6 +419,7 @@ void CCVKDevice::destroy() {
     CC_SAFE_DELETE(_gpuSemaphorePool);
     CC_SAFE_DELETE(_gpuDescriptorHub);
     CC_SAFE_DELETE(_gpuDescriptorSetHub);
+    CC_SAFE_DESTROY(_spirvCache);
 
     uint backBufferCount = ((CCVKContext *)_context)->gpuContext()->swapchainCreateInfo.minImageCount;
     for (uint i = 0u; i < backBufferCount; i++) {
@@ -420,10 +440,9 @@ void CCVKDevice::destroy() {
     }
 
     if (_gpuDevice) {
-        if (_gpuDevice->vkPipelineCache) {
-            vkDestroyPipelineCache(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, nullptr);
-            _gpuDevice->vkPipelineCache = VK_NULL_HANDLE;
-        }
+        CC_SAFE_DESTROY(_timestampPool);
+        CC_SAFE_DESTROY(_pipelineCache);
+        _gpuDevice->vkPipelineCache = VK_NULL_HANDLE;
 
         if (_gpuDevice->defaultBuffer.vkBuffer) {
             vmaDestroyBuffer(_gpuDevice->memoryAllocator, _gpuDevice->defaultBuffer.vkBuffer, _gpuDevice->defaultBuffer.vmaAllocation);
@@ -476,12 +495,18 @@ void CCVKDevice::acquire() {
 
     if (!checkSwapchainStatus()) return;
 
+    if (_timestampPool) _timestampPool->resolve(_profiler);
+    _profiler->beginFrame();
+
     queue->_numDrawCalls = 0;
     queue->_numInstances = 0;
     queue->_numTriangles = 0;
+    queue->_numUploadBytes = 0;
     queue->gpuQueue()->nextWaitSemaphore = VK_NULL_HANDLE;
     queue->gpuQueue()->nextSignalSemaphore = VK_NULL_HANDLE;
 
+    _textureStreamer->update();
+
     _gpuBufferHub->flush();
     _gpuDescriptorSetHub->flush();
 
@@ -497,10 +522,17 @@ void CCVKDevice::acquire() {
 }
 
 void CCVKDevice::present() {
+    _profiler->endFrame();
+
     CCVKQueue *queue = (CCVKQueue *)_queue;
     _numDrawCalls = queue->_numDrawCalls;
     _numInstances = queue->_numInstances;
     _numTriangles = queue->_numTriangles;
+    _numUploadBytes = queue->_numUploadBytes;
+    _numDescriptorWrites = _descriptorWriteCount;
+    _descriptorWriteCount = 0u;
+    memcpy(_numLODTriangles, _lodTriangleCount, sizeof(_numLODTriangles));
+    memset(_lodTriangleCount, 0, sizeof(_lodTriangleCount));
 
     if (queue->gpuQueue()->nextWaitSemaphore) { // don't present if not acquired
         VkPresentInfoKHR presentInfo{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
@@ -527,6 +559,8 @@ void CCVKDevice::present() {
         gpuRecycleBin()->clear();
         gpuStagingBufferPool()->reset();
     }
+
+    _pipelineCache->tick();
 }
 
 CCVKGPUFencePool *CCVKDevice::gpuFencePool() { return _gpuFencePools[_gpuDevice->curBackBufferIndex]; }
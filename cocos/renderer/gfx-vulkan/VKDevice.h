@@ -42,6 +42,9 @@ class CCVKGPUDescriptorSetHub;
 class CCVKGPUFencePool;
 class CCVKGPURecycleBin;
 class CCVKGPUStagingBufferPool;
+class CCVKPipelineCache;
+class CCVKSPIRVCache;
+class CCVKTimestampPool;
 
 class CC_VULKAN_API CCVKDevice final : public Device {
 public:
@@ -91,6 +94,10 @@ public:
     CCVKGPURecycleBin *gpuRecycleBin();
     CCVKGPUStagingBufferPool *gpuStagingBufferPool();
 
+    CC_INLINE CCVKSPIRVCache *spirvCache() const { return _spirvCache; }
+    CC_INLINE CCVKPipelineCache *pipelineCache() const { return _pipelineCache; }
+    CC_INLINE CCVKTimestampPool *timestampPool() const { return _timestampPool; }
+
 private:
     virtual CommandBuffer *doCreateCommandBuffer(const CommandBufferInfo &info, bool hasAgent) override;
     virtual Fence *createFence() override;
@@ -125,6 +132,10 @@ private:
     CCVKGPUSemaphorePool *_gpuSemaphorePool = nullptr;
     CCVKGPUDescriptorSetHub *_gpuDescriptorSetHub = nullptr;
 
+    CCVKSPIRVCache *_spirvCache = nullptr;
+    CCVKPipelineCache *_pipelineCache = nullptr;
+    CCVKTimestampPool *_timestampPool = nullptr;
+
     vector<const char *> _layers;
     vector<const char *> _extensions;
 
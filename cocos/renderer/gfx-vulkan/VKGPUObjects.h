@@ -303,6 +303,7 @@ public:
 
     bool useDescriptorUpdateTemplate = false;
     bool useMultiDrawIndirect = false;
+    bool usePipelineCreationFeedback = false;
 
     // for default backup usages
     CCVKGPUSampler defaultSampler;
@@ -744,14 +745,10 @@ public:
         _setsToBeUpdated.resize(device->backBufferCount);
     }
 
+    // writes are deferred until the next flush, where they are coalesced into a single batch
     void record(const CCVKGPUDescriptorSet *gpuDescriptorSet) {
-        update(gpuDescriptorSet);
         for (uint i = 0u; i < _device->backBufferCount; ++i) {
-            if (i == _device->curBackBufferIndex) {
-                _setsToBeUpdated[i].erase(gpuDescriptorSet);
-            } else {
-                _setsToBeUpdated[i].insert(gpuDescriptorSet);
-            }
+            _setsToBeUpdated[i].insert(gpuDescriptorSet);
         }
     }
 
@@ -763,32 +760,41 @@ public:
         }
     }
 
+    // updates every pending set of the current back buffer,
+    // must be called before any of them gets bound to a command buffer, and not while other threads record
     void flush() {
         DescriptorSetList &sets = _setsToBeUpdated[_device->curBackBufferIndex];
+        if (sets.empty()) return;
+
+        const uint backBufferIndex = _device->curBackBufferIndex;
         for (DescriptorSetList::iterator it = sets.begin(); it != sets.end(); ++it) {
-            update(*it);
+            const CCVKGPUDescriptorSet *gpuDescriptorSet = *it;
+            const CCVKGPUDescriptorSet::DescriptorSetInstance &instance = gpuDescriptorSet->instances[backBufferIndex];
+            if (gpuDescriptorSet->pUpdateTemplate) {
+                // template updates are per-set by design
+                if (*gpuDescriptorSet->pUpdateTemplate) { // skip empty descriptor sets
+                    vkUpdateDescriptorSetWithTemplateKHR(_device->vkDevice,
+                                                         instance.vkDescriptorSet,
+                                                         *gpuDescriptorSet->pUpdateTemplate, instance.descriptorInfos.data());
+                }
+            } else {
+                const vector<VkWriteDescriptorSet> &entries = instance.descriptorUpdateEntries;
+                _writes.insert(_writes.end(), entries.begin(), entries.end());
+            }
         }
         sets.clear();
-    }
 
-private:
-    void update(const CCVKGPUDescriptorSet *gpuDescriptorSet) {
-        const CCVKGPUDescriptorSet::DescriptorSetInstance &instance = gpuDescriptorSet->instances[_device->curBackBufferIndex];
-        if (gpuDescriptorSet->pUpdateTemplate) {
-            if (*gpuDescriptorSet->pUpdateTemplate) { // skip empty descriptor sets
-                vkUpdateDescriptorSetWithTemplateKHR(_device->vkDevice,
-                                                     instance.vkDescriptorSet,
-                                                     *gpuDescriptorSet->pUpdateTemplate, instance.descriptorInfos.data());
-            }
-        } else {
-            const vector<VkWriteDescriptorSet> &entries = instance.descriptorUpdateEntries;
-            vkUpdateDescriptorSets(_device->vkDevice, entries.size(), entries.data(), 0, nullptr);
+        if (!_writes.empty()) {
+            vkUpdateDescriptorSets(_device->vkDevice, _writes.size(), _writes.data(), 0, nullptr);
+            _writes.clear();
         }
     }
 
+private:
     CCVKGPUDevice *_device = nullptr;
     using DescriptorSetList = unordered_set<const CCVKGPUDescriptorSet *>;
     vector<DescriptorSetList> _setsToBeUpdated;
+    vector<VkWriteDescriptorSet> _writes;
 };
 
 /**
@@ -0,0 +1,200 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "VKStd.h"
+
+#include "VKGPUObjects.h"
+#include "VKPipelineCache.h"
+#include "base/ThreadPool.h"
+
+#include <cstdio>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr uint PIPELINE_CACHE_MAGIC = 0x4350564bu; // 'KVPC'
+constexpr uint PIPELINE_CACHE_VERSION = 1u;
+
+// engine-side header prepended to the driver blob, so truncated or
+// corrupted files never reach vkCreatePipelineCache
+struct PipelineCacheFileHeader {
+    uint magic = PIPELINE_CACHE_MAGIC;
+    uint version = PIPELINE_CACHE_VERSION;
+    uint dataSize = 0u;
+    uint checksum = 0u;
+};
+
+// layout of VkPipelineCacheHeaderVersionOne, as defined by the spec
+constexpr size_t VK_PIPELINE_CACHE_HEADER_SIZE = 4u * sizeof(uint32_t) + VK_UUID_SIZE;
+} // namespace
+
+CCVKPipelineCache::CCVKPipelineCache()
+: Object() {
+}
+
+CCVKPipelineCache::~CCVKPipelineCache() {
+}
+
+bool CCVKPipelineCache::initialize(CCVKGPUDevice *gpuDevice, const VkPhysicalDeviceProperties &properties, const String &path) {
+    _gpuDevice = gpuDevice;
+    _vendorID = properties.vendorID;
+    _deviceID = properties.deviceID;
+    memcpy(_pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    _path = path;
+
+    vector<uint8_t> fileData;
+    if (FILE *file = fopen(_path.c_str(), "rb")) {
+        fseek(file, 0, SEEK_END);
+        const long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (size > 0) {
+            fileData.resize(static_cast<size_t>(size));
+            if (fread(fileData.data(), 1, fileData.size(), file) != fileData.size()) {
+                fileData.clear();
+            }
+        }
+        fclose(file);
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    if (!fileData.empty()) {
+        PipelineCacheFileHeader header;
+        const uint8_t *blob = fileData.data() + sizeof(header);
+        bool valid = fileData.size() > sizeof(header);
+        if (valid) {
+            memcpy(&header, fileData.data(), sizeof(header));
+            valid = header.magic == PIPELINE_CACHE_MAGIC && header.version == PIPELINE_CACHE_VERSION &&
+                    fileData.size() - sizeof(header) == header.dataSize &&
+                    computeChecksum(blob, header.dataSize) == header.checksum &&
+                    isCompatible(blob, header.dataSize);
+        }
+        if (valid) {
+            pipelineCacheInfo.initialDataSize = header.dataSize;
+            pipelineCacheInfo.pInitialData = blob;
+            _blobSize = header.dataSize;
+        } else {
+            CC_LOG_INFO("Discarding stale pipeline cache: %s", _path.c_str());
+        }
+    }
+
+    VkResult res = vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_vkPipelineCache);
+    if (res != VK_SUCCESS && pipelineCacheInfo.pInitialData) {
+        // the driver may still reject the blob, start over with an empty cache
+        pipelineCacheInfo.initialDataSize = 0u;
+        pipelineCacheInfo.pInitialData = nullptr;
+        _blobSize = 0u;
+        res = vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_vkPipelineCache);
+    }
+    VK_CHECK(res);
+
+    _threadPool = ThreadPool::newSingleThreadPool();
+
+    return res == VK_SUCCESS;
+}
+
+void CCVKPipelineCache::destroy() {
+    CC_SAFE_DELETE(_threadPool);
+
+    if (_vkPipelineCache != VK_NULL_HANDLE) {
+        if (_dirty) save();
+        vkDestroyPipelineCache(_gpuDevice->vkDevice, _vkPipelineCache, nullptr);
+        _vkPipelineCache = VK_NULL_HANDLE;
+    }
+    _gpuDevice = nullptr;
+}
+
+void CCVKPipelineCache::tick() {
+    if (++_frameCount < SAVE_INTERVAL) return;
+    _frameCount = 0u;
+
+    if (!_dirty || !_threadPool || _saving.exchange(true)) return;
+    _threadPool->pushTask([this](int /*threadId*/) {
+        save();
+        _saving = false;
+    });
+}
+
+void CCVKPipelineCache::save() {
+    std::lock_guard<std::mutex> lock(_saveMutex);
+    _dirty = false;
+
+    size_t dataSize = 0u;
+    VK_CHECK(vkGetPipelineCacheData(_gpuDevice->vkDevice, _vkPipelineCache, &dataSize, nullptr));
+    if (!dataSize) return;
+
+    PipelineCacheFileHeader header;
+    vector<uint8_t> fileData(sizeof(header) + dataSize);
+    if (vkGetPipelineCacheData(_gpuDevice->vkDevice, _vkPipelineCache, &dataSize, fileData.data() + sizeof(header)) != VK_SUCCESS) {
+        _dirty = true;
+        return;
+    }
+    fileData.resize(sizeof(header) + dataSize);
+    header.dataSize = static_cast<uint>(dataSize);
+    header.checksum = computeChecksum(fileData.data() + sizeof(header), dataSize);
+    memcpy(fileData.data(), &header, sizeof(header));
+
+    // write to a temporary file first so an interrupted save never leaves a torn cache behind
+    const String tempPath = _path + ".tmp";
+    FILE *file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        CC_LOG_WARNING("Failed to save pipeline cache: %s", _path.c_str());
+        return;
+    }
+    const bool written = fwrite(fileData.data(), 1, fileData.size(), file) == fileData.size();
+    fclose(file);
+
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    remove(_path.c_str()); // rename doesn't replace existing files here
+#endif
+    if (!written || rename(tempPath.c_str(), _path.c_str())) {
+        remove(tempPath.c_str());
+        CC_LOG_WARNING("Failed to save pipeline cache: %s", _path.c_str());
+        return;
+    }
+    _blobSize = static_cast<uint>(dataSize);
+}
+
+void CCVKPipelineCache::recordPipeline(bool cacheHit) {
+    if (cacheHit) {
+        ++_hitCount;
+    } else {
+        ++_missCount;
+        _dirty = true;
+    }
+}
+
+bool CCVKPipelineCache::isCompatible(const uint8_t *data, size_t size) const {
+    if (size < VK_PIPELINE_CACHE_HEADER_SIZE) return false;
+
+    uint32_t header[4];
+    memcpy(header, data, sizeof(header));
+    return header[0] >= VK_PIPELINE_CACHE_HEADER_SIZE &&
+           header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header[2] == _vendorID &&
+           header[3] == _deviceID &&
+           !memcmp(data + sizeof(header), _pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+} // namespace gfx
+} // namespace cc
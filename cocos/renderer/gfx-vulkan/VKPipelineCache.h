@@ -0,0 +1,88 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_GFXVULKAN_PIPELINE_CACHE_H_
+#define CC_GFXVULKAN_PIPELINE_CACHE_H_
+
+#include "VKUtils.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace cc {
+class ThreadPool;
+
+namespace gfx {
+
+class CCVKGPUDevice;
+
+// Owns the device's VkPipelineCache and persists its contents across launches.
+// The blob is only handed back to the driver if it was written by the same
+// physical device, and it is written back on shutdown as well as periodically
+// on a background thread while new pipelines keep getting compiled.
+class CC_VULKAN_API CCVKPipelineCache final : public Object {
+public:
+    static constexpr uint SAVE_INTERVAL = 1800u; // in frames
+
+    CCVKPipelineCache();
+    ~CCVKPipelineCache();
+
+    bool initialize(CCVKGPUDevice *gpuDevice, const VkPhysicalDeviceProperties &properties, const String &path);
+    void destroy();
+
+    // Called once per frame; schedules a background save every SAVE_INTERVAL frames if anything changed.
+    void tick();
+    void save();
+
+    // Reports whether a newly created pipeline was served from the cache.
+    void recordPipeline(bool cacheHit);
+
+    CC_INLINE VkPipelineCache getVkPipelineCache() const { return _vkPipelineCache; }
+    CC_INLINE uint getHitCount() const { return _hitCount; }
+    CC_INLINE uint getMissCount() const { return _missCount; }
+    CC_INLINE uint getBlobSize() const { return _blobSize; }
+
+private:
+    bool isCompatible(const uint8_t *data, size_t size) const;
+
+    CCVKGPUDevice *_gpuDevice = nullptr;
+    VkPipelineCache _vkPipelineCache = VK_NULL_HANDLE;
+    uint32_t _vendorID = 0u;
+    uint32_t _deviceID = 0u;
+    uint8_t _pipelineCacheUUID[VK_UUID_SIZE] = {};
+    String _path;
+
+    uint _frameCount = 0u;
+    std::atomic<uint> _hitCount{0u};
+    std::atomic<uint> _missCount{0u};
+    std::atomic<uint> _blobSize{0u};
+    std::atomic<bool> _dirty{false};
+    std::atomic<bool> _saving{false};
+    std::mutex _saveMutex;
+    ThreadPool *_threadPool = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_GFXVULKAN_PIPELINE_CACHE_H_
@@ -72,6 +72,7 @@ void CCVKQueue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence *
             _numDrawCalls += cmdBuff->_numDrawCalls;
             _numInstances += cmdBuff->_numInstances;
             _numTriangles += cmdBuff->_numTriangles;
+            _numUploadBytes += cmdBuff->_numUploadBytes;
         }
     }
 
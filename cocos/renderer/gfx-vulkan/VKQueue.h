@@ -48,6 +48,7 @@ private:
     uint _numDrawCalls = 0;
     uint _numInstances = 0;
     uint _numTriangles = 0;
+    uint _numUploadBytes = 0;
 };
 
 } // namespace gfx
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "glslang/Public/ShaderLang.h"
 #include "StandAlone/ResourceLimits.h"
 
+#include <mutex>
+
 namespace cc {
 namespace gfx {
 
@@ -71,13 +73,11 @@ glslang::EShTargetLanguageVersion getTargetVersion(int vulkanMinorVersion) {
     }
 }
 
-bool glslangInitialized = false;
+std::once_flag glslangInitialized;
 
 const vector<unsigned int> GLSL2SPIRV(ShaderStageFlagBit type, const String &source, int vulkanMinorVersion = 0) {
-    if (!glslangInitialized) {
-        glslang::InitializeProcess();
-        glslangInitialized = true;
-    }
+    // shaders may be compiled on the SPIR-V cache's background thread as well
+    std::call_once(glslangInitialized, []() { glslang::InitializeProcess(); });
 
     EShLanguage stage = getShaderStage(type);
     const char *string = source.c_str();
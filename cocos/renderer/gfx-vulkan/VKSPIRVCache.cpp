@@ -0,0 +1,307 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "VKStd.h"
+
+#include "VKSPIRV.h"
+#include "VKSPIRVCache.h"
+#include "VKUtils.h"
+#include "base/ThreadPool.h"
+#include "platform/FileUtils.h"
+
+#include <cstdio>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr uint SPIRV_CACHE_MAGIC = 0x43565053u; // 'SPVC'
+constexpr uint SPIRV_CACHE_VERSION = 1u;
+constexpr uint SPIRV_MAGIC_NUMBER = 0x07230203u;
+const char *SPIRV_VERSION_DIRECTIVE = "#version 450\n";
+
+uint64_t fnv1a64(const void *data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0u; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t getKey(ShaderStageFlagBit type, const String &source, int vulkanMinorVersion) {
+    const uint header[] = {static_cast<uint>(type), static_cast<uint>(vulkanMinorVersion), static_cast<uint>(source.size())};
+    return fnv1a64(source.data(), source.size(), fnv1a64(header, sizeof(header)));
+}
+
+bool readFile(const String &path, vector<uint8_t> &data) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bool succeeded = size >= 0;
+    if (succeeded) {
+        data.resize(static_cast<size_t>(size));
+        succeeded = fread(data.data(), 1, data.size(), file) == data.size();
+    }
+    fclose(file);
+    return succeeded;
+}
+
+bool writeFile(const String &path, const void *data, size_t size) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const bool succeeded = fwrite(data, 1, size, file) == size;
+    fclose(file);
+    if (!succeeded) remove(path.c_str());
+    return succeeded;
+}
+
+template <typename T>
+void writeValue(vector<uint8_t> &data, const T &value) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readValue(const vector<uint8_t> &data, size_t &offset, T &value) {
+    if (offset + sizeof(T) > data.size()) return false;
+    memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+} // namespace
+
+CCVKSPIRVCache::CCVKSPIRVCache()
+: Object() {
+}
+
+CCVKSPIRVCache::~CCVKSPIRVCache() {
+}
+
+bool CCVKSPIRVCache::initialize(const String &directory, int vulkanMinorVersion, uint capacity) {
+    _directory = directory;
+    if (!_directory.empty() && _directory.back() != '/') {
+        _directory += '/';
+    }
+    _vulkanMinorVersion = vulkanMinorVersion;
+    _capacity = capacity;
+
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isDirectoryExist(_directory) && !fileUtils->createDirectory(_directory)) {
+        CC_LOG_WARNING("Failed to create SPIR-V cache directory: %s", _directory.c_str());
+        _directory.clear();
+        return false;
+    }
+
+    loadIndex();
+    _threadPool = ThreadPool::newSingleThreadPool();
+
+    return true;
+}
+
+void CCVKSPIRVCache::destroy() {
+    // the thread pool finishes any queued precompilation before it goes away
+    CC_SAFE_DELETE(_threadPool);
+    flush();
+
+    _entries.clear();
+    _size = 0u;
+}
+
+void CCVKSPIRVCache::compile(ShaderStageFlagBit type, const String &source, vector<unsigned int> &spirv) {
+    if (_directory.empty()) {
+        spirv = GLSL2SPIRV(type, SPIRV_VERSION_DIRECTIVE + source, _vulkanMinorVersion);
+        return;
+    }
+
+    const uint64_t key = getKey(type, source, _vulkanMinorVersion);
+    if (load(key, spirv)) {
+        ++_hitCount;
+        return;
+    }
+
+    ++_missCount;
+    spirv = GLSL2SPIRV(type, SPIRV_VERSION_DIRECTIVE + source, _vulkanMinorVersion);
+    if (!spirv.empty()) {
+        store(key, spirv);
+    }
+}
+
+void CCVKSPIRVCache::precompile(const ShaderStageList &stages) {
+    if (!_threadPool) return;
+
+    _threadPool->pushTask([this, stages](int /*threadId*/) {
+        vector<unsigned int> spirv;
+        for (const ShaderStage &stage : stages) {
+            const uint64_t key = getKey(stage.stage, stage.source, _vulkanMinorVersion);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_entries.count(key)) continue;
+            }
+            spirv = GLSL2SPIRV(stage.stage, SPIRV_VERSION_DIRECTIVE + stage.source, _vulkanMinorVersion);
+            if (!spirv.empty()) {
+                store(key, spirv);
+            }
+        }
+        flush();
+    });
+}
+
+void CCVKSPIRVCache::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_dirty) {
+        saveIndex();
+        _dirty = false;
+    }
+}
+
+String CCVKSPIRVCache::getBlobPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(key));
+    return _directory + name;
+}
+
+bool CCVKSPIRVCache::load(uint64_t key, vector<unsigned int> &spirv) {
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _entries.find(key);
+        if (iter == _entries.end()) return false;
+        entry = iter->second;
+    }
+
+    vector<uint8_t> data;
+    const bool valid = readFile(getBlobPath(key), data) &&
+                       data.size() == entry.size &&
+                       data.size() >= sizeof(uint) && data.size() % sizeof(uint) == 0 &&
+                       *reinterpret_cast<const uint *>(data.data()) == SPIRV_MAGIC_NUMBER &&
+                       computeChecksum(data.data(), data.size()) == entry.checksum;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!valid) {
+        CC_LOG_WARNING("Discarding corrupted SPIR-V cache entry %016llx.", static_cast<unsigned long long>(key));
+        if (_entries.count(key)) evict(key);
+        _dirty = true;
+        return false;
+    }
+
+    spirv.resize(data.size() / sizeof(unsigned int));
+    memcpy(spirv.data(), data.data(), data.size());
+
+    auto iter = _entries.find(key);
+    if (iter != _entries.end()) {
+        iter->second.lastUse = ++_useCounter;
+        _dirty = true;
+    }
+    return true;
+}
+
+void CCVKSPIRVCache::store(uint64_t key, const vector<unsigned int> &spirv) {
+    const size_t size = spirv.size() * sizeof(unsigned int);
+    if (size > _capacity) return;
+
+    Entry entry;
+    entry.size = static_cast<uint>(size);
+    entry.checksum = computeChecksum(spirv.data(), size);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_entries.count(key)) return;
+    if (!writeFile(getBlobPath(key), spirv.data(), size)) {
+        CC_LOG_WARNING("Failed to write SPIR-V cache entry %016llx.", static_cast<unsigned long long>(key));
+        return;
+    }
+
+    entry.lastUse = ++_useCounter;
+    _entries[key] = entry;
+    _size += entry.size;
+    _dirty = true;
+
+    while (_size > _capacity) {
+        auto victim = _entries.end();
+        for (auto iter = _entries.begin(); iter != _entries.end(); ++iter) {
+            if (iter->first != key && (victim == _entries.end() || iter->second.lastUse < victim->second.lastUse)) {
+                victim = iter;
+            }
+        }
+        if (victim == _entries.end()) break;
+        evict(victim->first);
+    }
+}
+
+void CCVKSPIRVCache::evict(uint64_t key) {
+    auto iter = _entries.find(key);
+    remove(getBlobPath(key).c_str());
+    _size -= iter->second.size;
+    _entries.erase(iter);
+}
+
+void CCVKSPIRVCache::loadIndex() {
+    vector<uint8_t> data;
+    if (!readFile(_directory + "index.bin", data)) return;
+
+    size_t offset = 0u;
+    uint magic = 0u, version = 0u, count = 0u;
+    if (!readValue(data, offset, magic) || magic != SPIRV_CACHE_MAGIC ||
+        !readValue(data, offset, version) || version != SPIRV_CACHE_VERSION ||
+        !readValue(data, offset, count)) {
+        CC_LOG_WARNING("Ignoring incompatible SPIR-V cache index in %s", _directory.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (uint i = 0u; i < count; ++i) {
+        uint64_t key = 0u;
+        Entry entry;
+        if (!readValue(data, offset, key) || !readValue(data, offset, entry.size) ||
+            !readValue(data, offset, entry.checksum) || !readValue(data, offset, entry.lastUse)) {
+            CC_LOG_WARNING("Truncated SPIR-V cache index in %s", _directory.c_str());
+            break;
+        }
+        _entries[key] = entry;
+        _size += entry.size;
+        _useCounter = std::max(_useCounter, entry.lastUse);
+    }
+}
+
+void CCVKSPIRVCache::saveIndex() {
+    vector<uint8_t> data;
+    data.reserve(3u * sizeof(uint) + _entries.size() * (2u * sizeof(uint64_t) + 2u * sizeof(uint)));
+    writeValue(data, SPIRV_CACHE_MAGIC);
+    writeValue(data, SPIRV_CACHE_VERSION);
+    writeValue(data, static_cast<uint>(_entries.size()));
+    for (const auto &iter : _entries) {
+        writeValue(data, iter.first);
+        writeValue(data, iter.second.size);
+        writeValue(data, iter.second.checksum);
+        writeValue(data, iter.second.lastUse);
+    }
+
+    if (!writeFile(_directory + "index.bin", data.data(), data.size())) {
+        CC_LOG_WARNING("Failed to save SPIR-V cache index in %s", _directory.c_str());
+    }
+}
+
+} // namespace gfx
+} // namespace cc
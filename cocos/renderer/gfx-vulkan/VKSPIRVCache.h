@@ -0,0 +1,95 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_GFXVULKAN_SPIRV_CACHE_H_
+#define CC_GFXVULKAN_SPIRV_CACHE_H_
+
+#include <atomic>
+#include <mutex>
+
+namespace cc {
+class ThreadPool;
+
+namespace gfx {
+
+// Content-addressed on-disk cache of compiled SPIR-V modules.
+// Every entry is keyed by the hash of its stage type, GLSL source and target
+// Vulkan minor version, and lives in its own blob file next to a compact index.
+// Blobs are validated on load and the least recently used ones are evicted
+// once the cache grows beyond its capacity.
+class CC_VULKAN_API CCVKSPIRVCache final : public Object {
+public:
+    static constexpr uint DEFAULT_CAPACITY = 32u * 1024u * 1024u;
+
+    CCVKSPIRVCache();
+    ~CCVKSPIRVCache();
+
+    bool initialize(const String &directory, int vulkanMinorVersion, uint capacity = DEFAULT_CAPACITY);
+    void destroy();
+
+    // Returns the module for the given stage source, compiling and storing it on a miss.
+    // Thread-safe; the source is taken as-is from ShaderStage, without a version directive.
+    void compile(ShaderStageFlagBit type, const String &source, vector<unsigned int> &spirv);
+
+    // Compiles the given stages on a background thread so later lookups hit the cache.
+    void precompile(const ShaderStageList &stages);
+
+    // Writes the index to disk if any entry has changed since the last flush.
+    void flush();
+
+    CC_INLINE uint getHitCount() const { return _hitCount; }
+    CC_INLINE uint getMissCount() const { return _missCount; }
+    CC_INLINE uint getSize() const { return _size; }
+
+private:
+    struct Entry {
+        uint size = 0u;
+        uint checksum = 0u;
+        uint64_t lastUse = 0u;
+    };
+
+    String getBlobPath(uint64_t key) const;
+    bool load(uint64_t key, vector<unsigned int> &spirv);
+    void store(uint64_t key, const vector<unsigned int> &spirv);
+    void evict(uint64_t key);
+    void loadIndex();
+    void saveIndex();
+
+    String _directory;
+    int _vulkanMinorVersion = 0;
+    uint _capacity = DEFAULT_CAPACITY;
+    uint _size = 0u;
+    std::atomic<uint> _hitCount{0u};
+    std::atomic<uint> _missCount{0u};
+    uint64_t _useCounter = 0u;
+    bool _dirty = false;
+
+    unordered_map<uint64_t, Entry> _entries;
+    std::mutex _mutex;
+    ThreadPool *_threadPool = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_GFXVULKAN_SPIRV_CACHE_H_
@@ -0,0 +1,126 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "VKStd.h"
+
+#include "VKGPUObjects.h"
+#include "VKTimestampPool.h"
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr uint QUERY_COUNT = Profiler::MAX_SCOPES * 2;
+} // namespace
+
+CCVKTimestampPool::CCVKTimestampPool()
+: Object() {
+}
+
+CCVKTimestampPool::~CCVKTimestampPool() {
+}
+
+bool CCVKTimestampPool::initialize(CCVKGPUDevice *gpuDevice, uint validBits, float period) {
+    if (!validBits || period <= 0.0f) return false;
+
+    _gpuDevice = gpuDevice;
+    _validMask = validBits >= 64u ? ~0ull : (1ull << validBits) - 1u;
+    _period = period;
+    _results.resize(QUERY_COUNT * 2);
+
+    VkQueryPoolCreateInfo createInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = QUERY_COUNT;
+
+    for (Slot &slot : _slots) {
+        if (vkCreateQueryPool(_gpuDevice->vkDevice, &createInfo, nullptr, &slot.vkQueryPool) != VK_SUCCESS) {
+            CC_LOG_ERROR("Failed to create the timestamp query pool.");
+            return false;
+        }
+        slot.written.resize(QUERY_COUNT, false);
+        slot.needsReset = true;
+    }
+    return true;
+}
+
+void CCVKTimestampPool::destroy() {
+    for (Slot &slot : _slots) {
+        if (slot.vkQueryPool) {
+            vkDestroyQueryPool(_gpuDevice->vkDevice, slot.vkQueryPool, nullptr);
+            slot.vkQueryPool = VK_NULL_HANDLE;
+        }
+        slot.written.clear();
+    }
+    _gpuDevice = nullptr;
+}
+
+void CCVKTimestampPool::reset(VkCommandBuffer vkCommandBuffer, uint slot) {
+    Slot &target = _slots[slot];
+    if (!target.needsReset) return;
+
+    vkCmdResetQueryPool(vkCommandBuffer, target.vkQueryPool, 0, QUERY_COUNT);
+    target.needsReset = false;
+}
+
+void CCVKTimestampPool::write(VkCommandBuffer vkCommandBuffer, uint slot, uint query) {
+    Slot &target = _slots[slot];
+    // writing into a pool that has not been reset yet is invalid, the scope simply gets no GPU time
+    if (target.needsReset || query >= QUERY_COUNT) return;
+
+    // scope begins are even, ends are odd
+    const VkPipelineStageFlagBits stage = (query & 1u) ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    vkCmdWriteTimestamp(vkCommandBuffer, stage, target.vkQueryPool, query);
+    target.written[query] = true;
+}
+
+void CCVKTimestampPool::resolve(Profiler *profiler) {
+    const uint slotIndex = profiler->getResolveSlot();
+    Slot &slot = _slots[slotIndex];
+    const uint scopeCount = std::min(profiler->getScopeCount(slotIndex), Profiler::MAX_SCOPES);
+
+    if (scopeCount && !slot.needsReset) {
+        // no wait flag: queries still in flight report as unavailable instead of stalling
+        const VkResult result = vkGetQueryPoolResults(_gpuDevice->vkDevice, slot.vkQueryPool, 0, scopeCount * 2,
+                                                      scopeCount * 2 * 2 * sizeof(uint64_t), _results.data(), 2 * sizeof(uint64_t),
+                                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result == VK_SUCCESS || result == VK_NOT_READY) {
+            for (uint i = 0u; i < scopeCount; ++i) {
+                const uint begin = i * 2;
+                const uint end = begin + 1;
+                if (!slot.written[begin] || !slot.written[end]) continue;
+                if (!_results[begin * 2 + 1] || !_results[end * 2 + 1]) continue;
+
+                const uint64_t beginNs = static_cast<uint64_t>((_results[begin * 2] & _validMask) * _period);
+                const uint64_t endNs = static_cast<uint64_t>((_results[end * 2] & _validMask) * _period);
+                profiler->resolveGPUScope(slotIndex, i, beginNs, endNs);
+            }
+        }
+    }
+
+    // the slot is about to be recorded into again
+    std::fill(slot.written.begin(), slot.written.end(), false);
+    slot.needsReset = true;
+}
+
+} // namespace gfx
+} // namespace cc
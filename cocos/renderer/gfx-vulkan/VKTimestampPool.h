@@ -0,0 +1,68 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_GFXVULKAN_TIMESTAMP_POOL_H_
+#define CC_GFXVULKAN_TIMESTAMP_POOL_H_
+
+#include "VKUtils.h"
+
+namespace cc {
+namespace gfx {
+
+class CCVKGPUDevice;
+
+// GPU timestamps for the profiler, one query pool per profiler frame slot.
+// A pool is reset at the start of the first primary command buffer of its frame
+// and read back without waiting when the slot comes around again.
+class CC_VULKAN_API CCVKTimestampPool final : public Object {
+public:
+    CCVKTimestampPool();
+    ~CCVKTimestampPool();
+
+    bool initialize(CCVKGPUDevice *gpuDevice, uint validBits, float period);
+    void destroy();
+
+    // must be recorded outside of any render pass
+    void reset(VkCommandBuffer vkCommandBuffer, uint slot);
+    void write(VkCommandBuffer vkCommandBuffer, uint slot, uint query);
+    // hands the finished timestamps of the profiler's resolve slot over to it
+    void resolve(Profiler *profiler);
+
+private:
+    struct Slot {
+        VkQueryPool vkQueryPool = VK_NULL_HANDLE;
+        vector<bool> written;
+        bool needsReset = true;
+    };
+
+    CCVKGPUDevice *_gpuDevice = nullptr;
+    Slot _slots[Profiler::FRAME_LATENCY];
+    vector<uint64_t> _results; // value and availability pairs
+    uint64_t _validMask = 0u;
+    double _period = 1.0; // nanoseconds per tick
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_GFXVULKAN_TIMESTAMP_POOL_H_
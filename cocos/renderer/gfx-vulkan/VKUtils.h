@@ -415,6 +415,17 @@ uint selectMemoryType(const VkPhysicalDeviceMemoryProperties &memoryProperties,
     return ~0u;
 }
 
+// FNV-1a, used to validate blobs persisted across launches
+uint computeChecksum(const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    uint hash = 2166136261u;
+    for (size_t i = 0u; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 VkImageCreateFlags MapVkImageCreateFlags(TextureType type) {
     uint res = 0u;
     switch (type) {
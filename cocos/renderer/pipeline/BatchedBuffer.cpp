@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "BatchedBuffer.h"
 #include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXInputAssembler.h"
@@ -31,6 +32,8 @@ THE SOFTWARE.
 namespace cc {
 namespace pipeline {
 map<uint, map<uint, BatchedBuffer *>> BatchedBuffer::_buffers;
+uint BatchedBuffer::_copiedBytes = 0;
+uint BatchedBuffer::_uploadedBytes = 0;
 BatchedBuffer *BatchedBuffer::get(uint pass) {
     return BatchedBuffer::get(pass, 0);
 }
@@ -41,6 +44,11 @@ BatchedBuffer *BatchedBuffer::get(uint pass, uint extraKey) {
     return buffer;
 }
 
+void BatchedBuffer::beginFrame() {
+    _copiedBytes = 0;
+    _uploadedBytes = 0;
+}
+
 BatchedBuffer::BatchedBuffer(const PassView *pass)
 : _pass(pass),
   _device(gfx::Device::getInstance()) {
@@ -76,113 +84,117 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
         return;
     }
 
-    const auto flatBuffer = subMesh->getFlatBuffer(flatBuffersID[1]);
-    auto vbSize = 0;
-    auto indexSize = 0;
-    const auto vbCount = flatBuffer->count;
-    const auto pass = subModel->getPassView(passIdx);
-    const auto shader = subModel->getShader(passIdx);
-    const auto descriptorSet = subModel->getDescriptorSet();
-    bool isBatchExist = false;
-
-    for (auto i = 0; i < _batches.size(); ++i) {
-        auto &batch = _batches[i];
-        if (batch.vbs.size() == flatBuffersCount && batch.mergeCount < UBOLocalBatched::BATCHING_COUNT) {
-            isBatchExist = true;
-            for (auto j = 0; j < flatBuffersCount; ++j) {
-                const auto vb = batch.vbs[j];
-                if (vb->getStride() != subMesh->getFlatBuffer(flatBuffersID[j + 1])->stride) {
-                    isBatchExist = false;
-                    break;
-                }
+    BatchedItem *batch = nullptr;
+    for (auto &candidate : _batches) {
+        if (candidate.vbs.size() != flatBuffersCount || candidate.mergeCount >= UBOLocalBatched::BATCHING_COUNT) {
+            continue;
+        }
+
+        bool isCompatible = true;
+        for (auto j = 0; j < flatBuffersCount; ++j) {
+            if (candidate.vbs[j]->getStride() != subMesh->getFlatBuffer(flatBuffersID[j + 1])->stride) {
+                isCompatible = false;
+                break;
             }
+        }
+        if (isCompatible) {
+            batch = &candidate;
+            break;
+        }
+    }
+    if (!batch) {
+        batch = createBatch(subModel);
+    }
 
-            if (isBatchExist) {
-                for (auto j = 0; j < flatBuffersCount; ++j) {
-                    const auto flatBuffer = subMesh->getFlatBuffer(flatBuffersID[j + 1]);
-                    auto batchVB = batch.vbs[j];
-                    auto vbData = batch.vbDatas[j];
-                    const auto vbBufSizeOld = batchVB->getSize();
-                    vbSize = (vbCount + batch.vbCount) * flatBuffer->stride;
-                    if (vbSize > vbBufSizeOld) {
-                        uint8_t *vbDataNew = static_cast<uint8_t *>(CC_MALLOC(vbSize));
-                        memcpy(vbDataNew, vbData, vbBufSizeOld);
-                        batchVB->resize(vbSize);
-                        CC_FREE(vbData);
-                        batch.vbDatas[j] = vbDataNew;
-                        vbData = vbDataNew;
-                    }
-
-                    auto size = 0u;
-                    auto offset = batch.vbCount * flatBuffer->stride;
-                    const auto data = flatBuffer->getBuffer(&size);
-                    memcpy(vbData + offset, data, size);
-                }
-
-                auto indexData = batch.indexData;
-                indexSize = (vbCount + batch.vbCount) * sizeof(float);
-                if (indexSize > batch.indexBuffer->getSize()) {
-
-                    auto newIndexData = static_cast<float *>(CC_MALLOC(indexSize));
-                    memcpy(newIndexData, indexData, batch.indexBuffer->getSize());
-                    CC_FREE(indexData);
-                    batch.indexData = newIndexData;
-                    indexData = batch.indexData;
-                    batch.indexBuffer->resize(indexSize);
-                }
-
-                const auto start = batch.vbCount;
-                const auto end = start + vbCount;
-                const auto mergeCount = batch.mergeCount;
-                if (indexData[start] != mergeCount || indexData[end - 1] != mergeCount) {
-                    for (auto j = start; j < end; j++) {
-                        indexData[j] = mergeCount + 0.1f; // guard against underflow
-                    }
-                }
-
-                // update world matrix
-                const auto offset = UBOLocalBatched::MAT_WORLDS_OFFSET + batch.mergeCount * 16;
-                const auto &worldMatrix = model->getTransform()->worldMatrix;
-                memcpy(batch.uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix));
-
-                if (!batch.mergeCount) {
-                    descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
-                    descriptorSet->update();
-                    batch.pass = pass;
-                    batch.shader = shader;
-                    batch.descriptorSet = descriptorSet;
-                }
-
-                ++batch.mergeCount;
-                batch.vbCount += vbCount;
-                auto prevCount = batch.ia->getVertexCount();
-                batch.ia->setVertexCount(prevCount + vbCount);
-                return;
+    const auto vbCount = subMesh->getFlatBuffer(flatBuffersID[1])->count;
+    const auto mergeIndex = batch->mergeCount;
+    const auto vertexStart = batch->vbCount;
+    const auto vertexEnd = vertexStart + vbCount;
+    const BatchedMember member = {subModel, subModel->subMeshID};
+    if (mergeIndex >= batch->members.size() || !(batch->members[mergeIndex] == member)) {
+        batch->members.resize(mergeIndex);
+        batch->members.emplace_back(member);
+        batch->dirtyMember = std::min(batch->dirtyMember, mergeIndex);
+
+        for (auto j = 0; j < flatBuffersCount; ++j) {
+            const auto flatBuffer = subMesh->getFlatBuffer(flatBuffersID[j + 1]);
+            auto batchVB = batch->vbs[j];
+            const auto vbSize = vertexEnd * flatBuffer->stride;
+            if (vbSize > batchVB->getSize()) {
+                const auto newSize = std::max(vbSize, batchVB->getSize() * 2);
+                const auto usedSize = vertexStart * flatBuffer->stride;
+                uint8_t *vbDataNew = static_cast<uint8_t *>(CC_MALLOC(newSize));
+                memcpy(vbDataNew, batch->vbDatas[j], usedSize);
+                _copiedBytes += usedSize;
+                CC_FREE(batch->vbDatas[j]);
+                batch->vbDatas[j] = vbDataNew;
+                batchVB->resize(newSize);
             }
+
+            auto size = 0u;
+            const auto data = flatBuffer->getBuffer(&size);
+            memcpy(batch->vbDatas[j] + vertexStart * flatBuffer->stride, data, size);
+            _copiedBytes += size;
+        }
+
+        const auto indexSize = static_cast<uint>(vertexEnd * sizeof(float));
+        if (indexSize > batch->indexBuffer->getSize()) {
+            const auto newSize = std::max(indexSize, batch->indexBuffer->getSize() * 2);
+            const auto usedSize = static_cast<uint>(vertexStart * sizeof(float));
+            auto newIndexData = static_cast<float *>(CC_MALLOC(newSize));
+            memcpy(newIndexData, batch->indexData, usedSize);
+            _copiedBytes += usedSize;
+            CC_FREE(batch->indexData);
+            batch->indexData = newIndexData;
+            batch->indexBuffer->resize(newSize);
         }
+        std::fill(batch->indexData + vertexStart, batch->indexData + vertexEnd, mergeIndex + 0.1f); // guard against underflow
+        _copiedBytes += vbCount * sizeof(float);
     }
 
-    // Create a new batch
+    // update world matrix
+    const auto offset = UBOLocalBatched::MAT_WORLDS_OFFSET + mergeIndex * 16;
+    const auto &worldMatrix = model->getTransform()->worldMatrix;
+    memcpy(batch->uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix));
+    _copiedBytes += sizeof(worldMatrix);
+
+    if (!mergeIndex) {
+        const auto descriptorSet = subModel->getDescriptorSet();
+        if (descriptorSet->getBuffer(UBOLocalBatched::BINDING) != batch->ubo) {
+            descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch->ubo);
+            descriptorSet->update();
+        }
+        batch->pass = subModel->getPassView(passIdx);
+        batch->shader = subModel->getShader(passIdx);
+        batch->descriptorSet = descriptorSet;
+    }
+
+    ++batch->mergeCount;
+    batch->vbCount = vertexEnd;
+    batch->ia->setVertexCount(vertexEnd);
+}
+
+BatchedItem *BatchedBuffer::createBatch(const SubModelView *subModel) {
+    const auto flatBuffersID = subModel->getSubMesh()->getFlatBufferArrayID();
+    const auto flatBuffersCount = flatBuffersID[0];
     vector<gfx::Buffer *> vbs(flatBuffersCount, nullptr);
     vector<uint8_t *> vbDatas(flatBuffersCount, 0);
     vector<gfx::Buffer *> totalVBs(flatBuffersCount + 1, nullptr);
 
+    uint vbCount = 0;
     for (auto i = 0; i < flatBuffersCount; ++i) {
-        const auto flatBuffer = subMesh->getFlatBuffer(flatBuffersID[i + 1]);
+        const auto flatBuffer = subModel->getSubMesh()->getFlatBuffer(flatBuffersID[i + 1]);
         auto newVB = _device->createBuffer({
             gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
             gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
             flatBuffer->count * flatBuffer->stride,
             flatBuffer->stride,
         });
-        auto size = 0u;
-        auto data = flatBuffer->getBuffer(&size);
-        newVB->update(data, size);
 
         vbs[i] = newVB;
         vbDatas[i] = static_cast<uint8_t *>(CC_MALLOC(newVB->getSize()));
-        memset(vbDatas[i], 0, newVB->getSize());
         totalVBs[i] = newVB;
+        vbCount = flatBuffer->count;
     }
 
     const auto indexBufferSize = vbCount * sizeof(float);
@@ -193,8 +205,6 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
         sizeof(float),
     });
     float *indexData = static_cast<float *>(CC_MALLOC(indexBufferSize));
-    memset(indexData, 0, indexBufferSize);
-    indexBuffer->update(indexData, indexBufferSize);
     totalVBs[flatBuffersCount] = indexBuffer;
 
     vector<gfx::Attribute> attributes = subModel->getInputAssembler()->getAttributes();
@@ -215,31 +225,54 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
         UBOLocalBatched::SIZE,
     });
 
-    descriptorSet->bindBuffer(UBOLocalBatched::BINDING, ubo);
-    descriptorSet->update();
-
-    std::array<float, UBOLocalBatched::COUNT> uboData;
-    const auto &worldMatrix = model->getTransform()->worldMatrix;
-    memcpy(uboData.data() + UBOLocalBatched::MAT_WORLDS_OFFSET, worldMatrix.m, sizeof(worldMatrix));
     BatchedItem item = {
-        std::move(vbs),                  //vbs
-        std::move(vbDatas),              //vbDatas
-        indexBuffer,                     //indexBuffer
-        static_cast<float *>(indexData), //indexData
-        vbCount,                         //vbCount
-        1,                               //mergeCount
-        ia,                              //ia
-        ubo,                             //ubo
-        std::move(uboData),              //uboData
-        descriptorSet,                   //descriptorSet
-        pass,                            //pass
-        shader,                          //shader
+        std::move(vbs),     //vbs
+        std::move(vbDatas), //vbDatas
+        indexBuffer,        //indexBuffer
+        indexData,          //indexData
+        0,                  //vbCount
+        0,                  //mergeCount
+        ia,                 //ia
+        ubo,                //ubo
+        {},                 //uboData
+        nullptr,            //descriptorSet
+        nullptr,            //pass
+        nullptr,            //shader
     };
     _batches.emplace_back(std::move(item));
+    return &_batches.back();
+}
+
+void BatchedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
+    for (auto &batch : _batches) {
+        if (!batch.mergeCount) continue;
+
+        // Merged vertices only need uploading after the membership changed, the world matrices always do.
+        if (batch.dirtyMember < batch.mergeCount) {
+            for (size_t i = 0; i < batch.vbs.size(); ++i) {
+                const auto size = batch.vbCount * batch.vbs[i]->getStride();
+                cmdBuff->updateBuffer(batch.vbs[i], batch.vbDatas[i], size);
+                _uploadedBytes += size;
+            }
+            const auto indexSize = static_cast<uint>(batch.vbCount * sizeof(float));
+            cmdBuff->updateBuffer(batch.indexBuffer, batch.indexData, indexSize);
+            _uploadedBytes += indexSize;
+            batch.dirtyMember = UBOLocalBatched::BATCHING_COUNT;
+        }
+
+        const auto uboSize = static_cast<uint>((UBOLocalBatched::MAT_WORLDS_OFFSET + batch.mergeCount * 16) * sizeof(float));
+        cmdBuff->updateBuffer(batch.ubo, batch.uboData.data(), uboSize);
+        _uploadedBytes += uboSize;
+    }
 }
 
 void BatchedBuffer::clear() {
     for (auto &batch : _batches) {
+        // Members merged but never uploaded can't be trusted by the next frame.
+        if (batch.dirtyMember < batch.members.size()) {
+            batch.members.resize(batch.dirtyMember);
+        }
+        batch.dirtyMember = UBOLocalBatched::BATCHING_COUNT;
         batch.vbCount = 0;
         batch.mergeCount = 0;
         batch.ia->setVertexCount(0);
@@ -30,6 +30,13 @@ namespace pipeline {
 struct PassView;
 struct SubModelView;
 
+struct CC_DLL BatchedMember {
+    const SubModelView *subModel = nullptr;
+    uint subMeshID = 0;
+
+    CC_INLINE bool operator==(const BatchedMember &rhs) const { return subModel == rhs.subModel && subMeshID == rhs.subMeshID; }
+};
+
 struct CC_DLL BatchedItem {
     gfx::BufferList vbs;
     vector<uint8_t *> vbDatas;
@@ -43,6 +50,11 @@ struct CC_DLL BatchedItem {
     gfx::DescriptorSet *descriptorSet = nullptr;
     const PassView *pass = nullptr;
     gfx::Shader *shader = nullptr;
+    // The sub-meshes the merged vertex data holds, in merge order. A frame merging the same
+    // sequence only refreshes the world matrices, a divergence rebuilds from that point on.
+    vector<BatchedMember> members;
+    // Members from this index on have not been uploaded yet.
+    uint dirtyMember = UBOLocalBatched::BATCHING_COUNT;
 };
 typedef vector<BatchedItem> BatchedItemList;
 typedef vector<uint> DynamicOffsetList;
@@ -51,12 +63,17 @@ class CC_DLL BatchedBuffer : public Object {
 public:
     static BatchedBuffer *get(uint pass);
     static BatchedBuffer *get(uint pass, uint extraKey);
+    // Resets the per-frame copy and upload counters.
+    static void beginFrame();
+    CC_INLINE static uint getCopiedBytes() { return _copiedBytes; }
+    CC_INLINE static uint getUploadedBytes() { return _uploadedBytes; }
 
     BatchedBuffer(const PassView *pass);
     virtual ~BatchedBuffer();
 
     void destroy();
     void merge(const SubModelView *, uint passIdx, const ModelView *);
+    void uploadBuffers(gfx::CommandBuffer *cmdBuff);
     void clear();
     void setDynamicOffset(uint idx, uint value);
 
@@ -65,7 +82,11 @@ public:
     CC_INLINE const DynamicOffsetList &getDynamicOffset() const { return _dynamicOffsets; }
 
 private:
+    BatchedItem *createBatch(const SubModelView *subModel);
+
     static map<uint, map<uint, BatchedBuffer *>> _buffers;
+    static uint _copiedBytes;
+    static uint _uploadedBytes;
     DynamicOffsetList _dynamicOffsets;
     BatchedItemList _batches;
     const PassView *_pass = nullptr;
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "Define.h"
 #include "cocos/bindings/jswrapper/SeApi.h"
+#include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDevice.h"
 #include "helper/SharedMemory.h"
 
@@ -277,6 +278,21 @@ const gfx::UniformSampler SPOT_LIGHTING_MAP::LAYOUT = {
     1,
 };
 
+const String CLUSTER_LIGHTS::NAME = "cc_clusterLights";
+const gfx::DescriptorSetLayoutBinding CLUSTER_LIGHTS::DESCRIPTOR = {
+    CLUSTER_LIGHTS::BINDING,
+    gfx::DescriptorType::SAMPLER,
+    1,
+    gfx::ShaderStageFlagBit::FRAGMENT,
+};
+const gfx::UniformSampler CLUSTER_LIGHTS::LAYOUT = {
+    GLOBAL_SET,
+    CLUSTER_LIGHTS::BINDING,
+    CLUSTER_LIGHTS::NAME,
+    gfx::Type::SAMPLER2D,
+    1,
+};
+
 const String JOINT_TEXTURE::NAME = "cc_jointTexture";
 const gfx::DescriptorSetLayoutBinding JOINT_TEXTURE::DESCRIPTOR = {
     JOINT_TEXTURE::BINDING,
@@ -426,6 +442,33 @@ uint nextPow2(uint val) {
     return val;
 }
 
+void recordDrawCalls(gfx::CommandBuffer *cmdBuff, const DrawCallList &drawCalls) {
+    gfx::PipelineState *lastPSO = nullptr;
+    gfx::DescriptorSet *lastGlobalSet = nullptr;
+    gfx::DescriptorSet *lastMaterialSet = nullptr;
+    gfx::InputAssembler *lastInputAssembler = nullptr;
+    for (const auto &drawCall : drawCalls) {
+        if (drawCall.pipelineState != lastPSO) {
+            cmdBuff->bindPipelineState(drawCall.pipelineState);
+            lastPSO = drawCall.pipelineState;
+        }
+        if (drawCall.globalSet && drawCall.globalSet != lastGlobalSet) {
+            cmdBuff->bindDescriptorSet(GLOBAL_SET, drawCall.globalSet);
+            lastGlobalSet = drawCall.globalSet;
+        }
+        if (drawCall.materialSet != lastMaterialSet) {
+            cmdBuff->bindDescriptorSet(MATERIAL_SET, drawCall.materialSet);
+            lastMaterialSet = drawCall.materialSet;
+        }
+        cmdBuff->bindDescriptorSet(LOCAL_SET, drawCall.localSet, drawCall.dynamicOffsetCount, drawCall.dynamicOffsets);
+        if (drawCall.inputAssembler != lastInputAssembler) {
+            cmdBuff->bindInputAssembler(drawCall.inputAssembler);
+            lastInputAssembler = drawCall.inputAssembler;
+        }
+        cmdBuff->draw(drawCall.inputAssembler);
+    }
+}
+
 uint getPhaseID(const String &phase) {
     se::Object *globalObj = se::ScriptEngine::getInstance()->getGlobalObject();
 
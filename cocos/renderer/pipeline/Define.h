@@ -31,6 +31,7 @@ namespace pipeline {
 
 class RenderStage;
 class RenderFlow;
+struct PassView;
 struct SubModelView;
 struct Light;
 struct ModelView;
@@ -47,6 +48,7 @@ struct Frustum;
 struct CC_DLL RenderObject {
     float depth = 0;
     const ModelView *model = nullptr;
+    const uint *subModelID = nullptr; // submodels of the level of detail picked for the model
 };
 typedef vector<struct RenderObject> RenderObjectList;
 
@@ -56,14 +58,27 @@ struct CC_DLL RenderTargetInfo {
 };
 
 struct CC_DLL RenderPass {
-    uint hash = 0;
+    uint64_t sortKey = 0;
     float depth = 0;
     uint shaderID = 0;
     uint passIndex = 0;
     const SubModelView *subModel = nullptr;
+    const ModelView *model = nullptr;
 };
 typedef vector<RenderPass> RenderPassList;
 
+// A draw whose pipeline state and descriptor sets are already looked up, so recording it touches no shared pools.
+struct CC_DLL DrawCall {
+    gfx::PipelineState *pipelineState = nullptr;
+    gfx::DescriptorSet *globalSet = nullptr; // nullptr keeps the global set bound by the stage
+    gfx::DescriptorSet *materialSet = nullptr;
+    gfx::DescriptorSet *localSet = nullptr;
+    gfx::InputAssembler *inputAssembler = nullptr;
+    uint dynamicOffsetCount = 0;
+    const uint *dynamicOffsets = nullptr;
+};
+typedef vector<DrawCall> DrawCallList;
+
 typedef gfx::ColorAttachment ColorDesc;
 typedef vector<ColorDesc> ColorDescList;
 
@@ -123,12 +138,6 @@ struct CC_DLL InternalBindingInst : public InternalBindingDesc {
     gfx::Texture *texture = nullptr;
 };
 
-struct CC_DLL RenderQueueCreateInfo {
-    bool isTransparent = false;
-    uint phases = 0;
-    std::function<bool(const RenderPass &a, const RenderPass &b)> sortFunc;
-};
-
 enum class CC_DLL RenderPriority {
     MIN = 0,
     MAX = 0xff,
@@ -140,6 +149,12 @@ enum class CC_DLL RenderQueueSortMode {
     BACK_TO_FRONT,
 };
 
+struct CC_DLL RenderQueueCreateInfo {
+    bool isTransparent = false;
+    uint phases = 0;
+    RenderQueueSortMode sortMode = RenderQueueSortMode::FRONT_TO_BACK;
+};
+
 struct CC_DLL RenderQueueDesc {
     bool isTransparent = false;
     RenderQueueSortMode sortMode = RenderQueueSortMode::FRONT_TO_BACK;
@@ -149,24 +164,6 @@ typedef std::vector<RenderQueueDesc> RenderQueueDescList;
 
 uint getPhaseID(const String &phase);
 
-CC_INLINE bool opaqueCompareFn(const RenderPass &a, const RenderPass &b) {
-    if (a.hash != b.hash)
-        return a.hash < b.hash;
-    else if (math::IsNotEqualF(a.depth, b.depth))
-        return a.depth < b.depth;
-    else
-        return a.shaderID < b.shaderID;
-}
-
-CC_INLINE bool transparentCompareFn(const RenderPass &a, const RenderPass &b) {
-    if (a.hash != b.hash)
-        return a.hash < b.hash;
-    else if (math::IsNotEqualF(a.depth, b.depth))
-        return b.depth < a.depth;
-    else
-        return a.shaderID < b.shaderID;
-}
-
 enum class CC_DLL PipelineGlobalBindings {
     UBO_GLOBAL,
     UBO_CAMERA,
@@ -175,6 +172,7 @@ enum class CC_DLL PipelineGlobalBindings {
     SAMPLER_SHADOWMAP,
     SAMPLER_ENVIRONMENT, // don't put this as the first sampler binding due to Mac GL driver issues: cubemap at texture unit 0 causes rendering issues
     SAMPLER_SPOT_LIGHTING_MAP,
+    SAMPLER_CLUSTER_LIGHTS,
 
     COUNT,
 };
@@ -380,6 +378,9 @@ const uint CAMERA_DEFAULT_MASK = ~static_cast<uint>(LayerList::UI_2D) & ~static_
 //                                                           Layers.BitMask.SCENE_GIZMO, Layers.BitMask.PROFILER]);
 
 uint nextPow2(uint val);
+
+// Safe to call from any thread, binds only the state that changes between consecutive draws.
+void recordDrawCalls(gfx::CommandBuffer *cmdBuff, const DrawCallList &drawCalls);
 enum class CC_DLL SetIndex {
     GLOBAL,
     MATERIAL,
@@ -414,6 +415,14 @@ struct CC_DLL SPOT_LIGHTING_MAP : public Object {
     static const String NAME;
 };
 
+// light parameters, cluster ranges and light indices packed by LightClusters, read with texelFetch
+struct CC_DLL CLUSTER_LIGHTS : public Object {
+    static constexpr uint BINDING = static_cast<uint>(PipelineGlobalBindings::SAMPLER_CLUSTER_LIGHTS);
+    static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
+    static const gfx::UniformSampler LAYOUT;
+    static const String NAME;
+};
+
 struct CC_DLL JOINT_TEXTURE : public Object {
     static constexpr uint BINDING = static_cast<uint>(ModelLocalBindings::SAMPLER_JOINTS);
     static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
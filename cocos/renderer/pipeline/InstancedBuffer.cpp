@@ -31,7 +31,62 @@ THE SOFTWARE.
 
 namespace cc {
 namespace pipeline {
+namespace {
+// Frame-scoped linear allocator for the CPU side of every instance group. Allocations are never moved
+// within a frame, since command buffers may keep pointing at them until the frame is submitted.
+class InstanceDataArena {
+public:
+    static constexpr uint CHUNK_SIZE = 64 * 1024;
+    static constexpr uint ALIGNMENT = 16;
+
+    ~InstanceDataArena() {
+        for (auto &chunk : _chunks) {
+            CC_FREE(chunk.data);
+        }
+    }
+
+    uint8_t *allocate(uint size) {
+        size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        if (_chunks.empty() || _chunks.back().used + size > _chunks.back().size) {
+            uint chunkSize = _chunks.empty() ? CHUNK_SIZE : _chunks.back().size * 2;
+            if (chunkSize < size) chunkSize = size;
+            _chunks.push_back({static_cast<uint8_t *>(CC_MALLOC(chunkSize)), chunkSize, 0});
+        }
+        auto &chunk = _chunks.back();
+        auto data = chunk.data + chunk.used;
+        chunk.used += size;
+        return data;
+    }
+
+    // Folds the chunks a frame needed into a single one, so steady state is one block and no allocations.
+    void reset() {
+        if (_chunks.size() > 1) {
+            uint totalSize = 0;
+            for (auto &chunk : _chunks) {
+                totalSize += chunk.size;
+                CC_FREE(chunk.data);
+            }
+            _chunks.clear();
+            _chunks.push_back({static_cast<uint8_t *>(CC_MALLOC(totalSize)), totalSize, 0});
+        } else if (!_chunks.empty()) {
+            _chunks.back().used = 0;
+        }
+    }
+
+private:
+    struct Chunk {
+        uint8_t *data = nullptr;
+        uint size = 0;
+        uint used = 0;
+    };
+    vector<Chunk> _chunks;
+};
+
+InstanceDataArena instanceDataArena;
+} // namespace
+
 map<uint, map<uint, InstancedBuffer *>> InstancedBuffer::_buffers;
+uint InstancedBuffer::_frame = 0;
 InstancedBuffer *InstancedBuffer::get(uint pass) {
     return InstancedBuffer::get(pass, 0);
 }
@@ -43,6 +98,16 @@ InstancedBuffer *InstancedBuffer::get(uint pass, uint extraKey) {
     return buffer;
 }
 
+void InstancedBuffer::beginFrame() {
+    ++_frame;
+    instanceDataArena.reset();
+    for (auto &record : _buffers) {
+        for (auto &pair : record.second) {
+            pair.second->evict(_frame);
+        }
+    }
+}
+
 InstancedBuffer::InstancedBuffer(const PassView *pass)
 : _pass(pass),
   _device(gfx::Device::getInstance()) {
@@ -53,13 +118,27 @@ InstancedBuffer::~InstancedBuffer() {
 
 void InstancedBuffer::destroy() {
     for (auto &instance : _instances) {
-        instance.vb->destroy();
-        instance.ia->destroy();
-        CC_FREE(instance.data);
+        CC_DESTROY(instance.ia);
+        CC_DESTROY(instance.vb);
     }
     _instances.clear();
 }
 
+void InstancedBuffer::evict(uint frame) {
+    for (auto iter = _instances.begin(); iter != _instances.end();) {
+        if (frame - iter->lastFrame > EVICTION_FRAMES) {
+            CC_DESTROY(iter->ia);
+            CC_DESTROY(iter->vb);
+            iter = _instances.erase(iter);
+        } else {
+            iter->count = 0;
+            iter->data = nullptr;
+            ++iter;
+        }
+    }
+    _hasPendingModels = false;
+}
+
 void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel, uint passIdx) {
     uint stride = 0;
     const auto instancedBuffer = model->getInstancedBuffer(&stride);
@@ -83,14 +162,15 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
         if (instance.stride != stride) {
             return;
         }
-        if (instance.count >= instance.capacity) { // resize buffers
+        if (!instance.data) { // first use this frame
+            instance.data = instanceDataArena.allocate(instance.stride * instance.capacity);
+        } else if (instance.count >= instance.capacity) { // resize buffers
             instance.capacity <<= 1;
             const auto newSize = instance.stride * instance.capacity;
             const auto oldData = instance.data;
-            instance.data = (uint8_t *)CC_MALLOC(newSize);
-            memcpy(instance.data, oldData, instance.vb->getSize());
+            instance.data = instanceDataArena.allocate(newSize);
+            memcpy(instance.data, oldData, instance.stride * instance.count);
             instance.vb->resize(newSize);
-            CC_FREE(oldData);
         }
         if (instance.shader != shader) {
             instance.shader = shader;
@@ -98,6 +178,7 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
         if (instance.descriptorSet != descriptorSet) {
             instance.descriptorSet = descriptorSet;
         }
+        instance.lastFrame = _frame;
         memcpy(instance.data + instance.stride * instance.count++, instancedBuffer, stride);
         _hasPendingModels = true;
         return;
@@ -124,12 +205,12 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
         attributes.emplace_back(std::move(newAttr));
     }
 
-    uint8_t *data = (uint8_t *)CC_MALLOC(newSize);
+    uint8_t *data = instanceDataArena.allocate(newSize);
     memcpy(data, instancedBuffer, stride);
     vertexBuffers.emplace_back(vb);
     gfx::InputAssemblerInfo iaInfo = {attributes, vertexBuffers, indexBuffer};
     auto ia = _device->createInputAssembler(iaInfo);
-    InstancedItem item = {1, INITIAL_CAPACITY, vb, data, ia, stride, shader, descriptorSet, lightingMap};
+    InstancedItem item = {1, INITIAL_CAPACITY, vb, data, ia, stride, shader, descriptorSet, lightingMap, _frame};
     _instances.emplace_back(std::move(item));
     _hasPendingModels = true;
 }
@@ -138,7 +219,7 @@ void InstancedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
     for (auto &instance : _instances) {
         if (!instance.count) continue;
 
-        cmdBuff->updateBuffer(instance.vb, instance.data, instance.vb->getSize());
+        cmdBuff->updateBuffer(instance.vb, instance.data, instance.stride * instance.count);
         instance.ia->setInstanceCount(instance.count);
     }
 }
@@ -146,6 +227,7 @@ void InstancedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
 void InstancedBuffer::clear() {
     for (auto &instance : _instances) {
         instance.count = 0;
+        instance.data = nullptr;
     }
     _hasPendingModels = false;
 }
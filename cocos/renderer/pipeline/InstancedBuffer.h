@@ -44,12 +44,14 @@ struct CC_DLL InstancedItem {
     uint count = 0;
     uint capacity = 0;
     gfx::Buffer *vb = nullptr;
+    // Points into the per-frame instance data arena, only valid during lastFrame.
     uint8_t *data = nullptr;
     gfx::InputAssembler *ia = nullptr;
     uint stride = 0;
     gfx::Shader *shader = nullptr;
     gfx::DescriptorSet *descriptorSet = nullptr;
     gfx::Texture *lightingMap = nullptr;
+    uint lastFrame = 0;
 };
 typedef vector<InstancedItem> InstancedItemList;
 typedef vector<uint> DynamicOffsetList;
@@ -58,8 +60,12 @@ class InstancedBuffer : public Object {
 public:
     static constexpr uint INITIAL_CAPACITY = 32;
     static constexpr uint MAX_CAPACITY = 1024;
+    // Instance groups which haven't been drawn for this many frames release their buffers.
+    static constexpr uint EVICTION_FRAMES = 120;
     static InstancedBuffer *get(uint pass);
     static InstancedBuffer *get(uint pass, uint extraKey);
+    // Recycles the instance data arena and evicts idle instance groups, must be called once per frame before any merge.
+    static void beginFrame();
 
     InstancedBuffer(const PassView *pass);
     virtual ~InstancedBuffer();
@@ -76,7 +82,10 @@ public:
     CC_INLINE const DynamicOffsetList &dynamicOffsets() const { return _dynamicOffsets; }
 
 private:
+    void evict(uint frame);
+
     static map<uint, map<uint, InstancedBuffer *>> _buffers;
+    static uint _frame;
     InstancedItemList _instances;
     const PassView *_pass = nullptr;
     bool _hasPendingModels = false;
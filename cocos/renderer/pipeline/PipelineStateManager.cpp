@@ -22,44 +22,367 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "PipelineStateManager.h"
+#include "base/Data.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXInputAssembler.h"
 #include "gfx/GFXRenderPass.h"
 #include "gfx/GFXShader.h"
 #include "helper/SharedMemory.h"
+#include "platform/FileUtils.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
 
 namespace cc {
 namespace pipeline {
-map<uint, gfx::PipelineState *> PipelineStateManager::_PSOHashMap;
+namespace {
+constexpr uint32_t WARMUP_RECORD_MAGIC = 0x53505343; // "CSPS"
+constexpr uint32_t WARMUP_RECORD_VERSION = 1;
+constexpr uint MIN_TABLE_CAPACITY = 256;
+
+// Everything a pipeline state is created from, except for objects which only exist at runtime:
+// the shader is matched by name and the render pass by its compatibility hash.
+struct PipelineStateDesc {
+    uint passHash = 0;
+    uint attributesHash = 0;
+    uint renderPassHash = 0;
+    uint shaderID = 0;
+    String shaderName;
+    gfx::AttributeList attributes;
+    gfx::RasterizerState rasterizerState;
+    gfx::DepthStencilState depthStencilState;
+    gfx::BlendState blendState;
+    gfx::PrimitiveMode primitive = gfx::PrimitiveMode::TRIANGLE_LIST;
+    gfx::DynamicStateFlags dynamicStates = gfx::DynamicStateFlagBit::NONE;
+};
+
+// Borrows the state of a lookup so that a cache hit doesn't copy anything.
+struct PipelineStateKey {
+    uint passHash = 0;
+    uint attributesHash = 0;
+    uint renderPassHash = 0;
+    uint shaderID = 0;
+    const gfx::AttributeList *attributes = nullptr;
+    const gfx::RasterizerState *rasterizerState = nullptr;
+    const gfx::DepthStencilState *depthStencilState = nullptr;
+    const gfx::BlendState *blendState = nullptr;
+    gfx::PrimitiveMode primitive = gfx::PrimitiveMode::TRIANGLE_LIST;
+    gfx::DynamicStateFlags dynamicStates = gfx::DynamicStateFlagBit::NONE;
+};
+
+struct PipelineStateEntry {
+    uint64_t hash = 0;
+    PipelineStateDesc desc;
+    gfx::PipelineState *pso = nullptr;
+    // Only states which are actually drawn with get recorded for the next session.
+    std::atomic<bool> used{false};
+};
+
+// Open addressing with linear probing, kept at most half full. Slots are only ever filled,
+// never moved or cleared, so readers probe without locking; growing publishes a new table
+// and keeps the retired one alive for readers still probing it.
+struct PipelineStateTable {
+    explicit PipelineStateTable(uint capacity) : mask(capacity - 1), slots(capacity) {}
+
+    uint mask = 0;
+    vector<std::atomic<PipelineStateEntry *>> slots;
+};
+
+std::atomic<PipelineStateTable *> currentTable{nullptr};
+vector<PipelineStateTable *> tables;
+vector<PipelineStateEntry *> entries;
+unordered_map<String, vector<PipelineStateDesc>> warmupRecords;
+unordered_map<uint, gfx::RenderPass *> warmupRenderPasses;
+std::mutex writeMutex;
+
+uint64_t mixHash(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+uint64_t getHash(const PipelineStateKey &key) {
+    uint64_t seed = mixHash(0, key.passHash);
+    seed = mixHash(seed, key.attributesHash);
+    seed = mixHash(seed, key.renderPassHash);
+    return mixHash(seed, key.shaderID);
+}
+
+PipelineStateKey getKey(const PipelineStateDesc &desc) {
+    return {desc.passHash, desc.attributesHash, desc.renderPassHash, desc.shaderID,
+            &desc.attributes, &desc.rasterizerState, &desc.depthStencilState, &desc.blendState,
+            desc.primitive, desc.dynamicStates};
+}
+
+PipelineStateKey getKey(const PassView *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass) {
+    return {pass->hash, inputAssembler->getAttributesHash(), renderPass->getHash(), shader->getID(),
+            &inputAssembler->getAttributes(), pass->getRasterizerState(), pass->getDepthStencilState(), pass->getBlendState(),
+            pass->getPrimitive(), pass->getDynamicState()};
+}
+
+bool isEqual(const gfx::AttributeList &lhs, const gfx::AttributeList &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        const auto &a = lhs[i];
+        const auto &b = rhs[i];
+        if (a.format != b.format || a.isNormalized != b.isNormalized || a.stream != b.stream ||
+            a.isInstanced != b.isInstanced || a.location != b.location || a.name != b.name) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isEqual(const gfx::BlendState &lhs, const gfx::BlendState &rhs) {
+    return lhs.isA2C == rhs.isA2C && lhs.isIndepend == rhs.isIndepend &&
+           !memcmp(&lhs.blendColor, &rhs.blendColor, sizeof(gfx::Color)) &&
+           lhs.targets.size() == rhs.targets.size() &&
+           !memcmp(lhs.targets.data(), rhs.targets.data(), lhs.targets.size() * sizeof(gfx::BlendTarget));
+}
+
+// The pass, attributes and render pass hashes only narrow the search, the states themselves decide.
+bool matches(const PipelineStateDesc &desc, const PipelineStateKey &key) {
+    return desc.shaderID == key.shaderID && desc.renderPassHash == key.renderPassHash &&
+           desc.primitive == key.primitive && desc.dynamicStates == key.dynamicStates &&
+           !memcmp(&desc.rasterizerState, key.rasterizerState, sizeof(gfx::RasterizerState)) &&
+           !memcmp(&desc.depthStencilState, key.depthStencilState, sizeof(gfx::DepthStencilState)) &&
+           isEqual(desc.blendState, *key.blendState) &&
+           isEqual(desc.attributes, *key.attributes);
+}
+
+PipelineStateEntry *find(const PipelineStateTable *table, uint64_t hash, const PipelineStateKey &key) {
+    if (!table) return nullptr;
+    for (uint i = static_cast<uint>(hash) & table->mask;; i = (i + 1) & table->mask) {
+        auto entry = table->slots[i].load(std::memory_order_acquire);
+        if (!entry) return nullptr;
+        if (entry->hash == hash && matches(entry->desc, key)) return entry;
+    }
+}
+
+void insertSlot(PipelineStateTable *table, PipelineStateEntry *entry) {
+    uint i = static_cast<uint>(entry->hash) & table->mask;
+    while (table->slots[i].load(std::memory_order_relaxed)) {
+        i = (i + 1) & table->mask;
+    }
+    table->slots[i].store(entry, std::memory_order_release);
+}
+
+// Must be called with writeMutex held.
+void insert(PipelineStateEntry *entry) {
+    auto table = currentTable.load(std::memory_order_relaxed);
+    if (!table || (entries.size() + 1) * 2 > table->slots.size()) {
+        const auto capacity = table ? static_cast<uint>(table->slots.size()) * 2 : MIN_TABLE_CAPACITY;
+        table = CC_NEW(PipelineStateTable(capacity));
+        for (auto oldEntry : entries) {
+            insertSlot(table, oldEntry);
+        }
+        tables.emplace_back(table);
+        currentTable.store(table, std::memory_order_release);
+    }
+
+    entries.emplace_back(entry);
+    insertSlot(table, entry);
+}
+
+// Must be called with writeMutex held.
+PipelineStateEntry *createEntry(PipelineStateDesc &&desc, gfx::Shader *shader, gfx::PipelineLayout *pipelineLayout, gfx::RenderPass *renderPass) {
+    gfx::PipelineStateInfo info = {
+        shader,
+        pipelineLayout,
+        renderPass,
+        {desc.attributes},
+        desc.rasterizerState,
+        desc.depthStencilState,
+        desc.blendState,
+        desc.primitive,
+        desc.dynamicStates};
+
+    auto entry = CC_NEW(PipelineStateEntry);
+    entry->hash = getHash(getKey(desc));
+    entry->desc = std::move(desc);
+    entry->pso = gfx::Device::getInstance()->createPipelineState(std::move(info));
+    insert(entry);
+    return entry;
+}
+
+// Must be called with writeMutex held.
+void warmup(gfx::Shader *shader, gfx::PipelineLayout *pipelineLayout) {
+    auto iter = warmupRecords.find(shader->getName());
+    if (iter == warmupRecords.end()) return;
+
+    auto records = std::move(iter->second);
+    warmupRecords.erase(iter);
+    for (auto &desc : records) {
+        auto renderPassIter = warmupRenderPasses.find(desc.renderPassHash);
+        if (renderPassIter == warmupRenderPasses.end()) continue;
+
+        desc.shaderID = shader->getID();
+        const auto key = getKey(desc);
+        if (find(currentTable.load(std::memory_order_relaxed), getHash(key), key)) continue;
+        createEntry(std::move(desc), shader, pipelineLayout, renderPassIter->second);
+    }
+}
+
+class RecordWriter {
+public:
+    template <typename T>
+    void write(const T &value) {
+        writeBytes(&value, sizeof(T));
+    }
+    void write(const String &value) {
+        write(static_cast<uint32_t>(value.size()));
+        writeBytes(value.data(), value.size());
+    }
+    void writeBytes(const void *bytes, size_t size) {
+        const auto begin = static_cast<const uint8_t *>(bytes);
+        _data.insert(_data.end(), begin, begin + size);
+    }
+    const vector<uint8_t> &getData() const { return _data; }
+
+private:
+    vector<uint8_t> _data;
+};
+
+class RecordReader {
+public:
+    RecordReader(const uint8_t *data, size_t size) : _cur(data), _end(data + size) {}
+
+    template <typename T>
+    bool read(T &value) {
+        return readBytes(&value, sizeof(T));
+    }
+    bool read(String &value) {
+        uint32_t size = 0;
+        if (!read(size) || size > static_cast<size_t>(_end - _cur)) return false;
+        value.assign(reinterpret_cast<const char *>(_cur), size);
+        _cur += size;
+        return true;
+    }
+    bool readBytes(void *bytes, size_t size) {
+        if (size > static_cast<size_t>(_end - _cur)) return false;
+        memcpy(bytes, _cur, size);
+        _cur += size;
+        return true;
+    }
+
+private:
+    const uint8_t *_cur = nullptr;
+    const uint8_t *_end = nullptr;
+};
+
+void writeDesc(RecordWriter &writer, const PipelineStateDesc &desc) {
+    writer.write(desc.passHash);
+    writer.write(desc.attributesHash);
+    writer.write(desc.renderPassHash);
+    writer.write(desc.shaderName);
+    writer.write(static_cast<uint32_t>(desc.attributes.size()));
+    for (const auto &attribute : desc.attributes) {
+        writer.write(attribute.name);
+        writer.write(static_cast<uint32_t>(attribute.format));
+        writer.write(static_cast<uint8_t>(attribute.isNormalized));
+        writer.write(attribute.stream);
+        writer.write(static_cast<uint8_t>(attribute.isInstanced));
+        writer.write(attribute.location);
+    }
+    writer.write(desc.rasterizerState);
+    writer.write(desc.depthStencilState);
+    writer.write(desc.blendState.isA2C);
+    writer.write(desc.blendState.isIndepend);
+    writer.write(desc.blendState.blendColor);
+    writer.write(static_cast<uint32_t>(desc.blendState.targets.size()));
+    writer.writeBytes(desc.blendState.targets.data(), desc.blendState.targets.size() * sizeof(gfx::BlendTarget));
+    writer.write(static_cast<uint32_t>(desc.primitive));
+    writer.write(static_cast<uint32_t>(desc.dynamicStates));
+}
+
+bool readDesc(RecordReader &reader, PipelineStateDesc &desc) {
+    uint32_t count = 0;
+    if (!reader.read(desc.passHash) || !reader.read(desc.attributesHash) || !reader.read(desc.renderPassHash) ||
+        !reader.read(desc.shaderName) || !reader.read(count)) {
+        return false;
+    }
+    desc.attributes.resize(count);
+    for (auto &attribute : desc.attributes) {
+        uint32_t format = 0;
+        uint8_t isNormalized = 0;
+        uint8_t isInstanced = 0;
+        if (!reader.read(attribute.name) || !reader.read(format) || !reader.read(isNormalized) ||
+            !reader.read(attribute.stream) || !reader.read(isInstanced) || !reader.read(attribute.location)) {
+            return false;
+        }
+        attribute.format = static_cast<gfx::Format>(format);
+        attribute.isNormalized = isNormalized != 0;
+        attribute.isInstanced = isInstanced != 0;
+    }
+
+    uint32_t primitive = 0;
+    uint32_t dynamicStates = 0;
+    if (!reader.read(desc.rasterizerState) || !reader.read(desc.depthStencilState) ||
+        !reader.read(desc.blendState.isA2C) || !reader.read(desc.blendState.isIndepend) ||
+        !reader.read(desc.blendState.blendColor) || !reader.read(count)) {
+        return false;
+    }
+    desc.blendState.targets.resize(count);
+    if (!reader.readBytes(desc.blendState.targets.data(), count * sizeof(gfx::BlendTarget)) ||
+        !reader.read(primitive) || !reader.read(dynamicStates)) {
+        return false;
+    }
+    desc.primitive = static_cast<gfx::PrimitiveMode>(primitive);
+    desc.dynamicStates = static_cast<gfx::DynamicStateFlags>(dynamicStates);
+    return true;
+}
+
+// Raw state structs are stored as they are, so any layout change invalidates the records.
+void writeHeader(RecordWriter &writer) {
+    writer.write(WARMUP_RECORD_MAGIC);
+    writer.write(WARMUP_RECORD_VERSION);
+    writer.write(static_cast<uint32_t>(sizeof(gfx::RasterizerState)));
+    writer.write(static_cast<uint32_t>(sizeof(gfx::DepthStencilState)));
+    writer.write(static_cast<uint32_t>(sizeof(gfx::BlendTarget)));
+}
+
+bool readHeader(RecordReader &reader) {
+    RecordWriter expected;
+    writeHeader(expected);
+    const auto &bytes = expected.getData();
+    vector<uint8_t> header(bytes.size());
+    return reader.readBytes(header.data(), header.size()) && header == bytes;
+}
+} // namespace
+
 gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const PassView *pass,
                                                                    gfx::Shader *shader,
                                                                    gfx::InputAssembler *inputAssembler,
                                                                    gfx::RenderPass *renderPass) {
-    const auto passHash = pass->hash;
-    const auto renderPassHash = renderPass->getHash();
-    const auto iaHash = inputAssembler->getAttributesHash();
-    const auto shaderID = shader->getID();
-    const auto hash = passHash ^ renderPassHash ^ iaHash ^ shaderID;
+    const auto key = getKey(pass, shader, inputAssembler, renderPass);
+    const auto hash = getHash(key);
 
-    auto pso = _PSOHashMap[hash];
-    if (!pso) {
-        auto pipelineLayout = pass->getPipelineLayout();
-        gfx::PipelineStateInfo info = {
-            shader,
-            pipelineLayout,
-            renderPass,
-            {inputAssembler->getAttributes()},
-            *(pass->getRasterizerState()),
-            *(pass->getDepthStencilState()),
-            *(pass->getBlendState()),
-            pass->getPrimitive(),
-            pass->getDynamicState()};
+    auto entry = find(currentTable.load(std::memory_order_acquire), hash, key);
+    if (!entry) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        entry = find(currentTable.load(std::memory_order_relaxed), hash, key);
+        if (!entry) {
+            PipelineStateDesc desc;
+            desc.passHash = key.passHash;
+            desc.attributesHash = key.attributesHash;
+            desc.renderPassHash = key.renderPassHash;
+            desc.shaderID = key.shaderID;
+            desc.shaderName = shader->getName();
+            desc.attributes = *key.attributes;
+            desc.rasterizerState = *key.rasterizerState;
+            desc.depthStencilState = *key.depthStencilState;
+            desc.blendState = *key.blendState;
+            desc.primitive = key.primitive;
+            desc.dynamicStates = key.dynamicStates;
 
-        pso = gfx::Device::getInstance()->createPipelineState(std::move(info));
-        _PSOHashMap[hash] = pso;
+            auto pipelineLayout = pass->getPipelineLayout();
+            entry = createEntry(std::move(desc), shader, pipelineLayout, renderPass);
+            warmup(shader, pipelineLayout);
+        }
     }
 
-    return pso;
+    if (!entry->used.load(std::memory_order_relaxed)) {
+        entry->used.store(true, std::memory_order_relaxed);
+    }
+    return entry->pso;
 }
 
 gfx::PipelineState *PipelineStateManager::getOrCreatePipelineStateByJS(uint32_t passHandle,
@@ -71,5 +394,88 @@ gfx::PipelineState *PipelineStateManager::getOrCreatePipelineStateByJS(uint32_t
     return PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
 }
 
+void PipelineStateManager::loadWarmupRecords(const String &path) {
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path)) return;
+
+    const auto data = fileUtils->getDataFromFile(path);
+    if (data.isNull()) return;
+
+    RecordReader reader(data.getBytes(), static_cast<size_t>(data.getSize()));
+    uint32_t count = 0;
+    if (!readHeader(reader) || !reader.read(count)) {
+        CC_LOG_WARNING("Ignoring incompatible pipeline state records: %s", path.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    for (uint32_t i = 0; i < count; ++i) {
+        PipelineStateDesc desc;
+        if (!readDesc(reader, desc)) {
+            CC_LOG_WARNING("Truncated pipeline state records: %s", path.c_str());
+            break;
+        }
+        warmupRecords[desc.shaderName].emplace_back(std::move(desc));
+    }
+}
+
+void PipelineStateManager::saveWarmupRecords(const String &path) {
+    RecordWriter writer;
+    writeHeader(writer);
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        uint32_t count = 0;
+        for (const auto entry : entries) {
+            if (entry->used) ++count;
+        }
+        writer.write(count);
+        for (const auto entry : entries) {
+            if (entry->used) writeDesc(writer, entry->desc);
+        }
+    }
+
+    const auto &bytes = writer.getData();
+    Data data;
+    data.copy(bytes.data(), static_cast<ssize_t>(bytes.size()));
+    if (!FileUtils::getInstance()->writeDataToFile(data, path)) {
+        CC_LOG_WARNING("Failed to save pipeline state records: %s", path.c_str());
+    }
+}
+
+void PipelineStateManager::addWarmupRenderPass(gfx::RenderPass *renderPass) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    warmupRenderPasses.emplace(renderPass->getHash(), renderPass);
+}
+
+void PipelineStateManager::removeWarmupRenderPass(gfx::RenderPass *renderPass) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto iter = warmupRenderPasses.find(renderPass->getHash());
+    if (iter != warmupRenderPasses.end() && iter->second == renderPass) {
+        warmupRenderPasses.erase(iter);
+    }
+}
+
+uint PipelineStateManager::getPipelineStateCount() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return static_cast<uint>(entries.size());
+}
+
+// No lookups may be in flight when the cache is torn down.
+void PipelineStateManager::destroyAll() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    currentTable.store(nullptr, std::memory_order_release);
+    for (auto entry : entries) {
+        CC_SAFE_DESTROY(entry->pso);
+        CC_DELETE(entry);
+    }
+    entries.clear();
+    for (auto table : tables) {
+        CC_DELETE(table);
+    }
+    tables.clear();
+    warmupRecords.clear();
+    warmupRenderPasses.clear();
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -46,8 +46,15 @@ public:
                                                             gfx::InputAssembler *inputAssembler,
                                                             gfx::RenderPass *renderPass);
 
-private:
-    static map<uint, gfx::PipelineState *> _PSOHashMap;
+    // Pipeline states recorded by an earlier session are created as soon as
+    // their shader is first used with a registered, compatible render pass.
+    static void loadWarmupRecords(const String &path);
+    static void saveWarmupRecords(const String &path);
+    static void addWarmupRenderPass(gfx::RenderPass *renderPass);
+    static void removeWarmupRenderPass(gfx::RenderPass *renderPass);
+
+    static uint getPipelineStateCount();
+    static void destroyAll();
 };
 
 } // namespace pipeline
@@ -58,38 +58,24 @@ void PlanarShadowQueue::gatherShadowPasses(Camera *camera, gfx::CommandBuffer *c
 
     if (!scene->getMainLight() || !shadowVisible) { return; }
     
-    const auto models = scene->getModels();
-    const auto modelCount = models[0];
     auto *instancedBuffer = InstancedBuffer::get(shadowInfo->planarPass);
 
-    uint visibility = 0, lenght = 0;
-    for (uint i = 1; i <= modelCount; i++) {
-        const auto *model = scene->getModelView(models[i]);
-        const auto *node = model->getNode();
-        if (model->enabled && model->castShadow) {
-            visibility = camera->visibility;
-            if ((model->nodeID && ((visibility & node->layer) == node->layer)) ||
-                (visibility & model->visFlags)) {
-
-                // frustum culling
-                if ((model->worldBoundsID) && !aabb_frustum(model->getWorldBounds(), camera->getFrustum())) {
-                    continue;
-                }
-
-                const auto *attributesID = model->getInstancedAttributeID();
-                lenght = attributesID[0];
-                if (lenght > 0) {
-                    const auto *subModelID = model->getSubModelID();
-                    const auto subModelCount = subModelID[0];
-                    for (uint m = 1; m <= subModelCount; ++m) {
-                        const auto *subModel = model->getSubModelView(subModelID[m]);
-                        instancedBuffer->merge(model, subModel, m - 1);
-                        _instancedQueue->add(instancedBuffer);
-                    }
-                } else {
-                    _pendingModels.emplace_back(model);
-                }
+    // visible shadow casters, collected by sceneCulling
+    uint lenght = 0;
+    for (const auto &ro : _pipeline->getRetainedView(camera).planarShadowObjects) {
+        const auto *model = ro.model;
+        const auto *attributesID = model->getInstancedAttributeID();
+        lenght = attributesID[0];
+        if (lenght > 0) {
+            const auto *subModelID = ro.subModelID;
+            const auto subModelCount = subModelID[0];
+            for (uint m = 1; m <= subModelCount; ++m) {
+                const auto *subModel = model->getSubModelView(subModelID[m]);
+                instancedBuffer->merge(model, subModel, m - 1);
+                _instancedQueue->add(instancedBuffer);
             }
+        } else {
+            _pendingObjects.emplace_back(ro);
         }
     }
 
@@ -97,32 +83,40 @@ void PlanarShadowQueue::gatherShadowPasses(Camera *camera, gfx::CommandBuffer *c
 }
 
 void PlanarShadowQueue::clear() {
-    _pendingModels.clear();
+    _pendingObjects.clear();
     if (_instancedQueue) _instancedQueue->clear();
 }
 
 void PlanarShadowQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
+    _drawCalls.clear();
+    resolveDrawCalls(renderPass, _drawCalls);
+    recordDrawCalls(cmdBuffer, _drawCalls);
+}
+
+void PlanarShadowQueue::resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) {
     const auto *shadowInfo = _pipeline->getShadows();
-    if (!shadowInfo->enabled || shadowInfo->getShadowType() != ShadowType::PLANAR || _pendingModels.empty()) { return; }
+    if (!shadowInfo->enabled || shadowInfo->getShadowType() != ShadowType::PLANAR || _pendingObjects.empty()) { return; }
 
-    _instancedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
+    _instancedQueue->resolveDrawCalls(renderPass, drawCalls);
 
     const auto *pass = shadowInfo->getPlanarShadowPass();
-    cmdBuffer->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
+    auto *materialSet = pass->getDescriptorSet();
 
-    for (auto model : _pendingModels) {
-        const auto subModelID = model->getSubModelID();
+    for (const auto &ro : _pendingObjects) {
+        const auto model = ro.model;
+        const auto subModelID = ro.subModelID;
         const auto subModelCount = subModelID[0];
         for (unsigned m = 1; m <= subModelCount; ++m) {
             const auto subModel = model->getSubModelView(subModelID[m]);
             const auto shader = subModel->getPlanarShader();
             const auto ia = subModel->getInputAssembler();
-            const auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass);
 
-            cmdBuffer->bindPipelineState(pso);
-            cmdBuffer->bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
-            cmdBuffer->bindInputAssembler(ia);
-            cmdBuffer->draw(ia);
+            DrawCall drawCall;
+            drawCall.pipelineState = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass);
+            drawCall.materialSet = materialSet;
+            drawCall.localSet = subModel->getDescriptorSet();
+            drawCall.inputAssembler = ia;
+            drawCalls.emplace_back(drawCall);
         }
     }
 }
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 #include "core/CoreStd.h"
+#include "Define.h"
 
 namespace cc {
 namespace gfx {
@@ -58,12 +59,15 @@ public:
     void clear();
     void gatherShadowPasses(Camera *camera , gfx::CommandBuffer *cmdBufferer);
     void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *);
+    // Appends the draws of the queue, must run on the main thread.
+    void resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls);
     void destroy();
     
 private:
     ForwardPipeline *_pipeline = nullptr;
     RenderInstancedQueue *_instancedQueue = nullptr;
-    std::vector<const ModelView *> _pendingModels;
+    RenderObjectList _pendingObjects;
+    DrawCallList _drawCalls;
 };
 } // namespace pipeline
 } // namespace cc
@@ -28,7 +28,6 @@ THE SOFTWARE.
 #include "PipelineStateManager.h"
 #include "RenderAdditiveLightQueue.h"
 
-#include "Application.h"
 #include "RenderBatchedQueue.h"
 #include "RenderInstancedQueue.h"
 #include "forward/ForwardPipeline.h"
@@ -39,6 +38,7 @@ THE SOFTWARE.
 #include "gfx/GFXFramebuffer.h"
 #include "helper/SharedMemory.h"
 #include "gfx/GFXSampler.h"
+#include "gfx/GFXShader.h"
 #include "gfx/GFXTexture.h"
 #include "Define.h"
 #include "forward/SceneCulling.h"
@@ -55,6 +55,19 @@ namespace {
     dst[offset + 1] = src.y;      \
     dst[offset + 2] = src.z;      \
     dst[offset + 3] = src.w;
+
+// Whether the other passes of the sub model shade every light themselves from the light clusters.
+bool readsLightClusters(const SubModelView *subModel, uint lightPassIdx) {
+    for (uint p = 0; p < subModel->passCount; ++p) {
+        if (p == lightPassIdx) continue;
+        const auto shader = subModel->getShader(p);
+        if (!shader) continue;
+        for (const auto &sampler : shader->getSamplers()) {
+            if (sampler.set == GLOBAL_SET && sampler.binding == CLUSTER_LIGHTS::BINDING) return true;
+        }
+    }
+    return false;
+}
 } // namespace
 
 RenderAdditiveLightQueue::RenderAdditiveLightQueue(RenderPipeline *pipeline) : _pipeline(static_cast<ForwardPipeline *>(pipeline)),
@@ -75,7 +88,6 @@ RenderAdditiveLightQueue::RenderAdditiveLightQueue(RenderPipeline *pipeline) : _
     });
     _firstLightBufferView = device->createBuffer({_lightBuffer, 0, UBOForwardLight::SIZE});
     _lightBufferData.resize(_lightBufferElementCount * _lightBufferCount);
-    _dynamicOffsets.resize(1, 0);
 
     gfx::SamplerInfo info{
         gfx::Filter::LINEAR,
@@ -100,62 +112,73 @@ RenderAdditiveLightQueue ::~RenderAdditiveLightQueue() {
 }
 
 void RenderAdditiveLightQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
-    _instancedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
-    _batchedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
+    _drawCalls.clear();
+    resolveDrawCalls(renderPass, _drawCalls);
+    recordDrawCalls(cmdBuffer, _drawCalls);
+}
+
+void RenderAdditiveLightQueue::resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) {
+    _instancedQueue->resolveDrawCalls(renderPass, drawCalls);
+    _batchedQueue->resolveDrawCalls(renderPass, drawCalls);
 
     for (const auto &lightPass : _lightPasses) {
         const auto subModel = lightPass.subModel;
         const auto pass = lightPass.pass;
         const auto &dynamicOffsets = lightPass.dynamicOffsets;
         auto *shader = lightPass.shader;
-        const auto lights = lightPass.lights;
+        const auto &lights = lightPass.lights;
         auto *ia = subModel->getInputAssembler();
         auto *pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass);
+        auto *materialSet = pass->getDescriptorSet();
         auto *descriptorSet = subModel->getDescriptorSet();
 
-        cmdBuffer->bindPipelineState(pso);
-        cmdBuffer->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
-        cmdBuffer->bindInputAssembler(ia);
-
         for (size_t i = 0; i < dynamicOffsets.size(); ++i) {
-            const auto *light = lights[i];
-            auto *globalDescriptorSet = getOrCreateDescriptorSet(light);
-            _dynamicOffsets[0] = dynamicOffsets[i];
-            cmdBuffer->bindDescriptorSet(GLOBAL_SET, globalDescriptorSet);
-            cmdBuffer->bindDescriptorSet(LOCAL_SET, descriptorSet, _dynamicOffsets);
-            cmdBuffer->draw(ia);
+            DrawCall drawCall;
+            drawCall.pipelineState = pso;
+            drawCall.globalSet = getOrCreateDescriptorSet(lights[i]);
+            drawCall.materialSet = materialSet;
+            drawCall.localSet = descriptorSet;
+            drawCall.inputAssembler = ia;
+            drawCall.dynamicOffsetCount = 1;
+            drawCall.dynamicOffsets = &dynamicOffsets[i];
+            drawCalls.emplace_back(drawCall);
         }
     }
 }
 
-void RenderAdditiveLightQueue::gatherLightPasses(const Camera *camera, gfx::CommandBuffer *cmdBufferer) {
+void RenderAdditiveLightQueue::gatherLightPasses(const Camera *camera, gfx::CommandBuffer *cmdBufferer, bool clusteredLighting) {
     static vector<uint> lightPassIndices;
 
     clear();
 
-    gatherValidLights(camera);
+    // lights and their bit masks over the render objects come from sceneCulling
+    const auto &view = _pipeline->getRetainedView(camera);
+    // the lights are only set up if some sub model still needs additive passes
+    if (clusteredLighting && !hasUnclusteredLightPass(view)) return;
+    gatherValidLights(view);
 
     if (_validLights.empty()) return;
 
     updateUBOs(camera, cmdBufferer);
     updateLightDescriptorSet(camera, cmdBufferer);
 
-    const auto &renderObjects = _pipeline->getRenderObjects();
-    for (const auto &renderObject : renderObjects) {
-        const auto model = renderObject.model;
-        if (!getLightPassIndex(model, lightPassIndices)) continue;
-
+    const auto &renderObjects = view.renderObjects;
+    for (size_t i = 0; i < renderObjects.size(); ++i) {
+        const auto &ro = renderObjects[i];
+        const auto model = ro.model;
+        const auto masks = view.lightMasks.data() + i * view.lightMaskWords;
         _lightIndices.clear();
-        for (size_t i = 0; i < _validLights.size(); i++) {
-            const auto light = _validLights[i];
-            const bool isCulled = cullingLight(light, model);
-            if (!isCulled) {
-                _lightIndices.emplace_back(i);
+        for (uint word = 0; word < view.lightMaskWords; ++word) {
+            for (auto bits = masks[word]; bits; bits &= bits - 1) {
+                uint bit = 0;
+                while (!(bits & (1u << bit))) ++bit;
+                _lightIndices.emplace_back(word * 32 + bit);
             }
         }
 
         if (_lightIndices.empty()) continue;
-        const auto subModelArrayID = model->getSubModelID();
+        if (!getLightPassIndex(ro, lightPassIndices, clusteredLighting)) continue;
+        const auto subModelArrayID = ro.subModelID;
         const auto subModelCount = subModelArrayID[0];
         for (unsigned j = 1; j <= subModelCount; j++) {
             const auto lightPassIdx = lightPassIndices[j - 1];
@@ -199,40 +222,10 @@ void RenderAdditiveLightQueue::clear() {
     _lightPasses.clear();
 }
 
-void RenderAdditiveLightQueue::gatherValidLights(const Camera* camera) {
-    const auto scene = camera->getScene();
-    const auto sphereLightArrayID = scene->getSphereLightArrayID();
-    auto count = sphereLightArrayID ? sphereLightArrayID[0] : 0;
-    Sphere sphere;
-    for (unsigned i = 1; i <= count; i++) {
-        const auto light = scene->getSphereLight(sphereLightArrayID[i]);
-        sphere.setCenter(light->position);
-        sphere.setRadius(light->range);
-        if (sphere_frustum(&sphere, camera->getFrustum())) {
-            _validLights.emplace_back(light);
-            getOrCreateDescriptorSet(light);
-        }
-    }
-    const auto spotLightArrayID = scene->getSpotLightArrayID();
-    count = spotLightArrayID ? spotLightArrayID[0] : 0;
-    for (unsigned i = 1; i <= count; i++) {
-        const auto light = scene->getSpotLight(spotLightArrayID[i]);
-        sphere.setCenter(light->position);
-        sphere.setRadius(light->range);
-        if (sphere_frustum(&sphere, camera->getFrustum())) {
-            _validLights.emplace_back(light);
-            getOrCreateDescriptorSet(light);
-        }
-    }
-}
-
-bool RenderAdditiveLightQueue::cullingLight(const Light *light, const ModelView *model) {
-    switch (light->getType()) {
-        case LightType::SPHERE:
-            return model->worldBoundsID && !aabb_aabb(model->getWorldBounds(), light->getAABB());
-        case LightType::SPOT:
-            return model->worldBoundsID && (!aabb_aabb(model->getWorldBounds(), light->getAABB()) || !aabb_frustum(model->getWorldBounds(), light->getFrustum()));
-        default: return false;
+void RenderAdditiveLightQueue::gatherValidLights(const RetainedView &view) {
+    _validLights.assign(view.lights.begin(), view.lights.end());
+    for (const auto *light : _validLights) {
+        getOrCreateDescriptorSet(light);
     }
 }
 
@@ -347,7 +340,6 @@ void RenderAdditiveLightQueue::updateLightDescriptorSet(const Camera *camera, gf
         descriptorSet->bindSampler(SPOT_LIGHTING_MAP::BINDING, _sampler);
         // Main light sampler binding
         descriptorSet->bindTexture(SHADOWMAP::BINDING, _pipeline->getDefaultTexture());
-        descriptorSet->update();
 
         _globalUBO.fill(0.0f);
         _shadowUBO.fill(0.0f);
@@ -375,9 +367,9 @@ void RenderAdditiveLightQueue::updateLightDescriptorSet(const Camera *camera, gf
                 memcpy(_shadowUBO.data() + UBOShadow::SHADOW_COLOR_OFFSET, &shadowInfo->color, sizeof(Vec4));
                 memcpy(_shadowUBO.data() + UBOShadow::SHADOW_INFO_OFFSET, &shadowInfos, sizeof(shadowInfos));
                 // Spot light sampler binding
-                const auto &shadowFramebufferMap = _pipeline->getShadowFramebufferMap();
-                if (shadowFramebufferMap.count(light) > 0) {
-                    auto *texture = shadowFramebufferMap.at(light)->getColorTextures()[0];
+                const auto &shadowMaps = _pipeline->getShadowMaps();
+                if (shadowMaps.count(light) > 0) {
+                    auto *texture = shadowMaps.at(light);
                     if (texture) {
                         descriptorSet->bindTexture(SPOT_LIGHTING_MAP::BINDING, texture);
                     }
@@ -414,7 +406,7 @@ void RenderAdditiveLightQueue::updateGlobalDescriptorSet(const Camera *camera, g
     // update UBOGlobal
     uboGlobalView[UBOGlobal::TIME_OFFSET] = root->cumulativeTime;
     uboGlobalView[UBOGlobal::TIME_OFFSET + 1] = root->frameTime;
-    uboGlobalView[UBOGlobal::TIME_OFFSET + 2] = Application::getInstance()->getTotalFrames();
+    uboGlobalView[UBOGlobal::TIME_OFFSET + 2] = _pipeline->getTotalFrames();
 
     uboGlobalView[UBOGlobal::SCREEN_SIZE_OFFSET] = device->getWidth();
     uboGlobalView[UBOGlobal::SCREEN_SIZE_OFFSET + 1] = device->getHeight();
@@ -517,11 +509,12 @@ void RenderAdditiveLightQueue::updateCameraUBO(const Camera *camera, gfx::Comman
     }
 }
 
-bool RenderAdditiveLightQueue::getLightPassIndex(const ModelView *model, vector<uint> &lightPassIndices) const {
+bool RenderAdditiveLightQueue::getLightPassIndex(const RenderObject &renderObject, vector<uint> &lightPassIndices, bool clusteredLighting) const {
     lightPassIndices.clear();
     bool hasValidLightPass = false;
 
-    const auto subModelArrayID = model->getSubModelID();
+    const auto model = renderObject.model;
+    const auto subModelArrayID = renderObject.subModelID;
     const auto count = subModelArrayID[0];
     for (unsigned i = 1; i <= count; i++) {
         const auto subModel = model->getSubModelView(subModelArrayID[i]);
@@ -530,16 +523,32 @@ bool RenderAdditiveLightQueue::getLightPassIndex(const ModelView *model, vector<
             const auto pass = subModel->getPassView(passIdx);
             if (pass->phase == _phaseID) {
                 lightPassIndex = passIdx;
-                hasValidLightPass = true;
                 break;
             }
         }
+        if (lightPassIndex != UINT_MAX && clusteredLighting && readsLightClusters(subModel, lightPassIndex)) {
+            lightPassIndex = UINT_MAX;
+        }
+        hasValidLightPass = hasValidLightPass || lightPassIndex != UINT_MAX;
         lightPassIndices.push_back(lightPassIndex);
     }
 
     return hasValidLightPass;
 }
 
+bool RenderAdditiveLightQueue::hasUnclusteredLightPass(const RetainedView &view) const {
+    static vector<uint> lightPassIndices;
+
+    const auto &renderObjects = view.renderObjects;
+    for (size_t i = 0; i < renderObjects.size(); ++i) {
+        const auto masks = view.lightMasks.data() + i * view.lightMaskWords;
+        bool lit = false;
+        for (uint word = 0; word < view.lightMaskWords && !lit; ++word) lit = masks[word] != 0;
+        if (lit && getLightPassIndex(renderObjects[i], lightPassIndices, true)) return true;
+    }
+    return false;
+}
+
 gfx::DescriptorSet *RenderAdditiveLightQueue::getOrCreateDescriptorSet(const Light *light) {
     if (!_descriptorSetMap.count(light)) {
         auto *device = gfx::Device::getInstance();
@@ -578,6 +587,9 @@ gfx::DescriptorSet *RenderAdditiveLightQueue::getOrCreateDescriptorSet(const Lig
         // Spot light sampler binding
         descriptorSet->bindSampler(SPOT_LIGHTING_MAP::BINDING, _sampler);
         descriptorSet->bindTexture(SPOT_LIGHTING_MAP::BINDING, _pipeline->getDefaultTexture());
+        // Clustered lights are not used by additive passes
+        descriptorSet->bindSampler(CLUSTER_LIGHTS::BINDING, _sampler);
+        descriptorSet->bindTexture(CLUSTER_LIGHTS::BINDING, _pipeline->getDefaultTexture());
 
         descriptorSet->update();
 
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include "Define.h"
 #include "core/CoreStd.h"
 #include "helper/SharedMemory.h"
 
@@ -41,6 +42,7 @@ struct Sphere;
 class Shader;
 class ForwardPipeline;
 class DescriptorSet;
+struct RetainedView;
 
 struct AdditiveLightPass {
     const SubModelView *subModel = nullptr;
@@ -56,19 +58,22 @@ public:
     ~RenderAdditiveLightQueue();
 
     void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer);
-    void gatherLightPasses(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
+    // Appends the draws of the queue, must run on the main thread.
+    void resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls);
+    // With clustered lighting only sub models whose shaders do not read the light clusters get additive passes.
+    void gatherLightPasses(const Camera *camera, gfx::CommandBuffer *cmdBuffer, bool clusteredLighting = false);
     void destroy();
 
 private:
     void clear();
-    void gatherValidLights(const Camera *camera);
-    bool cullingLight(const Light *light, const ModelView *model);
+    void gatherValidLights(const RetainedView &view);
     void addRenderQueue(const PassView *pass, const SubModelView *subModel, const ModelView *model, uint lightPassIdx);
     void updateUBOs(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
     void updateCameraUBO(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
     void updateLightDescriptorSet(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
     void updateGlobalDescriptorSet(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
-    bool getLightPassIndex(const ModelView *model, vector<uint> &lightPassIndices) const;
+    bool getLightPassIndex(const RenderObject &renderObject, vector<uint> &lightPassIndices, bool clusteredLighting) const;
+    bool hasUnclusteredLightPass(const RetainedView &view) const;
     gfx::DescriptorSet *getOrCreateDescriptorSet(const Light *);
 
 private:
@@ -79,7 +84,7 @@ private:
     vector<uint> _lightIndices;
     vector<AdditiveLightPass> _lightPasses;
     vector<RenderObject> _renderObjects;
-    vector<uint> _dynamicOffsets;
+    DrawCallList _drawCalls;
     vector<float> _lightBufferData;
     RenderInstancedQueue *_instancedQueue = nullptr;
     RenderBatchedQueue *_batchedQueue = nullptr;
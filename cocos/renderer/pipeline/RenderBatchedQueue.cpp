@@ -40,36 +40,37 @@ void RenderBatchedQueue::clear() {
 
 void RenderBatchedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
     for (auto batchedBuffer : _queues) {
-        auto &batches = batchedBuffer->getBatches();
-        for (auto &batch : batches) {
-            if (!batch.mergeCount) continue;
-
-            auto i = 0u;
-            for (auto vb : batch.vbs) {
-                cmdBuffer->updateBuffer(vb, batch.vbDatas[i++], vb->getSize());
-            }
-            cmdBuffer->updateBuffer(batch.indexBuffer, batch.indexData, batch.indexBuffer->getSize());
-            cmdBuffer->updateBuffer(batch.ubo, batch.uboData.data(), batch.ubo->getSize());
-        }
+        batchedBuffer->uploadBuffers(cmdBuffer);
     }
 }
 
 void RenderBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
+    _drawCalls.clear();
+    resolveDrawCalls(renderPass, _drawCalls);
+    recordDrawCalls(cmdBuffer, _drawCalls);
+}
+
+void RenderBatchedQueue::resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) const {
     for (auto batchedBuffer : _queues) {
-        bool boundPSO = false;
+        gfx::PipelineState *pso = nullptr;
+        gfx::DescriptorSet *materialSet = nullptr;
+        const auto &dynamicOffsets = batchedBuffer->getDynamicOffset();
         const auto &batches = batchedBuffer->getBatches();
         for (const auto &batch : batches) {
             if (!batch.mergeCount) continue;
-            if (!boundPSO) {
-                auto pso = PipelineStateManager::getOrCreatePipelineState(batch.pass, batch.shader, batch.ia, renderPass);
-                cmdBuffer->bindPipelineState(pso);
-                cmdBuffer->bindDescriptorSet(MATERIAL_SET, batch.pass->getDescriptorSet());
-                boundPSO = true;
+            if (!pso) {
+                pso = PipelineStateManager::getOrCreatePipelineState(batch.pass, batch.shader, batch.ia, renderPass);
+                materialSet = batch.pass->getDescriptorSet();
             }
 
-            cmdBuffer->bindDescriptorSet(LOCAL_SET, batch.descriptorSet, batchedBuffer->getDynamicOffset());
-            cmdBuffer->bindInputAssembler(batch.ia);
-            cmdBuffer->draw(batch.ia);
+            DrawCall drawCall;
+            drawCall.pipelineState = pso;
+            drawCall.materialSet = materialSet;
+            drawCall.localSet = batch.descriptorSet;
+            drawCall.inputAssembler = batch.ia;
+            drawCall.dynamicOffsetCount = static_cast<uint>(dynamicOffsets.size());
+            drawCall.dynamicOffsets = dynamicOffsets.data();
+            drawCalls.emplace_back(drawCall);
         }
     }
 }
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include "Define.h"
 #include "core/CoreStd.h"
 
 namespace cc {
@@ -38,10 +39,13 @@ public:
     void clear();
     void uploadBuffers(gfx::CommandBuffer *cmdBuff);
     void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *);
+    // Appends the draws of the queue, must run on the main thread.
+    void resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) const;
     void add(BatchedBuffer *batchedBuffer);
 
 private:
     unordered_set<BatchedBuffer *> _queues;
+    DrawCallList _drawCalls;
 };
 
 } // namespace pipeline
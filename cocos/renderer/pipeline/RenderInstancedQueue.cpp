@@ -46,26 +46,32 @@ void RenderInstancedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
 }
 
 void RenderInstancedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
+    _drawCalls.clear();
+    resolveDrawCalls(renderPass, _drawCalls);
+    recordDrawCalls(cmdBuffer, _drawCalls);
+}
+
+void RenderInstancedQueue::resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) const {
     for (auto instanceBuffer : _queues) {
         if (!instanceBuffer->hasPendingModels()) continue;
 
         const auto &instances = instanceBuffer->getInstances();
+        const auto &dynamicOffsets = instanceBuffer->dynamicOffsets();
         const auto pass = instanceBuffer->getPass();
-        cmdBuffer->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
-        gfx::PipelineState *lastPSO = nullptr;
+        auto materialSet = pass->getDescriptorSet();
         for (size_t b = 0; b < instances.size(); ++b) {
             const auto &instance = instances[b];
             if (!instance.count) {
                 continue;
             }
-            auto pso = PipelineStateManager::getOrCreatePipelineState(pass, instance.shader, instance.ia, renderPass);
-            if (lastPSO != pso) {
-                cmdBuffer->bindPipelineState(pso);
-                lastPSO = pso;
-            }
-            cmdBuffer->bindDescriptorSet(LOCAL_SET, instance.descriptorSet, instanceBuffer->dynamicOffsets());
-            cmdBuffer->bindInputAssembler(instance.ia);
-            cmdBuffer->draw(instance.ia);
+            DrawCall drawCall;
+            drawCall.pipelineState = PipelineStateManager::getOrCreatePipelineState(pass, instance.shader, instance.ia, renderPass);
+            drawCall.materialSet = materialSet;
+            drawCall.localSet = instance.descriptorSet;
+            drawCall.inputAssembler = instance.ia;
+            drawCall.dynamicOffsetCount = static_cast<uint>(dynamicOffsets.size());
+            drawCall.dynamicOffsets = dynamicOffsets.data();
+            drawCalls.emplace_back(drawCall);
         }
     }
 }
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include "Define.h"
 #include "core/CoreStd.h"
 
 namespace cc {
@@ -36,12 +37,15 @@ public:
     ~RenderInstancedQueue() = default;
 
     void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer);
+    // Appends the draws of the queue, must run on the main thread.
+    void resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) const;
     void add(InstancedBuffer *instancedBuffer);
     void uploadBuffers(gfx::CommandBuffer *cmdBuffer);
     void clear();
 
 private:
     unordered_set<InstancedBuffer *> _queues;
+    DrawCallList _drawCalls;
 };
 
 } // namespace pipeline
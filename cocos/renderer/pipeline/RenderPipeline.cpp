@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "RenderPipeline.h"
 #include "RenderFlow.h"
+#include "helper/TransientResourcePool.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXDescriptorSetLayout.h"
@@ -40,11 +41,17 @@ RenderPipeline *RenderPipeline::getInstance() {
 RenderPipeline::RenderPipeline()
 : _device(gfx::Device::getInstance()) {
     RenderPipeline::_instance = this;
+    _transientPool = CC_NEW(TransientResourcePool(_device));
 
     setDescriptorSetLayout();
 }
 
 RenderPipeline::~RenderPipeline() {
+    CC_SAFE_DELETE(_transientPool);
+}
+
+uint RenderPipeline::getRenderTargetPeakBytes() const {
+    return _transientPool->getPeakBytes();
 }
 
 void RenderPipeline::setDescriptorSetLayout() {
@@ -62,6 +69,8 @@ void RenderPipeline::setDescriptorSetLayout() {
     globalDescriptorSetLayout.bindings[ENVIRONMENT::BINDING] = ENVIRONMENT::DESCRIPTOR;
     globalDescriptorSetLayout.samplers[SPOT_LIGHTING_MAP::NAME] = SPOT_LIGHTING_MAP::LAYOUT;
     globalDescriptorSetLayout.bindings[SPOT_LIGHTING_MAP::BINDING] = SPOT_LIGHTING_MAP::DESCRIPTOR;
+    globalDescriptorSetLayout.samplers[CLUSTER_LIGHTS::NAME] = CLUSTER_LIGHTS::LAYOUT;
+    globalDescriptorSetLayout.bindings[CLUSTER_LIGHTS::BINDING] = CLUSTER_LIGHTS::DESCRIPTOR;
 
     localDescriptorSetLayout.bindings.resize(static_cast<size_t>(ModelLocalBindings::COUNT));
     localDescriptorSetLayout.blocks[UBOLocalBatched::NAME] = UBOLocalBatched::LAYOUT;
@@ -139,6 +148,9 @@ void RenderPipeline::render(const vector<uint> &cameras) {
 }
 
 void RenderPipeline::destroy() {
+    // pooled framebuffers go first, the flows own the render passes they were created with
+    _transientPool->destroy();
+
     for (auto flow : _flows) {
         flow->destroy();
     }
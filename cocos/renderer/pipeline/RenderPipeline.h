@@ -37,6 +37,7 @@ struct Camera;
 } // namespace gfx
 namespace pipeline {
 class DefineMap;
+class TransientResourcePool;
 
 struct CC_DLL RenderPipelineInfo {
     uint tag = 0;
@@ -63,6 +64,9 @@ public:
     CC_INLINE gfx::DescriptorSet *getDescriptorSet() const { return _descriptorSet; }
     CC_INLINE gfx::DescriptorSetLayout *getDescriptorSetLayout() const { return _descriptorSetLayout; }
     CC_INLINE gfx::Texture *getDefaultTexture() const { return _defaultTexture; }
+    CC_INLINE TransientResourcePool *getTransientPool() const { return _transientPool; }
+    // largest amount of pooled render target memory live at once during the last frame
+    uint getRenderTargetPeakBytes() const;
 
 protected:
     static RenderPipeline *_instance;
@@ -80,6 +84,7 @@ protected:
     // has not initBuiltinRes,
     // create temporary default Texture to binding sampler2d
     gfx::Texture *_defaultTexture = nullptr;
+    TransientResourcePool *_transientPool = nullptr;
 };
 
 } // namespace pipeline
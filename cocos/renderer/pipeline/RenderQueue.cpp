@@ -26,9 +26,32 @@ THE SOFTWARE.
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXShader.h"
 #include "helper/SharedMemory.h"
+#include <cstring>
 
 namespace cc {
 namespace pipeline {
+namespace {
+// Below this size a comparison sort beats the fixed cost of the radix histograms.
+constexpr size_t RADIX_SORT_THRESHOLD = 64;
+constexpr uint RADIX_BITS = 8;
+constexpr uint RADIX_SIZE = 1 << RADIX_BITS;
+constexpr uint RADIX_PASSES = 64 / RADIX_BITS;
+
+// Maps a float onto an unsigned integer with the same ordering.
+uint32_t getOrderedDepth(float depth) {
+    uint32_t bits = 0;
+    memcpy(&bits, &depth, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : bits | 0x80000000;
+}
+
+uint64_t getBits(uint value, uint bitCount) {
+    return static_cast<uint64_t>(value) & ((1ULL << bitCount) - 1);
+}
+
+bool compareSortKey(const RenderPass &a, const RenderPass &b) {
+    return a.sortKey < b.sortKey;
+}
+} // namespace
 
 RenderQueue::RenderQueue(const RenderQueueCreateInfo &desc)
 : _passDesc(desc) {
@@ -39,8 +62,7 @@ void RenderQueue::clear() {
 }
 
 bool RenderQueue::insertRenderPass(const RenderObject &renderObj, uint subModelIdx, uint passIdx) {
-    const auto subModelID = renderObj.model->getSubModelID();
-    const auto subModel = renderObj.model->getSubModelView(subModelID[subModelIdx]);
+    const auto subModel = renderObj.model->getSubModelView(renderObj.subModelID[subModelIdx]);
     const auto pass = subModel->getPassView(passIdx);
     const auto isTransparent = pass->getBlendState()->targets[0].blend;
 
@@ -48,18 +70,88 @@ bool RenderQueue::insertRenderPass(const RenderObject &renderObj, uint subModelI
         return false;
     }
 
-    const auto hash = (0 << 30) | (pass->priority << 16) | (subModel->priority << 8) | passIdx;
+    const auto sortKey = getSortKey(pass, subModel, passIdx, renderObj.depth);
     uint shaderID = subModel->shaderID[passIdx];
-    RenderPass renderPass = {hash, renderObj.depth, shaderID, passIdx, subModel};
+    RenderPass renderPass = {sortKey, renderObj.depth, shaderID, passIdx, subModel, renderObj.model};
     _queue.emplace_back(std::move(renderPass));
     return true;
 }
 
+// Pass priority, sub-model priority and pass index take the top 24 bits, in the order the pass hash had them.
+// All 32 bits of depth follow, front to back or back to front, and the shader breaks depth ties, so the keys order
+// passes exactly as the hash, depth and shader comparators did. Shader IDs wider than their field only lose the tie break.
+uint64_t RenderQueue::getSortKey(const PassView *pass, const SubModelView *subModel, uint passIdx, float depth) const {
+    CCASSERT(passIdx < 256, "RenderQueue: pass index exceeds its sort key field");
+    const auto priority = (getBits(pass->priority, 8) << 56) | (getBits(subModel->priority, 8) << 48) | (getBits(passIdx, 8) << 40);
+    const auto orderedDepth = getOrderedDepth(depth);
+    const auto depthBits = _passDesc.sortMode == RenderQueueSortMode::BACK_TO_FRONT ? ~orderedDepth : orderedDepth;
+    return priority | (static_cast<uint64_t>(depthBits) << 8) | getBits(subModel->shaderID[passIdx], 8);
+}
+
+void RenderQueue::radixSort(RenderPassList::iterator begin, RenderPassList::iterator end) {
+    const auto count = static_cast<size_t>(end - begin);
+    if (count < RADIX_SORT_THRESHOLD) {
+        std::stable_sort(begin, end, compareSortKey);
+        return;
+    }
+
+    uint histograms[RADIX_PASSES][RADIX_SIZE] = {};
+    for (auto iter = begin; iter != end; ++iter) {
+        for (uint pass = 0; pass < RADIX_PASSES; ++pass) {
+            ++histograms[pass][(iter->sortKey >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)];
+        }
+    }
+
+    _sortBuffer.resize(count);
+    RenderPass *src = &*begin;
+    RenderPass *dst = _sortBuffer.data();
+    for (uint pass = 0; pass < RADIX_PASSES; ++pass) {
+        auto histogram = histograms[pass];
+        const uint shift = pass * RADIX_BITS;
+        // Every key shares this digit, the pass would be a plain copy.
+        if (histogram[(src->sortKey >> shift) & (RADIX_SIZE - 1)] == count) continue;
+
+        uint offset = 0;
+        for (uint i = 0; i < RADIX_SIZE; ++i) {
+            const auto digitCount = histogram[i];
+            histogram[i] = offset;
+            offset += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[histogram[(src[i].sortKey >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != &*begin) {
+        std::copy(src, src + count, begin);
+    }
+}
+
 void RenderQueue::sort() {
-    std::sort(_queue.begin(), _queue.end(), _passDesc.sortFunc);
+    radixSort(_queue.begin(), _queue.end());
+}
+
+void RenderQueue::removeModels(const vector<const ModelView *> &models) {
+    _queue.erase(std::remove_if(_queue.begin(), _queue.end(), [&models](const RenderPass &renderPass) {
+                     return std::binary_search(models.begin(), models.end(), renderPass.model);
+                 }),
+                 _queue.end());
+}
+
+void RenderQueue::merge(size_t sortedCount) {
+    const auto middle = _queue.begin() + sortedCount;
+    radixSort(middle, _queue.end());
+    std::inplace_merge(_queue.begin(), middle, _queue.end(), compareSortKey);
 }
 
 void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    _drawCalls.clear();
+    resolveDrawCalls(renderPass, _drawCalls);
+    recordDrawCalls(cmdBuff, _drawCalls);
+}
+
+void RenderQueue::resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) const {
     for (size_t i = 0; i < _queue.size(); ++i) {
         const auto subModel = _queue[i].subModel;
         const auto passIdx = _queue[i].passIndex;
@@ -68,12 +160,12 @@ void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *rend
         const auto pass = subModel->getPassView(passIdx);
         auto shader = subModel->getShader(passIdx);
 
-        auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
-        cmdBuff->bindPipelineState(pso);
-        cmdBuff->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
-        cmdBuff->bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
-        cmdBuff->bindInputAssembler(inputAssembler);
-        cmdBuff->draw(inputAssembler);
+        DrawCall drawCall;
+        drawCall.pipelineState = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
+        drawCall.materialSet = pass->getDescriptorSet();
+        drawCall.localSet = subModel->getDescriptorSet();
+        drawCall.inputAssembler = inputAssembler;
+        drawCalls.emplace_back(drawCall);
     }
 }
 
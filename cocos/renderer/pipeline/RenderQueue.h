@@ -35,10 +35,23 @@ public:
     void clear();
     bool insertRenderPass(const RenderObject &renderObj, uint subModelIdx, uint passIdx);
     void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    // Appends the draws of the queue, must run on the main thread.
+    void resolveDrawCalls(gfx::RenderPass *renderPass, DrawCallList &drawCalls) const;
     void sort();
+    // Removes the passes of the given models, which must be sorted by address.
+    void removeModels(const vector<const ModelView *> &models);
+    // Sorts the passes inserted after the first sortedCount ones and merges them into the sorted range.
+    void merge(size_t sortedCount);
+
+    CC_INLINE size_t size() const { return _queue.size(); }
 
 private:
+    uint64_t getSortKey(const PassView *pass, const SubModelView *subModel, uint passIdx, float depth) const;
+    void radixSort(RenderPassList::iterator begin, RenderPassList::iterator end);
+
     RenderPassList _queue;
+    RenderPassList _sortBuffer;
+    DrawCallList _drawCalls;
     RenderQueueCreateInfo _passDesc;
 };
 
@@ -55,18 +55,18 @@ void ShadowMapBatchedQueue::gatherLightPasses(const Light *light, gfx::CommandBu
     if (light && shadowInfo->enabled && shadowInfo->getShadowType() == ShadowType::SHADOWMAP) {
         updateUBOs(light, cmdBufferer);
 
-        for (const auto ro : shadowObjects) {
+        for (const auto &ro : shadowObjects) {
             const auto *model = ro.model;
 
             switch (light->getType()) {
                 case LightType::DIRECTIONAL:
-                    add(model, cmdBufferer);
+                    add(ro, cmdBufferer);
                     break;
                 case LightType::SPOT:
                     if (model->getWorldBounds() &&
                         (aabb_aabb(model->getWorldBounds(), light->getAABB()) ||
                          aabb_frustum(model->getWorldBounds(), light->getFrustum()))) {
-                        add(model, cmdBufferer);
+                        add(ro, cmdBufferer);
                     }
                     break;
                 default:;
@@ -83,14 +83,15 @@ void ShadowMapBatchedQueue::clear() {
     if (_batchedQueue) _batchedQueue->clear();
 }
 
-void ShadowMapBatchedQueue::add(const ModelView *model, gfx::CommandBuffer *cmdBufferer) {
+void ShadowMapBatchedQueue::add(const RenderObject &renderObject, gfx::CommandBuffer *cmdBufferer) {
     // this assumes light pass index is the same for all submodels
-    const auto shadowPassIdx = getShadowPassIndex(model);
+    const auto shadowPassIdx = getShadowPassIndex(renderObject);
     if (shadowPassIdx < 0) {
         return;
     }
 
-    const auto subModelID = model->getSubModelID();
+    const auto model = renderObject.model;
+    const auto subModelID = renderObject.subModelID;
     const auto subModelCount = subModelID[0];
     for (unsigned m = 1; m <= subModelCount; ++m) {
         const auto subModel = model->getSubModelView(subModelID[m]);
@@ -202,8 +203,9 @@ void ShadowMapBatchedQueue::updateUBOs(const Light *light, gfx::CommandBuffer *c
     cmdBufferer->updateBuffer(_pipeline->getDescriptorSet()->getBuffer(UBOShadow::BINDING), shadowUBO.data(), UBOShadow::SIZE);
 }
 
-int ShadowMapBatchedQueue::getShadowPassIndex(const ModelView *model) const {
-    const auto subModelArrayID = model->getSubModelID();
+int ShadowMapBatchedQueue::getShadowPassIndex(const RenderObject &renderObject) const {
+    const auto model = renderObject.model;
+    const auto subModelArrayID = renderObject.subModelID;
     const auto count = subModelArrayID[0];
     for (unsigned i = 1; i <= count; i++) {
         const auto subModel = model->getSubModelView(subModelArrayID[i]);
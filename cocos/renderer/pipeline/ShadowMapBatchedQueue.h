@@ -50,12 +50,12 @@ public:
 
     void clear();
     void gatherLightPasses(const Light *, gfx::CommandBuffer *);
-    void add(const ModelView *, gfx::CommandBuffer *);
+    void add(const RenderObject &, gfx::CommandBuffer *);
     void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *) const;
 
 private:
     void updateUBOs(const Light *, gfx::CommandBuffer *) const;
-    int getShadowPassIndex(const ModelView *model) const;
+    int getShadowPassIndex(const RenderObject &renderObject) const;
 
 private:
     ForwardPipeline *_pipeline = nullptr;
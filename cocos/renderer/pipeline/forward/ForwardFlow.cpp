@@ -56,8 +56,6 @@ void ForwardFlow::activate(RenderPipeline *pipeline) {
 }
 
 void ForwardFlow::render(Camera *camera) {
-    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    sceneCulling(pipeline, camera);
     RenderFlow::render(camera);
 }
 
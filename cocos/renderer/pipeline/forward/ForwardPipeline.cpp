@@ -21,7 +21,16 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
+#include <chrono>
+
 #include "ForwardPipeline.h"
+#include "../BatchedBuffer.h"
+#include "../InstancedBuffer.h"
+#include "../PipelineStateManager.h"
+#include "../helper/OcclusionBuffer.h"
+#include "../helper/ParallelCulling.h"
+#include "../helper/SceneBVH.h"
+#include "../helper/TransientResourcePool.h"
 #include "../shadow/ShadowFlow.h"
 #include "ForwardFlow.h"
 #include "SceneCulling.h"
@@ -35,6 +44,7 @@ THE SOFTWARE.
 #include "gfx/GFXSampler.h"
 #include "gfx/GFXTexture.h"
 #include "platform/Application.h"
+#include "platform/FileUtils.h"
 
 namespace cc {
 namespace pipeline {
@@ -48,6 +58,10 @@ namespace {
     dst[offset + 1] = src.y;      \
     dst[offset + 2] = src.z;      \
     dst[offset + 3] = src.w;
+
+String getPipelineStateRecordPath() {
+    return FileUtils::getInstance()->getWritablePath() + "pipeline-states.bin";
+}
 } // namespace
 
 gfx::RenderPass *ForwardPipeline::getOrCreateRenderPass(gfx::ClearFlags clearFlags) {
@@ -83,6 +97,7 @@ gfx::RenderPass *ForwardPipeline::getOrCreateRenderPass(gfx::ClearFlags clearFla
         depthStencilAttachment,
     });
     _renderPasses[clearFlags] = renderPass;
+    PipelineStateManager::addWarmupRenderPass(renderPass);
 
     return renderPass;
 }
@@ -103,14 +118,6 @@ void ForwardPipeline::setShadows(uint shadows) {
     _shadows = GET_SHADOWS(shadows);
 }
 
-void ForwardPipeline::destroyShadowFrameBuffers() {
-    for (auto &pair : _shadowFrameBufferMap) {
-        pair.second->destroy();
-        delete pair.second;
-    }
-    _shadowFrameBufferMap.clear();
-}
-
 bool ForwardPipeline::initialize(const RenderPipelineInfo &info) {
     RenderPipeline::initialize(info);
 
@@ -124,6 +131,8 @@ bool ForwardPipeline::initialize(const RenderPipelineInfo &info) {
         _flows.emplace_back(forwardFlow);
     }
     _sphere = CC_NEW(Sphere);
+    _cullingWorkers = CC_NEW(CullingWorkers);
+    _occlusionBuffer = CC_NEW(OcclusionBuffer);
 
     return true;
 }
@@ -139,21 +148,109 @@ bool ForwardPipeline::activate() {
         return false;
     }
 
+    PipelineStateManager::loadWarmupRecords(getPipelineStateRecordPath());
+
     return true;
 }
 
+uint ForwardPipeline::getTotalFrames() const {
+    const auto app = Application::getInstance();
+    return app ? app->getTotalFrames() : _frameCount;
+}
+
 void ForwardPipeline::render(const vector<uint> &cameras) {
+    ++_frameCount;
+    releaseRetainedData();
     _commandBuffers[0]->begin();
+    InstancedBuffer::beginFrame();
+    BatchedBuffer::beginFrame();
+    _transientPool->beginFrame();
     updateGlobalUBO();
+    updateSceneBVHs(cameras);
+    _rebuiltEntryCount = 0;
+    _renderedShadowMapCount = 0;
+    _occludedObjectCount = 0;
+    _occlusionCullingTime = 0.0f;
+    _clusteredLightCount = 0;
+    _lightBinningTime = 0.0f;
+    _cullingTime = 0.0f;
+    _flowTimes.assign(_flows.size(), 0.0f);
     for (const auto cameraId : cameras) {
         Camera *camera = GET_CAMERA(cameraId);
         updateCameraUBO(camera);
-        for (const auto flow : _flows) {
-            flow->render(camera);
+        // visibility for every flow of the camera in one pass
+        auto start = std::chrono::steady_clock::now();
+        sceneCulling(this, camera);
+        std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - start;
+        _cullingTime += time.count();
+        for (size_t i = 0; i < _flows.size(); ++i) {
+            start = std::chrono::steady_clock::now();
+            _flows[i]->render(camera);
+            time = std::chrono::steady_clock::now() - start;
+            _flowTimes[i] += time.count();
         }
+        clearShadowMaps();
     }
     _commandBuffers[0]->end();
     _device->getQueue()->submit(_commandBuffers);
+    _transientPool->endFrame();
+}
+
+void ForwardPipeline::updateSceneBVHs(const vector<uint> &cameras) {
+    static vector<uint> updatedScenes;
+    updatedScenes.clear();
+    for (const auto cameraId : cameras) {
+        const auto sceneID = GET_CAMERA(cameraId)->sceneID;
+        if (std::find(updatedScenes.begin(), updatedScenes.end(), sceneID) != updatedScenes.end()) continue;
+        updatedScenes.emplace_back(sceneID);
+
+        auto &scene = _sceneBVHs[sceneID];
+        if (!scene.bvh) scene.bvh = CC_NEW(SceneBVH);
+        scene.lastUsedFrame = _frameCount;
+        scene.bvh->update(GET_SCENE(sceneID));
+    }
+}
+
+// Cameras and scenes are pooled, a destroyed one must not leave its data behind for the next one at its address.
+void ForwardPipeline::releaseRetainedData() {
+    for (auto iter = _retainedViews.begin(); iter != _retainedViews.end();) {
+        if (iter->second.lastUsedFrame + 1 < _frameCount) {
+            iter = _retainedViews.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    for (auto iter = _sceneBVHs.begin(); iter != _sceneBVHs.end();) {
+        if (iter->second.lastUsedFrame + 1 < _frameCount) {
+            CC_DELETE(iter->second.bvh);
+            iter = _sceneBVHs.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+SceneBVH *ForwardPipeline::getSceneBVH(const Camera *camera) const {
+    const auto iter = _sceneBVHs.find(camera->sceneID);
+    return iter != _sceneBVHs.end() ? iter->second.bvh : nullptr;
+}
+
+bool ForwardPipeline::isMultithreadedRecording() const {
+    // Metal's execute() only folds the statistics of secondary buffers and does not replay them.
+    return _multithreadedRecording && _cullingWorkers && _cullingWorkers->getWorkerCount() &&
+           _device->hasFeature(gfx::Feature::MULTITHREADED_SUBMISSION) && _device->getGfxAPI() != gfx::API::METAL;
+}
+
+void ForwardPipeline::setClusteredLighting(bool value) {
+    _clusteredLighting = value;
+    if (_descriptorSet) {
+        _macros.setValue("CC_USE_CLUSTERED_LIGHTING", isClusteredLighting());
+    }
+}
+
+bool ForwardPipeline::isClusteredLighting() const {
+    // light lists are read with texelFetch from a float texture
+    return _clusteredLighting && _device->getGfxAPI() != gfx::API::GLES2 && _device->hasFeature(gfx::Feature::TEXTURE_FLOAT);
 }
 
 void ForwardPipeline::updateCameraUBO(Camera *camera) {
@@ -252,8 +349,8 @@ void ForwardPipeline::updateShadowUBO(Camera *camera) {
     const auto shadowInfo = _shadows;
     if (shadowInfo->enabled) {
         if (mainLight && shadowInfo->getShadowType() == ShadowType::SHADOWMAP) {
-            if (_shadowFrameBufferMap.count(mainLight) > 0) {
-                auto *texture = _shadowFrameBufferMap.at(mainLight)->getColorTextures()[0];
+            if (_shadowMaps.count(mainLight) > 0) {
+                auto *texture = _shadowMaps.at(mainLight);
                 if (texture) {
                     _descriptorSet->bindTexture(SHADOWMAP::BINDING, texture);
                 }
@@ -315,7 +412,7 @@ void ForwardPipeline::updateGlobalUBO() {
     // update UBOGlobal
     uboGlobalView[UBOGlobal::TIME_OFFSET] = root->cumulativeTime;
     uboGlobalView[UBOGlobal::TIME_OFFSET + 1] = root->frameTime;
-    uboGlobalView[UBOGlobal::TIME_OFFSET + 2] = Application::getInstance()->getTotalFrames();
+    uboGlobalView[UBOGlobal::TIME_OFFSET + 2] = getTotalFrames();
 
     uboGlobalView[UBOGlobal::SCREEN_SIZE_OFFSET] = _device->getWidth();
     uboGlobalView[UBOGlobal::SCREEN_SIZE_OFFSET + 1] = _device->getHeight();
@@ -384,16 +481,24 @@ bool ForwardPipeline::activeRenderer() {
     this->_descriptorSet->bindSampler(SPOT_LIGHTING_MAP::BINDING, shadowMapSampler);
     this->_descriptorSet->bindTexture(SPOT_LIGHTING_MAP::BINDING, getDefaultTexture());
 
+    // Clustered lights binding, the forward stage swaps in its light texture
+    this->_descriptorSet->bindSampler(CLUSTER_LIGHTS::BINDING, shadowMapSampler);
+    this->_descriptorSet->bindTexture(CLUSTER_LIGHTS::BINDING, getDefaultTexture());
+
     _descriptorSet->update();
 
     // update global defines when all states initialized.
     _macros.setValue("CC_USE_HDR", _isHDR);
     _macros.setValue("CC_SUPPORT_FLOAT_TEXTURE", _device->hasFeature(gfx::Feature::TEXTURE_FLOAT));
+    _macros.setValue("CC_USE_CLUSTERED_LIGHTING", isClusteredLighting());
 
     return true;
 }
 
 void ForwardPipeline::destroy() {
+    PipelineStateManager::saveWarmupRecords(getPipelineStateRecordPath());
+    PipelineStateManager::destroyAll();
+
     if (_descriptorSet) {
         _descriptorSet->getBuffer(UBOGlobal::BINDING)->destroy();
         _descriptorSet->getBuffer(UBOCamera::BINDING)->destroy();
@@ -412,8 +517,15 @@ void ForwardPipeline::destroy() {
     _commandBuffers.clear();
 
     CC_SAFE_DELETE(_sphere);
+    CC_SAFE_DELETE(_cullingWorkers);
+    CC_SAFE_DELETE(_occlusionBuffer);
+    for (auto &pair : _sceneBVHs) {
+        CC_DELETE(pair.second.bvh);
+    }
+    _sceneBVHs.clear();
+    _retainedViews.clear();
 
-    _shadowFrameBufferMap.clear();
+    _shadowMaps.clear();
 
     RenderPipeline::destroy();
 }
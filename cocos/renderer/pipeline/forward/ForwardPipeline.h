@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include "../RenderPipeline.h"
 #include "../helper/SharedMemory.h"
+#include "SceneCulling.h"
 
 namespace cc {
 namespace pipeline {
@@ -40,6 +41,9 @@ struct Shadows;
 struct Sphere;
 struct Camera;
 class Framebuffer;
+class CullingWorkers;
+class OcclusionBuffer;
+class SceneBVH;
 
 class CC_DLL ForwardPipeline : public RenderPipeline {
 public:
@@ -55,16 +59,34 @@ public:
     void updateCameraUBO(Camera *camera);
     void updateShadowUBO(Camera *camera);
     CC_INLINE void setHDR(bool isHDR) { _isHDR = isHDR; }
+    CC_INLINE void setMultithreadedRecording(bool value) { _multithreadedRecording = value; }
+    // Whether stages may record their queues into secondary command buffers on the culling workers.
+    bool isMultithreadedRecording() const;
+    // Whether scene culling also drops models hidden behind the largest models in view, tested on the CPU.
+    CC_INLINE void setOcclusionCulling(bool value) { _occlusionCulling = value; }
+    CC_INLINE bool isOcclusionCulling() const { return _occlusionCulling; }
+    // Whether sphere and spot lights are binned into view space clusters and shaded in the base pass.
+    // Falls back to additive light passes where float textures are missing, and always on GLES2.
+    void setClusteredLighting(bool value);
+    bool isClusteredLighting() const;
+    // Scales the screen size of models before their level of detail is picked,
+    // values below 1 switch to coarser levels earlier, e.g. when a frame time governor falls behind.
+    CC_INLINE void setLODBias(float value) { _lodBias = value; }
+    CC_INLINE float getLODBias() const { return _lodBias; }
 
     gfx::RenderPass *getOrCreateRenderPass(gfx::ClearFlags clearFlags);
     void setFog(uint);
     void setAmbient(uint);
     void setSkybox(uint);
     void setShadows(uint);
-    void destroyShadowFrameBuffers();
-
-    CC_INLINE void setShadowFramebuffer(const Light *light, gfx::Framebuffer *framebuffer) { _shadowFrameBufferMap.emplace(light, framebuffer); }
-    CC_INLINE const std::unordered_map<const Light *, gfx::Framebuffer *> &getShadowFramebufferMap() const { return _shadowFrameBufferMap; }
+    // Whether the shadow flow keeps the maps of unchanged lights across frames instead of rendering them again.
+    CC_INLINE void setShadowMapCaching(bool value) { _shadowMapCaching = value; }
+    CC_INLINE bool isShadowMapCaching() const { return _shadowMapCaching; }
+
+    // the shadow maps of the camera being rendered, owned by the shadow flow
+    CC_INLINE void setShadowMap(const Light *light, gfx::Texture *texture) { _shadowMaps[light] = texture; }
+    CC_INLINE const std::unordered_map<const Light *, gfx::Texture *> &getShadowMaps() const { return _shadowMaps; }
+    CC_INLINE void clearShadowMaps() { _shadowMaps.clear(); }
     CC_INLINE gfx::Buffer *getLightsUBO() const { return _lightsUBO; }
     CC_INLINE const LightList &getValidLights() const { return _validLights; }
     CC_INLINE const gfx::BufferList &getLightBuffers() const { return _lightBuffers; }
@@ -81,16 +103,55 @@ public:
     CC_INLINE const Skybox *getSkybox() const { return _skybox; }
     CC_INLINE Shadows *getShadows() const { return _shadows; }
     CC_INLINE Sphere *getSphere() const { return _sphere; }
+    CC_INLINE CullingWorkers *getCullingWorkers() const { return _cullingWorkers; }
+    CC_INLINE OcclusionBuffer *getOcclusionBuffer() const { return _occlusionBuffer; }
+    SceneBVH *getSceneBVH(const Camera *camera) const;
+    CC_INLINE RetainedView &getRetainedView(const Camera *camera) { return _retainedViews[camera]; }
+    // Counts render() calls, per camera data not used during the previous one is released.
+    CC_INLINE uint getFrameCount() const { return _frameCount; }
+    // Frames ticked by the application, the shaders see it as cc_time.z. Falls back to getFrameCount() without an application.
+    uint getTotalFrames() const;
+    // Render objects and queue entries rebuilt during the current frame.
+    CC_INLINE uint getRebuiltEntryCount() const { return _rebuiltEntryCount; }
+    CC_INLINE void addRebuiltEntries(uint count) { _rebuiltEntryCount += count; }
+    // Shadow maps rendered during the current frame, cached ones are not counted.
+    CC_INLINE uint getRenderedShadowMapCount() const { return _renderedShadowMapCount; }
+    CC_INLINE void addRenderedShadowMap() { ++_renderedShadowMapCount; }
+    // Models dropped by occlusion culling during the current frame and the time it took in milliseconds.
+    CC_INLINE uint getOccludedObjectCount() const { return _occludedObjectCount; }
+    CC_INLINE float getOcclusionCullingTime() const { return _occlusionCullingTime; }
+    CC_INLINE void addOcclusionResult(uint occludedCount, float time) {
+        _occludedObjectCount += occludedCount;
+        _occlusionCullingTime += time;
+    }
+    // Lights binned into clusters during the current frame and the time it took in milliseconds.
+    CC_INLINE uint getClusteredLightCount() const { return _clusteredLightCount; }
+    CC_INLINE float getLightBinningTime() const { return _lightBinningTime; }
+    CC_INLINE void addLightBinningResult(uint lightCount, float time) {
+        _clusteredLightCount += lightCount;
+        _lightBinningTime += time;
+    }
+    // CPU time of scene culling and of every flow in the order of getFlows() during the current frame, in milliseconds.
+    CC_INLINE float getCullingTime() const { return _cullingTime; }
+    CC_INLINE const vector<float> &getFlowTimes() const { return _flowTimes; }
     CC_INLINE std::array<float, UBOShadow::COUNT> getShadowUBO() const { return _shadowUBO; }
 
     CC_INLINE void setRenderObjects(RenderObjectList &&ro) { _renderObjects = std::forward<RenderObjectList>(ro); }
+    CC_INLINE void setRenderObjects(const RenderObjectList &ro) { _renderObjects = ro; }
     CC_INLINE void setShadowObjects(RenderObjectList &&ro) { _shadowObjects = std::forward<RenderObjectList>(ro); }
 
 private:
     bool activeRenderer();
     void updateUBO(Camera *);
+    void updateSceneBVHs(const vector<uint> &cameras);
+    void releaseRetainedData();
 
 private:
+    struct RetainedScene {
+        SceneBVH *bvh = nullptr;
+        uint lastUsedFrame = 0;
+    };
+
     const Fog *_fog = nullptr;
     const Ambient *_ambient = nullptr;
     const Skybox *_skybox = nullptr;
@@ -107,12 +168,30 @@ private:
     std::array<float, UBOCamera::COUNT> _cameraUBO;
     std::array<float, UBOShadow::COUNT> _shadowUBO;
     Sphere *_sphere = nullptr;
+    CullingWorkers *_cullingWorkers = nullptr;
+    OcclusionBuffer *_occlusionBuffer = nullptr;
+    unordered_map<uint, RetainedScene> _sceneBVHs;
+    unordered_map<const Camera *, RetainedView> _retainedViews;
+    uint _frameCount = 0;
+    uint _rebuiltEntryCount = 0;
+    uint _renderedShadowMapCount = 0;
+    uint _occludedObjectCount = 0;
+    float _occlusionCullingTime = 0.0f;
+    uint _clusteredLightCount = 0;
+    float _lightBinningTime = 0.0f;
+    float _cullingTime = 0.0f;
+    vector<float> _flowTimes;
 
     float _shadingScale = 1.0f;
     bool _isHDR = false;
+    bool _multithreadedRecording = false;
+    bool _shadowMapCaching = true;
+    bool _occlusionCulling = false;
+    bool _clusteredLighting = false;
+    float _lodBias = 1.0f;
     float _fpScale = 1.0f / 1024.0f;
 
-    std::unordered_map<const Light *, gfx::Framebuffer *> _shadowFrameBufferMap;
+    std::unordered_map<const Light *, gfx::Texture *> _shadowMaps;
 };
 
 } // namespace pipeline
@@ -21,6 +21,8 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
+#include <chrono>
+
 #include "ForwardStage.h"
 #include "../BatchedBuffer.h"
 #include "../InstancedBuffer.h"
@@ -29,17 +31,24 @@ THE SOFTWARE.
 #include "../RenderBatchedQueue.h"
 #include "../RenderInstancedQueue.h"
 #include "../RenderQueue.h"
+#include "../helper/LightClusters.h"
+#include "../helper/ParallelCulling.h"
 #include "../helper/SharedMemory.h"
 #include "ForwardPipeline.h"
 #include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXFramebuffer.h"
 #include "gfx/GFXQueue.h"
+#include "gfx/GFXTexture.h"
 #include "UIPhase.h"
 
 namespace cc {
 namespace pipeline {
 namespace {
+// Same units as the additive light passes.
+constexpr float LIGHT_METER_SCALE = 10000.0f;
+
 void SRGBToLinear(gfx::Color &out, const gfx::Color &gamma) {
     out.x = gamma.x * gamma.x;
     out.y = gamma.y * gamma.y;
@@ -53,6 +62,9 @@ void LinearToSRGB(gfx::Color &out, const gfx::Color &linear) {
 }
 } // namespace
 
+constexpr uint ForwardStage::RECORD_TASK_COUNT;
+constexpr uint ForwardStage::UI_TASK_INDEX;
+
 RenderStageInfo ForwardStage::_initInfo = {
     "ForwardStage",
     static_cast<uint>(ForwardStagePriority::FORWARD),
@@ -65,6 +77,7 @@ ForwardStage::ForwardStage() : RenderStage() {
     _batchedQueue = CC_NEW(RenderBatchedQueue);
     _instancedQueue = CC_NEW(RenderInstancedQueue);
     _uiPhase = CC_NEW(UIPhase);
+    _lightClusters = CC_NEW(LightClusters);
 }
 
 ForwardStage::~ForwardStage() {
@@ -85,19 +98,7 @@ void ForwardStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
             phase |= getPhaseID(stage);
         }
 
-        std::function<int(const RenderPass &, const RenderPass &)> sortFunc = opaqueCompareFn;
-        switch (descriptor.sortMode) {
-            case RenderQueueSortMode::BACK_TO_FRONT:
-                sortFunc = transparentCompareFn;
-                break;
-            case RenderQueueSortMode::FRONT_TO_BACK:
-                sortFunc = opaqueCompareFn;
-            default:
-                break;
-        }
-
-        RenderQueueCreateInfo info = {descriptor.isTransparent, phase, sortFunc};
-        _renderQueues.emplace_back(CC_NEW(RenderQueue(std::move(info))));
+        _renderQueueInfos.push_back({descriptor.isTransparent, phase, descriptor.sortMode});
     }
 
     _additiveLightQueue = CC_NEW(RenderAdditiveLightQueue(_pipeline));
@@ -106,30 +107,54 @@ void ForwardStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
 }
 
 void ForwardStage::destroy() {
+    releaseCameraQueues(true);
+    _renderQueueInfos.clear();
+    for (auto cmdBuff : _secondaryCommandBuffers) {
+        CC_DESTROY(cmdBuff);
+    }
+    _secondaryCommandBuffers.clear();
     CC_SAFE_DELETE(_batchedQueue);
     CC_SAFE_DELETE(_instancedQueue);
     CC_SAFE_DELETE(_additiveLightQueue);
     CC_SAFE_DELETE(_planarShadowQueue);
     CC_SAFE_DELETE(_uiPhase);
+    CC_SAFE_DELETE(_lightClusters);
+    CC_SAFE_DESTROY(_clusterTexture);
     RenderStage::destroy();
 }
 
-void ForwardStage::render(Camera *camera) {
-    _instancedQueue->clear();
-    _batchedQueue->clear();
-    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    const auto &renderObjects = pipeline->getRenderObjects();
+ForwardStage::CameraQueues &ForwardStage::getCameraQueues(const Camera *camera) {
+    auto &queues = _cameraQueues[camera];
+    if (queues.renderQueues.empty()) {
+        for (const auto &info : _renderQueueInfos) {
+            queues.renderQueues.emplace_back(CC_NEW(RenderQueue(info)));
+        }
+    }
+    queues.lastUsedFrame = _frame;
+    return queues;
+}
 
-    for (auto queue : _renderQueues) {
-        queue->clear();
+void ForwardStage::releaseCameraQueues(bool all) {
+    for (auto iter = _cameraQueues.begin(); iter != _cameraQueues.end();) {
+        if (all || iter->second.lastUsedFrame + 1 < _frame) {
+            for (auto queue : iter->second.renderQueues) {
+                CC_DELETE(queue);
+            }
+            iter = _cameraQueues.erase(iter);
+        } else {
+            ++iter;
+        }
     }
+}
 
+uint ForwardStage::addRenderObjects(CameraQueues &queues, const RenderObjectList &renderObjects) {
+    uint count = 0;
     uint m = 0, p = 0;
     size_t k = 0;
     for (size_t i = 0; i < renderObjects.size(); ++i) {
         const auto &ro = renderObjects[i];
         const auto model = ro.model;
-        const auto subModelID = model->getSubModelID();
+        const auto subModelID = ro.subModelID;
         const auto subModelCount = subModelID[0];
         for (m = 1; m <= subModelCount; ++m) {
             auto subModel = model->getSubModelView(subModelID[m]);
@@ -138,30 +163,95 @@ void ForwardStage::render(Camera *camera) {
 
                 if (pass->phase != _phaseID) continue;
                 if (pass->getBatchingScheme() == BatchingSchemes::INSTANCING) {
-                    auto instancedBuffer = InstancedBuffer::get(subModel->passID[p]);
-                    instancedBuffer->merge(model, subModel, p);
-                    _instancedQueue->add(instancedBuffer);
+                    queues.instancedDraws.push_back({model, subModel, p});
+                    ++count;
                 } else if (pass->getBatchingScheme() == BatchingSchemes::VB_MERGING) {
-                    auto batchedBuffer = BatchedBuffer::get(subModel->passID[p]);
-                    batchedBuffer->merge(subModel, p, model);
-                    _batchedQueue->add(batchedBuffer);
+                    queues.batchedDraws.push_back({model, subModel, p});
+                    ++count;
                 } else {
-                    for (k = 0; k < _renderQueues.size(); k++) {
-                        _renderQueues[k]->insertRenderPass(ro, m, p);
+                    for (k = 0; k < queues.renderQueues.size(); k++) {
+                        if (queues.renderQueues[k]->insertRenderPass(ro, m, p)) ++count;
                     }
                 }
             }
         }
     }
-    for (auto queue : _renderQueues) {
-        queue->sort();
+    return count;
+}
+
+void ForwardStage::updateCameraQueues(CameraQueues &queues, const RetainedView &view) {
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    const bool patchable = !view.rebuilt && queues.cullingSerial + 1 == view.cullingSerial;
+    queues.cullingSerial = view.cullingSerial;
+
+    if (!patchable) {
+        for (auto queue : queues.renderQueues) {
+            queue->clear();
+        }
+        queues.instancedDraws.clear();
+        queues.batchedDraws.clear();
+
+        pipeline->addRebuiltEntries(addRenderObjects(queues, view.renderObjects));
+        for (auto queue : queues.renderQueues) {
+            queue->sort();
+        }
+        return;
     }
 
+    if (view.changedModels.empty()) return;
+
+    static vector<size_t> sortedCounts;
+    sortedCounts.clear();
+    for (auto queue : queues.renderQueues) {
+        queue->removeModels(view.changedModels);
+        sortedCounts.emplace_back(queue->size());
+    }
+    const auto isChanged = [&view](const DrawRef &draw) {
+        return std::binary_search(view.changedModels.begin(), view.changedModels.end(), draw.model);
+    };
+    queues.instancedDraws.erase(std::remove_if(queues.instancedDraws.begin(), queues.instancedDraws.end(), isChanged), queues.instancedDraws.end());
+    queues.batchedDraws.erase(std::remove_if(queues.batchedDraws.begin(), queues.batchedDraws.end(), isChanged), queues.batchedDraws.end());
+
+    pipeline->addRebuiltEntries(addRenderObjects(queues, view.changedObjects));
+    for (size_t i = 0; i < queues.renderQueues.size(); ++i) {
+        queues.renderQueues[i]->merge(sortedCounts[i]);
+    }
+}
+
+void ForwardStage::render(Camera *camera) {
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
     auto cmdBuff = pipeline->getCommandBuffers()[0];
+    cmdBuff->beginProfileScope("ForwardStage");
+
+    const auto frame = pipeline->getFrameCount();
+    if (frame != _frame) {
+        _frame = frame;
+        releaseCameraQueues(false);
+    }
+
+    _instancedQueue->clear();
+    _batchedQueue->clear();
+    auto &queues = getCameraQueues(camera);
+    updateCameraQueues(queues, pipeline->getRetainedView(camera));
+
+    // instance data is gathered every frame from the retained draw lists
+    for (const auto &draw : queues.instancedDraws) {
+        auto instancedBuffer = InstancedBuffer::get(draw.subModel->passID[draw.passIndex]);
+        instancedBuffer->merge(draw.model, draw.subModel, draw.passIndex);
+        _instancedQueue->add(instancedBuffer);
+    }
+    for (const auto &draw : queues.batchedDraws) {
+        auto batchedBuffer = BatchedBuffer::get(draw.subModel->passID[draw.passIndex]);
+        batchedBuffer->merge(draw.subModel, draw.passIndex, draw.model);
+        _batchedQueue->add(batchedBuffer);
+    }
 
     _instancedQueue->uploadBuffers(cmdBuff);
     _batchedQueue->uploadBuffers(cmdBuff);
-    _additiveLightQueue->gatherLightPasses(camera, cmdBuff);
+    const bool clusteredLighting = pipeline->isClusteredLighting();
+    if (clusteredLighting) updateLightClusters(camera, cmdBuff);
+    // sub models whose shaders do not read the clusters still take the additive passes
+    _additiveLightQueue->gatherLightPasses(camera, cmdBuff, clusteredLighting);
     _planarShadowQueue->gatherShadowPasses(camera, cmdBuff);
 
     // render area is not oriented
@@ -193,18 +283,123 @@ void ForwardStage::render(Camera *camera) {
 
     auto renderPass = colorTextures.size() && colorTextures[0] ? framebuffer->getRenderPass() : pipeline->getOrCreateRenderPass(static_cast<gfx::ClearFlagBit>(camera->clearFlag));
 
-    cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil);
-    cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
-
-    _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _instancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _batchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _additiveLightQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _planarShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _uiPhase->render(camera, renderPass);
-    
+    if (pipeline->isMultithreadedRecording()) {
+        cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors.data(), camera->clearDepth, camera->clearStencil, true);
+        recordSecondaryCommandBuffers(queues, camera, renderPass, framebuffer);
+        cmdBuff->execute(_secondaryCommandBuffers, RECORD_TASK_COUNT);
+    } else {
+        cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+        for (uint i = 0; i < RECORD_TASK_COUNT; ++i) {
+            recordQueue(i, queues, camera, renderPass, cmdBuff);
+        }
+    }
+
     cmdBuff->endRenderPass();
+    cmdBuff->endProfileScope();
+}
+
+void ForwardStage::updateLightClusters(Camera *camera, gfx::CommandBuffer *cmdBuff) {
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto luminanceScale = (pipeline->isHDR() ? pipeline->getFpScale() : camera->exposure) * LIGHT_METER_SCALE;
+    _lightClusters->build(camera, pipeline->getRetainedView(camera).lights, _device->getClipSpaceMinZ(), luminanceScale, pipeline->getCullingWorkers());
+
+    if (!_clusterTexture) {
+        _clusterTexture = _device->createTexture({
+            gfx::TextureType::TEX2D,
+            gfx::TextureUsageBit::SAMPLED | gfx::TextureUsageBit::TRANSFER_DST,
+            gfx::Format::RGBA32F,
+            LightClusters::TEXTURE_WIDTH,
+            LightClusters::TEXTURE_HEIGHT,
+        });
+        gfx::SamplerInfo info{
+            gfx::Filter::POINT,
+            gfx::Filter::POINT,
+            gfx::Filter::NONE,
+            gfx::Address::CLAMP,
+            gfx::Address::CLAMP,
+            gfx::Address::CLAMP,
+        };
+        auto descriptorSet = pipeline->getDescriptorSet();
+        descriptorSet->bindSampler(CLUSTER_LIGHTS::BINDING, getSampler(genSamplerHash(std::move(info))));
+        descriptorSet->bindTexture(CLUSTER_LIGHTS::BINDING, _clusterTexture);
+        descriptorSet->update();
+    }
+
+    // lights, cluster ranges and indices share one upload, only the rows in use
+    gfx::BufferTextureCopy region;
+    region.texExtent.width = LightClusters::TEXTURE_WIDTH;
+    region.texExtent.height = _lightClusters->getUsedRows();
+    const auto buffer = reinterpret_cast<const uint8_t *>(_lightClusters->getTexels());
+    cmdBuff->copyBuffersToTexture(&buffer, _clusterTexture, &region, 1);
+
+    const std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - start;
+    pipeline->addLightBinningResult(_lightClusters->getLightCount(), time.count());
+}
+
+void ForwardStage::recordQueue(uint index, const CameraQueues &queues, Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    switch (index) {
+        case 0: queues.renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 1: _instancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 2: _batchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 3: _additiveLightQueue->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 4: _planarShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 5: queues.renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 6: _uiPhase->render(camera, renderPass, cmdBuff); break;
+        default: break;
+    }
+}
+
+void ForwardStage::resolveQueue(uint index, const CameraQueues &queues, gfx::RenderPass *renderPass, DrawCallList &drawCalls) {
+    switch (index) {
+        case 0: queues.renderQueues[0]->resolveDrawCalls(renderPass, drawCalls); break;
+        case 1: _instancedQueue->resolveDrawCalls(renderPass, drawCalls); break;
+        case 2: _batchedQueue->resolveDrawCalls(renderPass, drawCalls); break;
+        case 3: _additiveLightQueue->resolveDrawCalls(renderPass, drawCalls); break;
+        case 4: _planarShadowQueue->resolveDrawCalls(renderPass, drawCalls); break;
+        case 5: queues.renderQueues[1]->resolveDrawCalls(renderPass, drawCalls); break;
+        default: break;
+    }
+}
+
+// Object pools, pass blend states and PipelineStateManager are main thread only,
+// so every draw is resolved to its pipeline state, descriptor sets and input assembler here first.
+// Workers then only bind and draw what was resolved, into their own secondary command buffers.
+void ForwardStage::recordSecondaryCommandBuffers(const CameraQueues &queues, Camera *camera, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer) {
+    if (_secondaryCommandBuffers.empty()) {
+        for (uint i = 0; i < RECORD_TASK_COUNT; ++i) {
+            _secondaryCommandBuffers.emplace_back(_device->createCommandBuffer({_device->getQueue(), gfx::CommandBufferType::SECONDARY}));
+        }
+    }
+
+    for (uint i = 0; i < UI_TASK_INDEX; ++i) {
+        _drawCalls[i].clear();
+        resolveQueue(i, queues, renderPass, _drawCalls[i]);
+    }
+
+    const gfx::Viewport viewport{_renderArea.x, _renderArea.y, _renderArea.width, _renderArea.height};
+    auto globalSet = _pipeline->getDescriptorSet();
+    const auto beginSecondary = [&](gfx::CommandBuffer *cmdBuff) {
+        cmdBuff->begin(renderPass, 0, framebuffer);
+        cmdBuff->setViewport(viewport);
+        cmdBuff->setScissor(_renderArea);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, globalSet);
+    };
+
+    auto uiCmdBuff = _secondaryCommandBuffers[UI_TASK_INDEX];
+    beginSecondary(uiCmdBuff);
+    _uiPhase->render(camera, renderPass, uiCmdBuff);
+    uiCmdBuff->end();
+
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    pipeline->getCullingWorkers()->dispatchEach(UI_TASK_INDEX, [&](uint index) {
+        auto cmdBuff = _secondaryCommandBuffers[index];
+        beginSecondary(cmdBuff);
+        recordDrawCalls(cmdBuff, _drawCalls[index]);
+        cmdBuff->end();
+    });
 }
 
 } // namespace pipeline
@@ -34,8 +34,10 @@ class RenderInstancedQueue;
 class RenderAdditiveLightQueue;
 class PlanarShadowQueue;
 class ForwardPipeline;
+class LightClusters;
 class UIPhase;
 struct Camera;
+struct RetainedView;
 
 class CC_DLL ForwardStage : public RenderStage {
 public:
@@ -50,6 +52,36 @@ public:
     virtual void render(Camera *camera) override;
 
 private:
+    struct DrawRef {
+        const ModelView *model = nullptr;
+        const SubModelView *subModel = nullptr;
+        uint passIndex = 0;
+    };
+    // Draw lists of one camera, kept across frames and patched together with its RetainedView.
+    struct CameraQueues {
+        vector<RenderQueue *> renderQueues;
+        vector<DrawRef> instancedDraws;
+        vector<DrawRef> batchedDraws;
+        uint cullingSerial = 0;
+        uint lastUsedFrame = 0;
+    };
+
+    // Queues are recorded in this order, either inline or one secondary command buffer each.
+    static constexpr uint RECORD_TASK_COUNT = 7;
+    // The UI phase reads its batches from the object pools, so its buffer is always recorded on the main thread.
+    static constexpr uint UI_TASK_INDEX = RECORD_TASK_COUNT - 1;
+
+    CameraQueues &getCameraQueues(const Camera *camera);
+    // Drops the queues of cameras that were not rendered during the previous frame, or all of them.
+    void releaseCameraQueues(bool all);
+    uint addRenderObjects(CameraQueues &queues, const RenderObjectList &renderObjects);
+    void updateCameraQueues(CameraQueues &queues, const RetainedView &view);
+    // Bins the lights sceneCulling found for the camera and uploads them, replacing the additive light passes.
+    void updateLightClusters(Camera *camera, gfx::CommandBuffer *cmdBuff);
+    void recordQueue(uint index, const CameraQueues &queues, Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    void resolveQueue(uint index, const CameraQueues &queues, gfx::RenderPass *renderPass, DrawCallList &drawCalls);
+    void recordSecondaryCommandBuffers(const CameraQueues &queues, Camera *camera, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer);
+
     static RenderStageInfo _initInfo;
     ForwardPipeline *_forwrdPipeline = nullptr;
     PlanarShadowQueue *_planarShadowQueue = nullptr;
@@ -57,8 +89,15 @@ private:
     RenderInstancedQueue *_instancedQueue = nullptr;
     RenderAdditiveLightQueue *_additiveLightQueue = nullptr;
     UIPhase *_uiPhase = nullptr;
+    LightClusters *_lightClusters = nullptr;
+    gfx::Texture *_clusterTexture = nullptr;
     gfx::Rect _renderArea;
     uint _phaseID = 0;
+    vector<RenderQueueCreateInfo> _renderQueueInfos;
+    unordered_map<const Camera *, CameraQueues> _cameraQueues;
+    uint _frame = 0;
+    gfx::CommandBufferList _secondaryCommandBuffers;
+    std::array<DrawCallList, UI_TASK_INDEX> _drawCalls;
 };
 
 } // namespace pipeline
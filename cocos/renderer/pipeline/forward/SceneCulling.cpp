@@ -22,23 +22,28 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include <array>
+#include <chrono>
+#include <limits>
 #include <vector>
 
 #include "../Define.h"
+#include "../helper/OcclusionBuffer.h"
+#include "../helper/ParallelCulling.h"
+#include "../helper/SceneBVH.h"
 #include "../helper/SharedMemory.h"
 #include "ForwardPipeline.h"
 #include "SceneCulling.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDevice.h"
 #include "math/Quaternion.h"
-#include "platform/Application.h"
 
 namespace cc {
 namespace pipeline {
 bool castBoundsInitialized = false;
 AABB castWorldBounds;
 
-RenderObject genRenderObject(const ModelView *model, const Camera *camera) {
+RenderObject genRenderObject(const ModelView *model, const Camera *camera, const LODGroup *lodGroup, uint lodLevel) {
     float depth = 0;
     if (model->nodeID) {
         const auto node = model->getTransform();
@@ -47,7 +52,8 @@ RenderObject genRenderObject(const ModelView *model, const Camera *camera) {
         depth = position.dot(camera->forward);
     }
 
-    return {depth, model};
+    const auto subModelID = lodGroup && lodLevel < lodGroup->levelCount ? lodGroup->getSubModelID(lodLevel) : model->getSubModelID();
+    return {depth, model, subModelID};
 }
 
 void getShadowWorldMatrix(const Sphere *sphere, const cc::Vec4 &rotation, const cc::Vec3 &dir, cc::Mat4 &shadowWorldMat, cc::Vec3 &out) {
@@ -158,35 +164,287 @@ void lightCollecting(Camera *camera, std::vector<const Light *> &validLights) {
     CC_SAFE_DELETE(sphere);
 }
 
-void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
-    const auto scene = camera->getScene();
+namespace {
+// At most this many models are rasterized as occluders, the ones covering most of the screen.
+constexpr uint MAX_OCCLUDERS = 32;
+// Bounding radius over view depth, smaller models hide too little to be worth rasterizing.
+constexpr float MIN_OCCLUDER_SIZE = 0.1f;
 
-    castBoundsInitialized = false;
+// Per range scratch of the parallel culling passes, kept across frames to avoid reallocation.
+struct CullingRange {
+    vector<uint> modelIndices;
+    RenderObjectList renderObjects;
+    AABB castWorldBounds;
+    bool castBoundsInitialized = false;
+};
+vector<CullingRange> cullingRanges;
+// Per scene model scratch of the visibility pass.
+vector<uint8_t> modelVisible;
+vector<uint> modelSlots;
+
+constexpr uint8_t INVALID_LOD_LEVEL = 0xFF;
+// A model has to get this much smaller than the threshold of its level before it switches to a coarser one.
+constexpr float LOD_HYSTERESIS = 0.1f;
+
+bool isModelVisible(const ModelView *model, uint visibility) {
+    if (!model->enabled) return false;
+    const auto node = model->getNode();
+    return (model->nodeID && ((visibility & node->layer) == node->layer)) ||
+           (visibility & model->visFlags);
+}
 
-    RenderObjectList shadowObjects;
+// Picks the level of detail from the share of the viewport height covered by the bounding sphere of the model.
+// lastLevel is the level picked before and receives the new one.
+uint pickLODLevel(const ModelView *model, const LODGroup *lodGroup, const Camera *camera, float bias, uint8_t &lastLevel) {
+    if (!lodGroup || !model->worldBoundsID) {
+        lastLevel = 0;
+        return 0;
+    }
+
+    const auto bounds = model->getWorldBounds();
+    const auto &matProj = camera->matProj.m;
+    const float radius = bounds->halfExtents.length();
+    float screenSize = radius * std::abs(matProj[5]);
+    if (matProj[11] != 0.0f) { // perspective
+        const float distance = bounds->center.distance(camera->position);
+        screenSize = distance > radius ? screenSize / distance : std::numeric_limits<float>::max();
+    }
+    screenSize *= bias;
+
+    const uint levelCount = lodGroup->levelCount < LODGroup::MAX_LEVELS ? lodGroup->levelCount : LODGroup::MAX_LEVELS;
+    uint level = 0;
+    while (level + 1 < levelCount && screenSize < lodGroup->screenSizes[level]) ++level;
+    if (lastLevel < level && screenSize >= lodGroup->screenSizes[lastLevel] * (1.0f - LOD_HYSTERESIS)) {
+        level = lastLevel;
+    }
+    lastLevel = static_cast<uint8_t>(level);
+    return level;
+}
+
+// Triangles of the visible models by level of detail, summed over all cameras by the device until the frame is presented.
+void countLODTriangles(const RetainedView &view) {
+    uint triangles[gfx::Device::MAX_LOD_LEVELS] = {};
+    const auto skyboxOffset = view.skyboxModelID ? 1u : 0u;
+    for (uint i = 0; i < view.renderObjects.size(); ++i) {
+        const auto &ro = view.renderObjects[i];
+        const auto lodLevel = i < skyboxOffset ? 0u : view.lodLevels[view.modelIndices[i - skyboxOffset]];
+        const auto level = std::min(lodLevel == INVALID_LOD_LEVEL ? 0u : lodLevel, gfx::Device::MAX_LOD_LEVELS - 1);
+        const auto subModelCount = ro.subModelID ? ro.subModelID[0] : 0;
+        for (uint m = 1; m <= subModelCount; ++m) {
+            const auto ia = ro.model->getSubModelView(ro.subModelID[m])->getInputAssembler();
+            if (ia) triangles[level] += (ia->getIndexCount() ? ia->getIndexCount() : ia->getVertexCount()) / 3;
+        }
+    }
+
+    auto *device = gfx::Device::getInstance();
+    for (uint level = 0; level < gfx::Device::MAX_LOD_LEVELS; ++level) {
+        if (triangles[level]) device->addLODTris(level, triangles[level]);
+    }
+}
+
+bool isViewChanged(const RetainedView &view, const Camera *camera) {
+    return view.visibility != camera->visibility ||
+           memcmp(view.matViewProj.m, camera->matViewProj.m, sizeof(view.matViewProj.m)) ||
+           memcmp(&view.position, &camera->position, sizeof(view.position)) ||
+           memcmp(&view.forward, &camera->forward, sizeof(view.forward));
+}
+
+// Drops the models of a freshly rebuilt view that are hidden behind the largest models in it.
+void cullOccludedModels(ForwardPipeline *pipeline, const Camera *camera, const SceneBVH *bvh, RetainedView &view) {
+    const auto start = std::chrono::steady_clock::now();
+    auto *workers = pipeline->getCullingWorkers();
+
+    static vector<std::pair<float, const AABB *>> candidates;
+    candidates.clear();
+    for (const auto modelIndex : view.modelIndices) {
+        const auto *bounds = bvh->getModel(modelIndex)->getWorldBounds();
+        if (!bounds) continue;
+        cc::Vec3 offset;
+        cc::Vec3::subtract(bounds->center, camera->position, &offset);
+        const float depth = offset.dot(camera->forward);
+        const float radius = bounds->halfExtents.length();
+        // boxes reaching behind the camera can't be projected
+        if (depth <= radius) continue;
+        if (radius >= depth * MIN_OCCLUDER_SIZE) candidates.emplace_back(radius / depth, bounds);
+    }
+    if (candidates.empty()) return;
+    if (candidates.size() > MAX_OCCLUDERS) {
+        std::nth_element(candidates.begin(), candidates.begin() + MAX_OCCLUDERS, candidates.end(),
+                         [](const std::pair<float, const AABB *> &a, const std::pair<float, const AABB *> &b) { return a.first > b.first; });
+        candidates.resize(MAX_OCCLUDERS);
+    }
+
+    static vector<const AABB *> occluders;
+    occluders.clear();
+    for (const auto &candidate : candidates) {
+        occluders.emplace_back(candidate.second);
+    }
+    auto *occlusionBuffer = pipeline->getOcclusionBuffer();
+    occlusionBuffer->build(camera->matViewProj, occluders, workers);
+
+    static vector<uint8_t> visible;
+    const auto modelCount = static_cast<uint>(view.modelIndices.size());
+    visible.resize(modelCount);
+    workers->dispatch(modelCount, [&](uint /*rangeIndex*/, uint begin, uint end) {
+        for (uint i = begin; i < end; ++i) {
+            visible[i] = occlusionBuffer->isVisible(bvh->getModel(view.modelIndices[i])->getWorldBounds());
+        }
+    });
+
+    const auto skyboxOffset = view.skyboxModelID ? 1 : 0;
+    uint visibleCount = 0;
+    for (uint i = 0; i < modelCount; ++i) {
+        if (!visible[i]) continue;
+        view.modelIndices[visibleCount] = view.modelIndices[i];
+        view.renderObjects[skyboxOffset + visibleCount] = view.renderObjects[skyboxOffset + i];
+        ++visibleCount;
+    }
+    view.modelIndices.resize(visibleCount);
+    view.renderObjects.resize(skyboxOffset + visibleCount);
 
-    const auto models = scene->getModels();
-    const auto modelCount = models[0];
-    for (size_t i = 1; i <= modelCount; i++) {
-        const auto model = scene->getModelView(models[i]);
-
-        // filter model by view visibility
-        if (model->enabled) {
-            const auto visibility = camera->visibility;
-            const auto node = model->getNode();
-            if ((model->nodeID && ((visibility & node->layer) == node->layer)) ||
-                (visibility & model->visFlags)) {
-                // shadow render Object
-                if (model->castShadow && model->getWorldBounds()) {
-                    if (!castBoundsInitialized) {
-                        castWorldBounds = *model->getWorldBounds();
-                        castBoundsInitialized = true;
-                    }
-                    castWorldBounds.merge(*model->getWorldBounds());
-                    shadowObjects.emplace_back(genRenderObject(model, camera));
-                }
+    const std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - start;
+    pipeline->addOcclusionResult(modelCount - visibleCount, time.count());
+}
+
+void rebuildView(ForwardPipeline *pipeline, Camera *camera, const SceneBVH *bvh, RetainedView &view) {
+    const auto visibility = camera->visibility;
+    auto *workers = pipeline->getCullingWorkers();
+
+    view.rebuilt = true;
+    view.bvh = bvh;
+    view.bvhVersion = bvh->getVersion();
+    view.visibility = visibility;
+    view.occlusionCulling = pipeline->isOcclusionCulling();
+    view.lodBias = pipeline->getLODBias();
+    view.matViewProj = camera->matViewProj;
+    view.position = camera->position;
+    view.forward = camera->forward;
+    view.modelIndices.clear();
+    view.renderObjects.clear();
+
+    if (view.skyboxModelID) {
+        view.renderObjects.emplace_back(genRenderObject(pipeline->getSkybox()->getModel(), camera));
+    }
+
+    // frustum culling
+    static vector<uint> modelIndices;
+    bvh->queryFrustum(camera->getFrustum(), modelIndices);
+
+    // filter model by view visibility
+    const auto modelCount = static_cast<uint>(modelIndices.size());
+    cullingRanges.resize(workers->getRangeCount(modelCount));
+    workers->dispatch(modelCount, [&](uint rangeIndex, uint begin, uint end) {
+        auto &range = cullingRanges[rangeIndex];
+        range.modelIndices.clear();
+        range.renderObjects.clear();
+        for (uint i = begin; i < end; ++i) {
+            const auto modelIndex = modelIndices[i];
+            if (modelVisible[modelIndex]) {
+                const auto model = bvh->getModel(modelIndex);
+                const auto lodGroup = bvh->getLODGroup(modelIndex);
+                const auto lodLevel = pickLODLevel(model, lodGroup, camera, view.lodBias, view.lodLevels[modelIndex]);
+                range.modelIndices.emplace_back(modelIndex);
+                range.renderObjects.emplace_back(genRenderObject(model, camera, lodGroup, lodLevel));
             }
         }
+    });
+
+    for (const auto &range : cullingRanges) {
+        view.modelIndices.insert(view.modelIndices.end(), range.modelIndices.begin(), range.modelIndices.end());
+        view.renderObjects.insert(view.renderObjects.end(), range.renderObjects.begin(), range.renderObjects.end());
+    }
+
+    if (view.occlusionCulling) {
+        cullOccludedModels(pipeline, camera, bvh, view);
+    }
+
+    pipeline->addRebuiltEntries(static_cast<uint>(view.renderObjects.size()));
+}
+
+void patchView(ForwardPipeline *pipeline, Camera *camera, const SceneBVH *bvh, RetainedView &view) {
+    const auto visibility = camera->visibility;
+    const auto frustum = camera->getFrustum();
+    const auto skyboxOffset = view.skyboxModelID ? 1 : 0;
+
+    view.rebuilt = false;
+    for (const auto modelIndex : bvh->getChangedIndices()) {
+        const auto model = bvh->getModel(modelIndex);
+        const bool visible = isModelVisible(model, visibility) &&
+                             (!model->worldBoundsID || aabb_frustum(model->getWorldBounds(), frustum));
+        const auto iter = std::lower_bound(view.modelIndices.begin(), view.modelIndices.end(), modelIndex);
+        const auto position = skyboxOffset + (iter - view.modelIndices.begin());
+        const bool retained = iter != view.modelIndices.end() && *iter == modelIndex;
+        if (!visible && !retained) continue;
+
+        if (!visible) {
+            view.modelIndices.erase(iter);
+            view.renderObjects.erase(view.renderObjects.begin() + position);
+        } else {
+            const auto lodGroup = bvh->getLODGroup(modelIndex);
+            const auto lodLevel = pickLODLevel(model, lodGroup, camera, view.lodBias, view.lodLevels[modelIndex]);
+            const auto renderObject = genRenderObject(model, camera, lodGroup, lodLevel);
+            if (retained) {
+                view.renderObjects[position] = renderObject;
+            } else {
+                view.modelIndices.insert(iter, modelIndex);
+                view.renderObjects.insert(view.renderObjects.begin() + position, renderObject);
+            }
+            view.changedObjects.emplace_back(renderObject);
+        }
+        view.changedModels.emplace_back(model);
+    }
+    std::sort(view.changedModels.begin(), view.changedModels.end());
+
+    pipeline->addRebuiltEntries(static_cast<uint>(view.changedModels.size()));
+}
+
+// The one walk over all scene models: layer visibility for rebuilding the view,
+// and the shadow casters with their merged bounds when shadow maps are on.
+// Casters use the level of detail the camera would pick without storing it, the view does that for visible models.
+void sweepModels(ForwardPipeline *pipeline, const Camera *camera, const SceneBVH *bvh, const RetainedView &view, bool collectCasters) {
+    const auto visibility = camera->visibility;
+    const auto modelCount = bvh->getModelCount();
+    auto *workers = pipeline->getCullingWorkers();
+
+    modelVisible.resize(modelCount);
+    cullingRanges.resize(workers->getRangeCount(modelCount));
+    workers->dispatch(modelCount, [&](uint rangeIndex, uint begin, uint end) {
+        auto &range = cullingRanges[rangeIndex];
+        range.renderObjects.clear();
+        range.castBoundsInitialized = false;
+        for (uint i = begin; i < end; ++i) {
+            const auto model = bvh->getModel(i);
+            const bool visible = isModelVisible(model, visibility);
+            modelVisible[i] = visible;
+            if (!collectCasters || !visible || !model->castShadow || !model->getWorldBounds()) continue;
+
+            // shadow render Object
+            if (!range.castBoundsInitialized) {
+                range.castWorldBounds = *model->getWorldBounds();
+                range.castBoundsInitialized = true;
+            } else {
+                range.castWorldBounds.merge(*model->getWorldBounds());
+            }
+            const auto lodGroup = bvh->getLODGroup(i);
+            auto lodLevel = view.lodLevels[i];
+            range.renderObjects.emplace_back(genRenderObject(model, camera, lodGroup, pickLODLevel(model, lodGroup, camera, pipeline->getLODBias(), lodLevel)));
+        }
+    });
+
+    if (!collectCasters) return;
+
+    castBoundsInitialized = false;
+    RenderObjectList shadowObjects;
+    for (auto &range : cullingRanges) {
+        if (range.castBoundsInitialized) {
+            if (!castBoundsInitialized) {
+                castWorldBounds = range.castWorldBounds;
+                castBoundsInitialized = true;
+            } else {
+                castWorldBounds.merge(range.castWorldBounds);
+            }
+        }
+        shadowObjects.insert(shadowObjects.end(), range.renderObjects.begin(), range.renderObjects.end());
     }
 
     pipeline->getSphere()->define(castWorldBounds);
@@ -194,42 +452,147 @@ void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
     pipeline->setShadowObjects(std::move(shadowObjects));
 }
 
-void sceneCulling(ForwardPipeline *pipeline, Camera *camera) {
+void gatherPlanarShadowObjects(ForwardPipeline *pipeline, RetainedView &view) {
+    view.planarShadowObjects.clear();
     const auto shadows = pipeline->getShadows();
-    const auto skyBox = pipeline->getSkybox();
-    const auto scene = camera->getScene();
-
-    const Light *mainLight = nullptr;
-    if (scene->mainLightID) mainLight = scene->getMainLight();
-    RenderObjectList renderObjects;
+    if (!shadows->enabled || shadows->getShadowType() != ShadowType::PLANAR) return;
 
-    if (skyBox->enabled && skyBox->modelID && (camera->clearFlag & SKYBOX_FLAG)) {
-        renderObjects.emplace_back(genRenderObject(skyBox->getModel(), camera));
+    const auto skyboxOffset = view.skyboxModelID ? 1 : 0;
+    for (size_t i = skyboxOffset; i < view.renderObjects.size(); ++i) {
+        if (view.renderObjects[i].model->castShadow) view.planarShadowObjects.emplace_back(view.renderObjects[i]);
     }
+}
 
-    const auto models = scene->getModels();
-    const auto modelCount = models[0];
-    for (size_t i = 1; i <= modelCount; i++) {
-        const auto model = scene->getModelView(models[i]);
+void gatherLights(const Camera *camera, RetainedView &view) {
+    view.lights.clear();
+    const auto scene = camera->getScene();
+    Sphere sphere;
+    const auto sphereLightArrayID = scene->getSphereLightArrayID();
+    auto count = sphereLightArrayID ? sphereLightArrayID[0] : 0;
+    for (uint i = 1; i <= count; ++i) {
+        const auto light = scene->getSphereLight(sphereLightArrayID[i]);
+        sphere.setCenter(light->position);
+        sphere.setRadius(light->range);
+        if (sphere_frustum(&sphere, camera->getFrustum())) {
+            view.lights.emplace_back(light);
+        }
+    }
+    const auto spotLightArrayID = scene->getSpotLightArrayID();
+    count = spotLightArrayID ? spotLightArrayID[0] : 0;
+    for (uint i = 1; i <= count; ++i) {
+        const auto light = scene->getSpotLight(spotLightArrayID[i]);
+        sphere.setCenter(light->position);
+        sphere.setRadius(light->range);
+        if (sphere_frustum(&sphere, camera->getFrustum())) {
+            view.lights.emplace_back(light);
+        }
+    }
+}
 
-        // filter model by view visibility
-        if (model->enabled) {
-            const auto visibility = camera->visibility;
-            const auto node = model->getNode();
-            if ((model->nodeID && ((visibility & node->layer) == node->layer)) ||
-                (visibility & model->visFlags)) {
+bool isLitBy(const ModelView *model, const Light *light) {
+    if (!model->worldBoundsID) return true;
+    const auto bounds = model->getWorldBounds();
+    switch (light->getType()) {
+        case LightType::SPHERE: return aabb_aabb(bounds, light->getAABB());
+        case LightType::SPOT: return aabb_aabb(bounds, light->getAABB()) && aabb_frustum(bounds, light->getFrustum());
+        default: return false;
+    }
+}
 
-                // frustum culling
-                if ((model->worldBoundsID) && !aabb_frustum(model->getWorldBounds(), camera->getFrustum())) {
-                    continue;
-                }
+// Sets the light bits of the render objects, every worker owns the lights of one mask word.
+void updateLightMasks(ForwardPipeline *pipeline, const SceneBVH *bvh, RetainedView &view) {
+    const auto lightCount = static_cast<uint>(view.lights.size());
+    const auto skyboxOffset = view.skyboxModelID ? 1u : 0u;
+    view.lightMaskWords = (lightCount + 31) / 32;
+    view.lightMasks.assign(view.renderObjects.size() * view.lightMaskWords, 0);
+    if (!lightCount) return;
+
+    modelSlots.assign(bvh->getModelCount(), SceneBVH::INVALID_INDEX);
+    for (uint i = 0; i < view.modelIndices.size(); ++i) {
+        modelSlots[view.modelIndices[i]] = skyboxOffset + i;
+    }
 
-                renderObjects.emplace_back(genRenderObject(model, camera));
+    pipeline->getCullingWorkers()->dispatchEach(view.lightMaskWords, [&](uint word) {
+        vector<uint> indices;
+        const auto end = std::min(lightCount, (word + 1) * 32);
+        for (uint i = word * 32; i < end; ++i) {
+            const auto light = view.lights[i];
+            const auto bit = 1u << (i % 32);
+            switch (light->getType()) {
+                case LightType::SPHERE:
+                    bvh->queryAABB(light->getAABB(), indices);
+                    break;
+                case LightType::SPOT:
+                    bvh->queryFrustum(light->getFrustum(), indices);
+                    break;
+                default: continue;
+            }
+            for (const auto modelIndex : indices) {
+                const auto slot = modelSlots[modelIndex];
+                if (slot == SceneBVH::INVALID_INDEX) continue;
+                const auto model = bvh->getModel(modelIndex);
+                if (light->getType() == LightType::SPOT && model->worldBoundsID && !aabb_aabb(model->getWorldBounds(), light->getAABB())) continue;
+                view.lightMasks[slot * view.lightMaskWords + word] |= bit;
+            }
+            // models outside of the scene tree, e.g. the skybox
+            if (skyboxOffset && isLitBy(view.renderObjects[0].model, light)) {
+                view.lightMasks[word] |= bit;
             }
         }
+    });
+}
+} // namespace
+
+void sceneCulling(ForwardPipeline *pipeline, Camera *camera) {
+    const auto skyBox = pipeline->getSkybox();
+    const auto shadows = pipeline->getShadows();
+    const auto bvh = pipeline->getSceneBVH(camera);
+    auto &view = pipeline->getRetainedView(camera);
+    const auto skyboxModelID = skyBox->enabled && (camera->clearFlag & SKYBOX_FLAG) ? skyBox->modelID : 0;
+
+    ++view.cullingSerial;
+    view.lastUsedFrame = pipeline->getFrameCount();
+    view.changedModels.clear();
+    view.changedObjects.clear();
+
+    // the changed indices only cover the last update, a view that missed one is rebuilt,
+    // patching only pays off while few models changed,
+    // and with occlusion culling any moved model may hide or reveal others
+    const auto &changedIndices = bvh->getChangedIndices();
+    const bool bvhChanged = view.bvh != bvh || view.bvhVersion != bvh->getVersion();
+    const bool rebuild = bvhChanged || view.bvhSerial + 1 != bvh->getUpdateSerial() ||
+                         view.skyboxModelID != skyboxModelID || isViewChanged(view, camera) ||
+                         view.occlusionCulling != pipeline->isOcclusionCulling() || view.lodBias != pipeline->getLODBias() ||
+                         (view.occlusionCulling && !changedIndices.empty()) ||
+                         changedIndices.size() > view.modelIndices.size() / 4 + 1;
+    const bool collectCasters = shadows->enabled && shadows->getShadowType() == ShadowType::SHADOWMAP;
+    if (bvhChanged || view.lodLevels.size() != bvh->getModelCount()) {
+        view.lodLevels.assign(bvh->getModelCount(), INVALID_LOD_LEVEL);
+    }
+    if (rebuild || collectCasters) {
+        sweepModels(pipeline, camera, bvh, view, collectCasters);
+    }
+    if (!collectCasters) {
+        pipeline->setShadowObjects(RenderObjectList());
     }
 
-    pipeline->setRenderObjects(std::move(renderObjects));
+    if (rebuild) {
+        view.skyboxModelID = skyboxModelID;
+        rebuildView(pipeline, camera, bvh, view);
+    } else {
+        patchView(pipeline, camera, bvh, view);
+    }
+    view.bvhSerial = bvh->getUpdateSerial();
+
+    gatherPlanarShadowObjects(pipeline, view);
+    gatherLights(camera, view);
+    if (!pipeline->isClusteredLighting()) {
+        updateLightMasks(pipeline, bvh, view);
+    }
+
+    countLODTriangles(view);
+
+    pipeline->setRenderObjects(view.renderObjects);
 }
 
 } // namespace pipeline
@@ -22,6 +22,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #pragma once
+#include "math/Mat4.h"
+#include "math/Vec3.h"
 #include "pipeline/Define.h"
 
 namespace cc {
@@ -34,15 +36,48 @@ struct RenderObject;
 struct Model;
 struct Camera;
 class ForwardPipeline;
+class SceneBVH;
 struct Sphere;
 struct Light;
 struct Sphere;
 struct Shadows;
+struct LODGroup;
 
-RenderObject genRenderObject(Model *, const Camera *);
+// Visible set of a camera kept across frames and patched with the model changes reported by SceneBVH,
+// along with the per frame results every stage of the camera reads instead of walking the scene again.
+struct RetainedView {
+    const SceneBVH *bvh = nullptr;
+    uint bvhVersion = 0;
+    uint bvhSerial = 0; // update serial of the tree the view was last culled against
+    uint lastUsedFrame = 0;
+    uint skyboxModelID = 0;
+    uint visibility = 0;
+    bool occlusionCulling = false;
+    float lodBias = 1.0f;
+    cc::Mat4 matViewProj;
+    cc::Vec3 position;
+    cc::Vec3 forward;
+    vector<uint> modelIndices;      // visible scene models in ascending order
+    RenderObjectList renderObjects; // the skybox if any, then one entry per modelIndices element
+    vector<uint8_t> lodLevels;      // per scene model, the level of detail picked last, kept to avoid popping
+
+    // result of the last culling pass
+    uint cullingSerial = 0;
+    bool rebuilt = true;
+    vector<const ModelView *> changedModels; // sorted by address, models whose entries were patched
+    RenderObjectList changedObjects;         // patched models that are still visible
+
+    // per frame results of the visibility pass
+    RenderObjectList planarShadowObjects; // visible shadow casters, empty unless planar shadows are on
+    vector<const Light *> lights;         // sphere and spot lights touching the frustum
+    uint lightMaskWords = 0;
+    vector<uint> lightMasks; // lightMaskWords per render object, bit i is set if lights[i] reaches it
+};
+
+RenderObject genRenderObject(const ModelView *, const Camera *, const LODGroup *lodGroup = nullptr, uint lodLevel = 0);
 
 void lightCollecting(Camera *, std::vector<const Light *>&);
-void shadowCollecting(ForwardPipeline *, Camera *);
+// Walks the scene models of the camera once and fills its RetainedView, the shadow casters and the shadow bounds.
 void sceneCulling(ForwardPipeline *, Camera *);
 void updateSphereLight(Shadows *shadows, const Light *light, std::array<float, UBOShadow::COUNT> &);
 void updateDirLight(Shadows *shadows, const Light *light, std::array<float, UBOShadow::COUNT>&);
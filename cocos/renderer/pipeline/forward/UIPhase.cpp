@@ -34,10 +34,8 @@ void UIPhase::activate(RenderPipeline *pipeline){
     _phaseID = getPhaseID("default");
 };
 
-void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass){
-    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    auto cmdBuff = pipeline->getCommandBuffers()[0];
-
+void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff){
+    cmdBuff->beginProfileScope("UIPhase");
     auto batches = camera->getScene()->getUIBatches();
     const int batchCount = batches[0];
     // Notice: The batches[0] is batchCount
@@ -64,6 +62,7 @@ void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass){
             cmdBuff->draw(inputAssembler);
         }
     }
+    cmdBuff->endProfileScope();
 }
 
 }
@@ -0,0 +1,245 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include <algorithm>
+#include <cstring>
+
+#include "LightClusters.h"
+#include "ParallelCulling.h"
+#include "SharedMemory.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// Exponential slicing needs a positive near plane, orthographic cameras may start at zero.
+constexpr float MIN_NEAR = 0.05f;
+
+bool intersectsCone(const Vec3 &apex, const Vec3 &direction, float cosAngle, float sinAngle, float range, const Vec4 &sphere) {
+    const Vec3 offset(sphere.x - apex.x, sphere.y - apex.y, sphere.z - apex.z);
+    const float axial = offset.dot(direction);
+    const float radial = std::sqrt(std::max(offset.lengthSquared() - axial * axial, 0.0f));
+    // distance from the sphere center to the cone surface, negative inside
+    const float distance = cosAngle * radial - sinAngle * axial;
+    return distance <= sphere.w && axial >= -sphere.w && axial <= range + sphere.w;
+}
+} // namespace
+
+constexpr uint LightClusters::SLICE_SIZE;
+constexpr uint LightClusters::CLUSTER_COUNT;
+constexpr uint LightClusters::MAX_LIGHTS;
+constexpr uint LightClusters::MAX_LIGHT_INDICES;
+constexpr uint LightClusters::TEXTURE_WIDTH;
+constexpr uint LightClusters::TEXTURE_HEIGHT;
+
+LightClusters::LightClusters() {
+    _texels.resize(TEXTURE_WIDTH * TEXTURE_HEIGHT * 4, 0.0f);
+    _clusterLights.resize(CLUSTER_COUNT);
+}
+
+void LightClusters::build(const Camera *camera, const vector<const Light *> &lights, float clipSpaceMinZ, float luminanceScale, CullingWorkers *workers) {
+    updateClusterBounds(camera, clipSpaceMinZ);
+
+    _lightCount = std::min(static_cast<uint>(lights.size()), MAX_LIGHTS);
+    _texels[0] = static_cast<float>(GRID_X);
+    _texels[1] = static_cast<float>(GRID_Y);
+    _texels[2] = static_cast<float>(GRID_Z);
+    _texels[3] = static_cast<float>(_lightCount);
+    _texels[4] = _near;
+    _texels[5] = _far;
+    _texels[6] = _sliceScale;
+    _texels[7] = _sliceBias;
+
+    _lightBounds.resize(_lightCount);
+    for (uint i = 0; i < _lightCount; ++i) {
+        packLight(i, lights[i], camera->matView, luminanceScale);
+    }
+
+    for (auto &list : _clusterLights) {
+        list.clear();
+    }
+    if (_lightCount) {
+        workers->dispatchEach(GRID_Z, [this](uint slice) { binSlice(slice); });
+    }
+
+    _indexCount = 0;
+    auto clusterTexel = _texels.data() + CLUSTERS_OFFSET * 4;
+    auto indices = _texels.data() + INDICES_OFFSET * 4;
+    for (const auto &list : _clusterLights) {
+        const auto count = std::min(static_cast<uint>(list.size()), MAX_LIGHT_INDICES - _indexCount);
+        clusterTexel[0] = static_cast<float>(_indexCount);
+        clusterTexel[1] = static_cast<float>(count);
+        clusterTexel += 4;
+        for (uint i = 0; i < count; ++i) {
+            indices[_indexCount++] = static_cast<float>(list[i]);
+        }
+    }
+    _usedRows = (INDICES_OFFSET + (_indexCount + 3) / 4 + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH;
+}
+
+void LightClusters::updateClusterBounds(const Camera *camera, float clipSpaceMinZ) {
+    if (_clusterBounds.size() && _clipSpaceMinZ == clipSpaceMinZ && !memcmp(_matProj.m, camera->matProj.m, sizeof(_matProj.m))) return;
+    _matProj = camera->matProj;
+    _clipSpaceMinZ = clipSpaceMinZ;
+
+    // tile corners on the near and far planes, lines between them work for both projections
+    static vector<Vec3> nearCorners;
+    static vector<Vec3> farCorners;
+    nearCorners.resize((GRID_X + 1) * (GRID_Y + 1));
+    farCorners.resize((GRID_X + 1) * (GRID_Y + 1));
+    for (uint y = 0; y <= GRID_Y; ++y) {
+        for (uint x = 0; x <= GRID_X; ++x) {
+            const float ndcX = static_cast<float>(x) / GRID_X * 2.0f - 1.0f;
+            const float ndcY = static_cast<float>(y) / GRID_Y * 2.0f - 1.0f;
+            const auto index = x + y * (GRID_X + 1);
+            nearCorners[index].transformMat4({ndcX, ndcY, clipSpaceMinZ}, camera->matProjInv);
+            farCorners[index].transformMat4({ndcX, ndcY, 1.0f}, camera->matProjInv);
+        }
+    }
+
+    Vec3 center;
+    center.transformMat4({0.0f, 0.0f, clipSpaceMinZ}, camera->matProjInv);
+    _near = std::max(-center.z, MIN_NEAR);
+    center.transformMat4({0.0f, 0.0f, 1.0f}, camera->matProjInv);
+    _far = std::max(-center.z, _near * 2.0f);
+    _sliceScale = GRID_Z / std::log(_far / _near);
+    _sliceBias = -std::log(_near) * _sliceScale;
+
+    _clusterBounds.clear();
+    _clusterSpheres.clear();
+    Vec3 points[8];
+    for (uint z = 0; z < GRID_Z; ++z) {
+        const float depths[2] = {
+            _near * std::pow(_far / _near, static_cast<float>(z) / GRID_Z),
+            _near * std::pow(_far / _near, static_cast<float>(z + 1) / GRID_Z),
+        };
+        for (uint y = 0; y < GRID_Y; ++y) {
+            for (uint x = 0; x < GRID_X; ++x) {
+                uint count = 0;
+                for (uint corner = 0; corner < 4; ++corner) {
+                    const auto index = x + (corner & 1) + (y + (corner >> 1)) * (GRID_X + 1);
+                    const auto &nearCorner = nearCorners[index];
+                    const auto &farCorner = farCorners[index];
+                    const float span = nearCorner.z - farCorner.z;
+                    for (const float depth : depths) {
+                        const float t = span > 0.0f ? (-depth - nearCorner.z) / -span : 0.0f;
+                        points[count++].set(nearCorner.x + (farCorner.x - nearCorner.x) * t,
+                                            nearCorner.y + (farCorner.y - nearCorner.y) * t,
+                                            -depth);
+                    }
+                }
+
+                Vec3 minPos = points[0];
+                Vec3 maxPos = points[0];
+                for (uint i = 1; i < 8; ++i) {
+                    minPos.set(std::min(minPos.x, points[i].x), std::min(minPos.y, points[i].y), std::min(minPos.z, points[i].z));
+                    maxPos.set(std::max(maxPos.x, points[i].x), std::max(maxPos.y, points[i].y), std::max(maxPos.z, points[i].z));
+                }
+                AABB box;
+                box.center.set((minPos.x + maxPos.x) * 0.5f, (minPos.y + maxPos.y) * 0.5f, (minPos.z + maxPos.z) * 0.5f);
+                box.halfExtents.set((maxPos.x - minPos.x) * 0.5f, (maxPos.y - minPos.y) * 0.5f, (maxPos.z - minPos.z) * 0.5f);
+                _clusterBounds.add(&box);
+                _clusterSpheres.emplace_back(box.center.x, box.center.y, box.center.z, box.halfExtents.length());
+            }
+        }
+    }
+}
+
+uint LightClusters::getSlice(float depth) const {
+    if (depth <= _near) return 0;
+    const auto slice = static_cast<int>(std::log(depth) * _sliceScale + _sliceBias);
+    return static_cast<uint>(std::min(std::max(slice, 0), static_cast<int>(GRID_Z) - 1));
+}
+
+void LightClusters::packLight(uint index, const Light *light, const Mat4 &matView, float luminanceScale) {
+    const bool spot = light->getType() == LightType::SPOT;
+    auto texel = _texels.data() + (LIGHTS_OFFSET + index * TEXELS_PER_LIGHT) * 4;
+
+    texel[0] = light->position.x;
+    texel[1] = light->position.y;
+    texel[2] = light->position.z;
+    texel[3] = spot ? 1.0f : 0.0f;
+
+    const auto &color = light->color;
+    if (light->useColorTemperature) {
+        const auto &tempRGB = light->colorTemperatureRGB;
+        texel[4] = color.x * tempRGB.x;
+        texel[5] = color.y * tempRGB.y;
+        texel[6] = color.z * tempRGB.z;
+    } else {
+        texel[4] = color.x;
+        texel[5] = color.y;
+        texel[6] = color.z;
+    }
+    texel[7] = light->luminance * luminanceScale;
+
+    texel[8] = light->size;
+    texel[9] = light->range;
+    texel[10] = spot ? light->spotAngle : 0.0f;
+    texel[11] = 0.0f;
+
+    texel[12] = spot ? light->direction.x : 0.0f;
+    texel[13] = spot ? light->direction.y : 0.0f;
+    texel[14] = spot ? light->direction.z : 0.0f;
+    texel[15] = 0.0f;
+
+    auto &bounds = _lightBounds[index];
+    matView.transformPoint(light->position, &bounds.center);
+    bounds.radius = light->range;
+    const float depth = -bounds.center.z;
+    if (depth + bounds.radius < _near || depth - bounds.radius > _far) {
+        // an empty slice range, the light never reaches the grid
+        bounds.firstSlice = 1;
+        bounds.lastSlice = 0;
+    } else {
+        bounds.firstSlice = getSlice(depth - bounds.radius);
+        bounds.lastSlice = getSlice(depth + bounds.radius);
+    }
+
+    // spotAngle holds the cosine of the half angle, cones of 180 degrees or wider are tested as spheres
+    bounds.spot = spot && light->spotAngle > 0.0f && light->spotAngle < 1.0f;
+    if (bounds.spot) {
+        matView.transformVector(light->direction, &bounds.direction);
+        bounds.direction.normalize();
+        bounds.cosAngle = light->spotAngle;
+        bounds.sinAngle = std::sqrt(1.0f - bounds.cosAngle * bounds.cosAngle);
+    }
+}
+
+void LightClusters::binSlice(uint slice) {
+    uint8_t hits[SLICE_SIZE];
+    const auto firstCluster = slice * SLICE_SIZE;
+    for (uint i = 0; i < _lightCount; ++i) {
+        const auto &bounds = _lightBounds[i];
+        if (slice < bounds.firstSlice || slice > bounds.lastSlice) continue;
+
+        _clusterBounds.intersect(bounds.center, bounds.radius, firstCluster / AABBBatch::BLOCK_SIZE, SLICE_SIZE / AABBBatch::BLOCK_SIZE, hits);
+        for (uint j = 0; j < SLICE_SIZE; ++j) {
+            if (!hits[j]) continue;
+            if (bounds.spot && !intersectsCone(bounds.center, bounds.direction, bounds.cosAngle, bounds.sinAngle, bounds.radius, _clusterSpheres[firstCluster + j])) continue;
+            _clusterLights[firstCluster + j].emplace_back(i);
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,111 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "ParallelCulling.h"
+#include "base/Macros.h"
+#include "math/Mat4.h"
+#include "math/Vec4.h"
+
+namespace cc {
+namespace pipeline {
+
+struct Camera;
+struct Light;
+class CullingWorkers;
+
+// Assigns sphere and spot lights to a grid of view space clusters so one forward pass can shade all of them.
+// The viewport is split into GRID_X x GRID_Y tiles in normalized device coordinates, and depth into GRID_Z
+// slices growing exponentially from the near to the far plane. The result is packed in RGBA32F texels,
+// TEXTURE_WIDTH per row, for shaders to read with texelFetch:
+//   texel 0:         GRID_X, GRID_Y, GRID_Z, light count
+//   texel 1:         near, far, slice scale, slice bias, slice = floor(log(depth) * scale + bias)
+//   LIGHTS_OFFSET:   four texels per light in the UBOForwardLight layout, world space
+//   CLUSTERS_OFFSET: one texel per cluster holding the first index and the light count,
+//                    cluster = x + (y + z * GRID_Y) * GRID_X with y growing upwards
+//   INDICES_OFFSET:  light indices, four per texel
+class CC_DLL LightClusters {
+public:
+    static constexpr uint GRID_X = 16;
+    static constexpr uint GRID_Y = 8;
+    static constexpr uint GRID_Z = 24;
+    static constexpr uint SLICE_SIZE = GRID_X * GRID_Y;
+    static constexpr uint CLUSTER_COUNT = SLICE_SIZE * GRID_Z;
+    static constexpr uint MAX_LIGHTS = 1024;         // extra lights are dropped
+    static constexpr uint MAX_LIGHT_INDICES = 65536; // clusters past the limit lose their lights
+    static constexpr uint TEXELS_PER_LIGHT = 4;
+    static constexpr uint LIGHTS_OFFSET = 4;
+    static constexpr uint CLUSTERS_OFFSET = LIGHTS_OFFSET + MAX_LIGHTS * TEXELS_PER_LIGHT;
+    static constexpr uint INDICES_OFFSET = CLUSTERS_OFFSET + CLUSTER_COUNT;
+    static constexpr uint TEXTURE_WIDTH = 1024;
+    static constexpr uint TEXTURE_HEIGHT = (INDICES_OFFSET + MAX_LIGHT_INDICES / 4 + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH;
+
+    LightClusters();
+
+    // luminanceScale converts light luminance to shader units, every slice of clusters is binned on its own worker
+    void build(const Camera *camera, const vector<const Light *> &lights, float clipSpaceMinZ, float luminanceScale, CullingWorkers *workers);
+
+    CC_INLINE const float *getTexels() const { return _texels.data(); }
+    // rows written by the last build, the rest of the texture may hold stale data
+    CC_INLINE uint getUsedRows() const { return _usedRows; }
+    CC_INLINE uint getLightCount() const { return _lightCount; }
+    CC_INLINE uint getIndexCount() const { return _indexCount; }
+
+private:
+    struct LightBounds {
+        Vec3 center; // view space
+        float radius = 0.0f;
+        Vec3 direction; // view space, spot lights only
+        float cosAngle = 0.0f;
+        float sinAngle = 0.0f;
+        bool spot = false;
+        uint firstSlice = 0;
+        uint lastSlice = 0;
+    };
+
+    // Rebuilds the view space cluster boxes when the projection changed.
+    void updateClusterBounds(const Camera *camera, float clipSpaceMinZ);
+    uint getSlice(float depth) const;
+    void packLight(uint index, const Light *light, const Mat4 &matView, float luminanceScale);
+    void binSlice(uint slice);
+
+    Mat4 _matProj;
+    float _clipSpaceMinZ = 0.0f;
+    float _near = 0.0f;
+    float _far = 0.0f;
+    float _sliceScale = 0.0f;
+    float _sliceBias = 0.0f;
+    AABBBatch _clusterBounds;
+    vector<Vec4> _clusterSpheres; // bounding spheres of the boxes for the cone tests
+    vector<LightBounds> _lightBounds;
+    vector<vector<uint>> _clusterLights;
+    vector<float> _texels;
+    uint _lightCount = 0;
+    uint _indexCount = 0;
+    uint _usedRows = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,199 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include <algorithm>
+#include <cfloat>
+
+#include "OcclusionBuffer.h"
+#include "ParallelCulling.h"
+#include "SharedMemory.h"
+#include "math/MathUtil.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// Clip space w below this counts as touching the camera plane.
+constexpr float MIN_CLIP_W = 1e-4f;
+
+float cross(const Vec2 &o, const Vec2 &a, const Vec2 &b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Andrew's monotone chain, hull needs room for 2 * count points while it is built.
+uint convexHull(Vec2 *points, uint count, Vec2 *hull) {
+    std::sort(points, points + count, [](const Vec2 &a, const Vec2 &b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    uint size = 0;
+    for (uint i = 0; i < count; ++i) {
+        while (size >= 2 && cross(hull[size - 2], hull[size - 1], points[i]) <= 0.0f) --size;
+        hull[size++] = points[i];
+    }
+    const uint lowerSize = size + 1;
+    for (int i = static_cast<int>(count) - 2; i >= 0; --i) {
+        while (size >= lowerSize && cross(hull[size - 2], hull[size - 1], points[i]) <= 0.0f) --size;
+        hull[size++] = points[i];
+    }
+    return size - 1; // the last point repeats the first one
+}
+} // namespace
+
+void OcclusionBuffer::build(const Mat4 &matViewProj, const vector<const AABB *> &occluders, CullingWorkers *workers) {
+    _matViewProj = matViewProj;
+    _depths.resize(WIDTH * HEIGHT);
+    _tileDepths.resize(TILE_COLUMNS * TILE_ROWS);
+
+    _occluders.clear();
+    Vec2 points[8];
+    Vec2 hull[16];
+    for (const auto *aabb : occluders) {
+        Occluder occluder;
+        float minDepth = 0.0f;
+        if (!project(aabb, points, minDepth, occluder.depth)) continue;
+
+        occluder.hullSize = convexHull(points, 8, hull);
+        if (occluder.hullSize < 3) continue;
+        std::copy(hull, hull + occluder.hullSize, occluder.hull);
+        float minY = occluder.hull[0].y;
+        float maxY = minY;
+        for (uint i = 1; i < occluder.hullSize; ++i) {
+            minY = std::min(minY, occluder.hull[i].y);
+            maxY = std::max(maxY, occluder.hull[i].y);
+        }
+        // rows whose pixel centers fall inside the hull
+        occluder.firstRow = static_cast<int>(std::ceil(std::max(minY, 0.0f) - 0.5f));
+        occluder.lastRow = static_cast<int>(std::floor(std::min(maxY, static_cast<float>(HEIGHT)) - 0.5f));
+        if (occluder.firstRow > occluder.lastRow) continue;
+        _occluders.emplace_back(occluder);
+    }
+
+    workers->dispatchEach(TILE_ROWS, [&](uint tileRow) {
+        const int firstRow = static_cast<int>(tileRow * TILE_SIZE);
+        const int lastRow = firstRow + static_cast<int>(TILE_SIZE) - 1;
+        std::fill(_depths.begin() + firstRow * WIDTH, _depths.begin() + (lastRow + 1) * WIDTH, FLT_MAX);
+        for (const auto &occluder : _occluders) {
+            if (occluder.lastRow < firstRow || occluder.firstRow > lastRow) continue;
+            rasterize(occluder, std::max(firstRow, occluder.firstRow), std::min(lastRow, occluder.lastRow));
+        }
+
+        for (uint column = 0; column < TILE_COLUMNS; ++column) {
+            const float *tile = _depths.data() + firstRow * WIDTH + column * TILE_SIZE;
+            float depth = MathUtil::getMaxDepth(tile, TILE_SIZE);
+            for (uint y = 1; y < TILE_SIZE; ++y) {
+                depth = std::max(depth, MathUtil::getMaxDepth(tile + y * WIDTH, TILE_SIZE));
+            }
+            _tileDepths[tileRow * TILE_COLUMNS + column] = depth;
+        }
+    });
+}
+
+bool OcclusionBuffer::isVisible(const AABB *aabb) const {
+    if (!aabb) return true;
+
+    Vec2 points[8];
+    float minDepth = 0.0f;
+    float maxDepth = 0.0f;
+    if (!project(aabb, points, minDepth, maxDepth)) return true;
+
+    Vec2 minPos = points[0];
+    Vec2 maxPos = points[0];
+    for (uint i = 1; i < 8; ++i) {
+        minPos.x = std::min(minPos.x, points[i].x);
+        minPos.y = std::min(minPos.y, points[i].y);
+        maxPos.x = std::max(maxPos.x, points[i].x);
+        maxPos.y = std::max(maxPos.y, points[i].y);
+    }
+    // every pixel the bounds touch
+    const int x0 = static_cast<int>(std::floor(std::max(minPos.x, 0.0f)));
+    const int y0 = static_cast<int>(std::floor(std::max(minPos.y, 0.0f)));
+    const int x1 = static_cast<int>(std::ceil(std::min(maxPos.x, static_cast<float>(WIDTH))));
+    const int y1 = static_cast<int>(std::ceil(std::min(maxPos.y, static_cast<float>(HEIGHT))));
+    // off screen, frustum culling has the final say
+    if (x0 >= x1 || y0 >= y1) return true;
+
+    for (int tileY = y0 / static_cast<int>(TILE_SIZE); tileY <= (y1 - 1) / static_cast<int>(TILE_SIZE); ++tileY) {
+        for (int tileX = x0 / static_cast<int>(TILE_SIZE); tileX <= (x1 - 1) / static_cast<int>(TILE_SIZE); ++tileX) {
+            // every pixel of the tile is nearer than the box
+            if (_tileDepths[tileY * TILE_COLUMNS + tileX] < minDepth) continue;
+
+            const int rowBegin = std::max(y0, tileY * static_cast<int>(TILE_SIZE));
+            const int rowEnd = std::min(y1, (tileY + 1) * static_cast<int>(TILE_SIZE));
+            const int columnBegin = std::max(x0, tileX * static_cast<int>(TILE_SIZE));
+            const int columnEnd = std::min(x1, (tileX + 1) * static_cast<int>(TILE_SIZE));
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                if (MathUtil::testDepthSpan(_depths.data() + y * WIDTH + columnBegin, columnEnd - columnBegin, minDepth)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool OcclusionBuffer::project(const AABB *aabb, Vec2 *points, float &minDepth, float &maxDepth) const {
+    const float *m = _matViewProj.m;
+    minDepth = FLT_MAX;
+    maxDepth = -FLT_MAX;
+    for (uint i = 0; i < 8; ++i) {
+        const float x = aabb->center.x + (i & 1 ? aabb->halfExtents.x : -aabb->halfExtents.x);
+        const float y = aabb->center.y + (i & 2 ? aabb->halfExtents.y : -aabb->halfExtents.y);
+        const float z = aabb->center.z + (i & 4 ? aabb->halfExtents.z : -aabb->halfExtents.z);
+        const float w = m[3] * x + m[7] * y + m[11] * z + m[15];
+        if (w < MIN_CLIP_W) return false;
+
+        const float invW = 1.0f / w;
+        const float depth = (m[2] * x + m[6] * y + m[10] * z + m[14]) * invW;
+        points[i].x = ((m[0] * x + m[4] * y + m[8] * z + m[12]) * invW * 0.5f + 0.5f) * WIDTH;
+        points[i].y = ((m[1] * x + m[5] * y + m[9] * z + m[13]) * invW * 0.5f + 0.5f) * HEIGHT;
+        minDepth = std::min(minDepth, depth);
+        maxDepth = std::max(maxDepth, depth);
+    }
+    return true;
+}
+
+void OcclusionBuffer::rasterize(const Occluder &occluder, int firstRow, int lastRow) {
+    for (int y = firstRow; y <= lastRow; ++y) {
+        // a convex hull crosses every row in one span
+        const float center = static_cast<float>(y) + 0.5f;
+        float left = FLT_MAX;
+        float right = -FLT_MAX;
+        for (uint i = 0; i < occluder.hullSize; ++i) {
+            const auto &a = occluder.hull[i];
+            const auto &b = occluder.hull[(i + 1) % occluder.hullSize];
+            if ((a.y <= center) == (b.y <= center)) continue;
+            const float x = a.x + (center - a.y) * (b.x - a.x) / (b.y - a.y);
+            left = std::min(left, x);
+            right = std::max(right, x);
+        }
+        if (left > right) continue;
+
+        const int begin = static_cast<int>(std::ceil(std::max(left, 0.0f) - 0.5f));
+        const int end = static_cast<int>(std::floor(std::min(right, static_cast<float>(WIDTH)) - 0.5f));
+        if (begin <= end) {
+            MathUtil::writeDepthSpan(_depths.data() + y * WIDTH + begin, end - begin + 1, occluder.depth);
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
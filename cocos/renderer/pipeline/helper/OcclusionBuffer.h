@@ -0,0 +1,74 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "base/Macros.h"
+#include "math/Mat4.h"
+#include "math/Vec2.h"
+
+namespace cc {
+namespace pipeline {
+
+struct AABB;
+class CullingWorkers;
+
+// Low resolution depth buffer rasterized on the CPU, used to reject models hidden behind large occluders.
+// Occluders are approximated by their world bounds drawn at their farthest depth, so they should be solid,
+// box-like models such as buildings. Depth is the normalized device depth, smaller values are nearer.
+// TILE_SIZE x TILE_SIZE tiles keep the farthest depth of their pixels, so most tests need one comparison per tile.
+class CC_DLL OcclusionBuffer {
+public:
+    static constexpr uint WIDTH = 256;
+    static constexpr uint HEIGHT = 128;
+    static constexpr uint TILE_SIZE = 8;
+    static constexpr uint TILE_COLUMNS = WIDTH / TILE_SIZE;
+    static constexpr uint TILE_ROWS = HEIGHT / TILE_SIZE;
+
+    // Clears the buffer and rasterizes the occluders, every worker fills its own rows of tiles.
+    void build(const Mat4 &matViewProj, const vector<const AABB *> &occluders, CullingWorkers *workers);
+    // Whether any part of the box may show, safe to call from several threads once build() returned.
+    bool isVisible(const AABB *aabb) const;
+
+private:
+    struct Occluder {
+        Vec2 hull[8]; // convex hull of the projected corners, in pixels
+        uint hullSize = 0;
+        float depth = 0.0f;
+        int firstRow = 0;
+        int lastRow = 0;
+    };
+
+    // Projects the corners into pixels, fails if the box reaches behind the near plane.
+    bool project(const AABB *aabb, Vec2 *points, float &minDepth, float &maxDepth) const;
+    void rasterize(const Occluder &occluder, int firstRow, int lastRow);
+
+    Mat4 _matViewProj;
+    vector<Occluder> _occluders;
+    vector<float> _depths;     // WIDTH x HEIGHT
+    vector<float> _tileDepths; // TILE_COLUMNS x TILE_ROWS
+};
+
+} // namespace pipeline
+} // namespace cc
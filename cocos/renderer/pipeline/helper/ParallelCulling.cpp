@@ -0,0 +1,204 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include <atomic>
+
+#include "ParallelCulling.h"
+#include "SharedMemory.h"
+#include "base/ThreadPool.h"
+#include "math/MathUtil.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// Six floats per entry: center xyz followed by half extents xyz.
+constexpr uint FLOATS_PER_BLOCK = AABBBatch::BLOCK_SIZE * 6;
+// Ranges smaller than this are not worth a hand-off to another thread.
+constexpr uint MIN_RANGE_SIZE = 256;
+constexpr uint MAX_WORKER_COUNT = 3;
+} // namespace
+
+constexpr uint AABBBatch::BLOCK_SIZE;
+
+void AABBBatch::packPlanes(const Frustum *frustum, float *planes) {
+    for (uint i = 0; i < PLANE_LENGTH; ++i) {
+        const auto &plane = frustum->planes[i];
+        planes[i * 4] = plane.normal.x;
+        planes[i * 4 + 1] = plane.normal.y;
+        planes[i * 4 + 2] = plane.normal.z;
+        planes[i * 4 + 3] = plane.distance;
+    }
+}
+
+void AABBBatch::clear() {
+    _blocks.clear();
+    _count = 0;
+}
+
+void AABBBatch::resize(uint count) {
+    _count = count;
+    _blocks.resize((count + BLOCK_SIZE - 1) / BLOCK_SIZE * FLOATS_PER_BLOCK, 0.0f);
+}
+
+float *AABBBatch::getSlot(uint index) {
+    return _blocks.data() + index / BLOCK_SIZE * FLOATS_PER_BLOCK + index % BLOCK_SIZE;
+}
+
+float *AABBBatch::nextSlot() {
+    if (!(_count % BLOCK_SIZE)) _blocks.resize(_blocks.size() + FLOATS_PER_BLOCK, 0.0f);
+    return getSlot(_count++);
+}
+
+void AABBBatch::add(const AABB *aabb) {
+    auto slot = nextSlot();
+    slot[0] = aabb->center.x;
+    slot[4] = aabb->center.y;
+    slot[8] = aabb->center.z;
+    slot[12] = aabb->halfExtents.x;
+    slot[16] = aabb->halfExtents.y;
+    slot[20] = aabb->halfExtents.z;
+}
+
+void AABBBatch::addUnbounded() {
+    // infinite extents keep the box on the positive side of every plane
+    const auto infinity = std::numeric_limits<float>::infinity();
+    auto slot = nextSlot();
+    slot[12] = infinity;
+    slot[16] = infinity;
+    slot[20] = infinity;
+}
+
+void AABBBatch::set(uint index, const AABB *aabb) {
+    auto slot = getSlot(index);
+    slot[0] = aabb->center.x;
+    slot[4] = aabb->center.y;
+    slot[8] = aabb->center.z;
+    slot[12] = aabb->halfExtents.x;
+    slot[16] = aabb->halfExtents.y;
+    slot[20] = aabb->halfExtents.z;
+}
+
+bool AABBBatch::intersects(uint index, const AABB *aabb) const {
+    const auto slot = _blocks.data() + index / BLOCK_SIZE * FLOATS_PER_BLOCK + index % BLOCK_SIZE;
+    return std::abs(slot[0] - aabb->center.x) <= slot[12] + aabb->halfExtents.x &&
+           std::abs(slot[4] - aabb->center.y) <= slot[16] + aabb->halfExtents.y &&
+           std::abs(slot[8] - aabb->center.z) <= slot[20] + aabb->halfExtents.z;
+}
+
+bool AABBBatch::equals(uint index, const AABB *aabb) const {
+    const auto slot = _blocks.data() + index / BLOCK_SIZE * FLOATS_PER_BLOCK + index % BLOCK_SIZE;
+    return slot[0] == aabb->center.x && slot[4] == aabb->center.y && slot[8] == aabb->center.z &&
+           slot[12] == aabb->halfExtents.x && slot[16] == aabb->halfExtents.y && slot[20] == aabb->halfExtents.z;
+}
+
+void AABBBatch::cull(const Frustum *frustum, vector<uint8_t> &visible) const {
+    float planes[PLANE_LENGTH * 4];
+    packPlanes(frustum, planes);
+
+    const auto blockCount = static_cast<uint>(_blocks.size() / FLOATS_PER_BLOCK);
+    visible.resize(blockCount * BLOCK_SIZE);
+    cull(planes, 0, blockCount, visible.data());
+}
+
+void AABBBatch::cull(const float *planes, uint firstBlock, uint blockCount, uint8_t *visible) const {
+    MathUtil::cullAABBs(planes, PLANE_LENGTH, _blocks.data() + firstBlock * FLOATS_PER_BLOCK, blockCount, visible);
+}
+
+void AABBBatch::intersect(const Vec3 &center, float radius, uint firstBlock, uint blockCount, uint8_t *hits) const {
+    const float sphere[4] = {center.x, center.y, center.z, radius};
+    MathUtil::intersectSphereAABBs(sphere, _blocks.data() + firstBlock * FLOATS_PER_BLOCK, blockCount, hits);
+}
+
+CullingWorkers::CullingWorkers() {
+    const auto concurrency = std::thread::hardware_concurrency();
+    _workerCount = concurrency > 1 ? std::min(concurrency - 1, MAX_WORKER_COUNT) : 0;
+    if (_workerCount) {
+        _threadPool = ThreadPool::newFixedThreadPool(_workerCount);
+    }
+}
+
+CullingWorkers::~CullingWorkers() {
+    CC_SAFE_DELETE(_threadPool);
+}
+
+uint CullingWorkers::getRangeCount(uint count) const {
+    const auto rangeCount = (count + MIN_RANGE_SIZE - 1) / MIN_RANGE_SIZE;
+    return std::max(1u, std::min(rangeCount, _workerCount + 1));
+}
+
+void CullingWorkers::dispatch(uint count, const RangeTask &task) {
+    const auto rangeCount = getRangeCount(count);
+    if (rangeCount == 1) {
+        task(0, 0, count);
+        return;
+    }
+
+    const auto rangeSize = (count + rangeCount - 1) / rangeCount;
+    _pendingRanges = rangeCount - 1;
+    for (uint i = 1; i < rangeCount; ++i) {
+        const auto begin = i * rangeSize;
+        const auto end = std::min(begin + rangeSize, count);
+        _threadPool->pushTask([this, &task, i, begin, end](int /*threadId*/) {
+            task(i, begin, end);
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pendingRanges == 0) _condition.notify_one();
+        });
+    }
+
+    task(0, 0, rangeSize);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return _pendingRanges == 0; });
+}
+
+void CullingWorkers::dispatchEach(uint count, const ItemTask &task) {
+    const auto threadCount = std::min(count, _workerCount + 1);
+    if (threadCount <= 1) {
+        for (uint i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    std::atomic<uint> next{0};
+    const auto drain = [&next, &task, count]() {
+        for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed)) {
+            task(i);
+        }
+    };
+
+    _pendingRanges = threadCount - 1;
+    for (uint i = 1; i < threadCount; ++i) {
+        _threadPool->pushTask([this, &drain](int /*threadId*/) {
+            drain();
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pendingRanges == 0) _condition.notify_one();
+        });
+    }
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return _pendingRanges == 0; });
+}
+
+} // namespace pipeline
+} // namespace cc
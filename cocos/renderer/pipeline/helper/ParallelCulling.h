@@ -0,0 +1,101 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "../../core/CoreStd.h"
+#include "base/Macros.h"
+#include "math/Vec3.h"
+
+namespace cc {
+class ThreadPool;
+namespace pipeline {
+
+struct AABB;
+struct Frustum;
+
+// World bounds snapshot packed in structure-of-arrays blocks of four for MathUtil::cullAABBs.
+class CC_DLL AABBBatch {
+public:
+    static constexpr uint BLOCK_SIZE = 4;
+
+    // Packs the frustum planes as {nx, ny, nz, d}, planes must hold PLANE_LENGTH * 4 floats.
+    static void packPlanes(const Frustum *frustum, float *planes);
+
+    void clear();
+    void resize(uint count);
+    void add(const AABB *aabb);
+    // Adds an entry that always passes the test, used for models without world bounds.
+    void addUnbounded();
+    void set(uint index, const AABB *aabb);
+    bool intersects(uint index, const AABB *aabb) const;
+    bool equals(uint index, const AABB *aabb) const;
+    // Tests every entry against the frustum, visible receives one byte per entry.
+    void cull(const Frustum *frustum, vector<uint8_t> &visible) const;
+    // Tests blockCount blocks starting at firstBlock against packed planes, visible receives BLOCK_SIZE bytes per block.
+    void cull(const float *planes, uint firstBlock, uint blockCount, uint8_t *visible) const;
+    // Tests blockCount blocks starting at firstBlock against a sphere, hits receives BLOCK_SIZE bytes per block.
+    void intersect(const Vec3 &center, float radius, uint firstBlock, uint blockCount, uint8_t *hits) const;
+
+    CC_INLINE uint size() const { return _count; }
+
+private:
+    float *nextSlot();
+    float *getSlot(uint index);
+
+    vector<float> _blocks;
+    uint _count = 0;
+};
+
+// Splits index ranges across a small fixed set of worker threads, the calling thread takes the first range.
+class CC_DLL CullingWorkers {
+public:
+    using RangeTask = std::function<void(uint rangeIndex, uint begin, uint end)>;
+    using ItemTask = std::function<void(uint index)>;
+
+    CullingWorkers();
+    ~CullingWorkers();
+
+    // Number of ranges dispatch() will split count items into.
+    uint getRangeCount(uint count) const;
+    // Runs task over [0, count) and blocks until every range has finished.
+    void dispatch(uint count, const RangeTask &task);
+    // Runs task once per index in [0, count), threads pull the next index as they finish, blocks until all are done.
+    void dispatchEach(uint count, const ItemTask &task);
+
+    CC_INLINE uint getWorkerCount() const { return _workerCount; }
+
+private:
+    ThreadPool *_threadPool = nullptr;
+    uint _workerCount = 0;
+    uint _pendingRanges = 0;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+};
+
+} // namespace pipeline
+} // namespace cc
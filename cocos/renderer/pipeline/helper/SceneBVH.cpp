@@ -0,0 +1,372 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "SceneBVH.h"
+#include "SharedMemory.h"
+#include "math/MathUtil.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr uint LEAF_SIZE = AABBBatch::BLOCK_SIZE;
+constexpr uint MAX_QUERY_DEPTH = 64;
+
+bool isModelMoved(const ModelView *model) {
+    return (model->nodeID && model->getNode()->flagsChanged) ||
+           (model->transformID && model->getTransform()->flagsChanged);
+}
+
+// Render state of one set of submodels.
+void combineSubModels(size_t &seed, const ModelView *model, const uint *subModelID) {
+    const auto subModelCount = subModelID ? subModelID[0] : 0;
+    for (uint m = 1; m <= subModelCount; ++m) {
+        const auto subModel = model->getSubModelView(subModelID[m]);
+        MathUtil::combineHash(seed, subModelID[m]);
+        MathUtil::combineHash(seed, subModel->priority);
+        MathUtil::combineHash(seed, subModel->descriptorSetID);
+        MathUtil::combineHash(seed, subModel->inputAssemblerID);
+        for (uint p = 0; p < subModel->passCount; ++p) {
+            MathUtil::combineHash(seed, subModel->passID[p]);
+            MathUtil::combineHash(seed, subModel->shaderID[p]);
+        }
+    }
+}
+
+// Everything culling and queue building read from a model besides its transform.
+size_t getModelSignature(const ModelView *model, const LODGroup *lodGroup) {
+    size_t seed = model->enabled;
+    MathUtil::combineHash(seed, model->visFlags);
+    MathUtil::combineHash(seed, model->castShadow);
+    MathUtil::combineHash(seed, model->receiveShadow);
+    MathUtil::combineHash(seed, model->nodeID ? model->getNode()->layer : 0);
+    MathUtil::combineHash(seed, model->subModelsID);
+    combineSubModels(seed, model, model->getSubModelID());
+    MathUtil::combineHash(seed, reinterpret_cast<size_t>(lodGroup));
+    if (lodGroup) {
+        for (uint level = 0; level < lodGroup->levelCount && level < LODGroup::MAX_LEVELS; ++level) {
+            MathUtil::combineHash(seed, std::hash<float>()(lodGroup->screenSizes[level]));
+            MathUtil::combineHash(seed, lodGroup->subModelsID[level]);
+            combineSubModels(seed, model, lodGroup->getSubModelID(level));
+        }
+    }
+    return seed;
+}
+} // namespace
+
+constexpr uint SceneBVH::INVALID_INDEX;
+
+void SceneBVH::update(const Scene *scene) {
+    ++_updateSerial;
+    _changedIndices.clear();
+    const auto models = scene->getModels();
+    if (isModelSetChanged(models)) {
+        rebuild(scene, models);
+        return;
+    }
+
+    // models reported by script, every model once if the change log was trimmed since the last update
+    const auto modelCount = getModelCount();
+    const uint *changes = nullptr;
+    uint changeCount = 0;
+    if (ModelChangeTable::getChanges(_changeSerial, changes, changeCount)) {
+        for (uint c = 0; c < changeCount; ++c) {
+            const auto index = getModelIndex(GET_MODEL(changes[c]));
+            if (index != INVALID_INDEX) _notified[index] = 1;
+        }
+    } else {
+        std::fill(_notified.begin(), _notified.end(), 1);
+    }
+    _changeSerial = ModelChangeTable::getSerial();
+
+    uint moved = 0;
+    for (uint i = 0; i < modelCount; ++i) {
+        const auto model = _models[i];
+        const bool notified = _notified[i];
+        const bool nodeMoved = isModelMoved(model);
+        if (!notified && !nodeMoved && !_animatedBounds[i]) continue;
+
+        bool changed = nodeMoved;
+        if (notified) {
+            _notified[i] = 0;
+            if (model->worldBoundsID != _worldBoundsIDs[i]) {
+                rebuild(scene, models);
+                return;
+            }
+            _lodGroups[i] = LODGroupTable::getModelLODGroup(_modelIDs[i]);
+            _animatedBounds[i] = ModelChangeTable::hasAnimatedBounds(_modelIDs[i]);
+        }
+        if (notified || nodeMoved) {
+            const auto signature = getModelSignature(model, _lodGroups[i]);
+            changed = changed || signature != _signatures[i];
+            _signatures[i] = signature;
+        }
+
+        // moved models take their new bounds as they are, only animated and reported ones are compared
+        const auto entry = _modelEntries[i];
+        const bool boundsChanged = entry != INVALID_INDEX &&
+                                   (nodeMoved || ((notified || _animatedBounds[i]) && !_bounds.equals(entry, model->getWorldBounds())));
+        if (boundsChanged || changed) _changedIndices.emplace_back(i);
+        if (!boundsChanged) continue;
+
+        _bounds.set(entry, model->getWorldBounds());
+        for (auto nodeIndex = _entryLeaves[entry];; nodeIndex = _nodes[nodeIndex].parent) {
+            auto &node = _nodes[nodeIndex];
+            if (node.dirty) break;
+            node.dirty = true;
+            if (!nodeIndex) break;
+        }
+        ++moved;
+    }
+    if (!moved) return;
+
+    // refitting loosens the tree, start over once as many leaves moved as there are models
+    _movedSinceBuild += moved;
+    if (_movedSinceBuild > modelCount) {
+        buildTree();
+        return;
+    }
+
+    // children are always stored after their parent
+    for (auto it = _nodes.rbegin(); it != _nodes.rend(); ++it) {
+        if (it->dirty) refitNode(*it);
+    }
+}
+
+bool SceneBVH::isModelSetChanged(const uint *models) const {
+    const auto count = models ? models[0] : 0;
+    if (count != _modelIDs.size()) return true;
+    return count && memcmp(models + 1, _modelIDs.data(), count * sizeof(uint)) != 0;
+}
+
+void SceneBVH::rebuild(const Scene *scene, const uint *models) {
+    const auto count = models ? models[0] : 0;
+    _modelIDs.assign(models ? models + 1 : nullptr, models ? models + 1 + count : nullptr);
+    _models.resize(count);
+    _worldBoundsIDs.resize(count);
+    _signatures.resize(count);
+    _lodGroups.resize(count);
+    _animatedBounds.resize(count);
+    _notified.assign(count, 0);
+    _modelIndices.clear();
+    _unboundedIndices.clear();
+    _changeSerial = ModelChangeTable::getSerial();
+    ++_version;
+
+    for (uint i = 0; i < count; ++i) {
+        const auto model = scene->getModelView(_modelIDs[i]);
+        _models[i] = model;
+        _worldBoundsIDs[i] = model->worldBoundsID;
+        _lodGroups[i] = LODGroupTable::getModelLODGroup(_modelIDs[i]);
+        _animatedBounds[i] = ModelChangeTable::hasAnimatedBounds(_modelIDs[i]);
+        _signatures[i] = getModelSignature(model, _lodGroups[i]);
+        _modelIndices[model] = i;
+        if (!model->worldBoundsID) _unboundedIndices.emplace_back(i);
+    }
+
+    buildTree();
+}
+
+void SceneBVH::buildTree() {
+    const auto count = getModelCount();
+    _centers.resize(count);
+    _modelEntries.assign(count, INVALID_INDEX);
+    _entries.clear();
+    _nodes.clear();
+    _movedSinceBuild = 0;
+
+    for (uint i = 0; i < count; ++i) {
+        if (!_worldBoundsIDs[i]) continue;
+        _centers[i] = _models[i]->getWorldBounds()->center;
+        _entries.emplace_back(i);
+    }
+
+    const auto entryCount = static_cast<uint>(_entries.size());
+    _entryLeaves.resize(entryCount);
+    _bounds.resize(entryCount);
+    if (!entryCount) return;
+
+    buildNode(0, 0, entryCount);
+    for (uint i = 0; i < entryCount; ++i) {
+        _modelEntries[_entries[i]] = i;
+        _bounds.set(i, _models[_entries[i]]->getWorldBounds());
+    }
+    for (auto it = _nodes.rbegin(); it != _nodes.rend(); ++it) {
+        refitNode(*it);
+    }
+}
+
+uint SceneBVH::buildNode(uint parent, uint first, uint count) {
+    const auto index = static_cast<uint>(_nodes.size());
+    _nodes.emplace_back();
+    _nodes[index].parent = parent;
+    _nodes[index].first = first;
+    _nodes[index].count = count;
+
+    if (count <= LEAF_SIZE) {
+        for (uint i = first; i < first + count; ++i) {
+            _entryLeaves[i] = index;
+        }
+        return index;
+    }
+
+    // split at the median along the longest axis of the centers
+    Vec3 minPos = _centers[_entries[first]];
+    Vec3 maxPos = minPos;
+    for (uint i = first + 1; i < first + count; ++i) {
+        const auto &center = _centers[_entries[i]];
+        minPos.set(std::min(minPos.x, center.x), std::min(minPos.y, center.y), std::min(minPos.z, center.z));
+        maxPos.set(std::max(maxPos.x, center.x), std::max(maxPos.y, center.y), std::max(maxPos.z, center.z));
+    }
+    const auto size = maxPos - minPos;
+    const uint axis = size.x >= size.y ? (size.x >= size.z ? 0 : 2) : (size.y >= size.z ? 1 : 2);
+
+    // the left half is kept a multiple of LEAF_SIZE so every leaf maps onto a single block of _bounds
+    const auto half = (count / 2 + LEAF_SIZE - 1) / LEAF_SIZE * LEAF_SIZE;
+    const auto begin = _entries.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [this, axis](uint lhs, uint rhs) {
+        const auto &a = _centers[lhs];
+        const auto &b = _centers[rhs];
+        return axis == 0 ? a.x < b.x : (axis == 1 ? a.y < b.y : a.z < b.z);
+    });
+
+    const auto left = buildNode(index, first, half);
+    const auto right = buildNode(index, first + half, count - half);
+    _nodes[index].left = left;
+    _nodes[index].right = right;
+    return index;
+}
+
+void SceneBVH::refitNode(BVHNode &node) {
+    node.dirty = false;
+    if (node.left) {
+        const auto &left = _nodes[node.left];
+        const auto &right = _nodes[node.right];
+        node.minPos.set(std::min(left.minPos.x, right.minPos.x), std::min(left.minPos.y, right.minPos.y), std::min(left.minPos.z, right.minPos.z));
+        node.maxPos.set(std::max(left.maxPos.x, right.maxPos.x), std::max(left.maxPos.y, right.maxPos.y), std::max(left.maxPos.z, right.maxPos.z));
+        return;
+    }
+
+    Vec3 minPos, maxPos;
+    _models[_entries[node.first]]->getWorldBounds()->getBoundary(node.minPos, node.maxPos);
+    for (uint i = node.first + 1; i < node.first + node.count; ++i) {
+        _models[_entries[i]]->getWorldBounds()->getBoundary(minPos, maxPos);
+        node.minPos.set(std::min(node.minPos.x, minPos.x), std::min(node.minPos.y, minPos.y), std::min(node.minPos.z, minPos.z));
+        node.maxPos.set(std::max(node.maxPos.x, maxPos.x), std::max(node.maxPos.y, maxPos.y), std::max(node.maxPos.z, maxPos.z));
+    }
+}
+
+void SceneBVH::appendNode(const BVHNode &node, vector<uint> &indices) const {
+    const auto begin = _entries.begin() + node.first;
+    indices.insert(indices.end(), begin, begin + node.count);
+}
+
+void SceneBVH::queryFrustum(const Frustum *frustum, vector<uint> &indices) const {
+    indices.assign(_unboundedIndices.begin(), _unboundedIndices.end());
+    if (_nodes.empty()) return;
+
+    float planes[PLANE_LENGTH * 4];
+    AABBBatch::packPlanes(frustum, planes);
+    uint8_t visible[LEAF_SIZE];
+
+    // every stack entry carries the planes its node still straddles
+    std::pair<uint, uint> stack[MAX_QUERY_DEPTH];
+    uint top = 0;
+    stack[top++] = {0, (1u << PLANE_LENGTH) - 1};
+    while (top) {
+        const auto nodeIndex = stack[--top].first;
+        auto mask = stack[top].second;
+        const auto &node = _nodes[nodeIndex];
+        const auto center = (node.minPos + node.maxPos) * 0.5f;
+        const auto halfExtents = (node.maxPos - node.minPos) * 0.5f;
+
+        bool outside = false;
+        for (uint i = 0; i < PLANE_LENGTH; ++i) {
+            if (!(mask & (1u << i))) continue;
+            const auto &plane = frustum->planes[i];
+            const auto &normal = plane.normal;
+            const auto dot = normal.dot(center);
+            const auto radius = std::abs(normal.x) * halfExtents.x + std::abs(normal.y) * halfExtents.y + std::abs(normal.z) * halfExtents.z;
+            if (dot + radius < plane.distance) {
+                outside = true;
+                break;
+            }
+            if (dot - radius >= plane.distance) mask &= ~(1u << i);
+        }
+        if (outside) continue;
+
+        if (!mask) {
+            appendNode(node, indices);
+        } else if (!node.left) {
+            _bounds.cull(planes, node.first / LEAF_SIZE, 1, visible);
+            for (uint i = 0; i < node.count; ++i) {
+                if (visible[i]) indices.emplace_back(_entries[node.first + i]);
+            }
+        } else {
+            CCASSERT(top + 2 <= MAX_QUERY_DEPTH, "BVH is too deep");
+            stack[top++] = {node.right, mask};
+            stack[top++] = {node.left, mask};
+        }
+    }
+
+    std::sort(indices.begin(), indices.end());
+}
+
+void SceneBVH::queryAABB(const AABB *aabb, vector<uint> &indices) const {
+    indices.assign(_unboundedIndices.begin(), _unboundedIndices.end());
+    if (_nodes.empty()) return;
+
+    Vec3 minPos, maxPos;
+    aabb->getBoundary(minPos, maxPos);
+
+    uint stack[MAX_QUERY_DEPTH];
+    uint top = 0;
+    stack[top++] = 0;
+    while (top) {
+        const auto &node = _nodes[stack[--top]];
+        if (node.minPos.x > maxPos.x || node.maxPos.x < minPos.x ||
+            node.minPos.y > maxPos.y || node.maxPos.y < minPos.y ||
+            node.minPos.z > maxPos.z || node.maxPos.z < minPos.z) {
+            continue;
+        }
+
+        if (!node.left) {
+            for (uint i = node.first; i < node.first + node.count; ++i) {
+                if (_bounds.intersects(i, aabb)) indices.emplace_back(_entries[i]);
+            }
+        } else {
+            CCASSERT(top + 2 <= MAX_QUERY_DEPTH, "BVH is too deep");
+            stack[top++] = node.right;
+            stack[top++] = node.left;
+        }
+    }
+
+    std::sort(indices.begin(), indices.end());
+}
+
+uint SceneBVH::getModelIndex(const ModelView *model) const {
+    const auto iter = _modelIndices.find(model);
+    return iter != _modelIndices.end() ? iter->second : INVALID_INDEX;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,114 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "ParallelCulling.h"
+#include "base/Macros.h"
+#include "math/Vec3.h"
+
+namespace cc {
+namespace pipeline {
+
+struct AABB;
+struct Frustum;
+struct LODGroup;
+struct ModelView;
+struct Scene;
+
+// Bounding volume hierarchy over the world bounds of the models in a scene.
+// Queries return indices into the scene model array (0-based) in ascending order,
+// models without world bounds are part of every result.
+// The tree also tracks which models moved or changed their render state since the last update,
+// so that retained per-camera data can be patched instead of rebuilt.
+class CC_DLL SceneBVH {
+public:
+    static constexpr uint INVALID_INDEX = 0xFFFFFFFF;
+
+    // Rebuilds the tree if the model set changed, otherwise refits the leaves whose world bounds changed.
+    // Only models whose node or transform changed, models reported through ModelChangeTable and models with
+    // animated bounds are looked at, everything else is assumed unchanged.
+    void update(const Scene *scene);
+
+    void queryFrustum(const Frustum *frustum, vector<uint> &indices) const;
+    void queryAABB(const AABB *aabb, vector<uint> &indices) const;
+
+    uint getModelIndex(const ModelView *model) const;
+    CC_INLINE const ModelView *getModel(uint index) const { return _models[index]; }
+    CC_INLINE uint getModelCount() const { return static_cast<uint>(_models.size()); }
+    // nullptr if the model has a single level.
+    CC_INLINE const LODGroup *getLODGroup(uint index) const { return _lodGroups[index]; }
+    // Bumped on every rebuild, model indices of different versions are unrelated.
+    CC_INLINE uint getVersion() const { return _version; }
+    // Bumped on every update, the changed indices only describe the step from the previous serial.
+    CC_INLINE uint getUpdateSerial() const { return _updateSerial; }
+    // Models that moved or changed their render state during the last update, in ascending order.
+    CC_INLINE const vector<uint> &getChangedIndices() const { return _changedIndices; }
+
+private:
+    struct BVHNode {
+        Vec3 minPos;
+        Vec3 maxPos;
+        uint first = 0; // first entry in _entries
+        uint count = 0;
+        uint left = 0; // 0 for leaves
+        uint right = 0;
+        uint parent = 0;
+        bool dirty = false;
+    };
+
+    bool isModelSetChanged(const uint *models) const;
+    void rebuild(const Scene *scene, const uint *models);
+    void buildTree();
+    uint buildNode(uint parent, uint first, uint count);
+    void refitNode(BVHNode &node);
+    void appendNode(const BVHNode &node, vector<uint> &indices) const;
+
+    vector<uint> _modelIDs;
+    vector<const ModelView *> _models;
+    vector<uint> _worldBoundsIDs;
+    vector<size_t> _signatures;
+    vector<const LODGroup *> _lodGroups;
+    vector<uint8_t> _animatedBounds;
+    vector<uint8_t> _notified;
+    vector<uint> _changedIndices;
+    vector<uint> _modelEntries;
+    unordered_map<const ModelView *, uint> _modelIndices;
+    vector<Vec3> _centers;
+    vector<uint> _unboundedIndices;
+
+    // model indices of the bounded models in tree order, every leaf covers one block of _bounds
+    vector<uint> _entries;
+    vector<uint> _entryLeaves;
+    AABBBatch _bounds;
+    vector<BVHNode> _nodes;
+
+    uint _movedSinceBuild = 0;
+    uint _version = 0;
+    uint _updateSerial = 0;
+    uint _changeSerial = 0; // ModelChangeTable serial the notifications were read up to
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -48,6 +48,54 @@ const se::PoolType RenderWindow::type = se::PoolType::RENDER_WINDOW;
 const se::PoolType Shadows::type = se::PoolType::SHADOW;
 const se::PoolType Sphere::type = se::PoolType::SPHERE;
 const se::PoolType UIBatch::type = se::PoolType::UI_BATCH;
+const se::PoolType LODGroup::type = se::PoolType::LOD_GROUP;
+
+unordered_map<uint, uint> LODGroupTable::_lodGroupIDs;
+vector<uint> ModelChangeTable::_log;
+uint ModelChangeTable::_serial = 0;
+unordered_set<uint> ModelChangeTable::_animatedBounds;
+
+void LODGroupTable::setModelLODGroup(uint modelID, uint lodGroupID) {
+    if (lodGroupID) {
+        _lodGroupIDs[modelID] = lodGroupID;
+    } else {
+        _lodGroupIDs.erase(modelID);
+    }
+    ModelChangeTable::notifyChanged(modelID);
+}
+
+const LODGroup *LODGroupTable::getModelLODGroup(uint modelID) {
+    const auto iter = _lodGroupIDs.find(modelID);
+    // the pool may not be registered at all, the lookup returns nullptr then
+    return iter != _lodGroupIDs.end() ? GET_LOD_GROUP(iter->second) : nullptr;
+}
+
+void ModelChangeTable::notifyChanged(uint modelID) {
+    // readers that fall behind a trimmed log look at every model once
+    if (_log.size() >= MAX_LOG_SIZE) _log.clear();
+    _log.emplace_back(modelID);
+    ++_serial;
+}
+
+void ModelChangeTable::setAnimatedBounds(uint modelID, bool animated) {
+    if (animated) {
+        _animatedBounds.emplace(modelID);
+    } else {
+        _animatedBounds.erase(modelID);
+    }
+    notifyChanged(modelID);
+}
+
+bool ModelChangeTable::hasAnimatedBounds(uint modelID) {
+    return _animatedBounds.count(modelID) != 0;
+}
+
+bool ModelChangeTable::getChanges(uint serial, const uint *&changes, uint &count) {
+    count = _serial - serial;
+    if (count > _log.size()) return false;
+    changes = _log.data() + _log.size() - count;
+    return true;
+}
 
 void AABB::getBoundary(cc::Vec3 &minPos, cc::Vec3 &maxPos) const {
     minPos = center - halfExtents;
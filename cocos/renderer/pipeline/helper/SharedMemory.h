@@ -66,6 +66,7 @@ extern gfx::BlendState *getBlendStateImpl(uint index);
 #define GET_BLEND_TARGET(index)        SharedMemory::getBuffer<gfx::BlendTarget>(se::PoolType::BLEND_TARGET, index)
 #define GET_BLEND_STATE(index)         getBlendStateImpl(index)
 #define GET_UI_BATCH(index)              SharedMemory::getBuffer<UIBatch>(index)
+#define GET_LOD_GROUP(index)           SharedMemory::getBuffer<LODGroup>(index)
 
 //Get object pool data
 #define GET_DESCRIPTOR_SET(index)  SharedMemory::getObject<gfx::DescriptorSet, se::PoolType::DESCRIPTOR_SETS>(index)
@@ -89,41 +90,23 @@ extern gfx::BlendState *getBlendStateImpl(uint index);
 #define GET_RAW_BUFFER(index, size) SharedMemory::getRawBuffer<uint8_t>(se::PoolType::RAW_BUFFER, index, size)
 
 static const float SHADOW_CAMERA_MAX_FAR = 2000.0f;
-static const float COEFFICIENT_OF_EXPANSION = 2.0f * std::sqrtf(3.0f);
+static const float COEFFICIENT_OF_EXPANSION = 2.0f * std::sqrt(3.0f);
 
 class CC_DLL SharedMemory : public Object {
 public:
     template <typename T>
-    static T *getBuffer(uint index) {
-        const auto &bufferMap = se::BufferPool::getPoolMap();
-        if (bufferMap.count(T::type) != 0) {
-            const se::BufferPool *bufferPool = bufferMap.at(T::type);
-            return bufferPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+    CC_INLINE static T *getBuffer(uint index) {
+        return se::BufferPool::getTypedObject<T>(T::type, index);
     }
 
     template <typename T>
-    static T *getBuffer(se::PoolType poolType, uint index) {
-        const auto &bufferMap = se::BufferPool::getPoolMap();
-        if (bufferMap.count(poolType) != 0) {
-            const se::BufferPool *bufferPool = bufferMap.at(poolType);
-            return bufferPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+    CC_INLINE static T *getBuffer(se::PoolType poolType, uint index) {
+        return se::BufferPool::getTypedObject<T>(poolType, index);
     }
 
     template <typename T, se::PoolType p>
-    static T *getObject(uint index) {
-        const auto &poolMap = se::ObjectPool::getPoolMap();
-        if (poolMap.count(p) != 0) {
-            const se::ObjectPool *objectPool = poolMap.at(p);
-            return objectPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+    CC_INLINE static T *getObject(uint index) {
+        return se::ObjectPool::getTypedObject<T>(p, index);
     }
 
     static uint32_t *getHandleArray(se::PoolType type, uint index) {
@@ -288,6 +271,53 @@ struct CC_DLL SubModelView {
     const static se::PoolType type;
 };
 
+// Levels of detail of a model, level 0 is the most detailed one.
+// A level is picked while the bounding sphere of the model covers at least screenSizes[level] of the viewport height,
+// smaller models keep the last level.
+struct CC_DLL LODGroup {
+    static constexpr uint MAX_LEVELS = 4;
+
+    uint32_t levelCount = 0;
+    float screenSizes[MAX_LEVELS] = {0, 0, 0, 0}; // descending
+    uint32_t subModelsID[MAX_LEVELS] = {0, 0, 0, 0}; // array pool id per level
+
+    CC_INLINE const uint *getSubModelID(uint level) const { return GET_SUBMODEL_ARRAY(subModelsID[level]); }
+    const static se::PoolType type;
+};
+
+// LOD groups attached to models by model handle, kept natively until the model layout shared with the scripts carries them.
+class CC_DLL LODGroupTable {
+public:
+    // 0 detaches the group of the model.
+    static void setModelLODGroup(uint modelID, uint lodGroupID);
+    // nullptr if the model has a single level.
+    static const LODGroup *getModelLODGroup(uint modelID);
+
+private:
+    static unordered_map<uint, uint> _lodGroupIDs;
+};
+
+// Model changes the node and transform flags do not cover, reported by script by model handle.
+class CC_DLL ModelChangeTable {
+public:
+    // The render state of the model changed: enabled, visibility, shadows, submodels, passes or its LOD group.
+    static void notifyChanged(uint modelID);
+    // Skinned and otherwise animated models change their world bounds without touching their node.
+    static void setAnimatedBounds(uint modelID, bool animated);
+    static bool hasAnimatedBounds(uint modelID);
+    // Bumped on every notification.
+    CC_INLINE static uint getSerial() { return _serial; }
+    // Models notified since serial, repeats included, false if the log no longer reaches back that far.
+    static bool getChanges(uint serial, const uint *&changes, uint &count);
+
+private:
+    static constexpr uint MAX_LOG_SIZE = 1 << 16;
+
+    static vector<uint> _log; // the last _log.size() notifications
+    static uint _serial;
+    static unordered_set<uint> _animatedBounds;
+};
+
 struct CC_DLL ModelView {
     uint32_t enabled = 0;
     uint32_t visFlags = 0;
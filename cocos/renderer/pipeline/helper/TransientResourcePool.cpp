@@ -0,0 +1,176 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "TransientResourcePool.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXTexture.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+bool isSameTexture(const gfx::TextureInfo &lhs, const gfx::TextureInfo &rhs) {
+    return lhs.type == rhs.type && lhs.usage == rhs.usage && lhs.format == rhs.format &&
+           lhs.width == rhs.width && lhs.height == rhs.height && lhs.depth == rhs.depth &&
+           lhs.flags == rhs.flags && lhs.layerCount == rhs.layerCount && lhs.levelCount == rhs.levelCount &&
+           lhs.samples == rhs.samples;
+}
+
+bool usesTexture(const gfx::Framebuffer *framebuffer, const gfx::Texture *texture) {
+    const auto &colorTextures = framebuffer->getColorTextures();
+    return framebuffer->getDepthStencilTexture() == texture ||
+           std::find(colorTextures.begin(), colorTextures.end(), texture) != colorTextures.end();
+}
+} // namespace
+
+TransientResourcePool::TransientResourcePool(gfx::Device *device)
+: _device(device) {
+}
+
+TransientResourcePool::~TransientResourcePool() {
+    destroy();
+}
+
+void TransientResourcePool::destroy() {
+    for (auto *framebuffer : _framebuffers) {
+        framebuffer->destroy();
+        CC_DELETE(framebuffer);
+    }
+    _framebuffers.clear();
+
+    for (auto &pooled : _textures) {
+        pooled.texture->destroy();
+        CC_DELETE(pooled.texture);
+    }
+    _textures.clear();
+
+    _liveBytes = 0;
+    _framePeakBytes = 0;
+    _pooledBytes = 0;
+}
+
+void TransientResourcePool::beginFrame() {
+    ++_frame;
+    _framePeakBytes = _liveBytes;
+}
+
+void TransientResourcePool::endFrame() {
+    _peakBytes = _framePeakBytes;
+
+    for (size_t i = 0; i < _textures.size();) {
+        const auto &pooled = _textures[i];
+        if (!pooled.live && _frame - pooled.lastUsedFrame >= RETIRE_FRAMES) {
+            retire(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+gfx::Texture *TransientResourcePool::acquireTexture(const gfx::TextureInfo &info) {
+    PooledTexture *target = nullptr;
+    for (auto &pooled : _textures) {
+        if (!pooled.live && isSameTexture(pooled.info, info)) {
+            target = &pooled;
+            break;
+        }
+    }
+
+    if (!target) {
+        _textures.emplace_back();
+        target = &_textures.back();
+        target->info = info;
+        target->texture = _device->createTexture(info);
+        _pooledBytes += target->texture->getSize();
+    }
+
+    target->live = true;
+    target->lastUsedFrame = _frame;
+    _liveBytes += target->texture->getSize();
+    _framePeakBytes = std::max(_framePeakBytes, _liveBytes);
+    return target->texture;
+}
+
+void TransientResourcePool::releaseTexture(gfx::Texture *texture) {
+    for (auto &pooled : _textures) {
+        if (pooled.texture == texture && pooled.live) {
+            pooled.live = false;
+            pooled.lastUsedFrame = _frame;
+            _liveBytes -= texture->getSize();
+            return;
+        }
+    }
+}
+
+gfx::Framebuffer *TransientResourcePool::getFramebuffer(gfx::RenderPass *renderPass, const gfx::TextureList &colorTextures, gfx::Texture *depthStencilTexture) {
+    for (auto *framebuffer : _framebuffers) {
+        if (framebuffer->getRenderPass() == renderPass && framebuffer->getColorTextures() == colorTextures &&
+            framebuffer->getDepthStencilTexture() == depthStencilTexture) {
+            return framebuffer;
+        }
+    }
+
+    auto *framebuffer = _device->createFramebuffer({
+        renderPass,
+        colorTextures,
+        depthStencilTexture,
+        {}, //colorMipmapLevels
+    });
+    _framebuffers.emplace_back(framebuffer);
+    return framebuffer;
+}
+
+void TransientResourcePool::trim() {
+    for (size_t i = 0; i < _textures.size();) {
+        if (!_textures[i].live) {
+            retire(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void TransientResourcePool::retire(size_t index) {
+    auto *texture = _textures[index].texture;
+
+    for (size_t i = 0; i < _framebuffers.size();) {
+        if (usesTexture(_framebuffers[i], texture)) {
+            _framebuffers[i]->destroy();
+            CC_DELETE(_framebuffers[i]);
+            _framebuffers[i] = _framebuffers.back();
+            _framebuffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+
+    _pooledBytes -= texture->getSize();
+    texture->destroy();
+    CC_DELETE(texture);
+
+    _textures[index] = _textures.back();
+    _textures.pop_back();
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,88 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "gfx/GFXDef.h"
+
+namespace cc {
+namespace gfx {
+class Device;
+class Framebuffer;
+class RenderPass;
+class Texture;
+} // namespace gfx
+namespace pipeline {
+
+// Frame-scoped allocator for render targets.
+// A texture is live from acquireTexture() until releaseTexture(), after which the next acquisition
+// with the same description may alias it, in the same frame or a later one.
+// Targets that stay idle for RETIRE_FRAMES frames are destroyed together with their framebuffers.
+class CC_DLL TransientResourcePool : public Object {
+public:
+    static constexpr uint RETIRE_FRAMES = 60;
+
+    TransientResourcePool(gfx::Device *device);
+    ~TransientResourcePool();
+
+    void destroy();
+
+    void beginFrame();
+    void endFrame();
+
+    gfx::Texture *acquireTexture(const gfx::TextureInfo &info);
+    void releaseTexture(gfx::Texture *texture);
+    // cached per render pass and attachment set, owned by the pool
+    gfx::Framebuffer *getFramebuffer(gfx::RenderPass *renderPass, const gfx::TextureList &colorTextures, gfx::Texture *depthStencilTexture);
+    // destroys every idle target right away, e.g. after the requested sizes changed
+    void trim();
+
+    // largest amount of render target memory live at once during the last frame
+    CC_INLINE uint getPeakBytes() const { return _peakBytes; }
+    // everything the pool holds, live or idle
+    CC_INLINE uint getPooledBytes() const { return _pooledBytes; }
+
+private:
+    struct PooledTexture {
+        gfx::TextureInfo info;
+        gfx::Texture *texture = nullptr;
+        uint64_t lastUsedFrame = 0;
+        bool live = false;
+    };
+
+    void retire(size_t index);
+
+    gfx::Device *_device = nullptr;
+    vector<PooledTexture> _textures;
+    vector<gfx::Framebuffer *> _framebuffers;
+
+    uint64_t _frame = 0;
+    uint _liveBytes = 0;
+    uint _framePeakBytes = 0;
+    uint _peakBytes = 0;
+    uint _pooledBytes = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
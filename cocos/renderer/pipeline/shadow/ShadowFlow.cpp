@@ -24,18 +24,33 @@ THE SOFTWARE.
 #include "ShadowFlow.h"
 
 #include "../Define.h"
+#include "../PipelineStateManager.h"
 #include "../forward/ForwardPipeline.h"
 #include "../helper/SharedMemory.h"
+#include "../helper/TransientResourcePool.h"
 #include "ShadowStage.h"
 #include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXFramebuffer.h"
 #include "gfx/GFXRenderPass.h"
 #include "gfx/GFXTexture.h"
+#include "math/MathUtil.h"
 #include "../forward/SceneCulling.h"
 
 namespace cc {
 namespace pipeline {
+namespace {
+void combineHash(size_t &seed, float value) {
+    MathUtil::combineHash(seed, std::hash<float>()(value));
+}
+
+void combineHash(size_t &seed, const Vec3 &value) {
+    combineHash(seed, value.x);
+    combineHash(seed, value.y);
+    combineHash(seed, value.z);
+}
+} // namespace
+
 RenderFlowInfo ShadowFlow::_initInfo = {
     "ShadowFlow",
     static_cast<uint>(ForwardFlowPriority::SHADOW),
@@ -63,32 +78,67 @@ void ShadowFlow::activate(RenderPipeline *pipeline) {
 
 void ShadowFlow::render(Camera *camera) {
     auto *pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    const auto *shadowInfo = pipeline->getShadows();
+    auto *shadowInfo = pipeline->getShadows();
+    auto *transientPool = pipeline->getTransientPool();
+
+    const auto frame = pipeline->getTotalFrames();
+    const bool newFrame = frame != _frame;
+    _frame = frame;
+    if (!pipeline->isShadowMapCaching() || shadowInfo->shadowMapDirty) {
+        // every map is rendered again, so the next light or camera may alias it
+        releaseShadowMaps(transientPool, true);
+    } else if (newFrame) {
+        // lights and cameras that went away
+        releaseShadowMaps(transientPool, false);
+    }
+
     if (!shadowInfo->enabled || shadowInfo->getShadowType() != ShadowType::SHADOWMAP) return;
 
+    // shadow casters were collected by sceneCulling
     lightCollecting(camera, _validLights);
-    shadowCollecting(pipeline, camera);
 
-    if (pipeline->getShadowObjects().empty()) {
-        clearShadowMap(camera);
-        return;
+    if (shadowInfo->shadowMapDirty) {
+        // maps of the old size won't be asked for again
+        transientPool->trim();
     }
 
-    const auto &shadowFramebufferMap = pipeline->getShadowFramebufferMap();
+    // without casters the maps are still cleared, so the forward pass doesn't sample stale depth
+    const bool hasCasters = !pipeline->getShadowObjects().empty();
     for (const auto *light : _validLights) {
-        if (!shadowFramebufferMap.count(light)) {
-            initShadowFrameBuffer(pipeline, light);
+        auto &shadowMap = _shadowMaps[{camera, light}];
+        shadowMap.lastUsedFrame = _frame;
+
+        bool moved = true;
+        const auto signature = pipeline->isShadowMapCaching() ? getShadowMapSignature(pipeline, camera, light, moved) : 0;
+        if (!shadowMap.texture || moved || shadowMap.signature != signature) {
+            auto *shadowFrameBuffer = acquireShadowFrameBuffer(pipeline, shadowMap);
+            for (auto *_stage : _stages) {
+                auto *shadowStage = static_cast<ShadowStage *>(_stage);
+                shadowStage->setUseData(light, shadowFrameBuffer);
+                if (hasCasters) {
+                    shadowStage->render(camera);
+                } else {
+                    shadowStage->clearFramebuffer(camera);
+                }
+            }
+            // only the color map is read later on, the next light can render with the same depth buffer
+            transientPool->releaseTexture(shadowFrameBuffer->getDepthStencilTexture());
+            shadowMap.signature = signature;
+            pipeline->addRenderedShadowMap();
         }
+        pipeline->setShadowMap(light, shadowMap.texture);
+    }
 
-        auto *shadowFrameBuffer = shadowFramebufferMap.at(light);
-        if (shadowInfo->shadowMapDirty) {
-            resizeShadowMap(light, (uint)shadowInfo->size.x, (uint)shadowInfo->size.y);
-        }
-        for (auto *_stage : _stages) {
-            auto *shadowStage = static_cast<ShadowStage *>(_stage);
-            shadowStage->setUseData(light, shadowFrameBuffer);
-            shadowStage->render(camera);
+    if (!hasCasters) {
+        // the cleared map may be a different pooled texture than the one bound last time
+        const auto *scene = camera->getScene();
+        const auto &shadowMaps = pipeline->getShadowMaps();
+        const auto iter = scene->mainLightID ? shadowMaps.find(scene->getMainLight()) : shadowMaps.end();
+        if (iter != shadowMaps.end()) {
+            pipeline->getDescriptorSet()->bindTexture(SHADOWMAP::BINDING, iter->second);
+            pipeline->getDescriptorSet()->update();
         }
+        return;
     }
 
     // After the shadowMap rendering of all lights is completed,
@@ -96,92 +146,120 @@ void ShadowFlow::render(Camera *camera) {
     pipeline->updateShadowUBO(camera);
 }
 
-void ShadowFlow::clearShadowMap(Camera *camera) {
-    auto *pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    const auto &shadowFramebufferMap = pipeline->getShadowFramebufferMap();
-    for (const auto *light : _validLights) {
-        if (!shadowFramebufferMap.count(light)) {
-            continue;
-        }
-
-        auto *shadowFrameBuffer = shadowFramebufferMap.at(light);
-        for (auto *_stage : _stages) {
-            auto *shadowStage = static_cast<ShadowStage *>(_stage);
-            shadowStage->setUseData(light, shadowFrameBuffer);
-            shadowStage->clearFramebuffer(camera);
+void ShadowFlow::releaseShadowMaps(TransientResourcePool *transientPool, bool all) {
+    for (auto iter = _shadowMaps.begin(); iter != _shadowMaps.end();) {
+        if (all || iter->second.lastUsedFrame + 1 < _frame) {
+            if (iter->second.texture) transientPool->releaseTexture(iter->second.texture);
+            iter = _shadowMaps.erase(iter);
+        } else {
+            ++iter;
         }
     }
 }
 
-void ShadowFlow::resizeShadowMap(const Light *light, const uint width, const uint height) const {
-    auto *pipeline = static_cast<ForwardPipeline *>(_pipeline);
-
-    if (pipeline->getShadowFramebufferMap().count(light)) {
-        auto *framebuffer = pipeline->getShadowFramebufferMap().at(light);
-
-        if (!framebuffer) {
-            return;
-        }
+size_t ShadowFlow::getShadowMapSignature(const ForwardPipeline *pipeline, const Camera *camera, const Light *light, bool &moved) const {
+    const auto *shadowInfo = pipeline->getShadows();
+    size_t seed = 0;
+    combineHash(seed, shadowInfo->size.x);
+    combineHash(seed, shadowInfo->size.y);
+    combineHash(seed, shadowInfo->nearValue);
+    combineHash(seed, shadowInfo->farValue);
+    combineHash(seed, shadowInfo->orthoSize);
+    combineHash(seed, shadowInfo->aspect);
+    combineHash(seed, shadowInfo->bias);
+    MathUtil::combineHash(seed, shadowInfo->pcfType);
+    MathUtil::combineHash(seed, shadowInfo->autoAdapt);
+
+    // the render area follows the camera viewport
+    combineHash(seed, camera->viewportX);
+    combineHash(seed, camera->viewportY);
+    combineHash(seed, camera->viewportWidth);
+    combineHash(seed, camera->viewportHeight);
+    combineHash(seed, pipeline->getShadingScale());
+
+    MathUtil::combineHash(seed, light->lightType);
+    combineHash(seed, light->position);
+    combineHash(seed, light->direction);
+    combineHash(seed, light->range);
+    combineHash(seed, light->spotAngle);
+    combineHash(seed, light->aspect);
+    moved = light->nodeID && light->getNode()->flagsChanged;
+
+    const auto lightType = light->getType();
+    if (lightType == LightType::DIRECTIONAL && shadowInfo->autoAdapt) {
+        // the light camera is fitted around the casters the camera sees
+        const auto *sphere = pipeline->getSphere();
+        combineHash(seed, sphere->center);
+        combineHash(seed, sphere->radius);
+    }
 
-        auto &renderTargets = framebuffer->getColorTextures();
-        for (auto *renderTarget : renderTargets) {
-            renderTarget->resize(width, height);
+    // same caster selection as ShadowMapBatchedQueue::gatherLightPasses
+    for (const auto &ro : pipeline->getShadowObjects()) {
+        const auto *model = ro.model;
+        const auto *worldBounds = model->getWorldBounds();
+        if (lightType == LightType::SPOT &&
+            (!worldBounds || (!aabb_aabb(worldBounds, light->getAABB()) && !aabb_frustum(worldBounds, light->getFrustum())))) {
+            continue;
         }
 
-        auto *depth = framebuffer->getDepthStencilTexture();
-        if (depth) {
-            depth->resize(width, height);
+        MathUtil::combineHash(seed, reinterpret_cast<size_t>(model));
+        if (worldBounds) {
+            // catches animated casters whose node stays in place
+            combineHash(seed, worldBounds->center);
+            combineHash(seed, worldBounds->halfExtents);
         }
-
-        framebuffer->destroy();
-        framebuffer->initialize({
-            _renderPass,
-            renderTargets,
-            depth,
-            {},
-        });
+        moved = moved ||
+                (model->nodeID && model->getNode()->flagsChanged) ||
+                (model->transformID && model->getTransform()->flagsChanged);
     }
+    return seed;
+}
+
+void ShadowFlow::initRenderPass() {
+    auto device = gfx::Device::getInstance();
+    _renderPass = device->createRenderPass({
+        {{
+            gfx::Format::RGBA8,
+            1,
+            gfx::LoadOp::CLEAR, // should clear color attachment
+            gfx::StoreOp::STORE,
+            gfx::TextureLayout::UNDEFINED,
+            gfx::TextureLayout::PRESENT_SRC,
+        }},
+        {
+            device->getDepthStencilFormat(),
+            1,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::DISCARD,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::DISCARD,
+            gfx::TextureLayout::UNDEFINED,
+            gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        },
+    });
+    PipelineStateManager::addWarmupRenderPass(_renderPass);
 }
 
-void ShadowFlow::initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *light) {
+gfx::Framebuffer *ShadowFlow::acquireShadowFrameBuffer(ForwardPipeline *pipeline, CachedShadowMap &shadowMap) {
     auto device = gfx::Device::getInstance();
-    const auto shadowMapSize = static_cast<ForwardPipeline *>(this->_pipeline)->getShadows()->size;
+    const auto shadowMapSize = pipeline->getShadows()->size;
     const auto width = (uint)shadowMapSize.x;
     const auto height = (uint)shadowMapSize.y;
 
-    if (!_renderPass) {
-        _renderPass = device->createRenderPass({
-            {{
-                gfx::Format::RGBA8,
-                1,
-                gfx::LoadOp::CLEAR, // should clear color attachment
-                gfx::StoreOp::STORE,
-                gfx::TextureLayout::UNDEFINED,
-                gfx::TextureLayout::PRESENT_SRC,
-            }},
-            {
-                device->getDepthStencilFormat(),
-                1,
-                gfx::LoadOp::CLEAR,
-                gfx::StoreOp::DISCARD,
-                gfx::LoadOp::CLEAR,
-                gfx::StoreOp::DISCARD,
-                gfx::TextureLayout::UNDEFINED,
-                gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-            },
+    if (!_renderPass) initRenderPass();
+
+    auto *transientPool = pipeline->getTransientPool();
+    if (!shadowMap.texture) {
+        shadowMap.texture = transientPool->acquireTexture({
+            gfx::TextureType::TEX2D,
+            gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::SAMPLED,
+            gfx::Format::RGBA8,
+            width,
+            height,
         });
     }
 
-    vector<gfx::Texture *> renderTargets;
-    renderTargets.emplace_back(device->createTexture({
-        gfx::TextureType::TEX2D,
-        gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::SAMPLED,
-        gfx::Format::RGBA8,
-        width,
-        height,
-    }));
-
-    gfx::Texture *depth = device->createTexture({
+    gfx::Texture *depth = transientPool->acquireTexture({
         gfx::TextureType::TEX2D,
         gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT,
         device->getDepthStencilFormat(),
@@ -189,24 +267,19 @@ void ShadowFlow::initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *l
         height,
     });
 
-    gfx::Framebuffer *framebuffer = device->createFramebuffer({
-        _renderPass,
-        renderTargets,
-        depth,
-        {}, //colorMipmapLevels
-    });
-
-    pipeline->setShadowFramebuffer(light, framebuffer);
+    // the depth buffer is only borrowed for the pass, so the framebuffer is looked up again every time the map is rendered
+    return transientPool->getFramebuffer(_renderPass, {shadowMap.texture}, depth);
 }
 
 void ShadowFlow::destroy() {
-    static_cast<ForwardPipeline *>(_pipeline)->destroyShadowFrameBuffers();
-
     if (_renderPass) {
+        PipelineStateManager::removeWarmupRenderPass(_renderPass);
         _renderPass->destroy();
         _renderPass = nullptr;
     }
 
+    // the pool is destroyed before the flows and takes the cached maps with it
+    _shadowMaps.clear();
     _validLights.clear();
 
     RenderFlow::destroy();
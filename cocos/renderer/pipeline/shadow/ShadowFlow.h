@@ -26,6 +26,7 @@ THE SOFTWARE.
 namespace cc {
 namespace pipeline {
 class ForwardPipeline;
+class TransientResourcePool;
 struct Light;
 struct Camera;
 
@@ -45,11 +46,20 @@ public:
     virtual void destroy() override;
 
 private:
-    void clearShadowMap(Camera *camera);
+    // A map stays valid across frames as long as its light, its casters and the shadow settings don't change.
+    struct CachedShadowMap {
+        gfx::Texture *texture = nullptr;
+        size_t signature = 0;
+        uint lastUsedFrame = 0;
+    };
 
-    void resizeShadowMap(const Light *light, const uint width, const uint height) const;
+    void initRenderPass();
 
-    void initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *light);
+    gfx::Framebuffer *acquireShadowFrameBuffer(ForwardPipeline *pipeline, CachedShadowMap &shadowMap);
+    // hands the maps back to the transient pool, all of them or only the ones not used during the last frame
+    void releaseShadowMaps(TransientResourcePool *transientPool, bool all);
+    // hash of the state the map is rendered from, moved is set if the light or one of its casters changed its transform
+    size_t getShadowMapSignature(const ForwardPipeline *pipeline, const Camera *camera, const Light *light, bool &moved) const;
 
 private:
     static RenderFlowInfo _initInfo;
@@ -57,6 +67,8 @@ private:
     gfx::RenderPass *_renderPass = nullptr;
 
     vector<const Light *> _validLights;
+    map<std::pair<const Camera *, const Light *>, CachedShadowMap> _shadowMaps;
+    uint _frame = 0;
 };
 } // namespace pipeline
 } // namespace cc
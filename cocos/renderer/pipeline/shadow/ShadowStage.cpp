@@ -70,6 +70,7 @@ void ShadowStage::render(Camera *camera) {
     }
 
     auto cmdBuffer = pipeline->getCommandBuffers()[0];
+    cmdBuffer->beginProfileScope("ShadowStage");
 
     _additiveShadowQueue->gatherLightPasses(_light, cmdBuffer);
 
@@ -88,6 +89,7 @@ void ShadowStage::render(Camera *camera) {
     _additiveShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuffer);
 
     cmdBuffer->endRenderPass();
+    cmdBuffer->endProfileScope();
 }
 
 void ShadowStage::destroy() {	
@@ -0,0 +1,125 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "BenchmarkHarness.h"
+
+#include "bindings/auto/jsb_gfx_auto.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "bindings/manual/jsb_classtype.h"
+#include "renderer/gfx-empty/GFXEmpty.h"
+
+namespace cc {
+namespace benchmark {
+namespace {
+// Phases are bit flags handed out in order of first use, the same as the engine scripts do.
+const char *PHASE_SCRIPT =
+    "(function () {"
+    "    var phases = {};"
+    "    var phaseNum = 0;"
+    "    this.nr = {"
+    "        getPhaseID: function (phaseName) {"
+    "            if (typeof phaseName === 'number') { return phaseName; }"
+    "            if (!phases[phaseName]) { phases[phaseName] = 1 << phaseNum++; }"
+    "            return phases[phaseName];"
+    "        },"
+    "    };"
+    "})();";
+
+const char *findOption(int argc, char **argv, const char *name) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i][0] == '-' && argv[i][1] == '-' && !strcmp(argv[i] + 2, name)) return argv[i + 1];
+    }
+    return nullptr;
+}
+} // namespace
+
+uint getOption(int argc, char **argv, const char *name, uint fallback) {
+    const auto value = findOption(argc, argv, name);
+    return value ? static_cast<uint>(strtoul(value, nullptr, 10)) : fallback;
+}
+
+vector<uint> getOptionList(int argc, char **argv, const char *name, const vector<uint> &fallback) {
+    const auto value = findOption(argc, argv, name);
+    if (!value) return fallback;
+
+    vector<uint> values;
+    for (const char *begin = value; *begin;) {
+        char *end = nullptr;
+        values.emplace_back(static_cast<uint>(strtoul(begin, &end, 10)));
+        if (end == begin) break;
+        begin = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+bool hasOption(int argc, char **argv, const char *name) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-' && argv[i][1] == '-' && !strcmp(argv[i] + 2, name)) return true;
+    }
+    return false;
+}
+
+bool startScriptEngine() {
+    auto se = se::ScriptEngine::getInstance();
+    se->addBeforeInitHook([]() {
+        JSBClassType::init();
+    });
+    // object pools hand out the private data of gfx objects
+    se->addRegisterCallback(register_all_gfx);
+    if (!se->start()) {
+        CC_LOG_ERROR("Failed to start the script engine.");
+        return false;
+    }
+
+    se::AutoHandleScope hs;
+    return se->evalString(PHASE_SCRIPT);
+}
+
+void stopScriptEngine() {
+    se::ScriptEngine::destroyInstance();
+}
+
+gfx::Device *createDevice(uint width, uint height) {
+    gfx::DeviceInfo info;
+    info.width = width;
+    info.height = height;
+    info.nativeWidth = width;
+    info.nativeHeight = height;
+
+    auto device = CC_NEW(gfx::EmptyDevice);
+    if (!device->initialize(info)) {
+        CC_LOG_ERROR("Failed to initialize the empty device.");
+        CC_DELETE(device);
+        return nullptr;
+    }
+    return device;
+}
+
+void destroyDevice(gfx::Device *device) {
+    if (!device) return;
+    device->destroy();
+    CC_DELETE(device);
+}
+
+} // namespace benchmark
+} // namespace cc
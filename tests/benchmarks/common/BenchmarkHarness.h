@@ -0,0 +1,66 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <chrono>
+
+#include "renderer/core/CoreStd.h"
+
+namespace cc {
+namespace gfx {
+class Device;
+}
+
+namespace benchmark {
+
+// Average wall time of one call of func in milliseconds, after one untimed call to warm up caches.
+template <typename Func>
+double measure(uint iterations, Func &&func) {
+    func();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint i = 0; i < iterations; ++i) {
+        func();
+    }
+    const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+    return iterations ? time.count() / iterations : 0.0;
+}
+
+// Value of "--name <value>" on the command line, fallback if it is missing.
+uint getOption(int argc, char **argv, const char *name, uint fallback);
+// Values of "--name <a,b,c>" on the command line, fallback if it is missing.
+vector<uint> getOptionList(int argc, char **argv, const char *name, const vector<uint> &fallback);
+// Whether "--name" is on the command line.
+bool hasOption(int argc, char **argv, const char *name);
+
+// The pools and the phase IDs of the pipeline live in the script engine, so every benchmark starts one with the
+// gfx bindings and a minimal nr.getPhaseID, in place of the engine scripts.
+bool startScriptEngine();
+void stopScriptEngine();
+
+// The empty device becomes the device instance the pipeline picks up.
+gfx::Device *createDevice(uint width, uint height);
+void destroyDevice(gfx::Device *device);
+
+} // namespace benchmark
+} // namespace cc
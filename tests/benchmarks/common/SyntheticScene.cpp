@@ -0,0 +1,585 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "SyntheticScene.h"
+
+#include "base/StringUtil.h"
+#include "bindings/dop/BufferAllocator.h"
+#include "bindings/dop/BufferPool.h"
+#include "bindings/dop/ObjectPool.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "bindings/manual/jsb_conversions.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDescriptorSetLayout.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineLayout.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXShader.h"
+#include "renderer/pipeline/Define.h"
+
+namespace cc {
+namespace benchmark {
+using namespace pipeline;
+
+namespace {
+constexpr uint ENTRY_BITS = 10;
+// se::ObjectPool masks this flag out of its handles
+constexpr uint OBJECT_POOL_FLAG = 1 << 29;
+// a blend state entry holds the state up to the blend color, followed by the handle of its target array
+constexpr uint BLEND_STATE_BYTES = 24;
+constexpr uint INPUT_ASSEMBLER_COUNT = 32;
+constexpr float CAMERA_FOV = 45.0f;
+constexpr float CAMERA_NEAR = 0.1f;
+constexpr float CAMERA_FAR = 2000.0f;
+
+struct PoolDesc {
+    se::PoolType type;
+    uint bytesPerEntry;
+};
+
+const PoolDesc BUFFER_POOLS[] = {
+    {se::PoolType::PASS, sizeof(PassView)},
+    {se::PoolType::SUB_MODEL, sizeof(SubModelView)},
+    {se::PoolType::MODEL, sizeof(ModelView)},
+    {se::PoolType::SCENE, sizeof(Scene)},
+    {se::PoolType::CAMERA, sizeof(Camera)},
+    {se::PoolType::NODE, sizeof(Node)},
+    {se::PoolType::ROOT, sizeof(Root)},
+    {se::PoolType::AABB, sizeof(AABB)},
+    {se::PoolType::RENDER_WINDOW, sizeof(RenderWindow)},
+    {se::PoolType::FRUSTUM, sizeof(Frustum)},
+    {se::PoolType::AMBIENT, sizeof(Ambient)},
+    {se::PoolType::FOG, sizeof(Fog)},
+    {se::PoolType::SKYBOX, sizeof(Skybox)},
+    {se::PoolType::SHADOW, sizeof(Shadows)},
+    {se::PoolType::LIGHT, sizeof(Light)},
+    {se::PoolType::RASTERIZER_STATE, sizeof(gfx::RasterizerState)},
+    {se::PoolType::DEPTH_STENCIL_STATE, sizeof(gfx::DepthStencilState)},
+    {se::PoolType::BLEND_TARGET, sizeof(gfx::BlendTarget)},
+    {se::PoolType::BLEND_STATE, BLEND_STATE_BYTES + sizeof(uint32_t)},
+};
+
+const se::PoolType ARRAY_POOLS[] = {
+    se::PoolType::SUB_MODEL_ARRAY,
+    se::PoolType::MODEL_ARRAY,
+    se::PoolType::LIGHT_ARRAY,
+    se::PoolType::BLEND_TARGET_ARRAY,
+    se::PoolType::UI_BATCH_ARRAY,
+};
+
+const se::PoolType OBJECT_POOLS[] = {
+    se::PoolType::DESCRIPTOR_SETS,
+    se::PoolType::SHADER,
+    se::PoolType::INPUT_ASSEMBLER,
+    se::PoolType::PIPELINE_LAYOUT,
+    se::PoolType::FRAMEBUFFER,
+};
+
+void setPlane(Plane &plane, const Mat4 &m, int row, float sign) {
+    // row 3 of the matrix plus or minus another row, with the normal pointing inside
+    plane.normal.set(m.m[3] + sign * m.m[row], m.m[7] + sign * m.m[4 + row], m.m[11] + sign * m.m[8 + row]);
+    const float d = m.m[15] + sign * m.m[12 + row];
+    const float length = plane.normal.length();
+    plane.normal.scale(1.0f / length);
+    plane.distance = -d / length;
+}
+
+void updateProjection(Camera *camera, const Mat4 &matView, float aspect) {
+    camera->matView = matView;
+    Mat4::createPerspective(MATH_DEG_TO_RAD(CAMERA_FOV), aspect, CAMERA_NEAR, CAMERA_FAR, &camera->matProj);
+    camera->matProjInv = camera->matProj.getInversed();
+    Mat4::multiply(camera->matProj, matView, &camera->matViewProj);
+    camera->matViewProjInv = camera->matViewProj.getInversed();
+    updateFrustum(SharedMemory::getBuffer<Frustum>(camera->frustumID), camera->matViewProj);
+}
+} // namespace
+
+void updateFrustum(Frustum *frustum, const Mat4 &matViewProj) {
+    setPlane(frustum->planes[0], matViewProj, 0, 1.0f);  // left
+    setPlane(frustum->planes[1], matViewProj, 0, -1.0f); // right
+    setPlane(frustum->planes[2], matViewProj, 1, 1.0f);  // bottom
+    setPlane(frustum->planes[3], matViewProj, 1, -1.0f); // top
+    setPlane(frustum->planes[4], matViewProj, 2, 1.0f);  // near
+    setPlane(frustum->planes[5], matViewProj, 2, -1.0f); // far
+
+    // far corners first
+    static const float corners[8][3] = {
+        {1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f},
+        {1.0f, 1.0f, -1.0f}, {-1.0f, 1.0f, -1.0f}, {-1.0f, -1.0f, -1.0f}, {1.0f, -1.0f, -1.0f}};
+    const auto matViewProjInv = matViewProj.getInversed();
+    for (uint i = 0; i < 8; ++i) {
+        const auto corner = matViewProjInv * Vec4(corners[i][0], corners[i][1], corners[i][2], 1.0f);
+        frustum->vertices[i].set(corner.x / corner.w, corner.y / corner.w, corner.z / corner.w);
+    }
+}
+
+SyntheticScene::SyntheticScene(const SyntheticSceneInfo &info)
+: _info(info),
+  _random(info.seed) {
+    se::AutoHandleScope hs;
+    createPools();
+    createGFXObjects();
+    createMaterials();
+    createModels();
+    createLights();
+    createCamera();
+}
+
+SyntheticScene::~SyntheticScene() {
+    se::AutoHandleScope hs;
+
+    // the gfx objects are destroyed here, not by the finalizers of their script objects
+    for (auto wrapper : _wrappers) {
+        wrapper->clearPrivateData();
+        wrapper->decRef();
+    }
+    _wrappers.clear();
+    for (auto &pair : _objectPools) {
+        CC_DELETE(pair.second.pool);
+        pair.second.jsArray->unroot();
+        pair.second.jsArray->decRef();
+    }
+    _objectPools.clear();
+
+    for (auto descriptorSet : _descriptorSets) {
+        CC_DESTROY(descriptorSet);
+    }
+    for (auto ia : _inputAssemblers) {
+        CC_DESTROY(ia);
+    }
+    for (auto buffer : _buffers) {
+        CC_DESTROY(buffer);
+    }
+    for (auto shader : _shaders) {
+        CC_DESTROY(shader);
+    }
+    CC_SAFE_DESTROY(_pipelineLayout);
+    CC_SAFE_DESTROY(_materialSetLayout);
+    CC_SAFE_DESTROY(_localSetLayout);
+    CC_SAFE_DESTROY(_framebuffer);
+    CC_SAFE_DESTROY(_renderPass);
+
+    for (auto jsObject : _jsObjects) {
+        jsObject->unroot();
+    }
+    _jsObjects.clear();
+    for (auto &pair : _pools) {
+        CC_DELETE(pair.second.pool);
+    }
+    _pools.clear();
+    for (auto &pair : _allocators) {
+        CC_DELETE(pair.second);
+    }
+    _allocators.clear();
+}
+
+template <typename T>
+uint SyntheticScene::allocate(se::PoolType type, T *&entry) {
+    auto &entries = _pools[type];
+    const uint index = entries.entryCount++;
+    const uint chunk = index >> ENTRY_BITS;
+    const uint handle = (chunk << ENTRY_BITS) | (index & ((1 << ENTRY_BITS) - 1)) | se::BufferPool::getPoolFlag();
+    if (!(index & ((1 << ENTRY_BITS) - 1))) {
+        // ArrayBuffers are only kept alive by the script objects holding them
+        auto chunkObject = entries.pool->allocateNewChunk();
+        chunkObject->root();
+        _jsObjects.emplace_back(chunkObject);
+    }
+
+    entry = new (se::BufferPool::getTypedObject<T>(type, handle)) T();
+    return handle;
+}
+
+uint SyntheticScene::allocateArray(se::PoolType type, const vector<uint> &handles) {
+    // 0 stays an invalid handle
+    const uint index = ++_arrayCounts[type];
+    auto arrayObject = _allocators[type]->alloc(index, static_cast<uint>((handles.size() + 1) * sizeof(uint32_t)));
+    arrayObject->root();
+    _jsObjects.emplace_back(arrayObject);
+
+    const uint handle = index | se::BufferPool::getPoolFlag();
+    auto array = SharedMemory::getHandleArray(type, handle);
+    array[0] = static_cast<uint32_t>(handles.size());
+    std::copy(handles.begin(), handles.end(), array + 1);
+    return handle;
+}
+
+template <typename T>
+uint SyntheticScene::addObject(se::PoolType type, T *object) {
+    auto &entries = _objectPools[type];
+    se::Value value;
+    native_ptr_to_seval<T>(object, &value);
+    auto wrapper = value.toObject();
+    entries.pool->bind(entries.count, wrapper);
+    wrapper->incRef();
+    _wrappers.emplace_back(wrapper);
+    return entries.count++ | OBJECT_POOL_FLAG;
+}
+
+void SyntheticScene::createPools() {
+    for (const auto &desc : BUFFER_POOLS) {
+        _pools[desc.type].pool = CC_NEW(se::BufferPool(desc.type, ENTRY_BITS, desc.bytesPerEntry));
+    }
+    for (const auto type : ARRAY_POOLS) {
+        _allocators[type] = CC_NEW(se::BufferAllocator(type));
+    }
+    for (const auto type : OBJECT_POOLS) {
+        auto &entries = _objectPools[type];
+        entries.jsArray = se::Object::createArrayObject(0);
+        entries.jsArray->root();
+        entries.pool = CC_NEW(se::ObjectPool(type, entries.jsArray));
+    }
+
+    // the root is the first entry of its pool, see GET_ROOT
+    Root *root = nullptr;
+    allocate(root);
+    root->frameTime = 1.0f / 60.0f;
+}
+
+void SyntheticScene::createGFXObjects() {
+    auto device = gfx::Device::getInstance();
+
+    _materialSetLayout = device->createDescriptorSetLayout({});
+    _localSetLayout = device->createDescriptorSetLayout({localDescriptorSetLayout.bindings});
+    _pipelineLayout = device->createPipelineLayout({{_materialSetLayout, _materialSetLayout, _localSetLayout}});
+    _pipelineLayoutID = addObject(se::PoolType::PIPELINE_LAYOUT, _pipelineLayout);
+
+    const gfx::AttributeList attributes = {{"a_position", gfx::Format::RGB32F}};
+    const bool hasLights = _info.sphereLightCount || _info.spotLightCount;
+    for (uint i = 0; i < _info.shaderCount; ++i) {
+        for (const char *suffix : {"", "-add"}) {
+            if (*suffix && !hasLights) {
+                _shaderIDs.emplace_back(0);
+                continue;
+            }
+            gfx::ShaderInfo shaderInfo;
+            shaderInfo.name = StringUtil::Format("synthetic-%u%s", i, suffix);
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, ""}, {gfx::ShaderStageFlagBit::FRAGMENT, ""}};
+            shaderInfo.attributes = attributes;
+            // base passes shade the lights from the clusters when clustered lighting is on
+            if (!*suffix && hasLights) shaderInfo.samplers = {CLUSTER_LIGHTS::LAYOUT};
+            auto shader = device->createShader(shaderInfo);
+            _shaders.emplace_back(shader);
+            _shaderIDs.emplace_back(addObject(se::PoolType::SHADER, shader));
+        }
+    }
+
+    // boxes of 12 to 96 triangles
+    for (uint i = 0; i < INPUT_ASSEMBLER_COUNT; ++i) {
+        const uint indexCount = 36 * (1 + i % 8);
+        auto vertexBuffer = device->createBuffer({
+            gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+            gfx::MemoryUsageBit::DEVICE,
+            24 * 3 * sizeof(float),
+            3 * sizeof(float),
+        });
+        auto indexBuffer = device->createBuffer({
+            gfx::BufferUsageBit::INDEX | gfx::BufferUsageBit::TRANSFER_DST,
+            gfx::MemoryUsageBit::DEVICE,
+            static_cast<uint>(indexCount * sizeof(uint16_t)),
+            sizeof(uint16_t),
+        });
+        _buffers.emplace_back(vertexBuffer);
+        _buffers.emplace_back(indexBuffer);
+
+        auto ia = device->createInputAssembler({attributes, {vertexBuffer}, indexBuffer});
+        _inputAssemblers.emplace_back(ia);
+        _iaIDs.emplace_back(addObject(se::PoolType::INPUT_ASSEMBLER, ia));
+    }
+
+    gfx::ColorAttachment colorAttachment;
+    colorAttachment.format = device->getColorFormat();
+    gfx::DepthStencilAttachment depthStencilAttachment;
+    depthStencilAttachment.format = device->getDepthStencilFormat();
+    _renderPass = device->createRenderPass({{colorAttachment}, depthStencilAttachment});
+    // no color textures, the forward stage draws on screen with its own render passes then
+    _framebuffer = device->createFramebuffer({_renderPass});
+}
+
+SyntheticScene::PassStates SyntheticScene::createPassStates(bool depthWrite, bool blend, gfx::BlendFactor blendSrc, gfx::BlendFactor blendDst) {
+    PassStates states;
+    gfx::RasterizerState *rasterizerState = nullptr;
+    states.rasterizerStateID = allocate(se::PoolType::RASTERIZER_STATE, rasterizerState);
+
+    gfx::DepthStencilState *depthStencilState = nullptr;
+    states.depthStencilStateID = allocate(se::PoolType::DEPTH_STENCIL_STATE, depthStencilState);
+    depthStencilState->depthWrite = depthWrite;
+
+    gfx::BlendTarget *blendTarget = nullptr;
+    const auto blendTargetID = allocate(se::PoolType::BLEND_TARGET, blendTarget);
+    blendTarget->blend = blend;
+    blendTarget->blendSrc = blendSrc;
+    blendTarget->blendDst = blendDst;
+
+    uint32_t *blendState = nullptr;
+    states.blendStateID = allocate(se::PoolType::BLEND_STATE, blendState);
+    blendState[BLEND_STATE_BYTES / sizeof(uint32_t)] = allocateArray(se::PoolType::BLEND_TARGET_ARRAY, {blendTargetID});
+    return states;
+}
+
+void SyntheticScene::createMaterials() {
+    auto device = gfx::Device::getInstance();
+    _opaqueStates = createPassStates(true, false, gfx::BlendFactor::ONE, gfx::BlendFactor::ZERO);
+    _transparentStates = createPassStates(false, true, gfx::BlendFactor::SRC_ALPHA, gfx::BlendFactor::ONE_MINUS_SRC_ALPHA);
+    _additiveStates = createPassStates(false, true, gfx::BlendFactor::ONE, gfx::BlendFactor::ONE);
+
+    const bool hasLights = _info.sphereLightCount || _info.spotLightCount;
+    const uint phases[] = {getPhaseID("default"), getPhaseID("forward-add")};
+    for (uint i = 0; i < _info.materialCount; ++i) {
+        const bool transparent = i * 100 < _info.transparentPercent * _info.materialCount;
+        for (uint p = 0; p < 2; ++p) {
+            // lights add to opaque materials only
+            if (p && (transparent || !hasLights)) {
+                _materialIDs.emplace_back(0);
+                continue;
+            }
+
+            auto descriptorSet = device->createDescriptorSet({_materialSetLayout});
+            _descriptorSets.emplace_back(descriptorSet);
+
+            const auto &states = p ? _additiveStates : transparent ? _transparentStates : _opaqueStates;
+            PassView *pass = nullptr;
+            _materialIDs.emplace_back(allocate(pass));
+            pass->priority = static_cast<uint>(RenderPriority::DEFAULT);
+            pass->stage = static_cast<uint>(RenderPassStage::DEFAULT);
+            pass->phase = phases[p];
+            pass->primitive = static_cast<uint>(gfx::PrimitiveMode::TRIANGLE_LIST);
+            pass->hash = i * 2 + p + 1;
+            pass->rasterizerStateID = states.rasterizerStateID;
+            pass->depthStencilStateID = states.depthStencilStateID;
+            pass->blendStateID = states.blendStateID;
+            pass->descriptorSetID = addObject(se::PoolType::DESCRIPTOR_SETS, descriptorSet);
+            pass->pipelineLayoutID = _pipelineLayoutID;
+        }
+    }
+}
+
+uint SyntheticScene::createNode(const Vec3 &position, uint layer) {
+    Node *node = nullptr;
+    const auto nodeID = allocate(node);
+    node->layer = layer;
+    node->worldScale.set(1.0f, 1.0f, 1.0f);
+    node->worldPosition = position;
+    node->worldRotation.set(0.0f, 0.0f, 0.0f, 1.0f);
+    Mat4::createTranslation(position, &node->worldMatrix);
+    return nodeID;
+}
+
+void SyntheticScene::createModels() {
+    auto device = gfx::Device::getInstance();
+    const uint layer = static_cast<uint>(LayerList::DEFAULT);
+
+    _modelIDs.reserve(_info.modelCount);
+    _modelNodeIDs.reserve(_info.modelCount);
+    for (uint i = 0; i < _info.modelCount; ++i) {
+        const Vec3 position(random(-_info.extent, _info.extent), random(0.0f, 20.0f), random(-_info.extent, _info.extent));
+        const auto nodeID = createNode(position, layer);
+
+        AABB *bounds = nullptr;
+        const auto boundsID = allocate(bounds);
+        bounds->center = position;
+        bounds->halfExtents.set(random(1.0f, 10.0f), random(1.0f, 10.0f), random(1.0f, 10.0f));
+
+        auto descriptorSet = device->createDescriptorSet({_localSetLayout});
+        _descriptorSets.emplace_back(descriptorSet);
+
+        const auto material = static_cast<uint>(random(0.0f, static_cast<float>(_info.materialCount))) % _info.materialCount;
+        const auto shader = material % _info.shaderCount;
+        SubModelView *subModel = nullptr;
+        const auto subModelID = allocate(subModel);
+        subModel->priority = static_cast<uint>(RenderPriority::DEFAULT);
+        subModel->passCount = _materialIDs[material * 2 + 1] ? 2 : 1;
+        for (uint p = 0; p < subModel->passCount; ++p) {
+            subModel->passID[p] = _materialIDs[material * 2 + p];
+            subModel->shaderID[p] = _shaderIDs[shader * 2 + p];
+        }
+        subModel->planarShaderID = subModel->shaderID[0];
+        subModel->descriptorSetID = addObject(se::PoolType::DESCRIPTOR_SETS, descriptorSet);
+        subModel->inputAssemblerID = _iaIDs[i % INPUT_ASSEMBLER_COUNT];
+
+        ModelView *model = nullptr;
+        _modelIDs.emplace_back(allocate(model));
+        model->enabled = 1;
+        model->castShadow = 1;
+        model->receiveShadow = 1;
+        model->worldBoundsID = boundsID;
+        model->nodeID = nodeID;
+        model->transformID = nodeID;
+        model->subModelsID = allocateArray(se::PoolType::SUB_MODEL_ARRAY, {subModelID});
+        _modelNodeIDs.emplace_back(nodeID);
+    }
+}
+
+void SyntheticScene::createLights() {
+    Light *mainLight = nullptr;
+    _mainLightID = allocate(mainLight);
+    mainLight->lightType = static_cast<uint>(LightType::DIRECTIONAL);
+    mainLight->nodeID = createNode(Vec3::ZERO, static_cast<uint>(LayerList::DEFAULT));
+    mainLight->direction.set(-0.5f, -1.0f, -0.3f);
+    mainLight->direction.normalize();
+    mainLight->color.set(1.0f, 1.0f, 1.0f);
+    mainLight->colorTemperatureRGB.set(1.0f, 1.0f, 1.0f);
+    mainLight->luminance = 65000.0f;
+
+    const uint lightCount = _info.sphereLightCount + _info.spotLightCount;
+    for (uint i = 0; i < lightCount; ++i) {
+        const bool spot = i >= _info.sphereLightCount;
+        Light *light = nullptr;
+        const auto lightID = allocate(light);
+        light->position.set(random(-_info.extent, _info.extent), random(5.0f, 30.0f), random(-_info.extent, _info.extent));
+        light->nodeID = createNode(light->position, static_cast<uint>(LayerList::DEFAULT));
+        light->range = random(10.0f, 50.0f);
+        light->color.set(random(0.5f, 1.0f), random(0.5f, 1.0f), random(0.5f, 1.0f));
+        light->colorTemperatureRGB.set(1.0f, 1.0f, 1.0f);
+        light->luminance = 1700.0f;
+
+        AABB *bounds = nullptr;
+        light->aabbID = allocate(bounds);
+        bounds->center = light->position;
+        bounds->halfExtents.set(light->range, light->range, light->range);
+
+        if (!spot) {
+            light->lightType = static_cast<uint>(LightType::SPHERE);
+            _sphereLightIDs.emplace_back(lightID);
+        } else {
+            light->lightType = static_cast<uint>(LightType::SPOT);
+            light->direction.set(random(-0.5f, 0.5f), -1.0f, random(-0.5f, 0.5f));
+            light->direction.normalize();
+            const float halfAngle = MATH_DEG_TO_RAD(random(15.0f, 45.0f));
+            light->spotAngle = std::cos(halfAngle);
+
+            Mat4 matView;
+            Mat4::createLookAt(light->position, light->position + light->direction, Vec3::UNIT_Z, &matView);
+            Mat4 matProj;
+            Mat4::createPerspective(halfAngle * 2.0f, 1.0f, 0.01f, light->range, &matProj);
+            Frustum *frustum = nullptr;
+            light->frustumID = allocate(frustum);
+            updateFrustum(frustum, matProj * matView);
+            _spotLightIDs.emplace_back(lightID);
+        }
+        _lights.emplace_back(light);
+    }
+}
+
+void SyntheticScene::createCamera() {
+    Scene *scene = nullptr;
+    _sceneID = allocate(scene);
+    scene->mainLightID = _mainLightID;
+    scene->modelsID = allocateArray(se::PoolType::MODEL_ARRAY, _modelIDs);
+    scene->sphereLights = allocateArray(se::PoolType::LIGHT_ARRAY, _sphereLightIDs);
+    scene->spotLights = allocateArray(se::PoolType::LIGHT_ARRAY, _spotLightIDs);
+    scene->uiBatches = allocateArray(se::PoolType::UI_BATCH_ARRAY, {});
+
+    Fog *fog = nullptr;
+    _fogID = allocate(fog);
+    Skybox *skybox = nullptr;
+    _skyboxID = allocate(skybox);
+    Shadows *shadows = nullptr;
+    _shadowsID = allocate(shadows);
+    shadows->size.set(1024.0f, 1024.0f);
+    shadows->normal.set(0.0f, 1.0f, 0.0f);
+    Ambient *ambient = nullptr;
+    _ambientID = allocate(ambient);
+    ambient->enabled = 1;
+    ambient->skyIllum = 20000.0f;
+    ambient->skyColor.set(0.2f, 0.5f, 0.8f, 1.0f);
+    ambient->groundAlbedo.set(0.2f, 0.2f, 0.2f, 1.0f);
+
+    RenderWindow *window = nullptr;
+    const auto windowID = allocate(window);
+    window->hasOnScreenAttachments = 1;
+    window->framebufferID = addObject(se::PoolType::FRAMEBUFFER, _framebuffer);
+
+    Frustum *frustum = nullptr;
+    const auto frustumID = allocate(frustum);
+
+    Camera *camera = nullptr;
+    _cameraID = allocate(camera);
+    camera->width = _info.width;
+    camera->height = _info.height;
+    camera->exposure = 1.0f;
+    camera->clearFlag = static_cast<uint>(gfx::ClearFlagBit::ALL);
+    camera->clearDepth = 1.0f;
+    camera->visibility = CAMERA_DEFAULT_MASK;
+    camera->nodeID = createNode(Vec3::ZERO, static_cast<uint>(LayerList::DEFAULT));
+    camera->sceneID = _sceneID;
+    camera->frustumID = frustumID;
+    camera->windowID = windowID;
+    camera->viewportWidth = 1.0f;
+    camera->viewportHeight = 1.0f;
+    camera->clearColor = {0.2f, 0.2f, 0.2f, 1.0f};
+
+    lookAt(Vec3(0.0f, _info.extent * 0.2f, _info.extent), Vec3::ZERO);
+}
+
+void SyntheticScene::lookAt(const Vec3 &eye, const Vec3 &target) {
+    auto camera = getCamera();
+    Mat4 matView;
+    Mat4::createLookAt(eye, target, Vec3::UNIT_Y, &matView);
+
+    auto node = SharedMemory::getBuffer<Node>(camera->nodeID);
+    node->worldMatrix = matView.getInversed();
+    node->worldPosition = eye;
+    node->flagsChanged = 1;
+    _changedNodeIDs.emplace_back(camera->nodeID);
+
+    camera->position = eye;
+    Vec3::subtract(target, eye, &camera->forward);
+    camera->forward.normalize();
+    updateProjection(camera, matView, static_cast<float>(_info.width) / _info.height);
+}
+
+void SyntheticScene::moveModels(uint count, float distance) {
+    if (_modelIDs.empty()) return;
+
+    for (uint i = 0; i < count; ++i) {
+        const auto index = static_cast<uint>(random(0.0f, static_cast<float>(_modelIDs.size()))) % _modelIDs.size();
+        const Vec3 offset(random(-distance, distance), 0.0f, random(-distance, distance));
+
+        auto node = SharedMemory::getBuffer<Node>(_modelNodeIDs[index]);
+        node->worldPosition += offset;
+        Mat4::createTranslation(node->worldPosition, &node->worldMatrix);
+        node->flagsChanged = 1;
+        _changedNodeIDs.emplace_back(_modelNodeIDs[index]);
+
+        auto bounds = const_cast<AABB *>(SharedMemory::getBuffer<ModelView>(_modelIDs[index])->getWorldBounds());
+        bounds->center += offset;
+    }
+}
+
+void SyntheticScene::clearChangedFlags() {
+    for (const auto nodeID : _changedNodeIDs) {
+        SharedMemory::getBuffer<Node>(nodeID)->flagsChanged = 0;
+    }
+    _changedNodeIDs.clear();
+}
+
+float SyntheticScene::random(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(_random);
+}
+
+} // namespace benchmark
+} // namespace cc
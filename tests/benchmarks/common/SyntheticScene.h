@@ -0,0 +1,177 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <random>
+
+#include "bindings/dop/PoolType.h"
+#include "renderer/core/CoreStd.h"
+#include "renderer/pipeline/helper/SharedMemory.h"
+
+namespace se {
+class BufferAllocator;
+class BufferPool;
+class Object;
+class ObjectPool;
+} // namespace se
+
+namespace cc {
+namespace gfx {
+class DescriptorSet;
+class DescriptorSetLayout;
+class Framebuffer;
+class InputAssembler;
+class PipelineLayout;
+class RenderPass;
+class Shader;
+class Buffer;
+} // namespace gfx
+
+namespace benchmark {
+
+struct SyntheticSceneInfo {
+    uint modelCount = 1000;
+    uint shaderCount = 16;
+    uint materialCount = 64;
+    uint transparentPercent = 10;
+    uint sphereLightCount = 0;
+    uint spotLightCount = 0;
+    float extent = 500.0f; // models and lights are spread over [-extent, extent] on x and z
+    uint width = 1280;
+    uint height = 720;
+    uint seed = 1;
+};
+
+// Planes and corners of the frustum of a view projection matrix, the way the engine scripts compute them.
+void updateFrustum(pipeline::Frustum *frustum, const Mat4 &matViewProj);
+
+// A scene laid out in the shared memory pools the same way the engine scripts do it:
+// boxes of random size, material and mesh spread over a square, a directional main light,
+// optional sphere and spot lights, and one perspective camera drawing to an on screen window.
+// Needs the script engine and the device, and should be built after the pipeline was created,
+// local descriptor sets are created from the layout the pipeline sets up.
+class SyntheticScene {
+public:
+    explicit SyntheticScene(const SyntheticSceneInfo &info);
+    ~SyntheticScene();
+
+    // Points the camera from eye to target and updates its matrices and frustum.
+    void lookAt(const Vec3 &eye, const Vec3 &target);
+    // Moves count random models by up to distance on x and z and flags their nodes as changed.
+    void moveModels(uint count, float distance);
+    // Resets the changed flags, as the scene graph does once a frame was rendered.
+    void clearChangedFlags();
+
+    CC_INLINE uint getCameraID() const { return _cameraID; }
+    CC_INLINE pipeline::Camera *getCamera() const { return pipeline::SharedMemory::getBuffer<pipeline::Camera>(_cameraID); }
+    CC_INLINE uint getSceneID() const { return _sceneID; }
+    CC_INLINE uint getFogID() const { return _fogID; }
+    CC_INLINE uint getAmbientID() const { return _ambientID; }
+    CC_INLINE uint getSkyboxID() const { return _skyboxID; }
+    CC_INLINE uint getShadowsID() const { return _shadowsID; }
+    CC_INLINE const vector<uint> &getModelIDs() const { return _modelIDs; }
+    // sphere lights first, then spot lights
+    CC_INLINE const vector<const pipeline::Light *> &getLights() const { return _lights; }
+
+private:
+    struct PoolEntries {
+        se::BufferPool *pool = nullptr;
+        uint entryCount = 0;
+    };
+
+    struct PassStates {
+        uint rasterizerStateID = 0;
+        uint depthStencilStateID = 0;
+        uint blendStateID = 0;
+    };
+
+    struct ObjectEntries {
+        se::ObjectPool *pool = nullptr;
+        se::Object *jsArray = nullptr;
+        uint count = 0;
+    };
+
+    template <typename T>
+    uint allocate(se::PoolType type, T *&entry);
+    template <typename T>
+    uint allocate(T *&entry) { return allocate(T::type, entry); }
+    uint allocateArray(se::PoolType type, const vector<uint> &handles);
+    template <typename T>
+    uint addObject(se::PoolType type, T *object);
+
+    void createPools();
+    void createGFXObjects();
+    PassStates createPassStates(bool depthWrite, bool blend, gfx::BlendFactor blendSrc, gfx::BlendFactor blendDst);
+    void createMaterials();
+    void createModels();
+    void createLights();
+    void createCamera();
+    uint createNode(const Vec3 &position, uint layer);
+    float random(float min, float max);
+
+    SyntheticSceneInfo _info;
+    std::mt19937 _random;
+
+    map<se::PoolType, PoolEntries> _pools;
+    map<se::PoolType, se::BufferAllocator *> _allocators;
+    map<se::PoolType, uint> _arrayCounts;
+    map<se::PoolType, ObjectEntries> _objectPools;
+    vector<se::Object *> _jsObjects; // rooted chunks and arrays
+    vector<se::Object *> _wrappers;  // script objects of the gfx objects in the object pools
+
+    vector<gfx::Shader *> _shaders;
+    vector<gfx::Buffer *> _buffers;
+    vector<gfx::InputAssembler *> _inputAssemblers;
+    vector<gfx::DescriptorSet *> _descriptorSets;
+    gfx::DescriptorSetLayout *_materialSetLayout = nullptr;
+    gfx::DescriptorSetLayout *_localSetLayout = nullptr;
+    gfx::PipelineLayout *_pipelineLayout = nullptr;
+    gfx::RenderPass *_renderPass = nullptr;
+    gfx::Framebuffer *_framebuffer = nullptr;
+
+    vector<uint> _shaderIDs;    // default pass shader, then forward-add shader of every shader index
+    vector<uint> _materialIDs;  // default pass, then forward-add pass or 0 of every material
+    vector<uint> _iaIDs;
+    uint _pipelineLayoutID = 0;
+    PassStates _opaqueStates;
+    PassStates _transparentStates;
+    PassStates _additiveStates;
+
+    vector<uint> _modelIDs;
+    vector<uint> _modelNodeIDs;
+    vector<uint> _changedNodeIDs;
+    vector<const pipeline::Light *> _lights;
+    uint _mainLightID = 0;
+    vector<uint> _sphereLightIDs;
+    vector<uint> _spotLightIDs;
+    uint _cameraID = 0;
+    uint _sceneID = 0;
+    uint _fogID = 0;
+    uint _ambientID = 0;
+    uint _skyboxID = 0;
+    uint _shadowsID = 0;
+};
+
+} // namespace benchmark
+} // namespace cc
@@ -0,0 +1,167 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Frustum culls the models of a synthetic scene with the scalar per-model test, the packed AABB batch on one thread
+// and split across the culling workers, and the scene BVH, and reports the time of one pass and the visible count.
+//
+// culling_benchmark [--models 1000,10000,100000] [--iterations 100] [--moving 1]
+//
+// --moving is the percentage of models moved before every BVH refit.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+#include "renderer/pipeline/helper/ParallelCulling.h"
+#include "renderer/pipeline/helper/SceneBVH.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+using namespace cc::pipeline;
+
+namespace {
+
+uint countVisible(const cc::vector<uint8_t> &visible, uint count) {
+    uint visibleCount = 0;
+    for (uint i = 0; i < count; ++i) {
+        visibleCount += visible[i] ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+bool run(uint modelCount, uint iterations, uint movingPercent, CullingWorkers *workers) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(1280, 720);
+    if (!device) return false;
+
+    // only constructed for the descriptor set layouts the scene creates its local descriptor sets from
+    auto pipeline = CC_NEW(ForwardPipeline);
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    auto scene = CC_NEW(SyntheticScene(info));
+    const auto frustum = scene->getCamera()->getFrustum();
+    const auto sceneView = GET_SCENE(scene->getSceneID());
+
+    cc::vector<const AABB *> bounds;
+    for (const auto modelID : scene->getModelIDs()) {
+        bounds.emplace_back(GET_MODEL(modelID)->getWorldBounds());
+    }
+
+    cc::vector<uint8_t> visible(modelCount + AABBBatch::BLOCK_SIZE);
+    uint scalarCount = 0;
+    const double scalarTime = measure(iterations, [&]() {
+        for (uint i = 0; i < modelCount; ++i) {
+            visible[i] = aabb_frustum(bounds[i], frustum);
+        }
+        scalarCount = countVisible(visible, modelCount);
+    });
+
+    AABBBatch batch;
+    uint batchCount = 0;
+    const double batchTime = measure(iterations, [&]() {
+        batch.clear();
+        for (const auto aabb : bounds) {
+            batch.add(aabb);
+        }
+        batch.cull(frustum, visible);
+        batchCount = countVisible(visible, modelCount);
+    });
+
+    // every range packs its own models, as scene culling did before the BVH
+    cc::vector<AABBBatch> rangeBatches(workers->getRangeCount(modelCount));
+    uint parallelCount = 0;
+    const double parallelTime = measure(iterations, [&]() {
+        workers->dispatch(modelCount, [&](uint rangeIndex, uint begin, uint end) {
+            float planes[PLANE_LENGTH * 4];
+            AABBBatch::packPlanes(frustum, planes);
+            auto &rangeBatch = rangeBatches[rangeIndex];
+            rangeBatch.clear();
+            for (uint i = begin; i < end; ++i) {
+                rangeBatch.add(bounds[i]);
+            }
+            const auto blockCount = (end - begin + AABBBatch::BLOCK_SIZE - 1) / AABBBatch::BLOCK_SIZE;
+            cc::vector<uint8_t> rangeVisible(blockCount * AABBBatch::BLOCK_SIZE);
+            rangeBatch.cull(planes, 0, blockCount, rangeVisible.data());
+            std::copy(rangeVisible.begin(), rangeVisible.begin() + (end - begin), visible.begin() + begin);
+        });
+        parallelCount = countVisible(visible, modelCount);
+    });
+
+    SceneBVH bvh;
+    const double buildTime = measure(1, [&]() {
+        bvh = SceneBVH();
+        bvh.update(sceneView);
+    });
+    cc::vector<uint> indices;
+    const double queryTime = measure(iterations, [&]() { bvh.queryFrustum(frustum, indices); });
+    const uint bvhCount = static_cast<uint>(indices.size());
+    const uint movingCount = modelCount * movingPercent / 100;
+    double refitTime = 0.0;
+    for (uint i = 0; i < iterations; ++i) {
+        scene->moveModels(movingCount, 1.0f);
+        const auto start = std::chrono::steady_clock::now();
+        bvh.update(sceneView);
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        refitTime += time.count();
+        scene->clearChangedFlags();
+    }
+
+    printf("%u models, %u iterations, %u culling threads\n", modelCount, iterations, workers->getWorkerCount() + 1);
+    printf("  %-28s %10.3f ms %8u visible\n", "scalar aabb_frustum", scalarTime, scalarCount);
+    printf("  %-28s %10.3f ms %8u visible\n", "AABB batch, pack + cull", batchTime, batchCount);
+    printf("  %-28s %10.3f ms %8u visible\n", "AABB batch, workers", parallelTime, parallelCount);
+    printf("  %-28s %10.3f ms\n", "BVH build", buildTime);
+    printf("  %-28s %10.3f ms %8u visible\n", "BVH query", queryTime, bvhCount);
+    printf("  %-28s %10.3f ms\n", "BVH refit", iterations ? refitTime / iterations : 0.0);
+
+    const bool agreed = scalarCount == batchCount && batchCount == parallelCount;
+    if (!agreed) CC_LOG_ERROR("Culling paths disagree on the visible set of %u models.", modelCount);
+
+    CC_DELETE(scene);
+    CC_DELETE(pipeline);
+    destroyDevice(device);
+    return agreed;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto modelCounts = getOptionList(argc, argv, "models", {1000, 10000, 100000});
+    const uint iterations = getOption(argc, argv, "iterations", 100);
+    const uint movingPercent = getOption(argc, argv, "moving", 1);
+
+    if (!startScriptEngine()) return 1;
+
+    CullingWorkers workers;
+    bool succeeded = true;
+    for (const auto modelCount : modelCounts) {
+        succeeded = run(modelCount, iterations, movingPercent, &workers) && succeeded;
+    }
+
+    stopScriptEngine();
+    return succeeded ? 0 : 1;
+}
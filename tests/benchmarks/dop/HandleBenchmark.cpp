@@ -0,0 +1,170 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Walks every model of a synthetic scene the way culling and queue building do, resolving each handle through
+// the per-type slot tables and through the pool maps the lookups used before, and reports the time of one walk.
+//
+// handle_benchmark [--models 1000,10000,100000] [--iterations 100]
+
+#include <cstdio>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/dop/BufferPool.h"
+#include "bindings/dop/ObjectPool.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+using namespace cc::pipeline;
+
+namespace {
+
+// Resolves handles the way SharedMemory does now.
+struct SlotLookup {
+    template <typename T>
+    CC_INLINE static T *getBuffer(uint index) {
+        return se::BufferPool::getTypedObject<T>(T::type, index);
+    }
+
+    template <typename T, se::PoolType p>
+    CC_INLINE static T *getObject(uint index) {
+        return se::ObjectPool::getTypedObject<T>(p, index);
+    }
+};
+
+// Resolves handles the way SharedMemory did before the slot tables, with a map search per call.
+struct MapLookup {
+    template <typename T>
+    static T *getBuffer(uint index) {
+        const auto &bufferMap = se::BufferPool::getPoolMap();
+        if (bufferMap.count(T::type) != 0) {
+            return bufferMap.at(T::type)->template getTypedObject<T>(index);
+        }
+        return nullptr;
+    }
+
+    template <typename T, se::PoolType p>
+    static T *getObject(uint index) {
+        const auto &poolMap = se::ObjectPool::getPoolMap();
+        if (poolMap.count(p) != 0) {
+            return poolMap.at(p)->template getTypedObject<T>(index);
+        }
+        return nullptr;
+    }
+};
+
+// Touches the node, bounds, sub models, passes, shaders, input assemblers and descriptor sets of every model,
+// the sum of the addresses keeps the compiler from dropping the lookups.
+template <typename Lookup>
+size_t walkModels(const cc::vector<uint> &modelIDs) {
+    size_t sum = 0;
+    for (const auto modelID : modelIDs) {
+        const auto model = Lookup::template getBuffer<ModelView>(modelID);
+        sum += reinterpret_cast<size_t>(Lookup::template getBuffer<Node>(model->nodeID));
+        sum += reinterpret_cast<size_t>(Lookup::template getBuffer<AABB>(model->worldBoundsID));
+
+        const auto subModelIDs = model->getSubModelID();
+        const auto subModelCount = subModelIDs[0];
+        for (uint m = 1; m <= subModelCount; ++m) {
+            const auto subModel = Lookup::template getBuffer<SubModelView>(subModelIDs[m]);
+            for (uint p = 0; p < subModel->passCount; ++p) {
+                const auto pass = Lookup::template getBuffer<PassView>(subModel->passID[p]);
+                sum += pass->phase;
+                sum += reinterpret_cast<size_t>(Lookup::template getObject<gfx::Shader, se::PoolType::SHADER>(subModel->shaderID[p]));
+            }
+            sum += reinterpret_cast<size_t>(Lookup::template getObject<gfx::InputAssembler, se::PoolType::INPUT_ASSEMBLER>(subModel->inputAssemblerID));
+            sum += reinterpret_cast<size_t>(Lookup::template getObject<gfx::DescriptorSet, se::PoolType::DESCRIPTOR_SETS>(subModel->descriptorSetID));
+        }
+    }
+    return sum;
+}
+
+// Only the buffer pools, object handles resolve through the same native mirror with either lookup.
+template <typename Lookup>
+size_t walkBuffers(const cc::vector<uint> &modelIDs) {
+    size_t sum = 0;
+    for (const auto modelID : modelIDs) {
+        const auto model = Lookup::template getBuffer<ModelView>(modelID);
+        sum += reinterpret_cast<size_t>(Lookup::template getBuffer<Node>(model->nodeID));
+        sum += reinterpret_cast<size_t>(Lookup::template getBuffer<AABB>(model->worldBoundsID));
+
+        const auto subModelIDs = model->getSubModelID();
+        const auto subModelCount = subModelIDs[0];
+        for (uint m = 1; m <= subModelCount; ++m) {
+            const auto subModel = Lookup::template getBuffer<SubModelView>(subModelIDs[m]);
+            for (uint p = 0; p < subModel->passCount; ++p) {
+                sum += Lookup::template getBuffer<PassView>(subModel->passID[p])->phase;
+            }
+        }
+    }
+    return sum;
+}
+
+bool run(uint modelCount, uint iterations) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(1280, 720);
+    if (!device) return false;
+
+    // only constructed for the descriptor set layouts the scene creates its local descriptor sets from
+    auto pipeline = CC_NEW(ForwardPipeline);
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    auto scene = CC_NEW(SyntheticScene(info));
+    const auto &modelIDs = scene->getModelIDs();
+
+    size_t sink = 0;
+    const double bufferMap = measure(iterations, [&]() { sink += walkBuffers<MapLookup>(modelIDs); });
+    const double bufferSlot = measure(iterations, [&]() { sink += walkBuffers<SlotLookup>(modelIDs); });
+    const double allMap = measure(iterations, [&]() { sink += walkModels<MapLookup>(modelIDs); });
+    const double allSlot = measure(iterations, [&]() { sink += walkModels<SlotLookup>(modelIDs); });
+
+    printf("%u models, %u iterations (checksum %zx)\n", modelCount, iterations, sink);
+    printf("  %-32s %10.3f ms\n", "buffer handles, pool map", bufferMap);
+    printf("  %-32s %10.3f ms\n", "buffer handles, slot table", bufferSlot);
+    printf("  %-32s %10.3f ms\n", "all handles, pool map", allMap);
+    printf("  %-32s %10.3f ms\n", "all handles, slot table", allSlot);
+
+    CC_DELETE(scene);
+    CC_DELETE(pipeline);
+    destroyDevice(device);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto modelCounts = getOptionList(argc, argv, "models", {1000, 10000, 100000});
+    const uint iterations = getOption(argc, argv, "iterations", 100);
+
+    if (!startScriptEngine()) return 1;
+
+    bool succeeded = true;
+    for (const auto modelCount : modelCounts) {
+        succeeded = run(modelCount, iterations) && succeeded;
+    }
+
+    stopScriptEngine();
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Exercises the render thread of the empty device without any GPU: command order and thread, staged data,
+// payloads too large for the ring, retired callbacks, frame pacing, switching the thread off with work queued,
+// and the forward pipeline producing the same frame statistics with and without the render thread.
+//
+// render_thread_test [--frames 20] [--models 1000] [--device-only]
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXDevice.h"
+#include "renderer/gfx-empty/GFXEmpty.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+
+namespace {
+uint failures = 0;
+
+void check(bool condition, const char *expression, int line) {
+    if (!condition) {
+        CC_LOG_ERROR("render_thread_test:%d: check failed: %s", line, expression);
+        ++failures;
+    }
+}
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+void testCommandOrder(gfx::Device *device) {
+    device->setMultithreaded(true);
+    CHECK(device->isMultithreaded());
+
+    const auto mainThread = std::this_thread::get_id();
+    cc::vector<uint> order;
+    bool onMainThread = false;
+    for (uint i = 0; i < 1000; ++i) {
+        device->enqueue([&order, &onMainThread, mainThread, i]() {
+            onMainThread = onMainThread || std::this_thread::get_id() == mainThread;
+            order.push_back(i);
+        });
+    }
+    device->flushRenderThread();
+
+    CHECK(!onMainThread);
+    CHECK(order.size() == 1000);
+    bool ordered = true;
+    for (uint i = 0; i < order.size(); ++i) ordered = ordered && order[i] == i;
+    CHECK(ordered);
+
+    device->setMultithreaded(false);
+    CHECK(!device->isMultithreaded());
+
+    // single threaded commands run right away
+    bool ran = false;
+    device->enqueue([&ran]() { ran = true; });
+    CHECK(ran);
+}
+
+void testStaging(gfx::Device *device) {
+    device->setMultithreaded(true);
+    auto renderThread = device->getRenderThread();
+
+    // small payloads live in the ring, the large one does not fit a quarter of it and goes to the heap
+    const uint sizes[] = {16, 4096, gfx::RenderThread::DEFAULT_RING_SIZE};
+    for (const auto size : sizes) {
+        cc::vector<uint8_t> source(size);
+        for (uint i = 0; i < size; ++i) source[i] = static_cast<uint8_t>(i * 7);
+        cc::vector<uint8_t> expected = source;
+
+        const void *staged = device->stage(source.data(), size);
+        bool equal = false;
+        device->enqueue([staged, size, &expected, &equal]() {
+            equal = !memcmp(staged, expected.data(), size);
+        });
+        // the copy is what the command reads, not the source
+        std::fill(source.begin(), source.end(), 0);
+        device->flushRenderThread();
+        CHECK(equal);
+    }
+
+    // a wrapped ring, many more bytes than it holds go through it without a flush
+    std::atomic<uint> executed{0};
+    cc::vector<uint8_t> block(64 * 1024, 1);
+    const uint blockCount = 4 * gfx::RenderThread::DEFAULT_RING_SIZE / static_cast<uint>(block.size());
+    for (uint i = 0; i < blockCount; ++i) {
+        const auto staged = static_cast<const uint8_t *>(renderThread->stage(block.data(), static_cast<uint>(block.size())));
+        device->enqueue([staged, &executed]() {
+            if (staged[0] == 1) ++executed;
+        });
+    }
+    device->flushRenderThread();
+    CHECK(executed.load() == blockCount);
+
+    device->setMultithreaded(false);
+}
+
+void testFramePacing(gfx::Device *device, uint frames) {
+    device->setMultithreaded(true);
+    auto renderThread = device->getRenderThread();
+
+    const auto mainThread = std::this_thread::get_id();
+    std::atomic<uint> completedFrames{0};
+    bool paced = true;
+    bool retiredOnMainThread = true;
+    bool retiredLate = false;
+    for (uint frame = 1; frame <= frames; ++frame) {
+        device->acquire();
+        // some work to keep the render thread behind
+        device->enqueue([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+        device->enqueue([&completedFrames, frame]() { completedFrames = frame; });
+        renderThread->retire([&, frame]() {
+            retiredOnMainThread = retiredOnMainThread && std::this_thread::get_id() == mainThread;
+            retiredLate = retiredLate || completedFrames.load() < frame;
+        });
+        device->present();
+
+        // the main thread may only run MAX_FRAMES_AHEAD frames ahead of the render thread
+        paced = paced && completedFrames.load() + gfx::RenderThread::MAX_FRAMES_AHEAD >= frame;
+    }
+    device->flushRenderThread();
+
+    CHECK(paced);
+    CHECK(completedFrames.load() == frames);
+    CHECK(retiredOnMainThread);
+    CHECK(!retiredLate);
+    device->setMultithreaded(false);
+}
+
+void testStopWithQueuedWork(gfx::Device *device) {
+    device->setMultithreaded(true);
+    std::atomic<uint> executed{0};
+    for (uint i = 0; i < 100; ++i) {
+        device->enqueue([&executed]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++executed;
+        });
+    }
+    // stopping executes everything still queued
+    device->setMultithreaded(false);
+    CHECK(executed.load() == 100);
+}
+
+struct FrameStats {
+    uint drawCalls = 0;
+    uint triangles = 0;
+    uint stateChanges = 0;
+};
+
+// Renders the same frames with the render thread on or off and records what the device counted.
+bool renderFrames(uint modelCount, uint frames, bool multithreaded, cc::vector<FrameStats> &stats) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(1280, 720);
+    if (!device) return false;
+    device->setMultithreaded(multithreaded);
+
+    auto pipeline = CC_NEW(pipeline::ForwardPipeline);
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    info.sphereLightCount = 4;
+    info.spotLightCount = 4;
+    auto scene = CC_NEW(SyntheticScene(info));
+
+    pipeline->initialize({});
+    pipeline->setFog(scene->getFogID());
+    pipeline->setAmbient(scene->getAmbientID());
+    pipeline->setSkybox(scene->getSkyboxID());
+    pipeline->setShadows(scene->getShadowsID());
+    const bool activated = pipeline->activate();
+
+    const cc::vector<uint> cameras = {scene->getCameraID()};
+    for (uint frame = 0; activated && frame < frames; ++frame) {
+        se::AutoHandleScope frameScope;
+        scene->lookAt(Vec3(std::sin(frame * 0.1f) * info.extent, info.extent * 0.2f, std::cos(frame * 0.1f) * info.extent), Vec3::ZERO);
+        scene->moveModels(modelCount / 100, 1.0f);
+        device->acquire();
+        pipeline->render(cameras);
+        device->present();
+        scene->clearChangedFlags();
+        stats.push_back({device->getNumDrawCalls(), device->getNumTris(), static_cast<gfx::EmptyDevice *>(device)->getNumStateChanges()});
+    }
+
+    pipeline->destroy();
+    CC_DELETE(pipeline);
+    CC_DELETE(scene);
+    destroyDevice(device);
+    return activated;
+}
+
+void testPipeline(uint modelCount, uint frames) {
+    cc::vector<FrameStats> singleThreaded;
+    cc::vector<FrameStats> multithreaded;
+    CHECK(renderFrames(modelCount, frames, false, singleThreaded));
+    CHECK(renderFrames(modelCount, frames, true, multithreaded));
+    CHECK(singleThreaded.size() == multithreaded.size());
+
+    bool equal = singleThreaded.size() == multithreaded.size();
+    for (size_t i = 0; equal && i < singleThreaded.size(); ++i) {
+        equal = singleThreaded[i].drawCalls == multithreaded[i].drawCalls && singleThreaded[i].triangles == multithreaded[i].triangles &&
+                singleThreaded[i].stateChanges == multithreaded[i].stateChanges;
+    }
+    CHECK(equal);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint frames = getOption(argc, argv, "frames", 20);
+    const uint modelCount = getOption(argc, argv, "models", 1000);
+
+    // the device checks only need the empty device, they run before and without the script engine
+    auto device = createDevice(1280, 720);
+    CHECK(device != nullptr);
+    if (device) {
+        testCommandOrder(device);
+        testStaging(device);
+        testFramePacing(device, frames);
+        testStopWithQueuedWork(device);
+        destroyDevice(device);
+    }
+
+    if (!hasOption(argc, argv, "device-only")) {
+        const bool started = startScriptEngine();
+        CHECK(started);
+        if (started) testPipeline(modelCount, frames);
+        stopScriptEngine();
+    }
+
+    printf("render_thread_test: %u failed checks\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Records the command stream the GLES3 command buffer produces for a sorted frame of meshes with several sub meshes,
+// runs GLES3CmdFuncOptimizeCmds over it and reports the bind state walks and glDraw* calls replay would issue
+// before and after, along with the cost of the pass. Nothing is replayed, so no GL context is needed.
+//
+// gles3_command_benchmark [--meshes 1000,10000] [--submeshes 3] [--shaders 16] [--materials 64] [--iterations 100]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "common/BenchmarkHarness.h"
+#include "renderer/gfx-gles3/GLES3Std.h"
+#include "renderer/gfx-gles3/GLES3Commands.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+using namespace cc::gfx;
+
+namespace {
+constexpr uint SET_COUNT = 3;
+constexpr uint MATERIAL_SET = 1;
+constexpr uint LOCAL_SET = 2;
+constexpr uint INDICES_PER_SUBMESH = 36;
+
+// Records commands the way GLES3CommandBuffer does: state is only captured by a draw when something changed,
+// and dynamic offsets always count as a change.
+class Recorder {
+public:
+    Recorder(GLES3GPUCommandAllocator *allocator, GLES3CmdPackage *package)
+    : _allocator(allocator), _package(package), _descriptorSets(SET_COUNT, nullptr) {}
+
+    void beginRenderPass() {
+        _package->beginRenderPassCmds.push(_allocator->beginRenderPassCmdPool.alloc());
+        _package->cmds.push(GFXCmdType::BEGIN_RENDER_PASS);
+        _isStateInvalid = true;
+    }
+
+    void endRenderPass() {
+        _package->cmds.push(GFXCmdType::END_RENDER_PASS);
+    }
+
+    void bindPipelineState(GLES3GPUPipelineState *pipelineState) {
+        if (_pipelineState != pipelineState) {
+            _pipelineState = pipelineState;
+            _isStateInvalid = true;
+        }
+    }
+
+    void bindDescriptorSet(uint set, GLES3GPUDescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+        if (_descriptorSets[set] != descriptorSet) {
+            _descriptorSets[set] = descriptorSet;
+            _isStateInvalid = true;
+        }
+        if (dynamicOffsetCount) {
+            _dynamicOffsets.assign(dynamicOffsets, dynamicOffsets + dynamicOffsetCount);
+            _isStateInvalid = true;
+        }
+    }
+
+    void bindInputAssembler(GLES3GPUInputAssembler *inputAssembler) {
+        if (_inputAssembler != inputAssembler) {
+            _inputAssembler = inputAssembler;
+            _isStateInvalid = true;
+        }
+    }
+
+    void draw(const DrawInfo &drawInfo) {
+        if (_isStateInvalid) {
+            GLES3CmdBindStates *cmd = _allocator->bindStatesCmdPool.alloc();
+            cmd->gpuPipelineState = _pipelineState;
+            cmd->gpuInputAssembler = _inputAssembler;
+            cmd->gpuDescriptorSets = _descriptorSets;
+            cmd->dynamicOffsets = _dynamicOffsets;
+            _package->bindStatesCmds.push(cmd);
+            _package->cmds.push(GFXCmdType::BIND_STATES);
+            _isStateInvalid = false;
+        }
+
+        GLES3CmdDraw *cmd = _allocator->drawCmdPool.alloc();
+        cmd->drawInfo = drawInfo;
+        _package->drawCmds.push(cmd);
+        _package->cmds.push(GFXCmdType::DRAW);
+    }
+
+private:
+    GLES3GPUCommandAllocator *_allocator = nullptr;
+    GLES3CmdPackage *_package = nullptr;
+    GLES3GPUPipelineState *_pipelineState = nullptr;
+    GLES3GPUInputAssembler *_inputAssembler = nullptr;
+    cc::vector<GLES3GPUDescriptorSet *> _descriptorSets;
+    cc::vector<uint> _dynamicOffsets;
+    bool _isStateInvalid = true;
+};
+
+struct Mesh {
+    uint shader = 0;
+    uint material = 0;
+    uint dynamicOffset = 0;
+    GLES3GPUInputAssembler *inputAssembler = nullptr;
+};
+
+struct Counts {
+    uint bindStates = 0;
+    uint draws = 0;
+    uint indices = 0;
+};
+
+Counts getCounts(const GLES3CmdPackage &package) {
+    Counts counts;
+    counts.bindStates = package.bindStatesCmds.size();
+    counts.draws = package.drawCmds.size();
+    for (uint i = 0; i < package.drawCmds.size(); ++i) {
+        counts.indices += package.drawCmds[i]->drawInfo.indexCount;
+    }
+    return counts;
+}
+
+bool run(uint meshCount, uint subMeshCount, uint shaderCount, uint materialCount, uint iterations) {
+    GLES3GPUBuffer indexBuffer;
+    GLES3GPUDescriptorSet globalSet;
+    GLES3GPUDescriptorSet localSet;
+    cc::vector<GLES3GPUPipelineState> pipelineStates(shaderCount);
+    cc::vector<GLES3GPUDescriptorSet> materialSets(materialCount);
+    cc::vector<GLES3GPUInputAssembler> inputAssemblers(meshCount);
+
+    // every mesh has its own geometry, the sub meshes are consecutive ranges of its index buffer
+    std::mt19937 random(1);
+    cc::vector<Mesh> meshes(meshCount);
+    for (uint i = 0; i < meshCount; ++i) {
+        auto &mesh = meshes[i];
+        mesh.material = random() % materialCount;
+        mesh.shader = mesh.material % shaderCount;
+        mesh.dynamicOffset = i * 256;
+        mesh.inputAssembler = &inputAssemblers[i];
+        mesh.inputAssembler->gpuIndexBuffer = &indexBuffer;
+    }
+    // the order a front to back render queue leaves them in
+    std::stable_sort(meshes.begin(), meshes.end(), [](const Mesh &a, const Mesh &b) {
+        return a.shader != b.shader ? a.shader < b.shader : a.material < b.material;
+    });
+
+    GLES3GPUCommandAllocator allocator;
+    GLES3CmdPackage package;
+    auto record = [&]() {
+        Recorder recorder(&allocator, &package);
+        recorder.beginRenderPass();
+        recorder.bindDescriptorSet(0, &globalSet, 0, nullptr);
+        for (const auto &mesh : meshes) {
+            for (uint s = 0; s < subMeshCount; ++s) {
+                recorder.bindPipelineState(&pipelineStates[mesh.shader]);
+                recorder.bindDescriptorSet(MATERIAL_SET, &materialSets[mesh.material], 0, nullptr);
+                recorder.bindDescriptorSet(LOCAL_SET, &localSet, 1, &mesh.dynamicOffset);
+                recorder.bindInputAssembler(mesh.inputAssembler);
+                DrawInfo drawInfo;
+                drawInfo.firstIndex = s * INDICES_PER_SUBMESH;
+                drawInfo.indexCount = INDICES_PER_SUBMESH;
+                recorder.draw(drawInfo);
+            }
+        }
+        recorder.endRenderPass();
+    };
+
+    Counts before;
+    Counts after;
+    uint commandCount = 0;
+    double optimizeTime = 0.0;
+    for (uint i = 0; i < iterations; ++i) {
+        record();
+        before = getCounts(package);
+        commandCount = package.cmds.size();
+
+        const auto start = std::chrono::steady_clock::now();
+        GLES3CmdFuncOptimizeCmds(&allocator, &package);
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        optimizeTime += time.count();
+
+        after = getCounts(package);
+        allocator.clearCmds(&package);
+        allocator.reset();
+    }
+
+    printf("%u meshes, %u sub meshes each, %u shaders, %u materials, %u commands recorded\n", meshCount, subMeshCount, shaderCount,
+           materialCount, commandCount);
+    printf("  %-20s %10s %10s\n", "", "recorded", "replayed");
+    printf("  %-20s %10u %10u\n", "bind state walks", before.bindStates, after.bindStates);
+    printf("  %-20s %10u %10u\n", "glDraw* calls", before.draws, after.draws);
+    printf("  %-20s %10.3f ms\n", "optimize pass", iterations ? optimizeTime / iterations : 0.0);
+
+    const bool preserved = before.indices == after.indices;
+    if (!preserved) CC_LOG_ERROR("Optimizing changed the drawn index count from %u to %u.", before.indices, after.indices);
+    return preserved;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto meshCounts = getOptionList(argc, argv, "meshes", {1000, 10000});
+    const uint subMeshCount = getOption(argc, argv, "submeshes", 3);
+    const uint shaderCount = std::max(getOption(argc, argv, "shaders", 16), 1u);
+    const uint materialCount = std::max(getOption(argc, argv, "materials", 64), 1u);
+    const uint iterations = std::max(getOption(argc, argv, "iterations", 100), 1u);
+
+    bool succeeded = true;
+    for (const auto meshCount : meshCounts) {
+        succeeded = run(meshCount, subMeshCount, shaderCount, materialCount, iterations) && succeeded;
+    }
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Bins the sphere and spot lights of a synthetic scene into view space clusters, and renders the scene once with
+// forward-add passes per light and once with clustered lighting, for a range of light counts. Reports the binning
+// time, the light indices it produced and what a frame costs either way.
+//
+// light_cluster_benchmark [--lights 16,64,256,1024] [--models 1000] [--iterations 100] [--frames 20]
+
+#include <chrono>
+#include <cstdio>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXDevice.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+#include "renderer/pipeline/helper/LightClusters.h"
+#include "renderer/pipeline/helper/ParallelCulling.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+
+namespace {
+constexpr uint WIDTH = 1280;
+constexpr uint HEIGHT = 720;
+constexpr uint WARMUP_FRAMES = 3;
+
+struct FrameStats {
+    double frameTime = 0.0;
+    double drawCalls = 0.0;
+    double binningTime = 0.0;
+};
+
+SyntheticSceneInfo getSceneInfo(uint modelCount, uint lightCount) {
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    info.sphereLightCount = lightCount / 2;
+    info.spotLightCount = lightCount - info.sphereLightCount;
+    info.width = WIDTH;
+    info.height = HEIGHT;
+    return info;
+}
+
+// Binning on its own, over every light of the scene whether it is in view or not.
+bool measureBinning(uint modelCount, uint lightCount, uint iterations, double &time, uint &indexCount) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(WIDTH, HEIGHT);
+    if (!device) return false;
+
+    // only constructed for the descriptor set layouts the scene creates its local descriptor sets from
+    auto pipeline = CC_NEW(pipeline::ForwardPipeline);
+    auto scene = CC_NEW(SyntheticScene(getSceneInfo(modelCount, lightCount)));
+    pipeline::CullingWorkers workers;
+    pipeline::LightClusters clusters;
+    time = measure(iterations, [&]() {
+        clusters.build(scene->getCamera(), scene->getLights(), device->getClipSpaceMinZ(), 1.0f, &workers);
+    });
+    indexCount = clusters.getIndexCount();
+
+    CC_DELETE(scene);
+    CC_DELETE(pipeline);
+    destroyDevice(device);
+    return true;
+}
+
+bool render(uint modelCount, uint lightCount, uint frames, bool clusteredLighting, FrameStats &stats) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(WIDTH, HEIGHT);
+    if (!device) return false;
+
+    auto pipeline = CC_NEW(pipeline::ForwardPipeline);
+    auto scene = CC_NEW(SyntheticScene(getSceneInfo(modelCount, lightCount)));
+
+    pipeline->initialize({});
+    pipeline->setFog(scene->getFogID());
+    pipeline->setAmbient(scene->getAmbientID());
+    pipeline->setSkybox(scene->getSkyboxID());
+    pipeline->setShadows(scene->getShadowsID());
+    pipeline->setClusteredLighting(clusteredLighting);
+    const bool activated = pipeline->activate();
+
+    const cc::vector<uint> cameras = {scene->getCameraID()};
+    for (uint frame = 0; activated && frame < WARMUP_FRAMES + frames; ++frame) {
+        se::AutoHandleScope frameScope;
+        const auto start = std::chrono::steady_clock::now();
+        device->acquire();
+        pipeline->render(cameras);
+        device->present();
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        if (frame < WARMUP_FRAMES) continue;
+
+        stats.frameTime += time.count();
+        stats.drawCalls += device->getNumDrawCalls();
+        stats.binningTime += pipeline->getLightBinningTime();
+    }
+    if (!activated) CC_LOG_ERROR("Failed to activate the pipeline.");
+
+    pipeline->destroy();
+    CC_DELETE(pipeline);
+    CC_DELETE(scene);
+    destroyDevice(device);
+    return activated;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto lightCounts = getOptionList(argc, argv, "lights", {16, 64, 256, 1024});
+    const uint modelCount = getOption(argc, argv, "models", 1000);
+    const uint iterations = getOption(argc, argv, "iterations", 100);
+    const uint frames = getOption(argc, argv, "frames", 20);
+    const double frameCount = frames ? frames : 1;
+
+    if (!startScriptEngine()) return 1;
+
+    printf("%u models, binning averaged over %u builds, frames over %u frames\n", modelCount, iterations, frames);
+    printf("  %-8s %10s %10s | %10s %10s | %10s %10s %10s\n", "lights", "binning ms", "indices", "add ms", "add draws",
+           "cluster ms", "draws", "binning ms");
+    bool succeeded = true;
+    for (const auto lightCount : lightCounts) {
+        double binningTime = 0.0;
+        uint indexCount = 0;
+        FrameStats forwardAdd;
+        FrameStats clustered;
+        succeeded = measureBinning(modelCount, lightCount, iterations, binningTime, indexCount) && succeeded;
+        succeeded = render(modelCount, lightCount, frames, false, forwardAdd) && succeeded;
+        succeeded = render(modelCount, lightCount, frames, true, clustered) && succeeded;
+
+        printf("  %-8u %10.3f %10u | %10.3f %10.0f | %10.3f %10.0f %10.3f\n", lightCount, binningTime, indexCount,
+               forwardAdd.frameTime / frameCount, forwardAdd.drawCalls / frameCount, clustered.frameTime / frameCount,
+               clustered.drawCalls / frameCount, clustered.binningTime / frameCount);
+    }
+
+    stopScriptEngine();
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Renders a synthetic scene from street level, where near boxes hide most of the far ones, once without and once
+// with occlusion culling, and reports what a frame costs, how many models the occlusion buffer rejected and how
+// long building and testing it took.
+//
+// occlusion_benchmark [--models 10000,50000] [--frames 100] [--height 5]
+//
+// --height is the eye height of the camera, models are up to 20 units tall.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXDevice.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+
+namespace {
+constexpr uint WIDTH = 1280;
+constexpr uint HEIGHT = 720;
+constexpr uint WARMUP_FRAMES = 5;
+
+struct FrameStats {
+    double frameTime = 0.0;
+    double cullingTime = 0.0;
+    double drawCalls = 0.0;
+    double occludedObjects = 0.0;
+    double occlusionTime = 0.0;
+};
+
+bool run(uint modelCount, uint frames, float height, bool occlusionCulling, FrameStats &stats) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(WIDTH, HEIGHT);
+    if (!device) return false;
+
+    auto pipeline = CC_NEW(pipeline::ForwardPipeline);
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    info.width = WIDTH;
+    info.height = HEIGHT;
+    auto scene = CC_NEW(SyntheticScene(info));
+
+    pipeline->initialize({});
+    pipeline->setFog(scene->getFogID());
+    pipeline->setAmbient(scene->getAmbientID());
+    pipeline->setSkybox(scene->getSkyboxID());
+    pipeline->setShadows(scene->getShadowsID());
+    pipeline->setOcclusionCulling(occlusionCulling);
+    const bool activated = pipeline->activate();
+
+    const cc::vector<uint> cameras = {scene->getCameraID()};
+    for (uint frame = 0; activated && frame < WARMUP_FRAMES + frames; ++frame) {
+        se::AutoHandleScope frameScope;
+        // turning on the spot in the middle of the scene
+        const float angle = frame * 0.01f;
+        const Vec3 eye(0.0f, height, 0.0f);
+        scene->lookAt(eye, eye + Vec3(std::sin(angle), 0.0f, -std::cos(angle)));
+
+        const auto start = std::chrono::steady_clock::now();
+        device->acquire();
+        pipeline->render(cameras);
+        device->present();
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        scene->clearChangedFlags();
+        if (frame < WARMUP_FRAMES) continue;
+
+        stats.frameTime += time.count();
+        stats.cullingTime += pipeline->getCullingTime();
+        stats.drawCalls += device->getNumDrawCalls();
+        stats.occludedObjects += pipeline->getOccludedObjectCount();
+        stats.occlusionTime += pipeline->getOcclusionCullingTime();
+    }
+    if (!activated) CC_LOG_ERROR("Failed to activate the pipeline.");
+
+    pipeline->destroy();
+    CC_DELETE(pipeline);
+    CC_DELETE(scene);
+    destroyDevice(device);
+    return activated;
+}
+
+void print(const char *name, const FrameStats &stats, uint frames) {
+    const double count = frames ? frames : 1;
+    printf("  %-18s %10.3f %10.3f %10.0f %10.0f %10.3f\n", name, stats.frameTime / count, stats.cullingTime / count,
+           stats.drawCalls / count, stats.occludedObjects / count, stats.occlusionTime / count);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto modelCounts = getOptionList(argc, argv, "models", {10000, 50000});
+    const uint frames = getOption(argc, argv, "frames", 100);
+    const float height = static_cast<float>(getOption(argc, argv, "height", 5));
+
+    if (!startScriptEngine()) return 1;
+
+    bool succeeded = true;
+    for (const auto modelCount : modelCounts) {
+        FrameStats withoutOcclusion;
+        FrameStats withOcclusion;
+        succeeded = run(modelCount, frames, height, false, withoutOcclusion) && succeeded;
+        succeeded = run(modelCount, frames, height, true, withOcclusion) && succeeded;
+
+        printf("%u models, camera at height %.0f, %u frames\n", modelCount, height, frames);
+        printf("  %-18s %10s %10s %10s %10s %10s\n", "", "frame ms", "culling ms", "draws", "occluded", "occl. ms");
+        print("frustum only", withoutOcclusion, frames);
+        print("frustum+occlusion", withOcclusion, frames);
+    }
+
+    stopScriptEngine();
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Renders a synthetic scene with the forward pipeline on the empty device and reports what one frame costs the CPU.
+//
+// pipeline_benchmark [--models 1000,10000,50000] [--frames 100] [--lights 0] [--moving 1]
+//                    [--static-camera] [--multithreaded] [--occlusion] [--clustered] [--render-thread]
+//
+// --moving is the percentage of models moved every frame, --static-camera keeps the camera still so retained views
+// are patched instead of rebuilt, the other switches turn on the pipeline and device options of the same name.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXDevice.h"
+#include "renderer/gfx-empty/GFXEmpty.h"
+#include "renderer/pipeline/RenderFlow.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+
+namespace {
+constexpr uint WIDTH = 1280;
+constexpr uint HEIGHT = 720;
+// frames rendered before measuring, the first ones build every cache
+constexpr uint WARMUP_FRAMES = 5;
+
+struct Options {
+    uint frames = 100;
+    uint lightCount = 0;
+    uint movingPercent = 1;
+    bool staticCamera = false;
+    bool multithreadedRecording = false;
+    bool occlusionCulling = false;
+    bool clusteredLighting = false;
+    bool renderThread = false;
+};
+
+struct FrameStats {
+    double frameTime = 0.0;
+    double cullingTime = 0.0;
+    cc::vector<double> flowTimes;
+    double drawCalls = 0.0;
+    double stateChanges = 0.0;
+    double triangles = 0.0;
+    double rebuiltEntries = 0.0;
+    double occludedObjects = 0.0;
+    double lightBinningTime = 0.0;
+};
+
+bool run(uint modelCount, const Options &options) {
+    se::AutoHandleScope hs;
+    // a fresh device for every scene, destroying the pipeline also destroys the device command buffer
+    auto device = createDevice(WIDTH, HEIGHT);
+    if (!device) return false;
+    device->setMultithreaded(options.renderThread);
+
+    auto pipeline = CC_NEW(pipeline::ForwardPipeline);
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    info.sphereLightCount = options.lightCount / 2;
+    info.spotLightCount = options.lightCount - info.sphereLightCount;
+    info.width = WIDTH;
+    info.height = HEIGHT;
+    auto scene = CC_NEW(SyntheticScene(info));
+
+    pipeline->initialize({});
+    pipeline->setFog(scene->getFogID());
+    pipeline->setAmbient(scene->getAmbientID());
+    pipeline->setSkybox(scene->getSkyboxID());
+    pipeline->setShadows(scene->getShadowsID());
+    pipeline->setMultithreadedRecording(options.multithreadedRecording);
+    pipeline->setOcclusionCulling(options.occlusionCulling);
+    pipeline->setClusteredLighting(options.clusteredLighting);
+    const bool activated = pipeline->activate();
+
+    FrameStats stats;
+    stats.flowTimes.resize(pipeline->getFlows().size());
+    const cc::vector<uint> cameras = {scene->getCameraID()};
+    const uint movingCount = modelCount * options.movingPercent / 100;
+    for (uint frame = 0; activated && frame < WARMUP_FRAMES + options.frames; ++frame) {
+        se::AutoHandleScope frameScope;
+        if (!options.staticCamera || !frame) {
+            const float angle = frame * 0.01f;
+            scene->lookAt(Vec3(std::sin(angle) * info.extent, info.extent * 0.2f, std::cos(angle) * info.extent), Vec3::ZERO);
+        }
+        scene->moveModels(movingCount, 1.0f);
+
+        const auto start = std::chrono::steady_clock::now();
+        device->acquire();
+        pipeline->render(cameras);
+        device->present();
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        scene->clearChangedFlags();
+        if (frame < WARMUP_FRAMES) continue;
+
+        stats.frameTime += time.count();
+        stats.cullingTime += pipeline->getCullingTime();
+        for (size_t i = 0; i < stats.flowTimes.size(); ++i) {
+            stats.flowTimes[i] += pipeline->getFlowTimes()[i];
+        }
+        stats.drawCalls += device->getNumDrawCalls();
+        stats.stateChanges += static_cast<gfx::EmptyDevice *>(device)->getNumStateChanges();
+        stats.triangles += device->getNumTris();
+        stats.rebuiltEntries += pipeline->getRebuiltEntryCount();
+        stats.occludedObjects += pipeline->getOccludedObjectCount();
+        stats.lightBinningTime += pipeline->getLightBinningTime();
+    }
+
+    if (activated) {
+        const double frames = options.frames ? options.frames : 1;
+        printf("%u models, %u lights, %u%% moving, %s camera\n", modelCount, options.lightCount, options.movingPercent,
+               options.staticCamera ? "static" : "orbiting");
+        printf("  %-20s %10.3f ms\n", "frame", stats.frameTime / frames);
+        printf("  %-20s %10.3f ms\n", "culling", stats.cullingTime / frames);
+        for (size_t i = 0; i < stats.flowTimes.size(); ++i) {
+            printf("  %-20s %10.3f ms\n", pipeline->getFlows()[i]->getName().c_str(), stats.flowTimes[i] / frames);
+        }
+        if (options.clusteredLighting) printf("  %-20s %10.3f ms\n", "light binning", stats.lightBinningTime / frames);
+        printf("  %-20s %10.0f\n", "draw calls", stats.drawCalls / frames);
+        printf("  %-20s %10.0f\n", "state changes", stats.stateChanges / frames);
+        printf("  %-20s %10.0f\n", "triangles", stats.triangles / frames);
+        printf("  %-20s %10.0f\n", "rebuilt entries", stats.rebuiltEntries / frames);
+        if (options.occlusionCulling) printf("  %-20s %10.0f\n", "occluded objects", stats.occludedObjects / frames);
+    } else {
+        CC_LOG_ERROR("Failed to activate the pipeline.");
+    }
+
+    pipeline->destroy();
+    CC_DELETE(pipeline);
+    CC_DELETE(scene);
+    destroyDevice(device);
+    return activated;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto modelCounts = getOptionList(argc, argv, "models", {1000, 10000, 50000});
+    Options options;
+    options.frames = getOption(argc, argv, "frames", options.frames);
+    options.lightCount = getOption(argc, argv, "lights", options.lightCount);
+    options.movingPercent = getOption(argc, argv, "moving", options.movingPercent);
+    options.staticCamera = hasOption(argc, argv, "static-camera");
+    options.multithreadedRecording = hasOption(argc, argv, "multithreaded");
+    options.occlusionCulling = hasOption(argc, argv, "occlusion");
+    options.clusteredLighting = hasOption(argc, argv, "clustered");
+    options.renderThread = hasOption(argc, argv, "render-thread");
+
+    if (!startScriptEngine()) return 1;
+
+    bool succeeded = true;
+    for (const auto modelCount : modelCounts) {
+        succeeded = run(modelCount, options) && succeeded;
+    }
+
+    stopScriptEngine();
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Sorts the opaque passes of a synthetic scene with the packed key radix sort of RenderQueue and with std::sort
+// over the comparator the queues used before (priority hash, then depth, then shader), and reports the time to
+// fill and sort a queue and how many pipeline state and material descriptor set binds the sorted order needs.
+// Fails if the draws the queue resolves differ from the comparator order, reporting the first mismatch.
+//
+// render_queue_benchmark [--models 10000,50000,100000] [--iterations 20] [--shaders 16] [--materials 64]
+
+#include <algorithm>
+#include <cstdio>
+
+#include "common/BenchmarkHarness.h"
+#include "common/SyntheticScene.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXDevice.h"
+#include "renderer/pipeline/PipelineStateManager.h"
+#include "renderer/pipeline/RenderQueue.h"
+#include "renderer/pipeline/forward/ForwardPipeline.h"
+
+using namespace cc;
+using namespace cc::benchmark;
+using namespace cc::pipeline;
+
+namespace {
+
+// RenderPass as it was before the packed sort keys.
+struct HashedPass {
+    uint hash = 0;
+    float depth = 0;
+    uint shaderID = 0;
+    uint passIndex = 0;
+    const SubModelView *subModel = nullptr;
+};
+
+// Depths are compared exactly, an epsilon compare is not a strict weak ordering.
+bool opaqueCompareFn(const HashedPass &a, const HashedPass &b) {
+    if (a.hash != b.hash)
+        return a.hash < b.hash;
+    else if (a.depth != b.depth)
+        return a.depth < b.depth;
+    else
+        return a.shaderID < b.shaderID;
+}
+
+struct Binds {
+    uint pipelineStates = 0;
+    uint materialSets = 0;
+};
+
+// Binds the draws need when unchanged state is not bound again, as recordDrawCalls does.
+Binds countBinds(const DrawCallList &drawCalls) {
+    Binds binds;
+    const gfx::PipelineState *pipelineState = nullptr;
+    const gfx::DescriptorSet *materialSet = nullptr;
+    for (const auto &drawCall : drawCalls) {
+        if (drawCall.pipelineState != pipelineState) {
+            pipelineState = drawCall.pipelineState;
+            ++binds.pipelineStates;
+        }
+        if (drawCall.materialSet != materialSet) {
+            materialSet = drawCall.materialSet;
+            ++binds.materialSets;
+        }
+    }
+    return binds;
+}
+
+RenderObject getRenderObject(const ModelView *model, const Camera *camera) {
+    cc::Vec3 position;
+    cc::Vec3::subtract(model->getTransform()->worldPosition, camera->position, &position);
+    return {position.dot(camera->forward), model, model->getSubModelID()};
+}
+
+bool run(uint modelCount, uint iterations, uint shaderCount, uint materialCount) {
+    se::AutoHandleScope hs;
+    auto device = createDevice(1280, 720);
+    if (!device) return false;
+
+    // only constructed for the descriptor set layouts the scene creates its local descriptor sets from
+    auto pipeline = CC_NEW(ForwardPipeline);
+    SyntheticSceneInfo info;
+    info.modelCount = modelCount;
+    info.shaderCount = shaderCount;
+    info.materialCount = materialCount;
+    auto scene = CC_NEW(SyntheticScene(info));
+    const auto camera = scene->getCamera();
+
+    gfx::ColorAttachment colorAttachment;
+    colorAttachment.format = device->getColorFormat();
+    gfx::DepthStencilAttachment depthStencilAttachment;
+    depthStencilAttachment.format = device->getDepthStencilFormat();
+    auto renderPass = device->createRenderPass({{colorAttachment}, depthStencilAttachment});
+
+    RenderObjectList renderObjects;
+    for (const auto modelID : scene->getModelIDs()) {
+        renderObjects.emplace_back(getRenderObject(GET_MODEL(modelID), camera));
+    }
+
+    const uint phase = getPhaseID("default");
+    RenderQueueCreateInfo queueInfo;
+    queueInfo.phases = phase;
+    queueInfo.sortMode = RenderQueueSortMode::FRONT_TO_BACK;
+    RenderQueue queue(queueInfo);
+    auto fillQueue = [&]() {
+        queue.clear();
+        for (const auto &renderObject : renderObjects) {
+            const auto subModelCount = renderObject.subModelID[0];
+            for (uint m = 1; m <= subModelCount; ++m) {
+                const auto subModel = renderObject.model->getSubModelView(renderObject.subModelID[m]);
+                for (uint p = 0; p < subModel->passCount; ++p) {
+                    if (subModel->getPassView(p)->phase == phase) queue.insertRenderPass(renderObject, m, p);
+                }
+            }
+        }
+    };
+
+    // same passes as the queue takes, opaque ones of the default phase
+    cc::vector<HashedPass> hashedPasses;
+    auto fillHashedPasses = [&]() {
+        hashedPasses.clear();
+        for (const auto &renderObject : renderObjects) {
+            const auto subModelCount = renderObject.subModelID[0];
+            for (uint m = 1; m <= subModelCount; ++m) {
+                const auto subModel = renderObject.model->getSubModelView(renderObject.subModelID[m]);
+                for (uint p = 0; p < subModel->passCount; ++p) {
+                    const auto pass = subModel->getPassView(p);
+                    if (pass->phase != phase || pass->getBlendState()->targets[0].blend) continue;
+                    const uint hash = (0 << 30) | (pass->priority << 16) | (subModel->priority << 8) | p;
+                    hashedPasses.push_back({hash, renderObject.depth, subModel->shaderID[p], p, subModel});
+                }
+            }
+        }
+    };
+
+    const double queueFillTime = measure(iterations, fillQueue);
+    const double queueSortTime = measure(iterations, [&]() {
+        fillQueue();
+        queue.sort();
+    });
+    const double hashedFillTime = measure(iterations, fillHashedPasses);
+    const double hashedSortTime = measure(iterations, [&]() {
+        fillHashedPasses();
+        std::sort(hashedPasses.begin(), hashedPasses.end(), opaqueCompareFn);
+    });
+
+    // the reference keeps passes that compare equal in fill order, as the radix sort does
+    fillHashedPasses();
+    std::stable_sort(hashedPasses.begin(), hashedPasses.end(), opaqueCompareFn);
+
+    DrawCallList queueDraws;
+    queue.resolveDrawCalls(renderPass, queueDraws);
+    DrawCallList hashedDraws;
+    for (const auto &hashedPass : hashedPasses) {
+        const auto subModel = hashedPass.subModel;
+        const auto pass = subModel->getPassView(hashedPass.passIndex);
+        DrawCall drawCall;
+        drawCall.pipelineState = PipelineStateManager::getOrCreatePipelineState(pass, subModel->getShader(hashedPass.passIndex), subModel->getInputAssembler(), renderPass);
+        drawCall.materialSet = pass->getDescriptorSet();
+        drawCall.localSet = subModel->getDescriptorSet();
+        drawCall.inputAssembler = subModel->getInputAssembler();
+        hashedDraws.emplace_back(drawCall);
+    }
+    const auto queueBinds = countBinds(queueDraws);
+    const auto hashedBinds = countBinds(hashedDraws);
+
+    printf("%u models, %zu opaque passes, %u shaders, %u materials, %u iterations\n", modelCount, queue.size(), shaderCount,
+           materialCount, iterations);
+    printf("  %-24s %10s %10s %10s %10s\n", "", "fill ms", "sort ms", "pso binds", "mat binds");
+    printf("  %-24s %10.3f %10.3f %10u %10u\n", "radix sort, packed keys", queueFillTime, queueSortTime - queueFillTime,
+           queueBinds.pipelineStates, queueBinds.materialSets);
+    printf("  %-24s %10.3f %10.3f %10u %10u\n", "std::sort, hash + depth", hashedFillTime, hashedSortTime - hashedFillTime,
+           hashedBinds.pipelineStates, hashedBinds.materialSets);
+
+    bool sameOrder = queueDraws.size() == hashedDraws.size();
+    if (!sameOrder) CC_LOG_ERROR("The queue took %zu passes instead of %zu.", queueDraws.size(), hashedDraws.size());
+    for (size_t i = 0; sameOrder && i < queueDraws.size(); ++i) {
+        const auto &draw = queueDraws[i];
+        const auto &expected = hashedDraws[i];
+        sameOrder = draw.pipelineState == expected.pipelineState && draw.materialSet == expected.materialSet &&
+                    draw.localSet == expected.localSet && draw.inputAssembler == expected.inputAssembler;
+        if (!sameOrder) {
+            const auto &hashedPass = hashedPasses[i];
+            CC_LOG_ERROR("Draw %zu differs from the comparator order, expected hash %x, depth %f, shader %x.", i, hashedPass.hash,
+                         hashedPass.depth, hashedPass.shaderID);
+        }
+    }
+
+    PipelineStateManager::destroyAll();
+    CC_DESTROY(renderPass);
+    CC_DELETE(scene);
+    CC_DELETE(pipeline);
+    destroyDevice(device);
+    return sameOrder;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const auto modelCounts = getOptionList(argc, argv, "models", {10000, 50000, 100000});
+    const uint iterations = getOption(argc, argv, "iterations", 20);
+    const uint shaderCount = getOption(argc, argv, "shaders", 16);
+    const uint materialCount = getOption(argc, argv, "materials", 64);
+
+    if (!startScriptEngine()) return 1;
+
+    bool succeeded = true;
+    for (const auto modelCount : modelCounts) {
+        succeeded = run(modelCount, iterations, shaderCount, materialCount) && succeeded;
+    }
+
+    stopScriptEngine();
+    return succeeded ? 0 : 1;
+}
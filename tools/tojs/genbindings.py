@@ -155,6 +155,7 @@ def main():
                     'gles3.ini': ('gles3', 'jsb_gles3_auto'),
                     'metal.ini': ('metal', 'jsb_mtl_auto'),
                     'vulkan.ini': ('vulkan', 'jsb_vk_auto'),
+                    'empty.ini': ('empty', 'jsb_empty_auto'),
                     'pipeline.ini': ('pipeline', 'jsb_pipeline_auto'),
                     'spine.ini': ('spine','jsb_spine_auto'),
                     'editor_support.ini': ('editor_support','jsb_editor_support_auto'),